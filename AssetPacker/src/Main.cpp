@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "Core/AssetArchive.h"
+#include "Core/VirtualFileSystem.h"
+
+// Packs an asset directory into an AssetArchive, and times reading every asset from loose files against reading
+// them from the archive. The benchmark only measures a cold start if the OS file cache doesn't hold the files
+// yet, so run each mode in a fresh process after a reboot (or after flushing the standby list).
+//
+// Usage:
+//   AssetPacker <asset directory> <archive> [--no-compress]
+//   AssetPacker --benchmark loose <asset directory>
+//   AssetPacker --benchmark archive <archive>
+
+namespace
+{
+	// Paths in the archive are relative to the asset directory's parent, the same paths the engine opens them with
+	std::vector<AssetArchive::SourceFile> FindSourceFiles(const std::filesystem::path& assetDirectory)
+	{
+		std::vector<AssetArchive::SourceFile> files;
+		const std::filesystem::path root = assetDirectory.lexically_normal().parent_path();
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(assetDirectory))
+		{
+			if (entry.is_regular_file())
+			{
+				files.push_back({ entry.path(), entry.path().lexically_normal().lexically_relative(root).generic_string() });
+			}
+		}
+
+		std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.ArchivePath < b.ArchivePath; });
+		return files;
+	}
+
+	// Opens every file and touches every page of it, so the data actually has to come off the disk
+	void ReadAll(const std::vector<std::string>& filepaths, const char* mode)
+	{
+		Timer timer;
+		size_t bytes = 0;
+		uint64_t checksum = 0;
+		for (const auto& filepath : filepaths)
+		{
+			const AssetFile file = VirtualFileSystem::Open(filepath);
+			if (!file.IsOpen())
+			{
+				std::cerr << "Failed to open " << filepath << "\n";
+				continue;
+			}
+
+			for (size_t i = 0; i < file.GetSize(); i += 4096)
+			{
+				checksum += file.GetData()[i];
+			}
+			bytes += file.GetSize();
+		}
+
+		const double ms = timer.GetElapsedInMilliseconds();
+		std::cout << std::format("{}: {} files, {:.2f}MB in {:.2f}ms ({:.1f}MB/s, checksum {})\n",
+			mode, filepaths.size(), bytes / (1024.0 * 1024.0), ms, bytes / (1024.0 * 1024.0) / (ms / 1000.0), checksum);
+	}
+
+	int Benchmark(const std::string& mode, const std::filesystem::path& path)
+	{
+		std::vector<std::string> filepaths;
+		Timer timer;
+		if (mode == "loose")
+		{
+			for (const auto& file : FindSourceFiles(path))
+			{
+				filepaths.push_back(file.ArchivePath);
+			}
+		}
+		else if (mode == "archive")
+		{
+			if (!VirtualFileSystem::Mount(path))
+			{
+				std::cerr << "Failed to mount " << path.string() << "\n";
+				return 1;
+			}
+
+			AssetArchive archive(path);
+			for (size_t i = 0; i < archive.GetNumEntries(); i++)
+			{
+				filepaths.emplace_back(archive.GetPath(archive.GetEntry(i)));
+			}
+		}
+		else
+		{
+			std::cerr << "Unknown benchmark mode " << mode << "\n";
+			return 1;
+		}
+		std::cout << std::format("Found {} files in {:.2f}ms\n", filepaths.size(), timer.GetElapsedInMilliseconds());
+
+		ReadAll(filepaths, mode.c_str());
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	STRIP_DEBUG(Log::Init());
+
+	if (argc == 4 && std::string(argv[1]) == "--benchmark")
+	{
+		return Benchmark(argv[2], argv[3]);
+	}
+
+	if (argc < 3)
+	{
+		std::cerr << "Usage: AssetPacker <asset directory> <archive> [--no-compress]\n"
+			<< "       AssetPacker --benchmark loose <asset directory>\n"
+			<< "       AssetPacker --benchmark archive <archive>\n";
+		return 1;
+	}
+
+	const std::filesystem::path assetDirectory = argv[1];
+	const std::filesystem::path archivePath = argv[2];
+	const bool compress = !(argc > 3 && std::string(argv[3]) == "--no-compress");
+
+	Timer timer;
+	const std::vector<AssetArchive::SourceFile> files = FindSourceFiles(assetDirectory);
+	if (!AssetArchive::Write(archivePath, files, compress))
+	{
+		std::cerr << "Failed to write " << archivePath.string() << "\n";
+		return 1;
+	}
+
+	AssetArchive archive(archivePath);
+	size_t size = 0;
+	size_t storedSize = 0;
+	size_t numCompressed = 0;
+	for (size_t i = 0; i < archive.GetNumEntries(); i++)
+	{
+		const AssetArchive::Entry& entry = archive.GetEntry(i);
+		size += entry.Size;
+		storedSize += entry.StoredSize;
+		numCompressed += entry.Compression != AssetArchive::EntryCompression::None;
+	}
+
+	std::cout << std::format("Packed {} files ({} compressed) into {} in {:.2f}ms, {:.2f}MB -> {:.2f}MB\n", archive.GetNumEntries(), numCompressed,
+		archivePath.string(), timer.GetElapsedInMilliseconds(), size / (1024.0 * 1024.0), storedSize / (1024.0 * 1024.0));
+
+	return 0;
+}
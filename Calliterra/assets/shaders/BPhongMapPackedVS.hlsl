@@ -0,0 +1,46 @@
+#include "Common/TransformsCBuff.hlsl"
+#include "Common/VSOut_PosNormTanBitanTex.hlsl"
+
+cbuffer QuantizationCBuff : register(b1)
+{
+    float3 BoundsMin;
+    float3 BoundsExtent;
+};
+
+// ModelVertexPacked, the input layout does the unorm/snorm/half to float conversion
+struct VSIn
+{
+    float4 Position : POSITION;
+    float2 Normal : NORMAL;
+    float2 Tangent : TANGENT;
+    float2 Texture : TEXCOORD;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+
+VSOut main(VSIn vIn)
+{
+    const float3 position = BoundsMin + vIn.Position.xyz * BoundsExtent;
+    const float3 normal = DecodeOctahedral(vIn.Normal);
+    const float3 tangent = DecodeOctahedral(vIn.Tangent);
+    const float bitangentSign = vIn.Position.w * 2.0f - 1.0f;
+
+    VSOut vOut;
+    vOut.Pos = mul(float4(position, 1.0f), ModelViewProj);
+    vOut.v_Pos = (float3)mul(float4(position, 1.0f), ModelView);
+    vOut.v_Normal = normalize(mul(normal, (float3x3) NormalMatrix));
+
+    vOut.v_Tangent = mul(tangent, (float3x3) ModelView);
+    vOut.v_Tangent = normalize(vOut.v_Tangent - dot(vOut.v_Tangent, vOut.v_Normal) * vOut.v_Normal);
+    vOut.v_Bitangent = cross(vOut.v_Normal, vOut.v_Tangent) * bitangentSign;
+
+    vOut.Texture = vIn.Texture;
+
+    return vOut;
+}
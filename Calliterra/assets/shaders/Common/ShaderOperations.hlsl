@@ -9,9 +9,12 @@ float3 MapNormal(
     // Build a transform (rotation) into the same space as tan/bitan/normal
     const float3x3 tanToTarget = float3x3(tan, bitan, normal);
 
-    // Sample and unpack the normal from texture into tangent space
-    const float3 normalSample = normalMap.Sample(samplerState, textureCoord).xyz;
-    float3 tanNormal = normalSample * 2.f - 1.f;
+    // Sample and unpack the normal from texture into tangent space. Normal maps are stored as BC5
+    // which only keeps X and Y, Z is rebuilt from them since the normal is unit length and faces out.
+    const float2 normalSample = normalMap.Sample(samplerState, textureCoord).xy;
+    float3 tanNormal;
+    tanNormal.xy = normalSample * 2.f - 1.f;
+    tanNormal.z = sqrt(saturate(1.f - dot(tanNormal.xy, tanNormal.xy)));
 
     // Bring normal from tangent space to target space
     return normalize(mul(tanNormal, tanToTarget));
@@ -24,6 +24,24 @@ public:
 
 	std::array<std::string, NumSupportedMaps> GetMaterialMaps() const { return m_MaterialMaps; }
 
+	// Materials with the same contents are drawn the same way, which is what lets meshes share them
+	bool operator==(const Material& other) const = default;
+	size_t GetHash() const
+	{
+		size_t hash = std::hash<float>{}(m_Shininess);
+		for (int i = 0; i < NumSupportedMaps; i++)
+		{
+			const size_t mapHash = std::hash<std::string>{}(m_MaterialMaps[i]) ^ static_cast<size_t>(m_Maps[i]);
+			hash ^= mapHash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+
+	struct Hasher
+	{
+		size_t operator()(const Material& material) const { return material.GetHash(); }
+	};
+
 private:
 	std::array<bool, NumSupportedMaps> m_Maps = {};
 	std::array<std::string, NumSupportedMaps> m_MaterialMaps = {};
@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "MaterialInstance.h"
+#include "Renderer/Renderer.h"
+
+MaterialInstance::MaterialInstance(const Material& material, uint32_t id)
+	: m_Id(id), m_Material(material)
+{
+	std::vector<std::shared_ptr<Bindable>> bindables;
+
+	for (int i = 0; i < Material::NumSupportedMaps; i++)
+	{
+		const std::string& filepath = m_Material.GetMaterialMap(static_cast<Material::MapTypes>(i));
+		if (m_Material.HasMaterialMap(static_cast<Material::MapTypes>(i)))
+		{
+			auto tex = Texture::Resolve(filepath, i);
+			if (i == Material::Albedo && tex->HasBlending())
+			{
+				m_HasBlending = true;
+			}
+			bindables.push_back(tex);
+			m_Textures.push_back(tex);
+		}
+		else
+		{
+			bindables.push_back(Texture::Resolve(filepath, i, Texture::Filter::Point));
+		}
+	}
+
+	PixelConstantBuffer pcb = {
+		m_Material.GetShininess(),
+		m_Material.HasMaterialMap(Material::Normal),
+		m_Material.HasMaterialMap(Material::Specular)
+	};
+
+	// Tagged by the instance rather than by mesh, so there is one constant buffer per distinct material
+	bindables.push_back(ConstantBuffer::Resolve<PixelConstantBuffer>(Shader::PIXEL_SHADER, pcb, 1, "Material%" + std::to_string(m_Id)));
+
+	if (m_HasBlending)
+	{
+		bindables.push_back(Blender::Resolve(true, Blender::BlendFunc::BLEND_SRC_ALPHA, Blender::BlendFunc::BLEND_INV_SRC_ALPHA, Blender::BlendOp::ADD));
+	}
+	else
+	{
+		bindables.push_back(Blender::Resolve(false, Blender::BlendFunc::NONE, Blender::BlendFunc::NONE, Blender::BlendOp::NONE));
+	}
+
+	m_Bindables = std::make_shared<const std::vector<std::shared_ptr<Bindable>>>(std::move(bindables));
+}
+
+std::shared_ptr<const MaterialInstance> MaterialInstance::Resolve(const Material& material)
+{
+	const auto i = s_Instances.find(material);
+	if (i != s_Instances.end())
+	{
+		return i->second;
+	}
+
+	const uint32_t id = static_cast<uint32_t>(s_Instances.size()) + 1;
+	auto instance = std::make_shared<const MaterialInstance>(material, id);
+	s_Instances.emplace(material, instance);
+	return instance;
+}
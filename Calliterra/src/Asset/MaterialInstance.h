@@ -0,0 +1,46 @@
+#pragma once
+#include "Renderer/Bindable.h"
+#include "Renderer/Texture.h"
+#include "Material.h"
+
+// The GPU side of a Material: its texture set, the pixel constant buffer and the blend state. Instances
+// are keyed by the material's contents, so every mesh (of any model) with an identical material shares
+// one instance and its bindables. Steps drawn with the same instance are grouped by the StepPass and
+// only bind it once.
+class MaterialInstance
+{
+public:
+	// Creates the GPU resources, so this has to be called on the main thread
+	MaterialInstance(const Material& material, uint32_t id);
+
+	static std::shared_ptr<const MaterialInstance> Resolve(const Material& material);
+	static size_t GetNumInstances() { return s_Instances.size(); }
+
+	// Unique per instance and never 0, which Steps use for "no material"
+	uint32_t GetId() const { return m_Id; }
+	const Material& GetMaterial() const { return m_Material; }
+	const std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>>& GetBindables() const { return m_Bindables; }
+	// The material maps the material actually has, placeholders for missing maps aren't included
+	const std::vector<std::shared_ptr<Texture>>& GetTextures() const { return m_Textures; }
+	bool HasBlending() const { return m_HasBlending; }
+
+private:
+	// HLSL bools are 32 bit
+	struct PixelConstantBuffer
+	{
+		float SpecularPower;
+		int32_t hasNormalMap;
+		int32_t hasSpecMap;
+		float padding[1];
+	};
+
+private:
+	uint32_t m_Id;
+	Material m_Material;
+	std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> m_Bindables;
+	std::vector<std::shared_ptr<Texture>> m_Textures;
+	bool m_HasBlending = false;
+
+	// Like the RendererResourceLibrary, instances live until shutdown
+	inline static std::unordered_map<Material, std::shared_ptr<const MaterialInstance>, Material::Hasher> s_Instances;
+};
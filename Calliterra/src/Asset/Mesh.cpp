@@ -1,119 +1,217 @@
 #include "pch.h"
 #include "Mesh.h"
-
-Mesh::Mesh(int meshIndex, const aiScene& ObjModel, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::unique_ptr<Material> material, const std::string& filepath)
-	: Drawable(transform, color), m_MeshIndex(meshIndex), m_AssimpModel(&ObjModel), m_Material(std::move(material)), m_Filepath(filepath)
+#include "Renderer/RenderQueue/Step.h"
+#include "Renderer/TextureStreamer.h"
+#include "Core/ImportProfiler.h"
+
+// Each LOD gets a technique that binds the prototype's shared bindables, the material's bindables and
+// then our own transform
+Mesh::Mesh(std::shared_ptr<const MeshPrototype> prototype, const DX::XMMATRIX& transform, DX::XMFLOAT3 color)
+	: Drawable(transform, color),
+	  m_Prototype(std::move(prototype))
 {
-	InitBuffers();
+	PROFILE_IMPORT("Mesh", m_Prototype->GetFilepath());
+	auto transformBuffer = std::make_shared<TransformConstantBuffer>();
+	const MaterialInstance& material = *m_Prototype->GetMaterialInstance();
+	for (const auto& lod : m_Prototype->GetLods())
+	{
+		Step lodStep(PassName::Lambertian);
+		lodStep.SetSharedBindables(lod.Bindables);
+		lodStep.SetMaterial(material.GetId(), material.GetBindables(), material.HasBlending());
+		lodStep.SetIndexCount(lod.IndexCount);
+		lodStep.AddBindable(transformBuffer);
+
+		Technique drawTech;
+		drawTech.AddStep(std::move(lodStep));
+		AddTechnique(std::move(drawTech));
+	}
+
+	SetTransform(transform);
 }
 
-Mesh::Mesh(int meshIndex, const rapidobj::Result& ObjModel, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::unique_ptr<Material> material, const std::string& filepath)
-	: Drawable(transform, color), m_MeshIndex(meshIndex), m_ObjModel(&ObjModel), m_Material(std::move(material)), m_Filepath(filepath)
+Mesh::Mesh(const MeshData& meshData, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::string& filepath)
+	: Mesh(std::make_shared<MeshPrototype>(meshData, filepath), transform, color)
 {
-	m_VerticesSemi = ModelLoader::GetMeshVertexVector(*m_ObjModel, m_MeshIndex);
-	m_Indices = ModelLoader::GetMeshIndexVector(*m_ObjModel, m_MeshIndex);
-
-	InitBuffers();
 }
 
-Mesh::Mesh(int meshIndex, const fastgltf::Asset& gltfModel, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::unique_ptr<Material> material, const std::string& filepath)
-	: Drawable(transform, color), m_MeshIndex(meshIndex), m_GltfModel(&gltfModel), m_Material(std::move(material)), m_Filepath(filepath)
+void Mesh::Submit() const
 {
-	m_VerticesSemi = ModelLoader::GetMeshVertexVector(*m_GltfModel, m_MeshIndex);
-	m_Indices = ModelLoader::GetMeshIndexVector(*m_GltfModel, m_MeshIndex);
+	const auto& techniques = GetTechniques();
+	if (techniques.empty())
+	{
+		return;
+	}
 
-	InitBuffers();
-}
+	RequestTextures();
 
-Mesh::Mesh(int meshIndex, const UfbxScene& fbxModel, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::unique_ptr<Material> material, const std::string& filepath)
-	: Drawable(transform, color), m_MeshIndex(meshIndex), m_FbxModel(&fbxModel), m_Material(std::move(material)), m_Filepath(filepath)
-{
-	m_VerticesSemi = ModelLoader::GetMeshVertexVector(*m_FbxModel, m_MeshIndex);
-	m_Indices = ModelLoader::GetMeshIndexVector(*m_FbxModel, m_VerticesSemi, m_MeshIndex);
+	const float viewDepth = DX::XMVectorGetZ(DX::XMVector3Transform(DX::XMLoadFloat3(&m_WorldBoundingSphere.Center), m_ViewMatrix));
+
+	// The lower LODs are only used when the mesh is small on screen, where culling parts of it isn't worth it
+	const size_t lod = SelectLod();
+	const std::vector<Meshlet>& meshlets = m_Prototype->GetMeshlets();
+	if (lod != 0 || meshlets.empty())
+	{
+		techniques[lod].Submit(viewDepth);
+		s_CullingStats.DrawCalls++;
+		return;
+	}
 
-	InitBuffers();
+	std::vector<DrawRange>& drawRanges = s_DrawRanges;
+	drawRanges.clear();
+	CullMeshlets(drawRanges);
+	s_CullingStats.DrawCalls += static_cast<uint32_t>(drawRanges.size());
+
+	if (drawRanges.size() == 1 && drawRanges[0].IndexCount == meshlets.back().IndexOffset + meshlets.back().IndexCount)
+	{
+		techniques[0].Submit(viewDepth);
+	}
+	else if (!drawRanges.empty())
+	{
+		techniques[0].Submit(drawRanges, viewDepth);
+	}
 }
 
 void Mesh::Update(float dt)
 {
 }
 
-void Mesh::InitBuffers()
+// Transforming the model space bounds is enough to keep the world space ones up to date
+void Mesh::SetTransform(const DX::XMMATRIX& transform)
+{
+	Drawable::SetTransform(transform);
+	m_Prototype->GetBounds().Transform(m_WorldBounds, transform);
+	m_Prototype->GetBoundingSphere().Transform(m_WorldBoundingSphere, transform);
+}
+
+size_t Mesh::SelectLod() const
 {
-	Technique drawTech;
-	Step onlyStep(PassName::Lambertian);
+	const size_t numLods = GetTechniques().size();
+	if (numLods <= 1)
+	{
+		return 0;
+	}
 
-	using namespace std::string_literals;
-	auto meshTag = m_Filepath + "%" + std::to_string(m_MeshIndex);
+	const DX::XMVECTOR viewCenter = DX::XMVector3Transform(DX::XMLoadFloat3(&m_WorldBoundingSphere.Center), m_ViewMatrix);
+	const float distance = DX::XMVectorGetZ(viewCenter);
+	const float radius = m_WorldBoundingSphere.Radius;
 
-	bool hasNormalMap = m_Material->HasMaterialMap(Material::Normal);
-	bool hasSpecMap = m_Material->HasMaterialMap(Material::Specular);
+	// The camera is inside of the bounds
+	if (distance <= radius)
+	{
+		return 0;
+	}
 
-	auto vShader = Shader::Resolve("assets/shaders/BPhongMapVS.hlsl", Shader::VERTEX_SHADER);
-	onlyStep.AddBindable(vShader);
-	onlyStep.AddBindable(Shader::Resolve("assets/shaders/BPhongMapPS.hlsl", Shader::PIXEL_SHADER));
+	// Fraction of the screen's height that the bounding sphere's diameter covers
+	const float screenSize = radius * DX::XMVectorGetY(m_ProjectionMatrix.r[1]) / distance;
 
-	m_VerticesFull = ModelLoader::GetMeshVertexVectorFull(*m_AssimpModel, m_MeshIndex);
-	auto vBuff = VertexBuffer::Resolve(meshTag, m_VerticesFull);
+	size_t lod = 0;
+	float lodScreenSize = s_LodScreenSize;
+	while (screenSize < lodScreenSize && lod + 1 < numLods)
+	{
+		lod++;
+		lodScreenSize *= 0.5f;
+	}
 
-	vBuff->CreateLayout({
-		{"POSITION", 0, ShaderDataType::Float3},
-		{"NORMAL", 0, ShaderDataType::Float3},
-		{"TANGENT", 0, ShaderDataType::Float3},
-		{"BITANGENT", 0, ShaderDataType::Float3},
-		{"TEXCOORD", 0, ShaderDataType::Float2},
-		}, vShader.get());
-	onlyStep.AddBindable(vBuff);
+	return lod;
+}
 
-	m_Indices = ModelLoader::GetMeshIndexVector(*m_AssimpModel, m_MeshIndex);
+// Estimates how many pixels one UV unit covers at the point of the mesh closest to the camera. Meshes that
+// end up culled still ask for their textures, they're likely to come into view again soon.
+void Mesh::RequestTextures() const
+{
+	const std::vector<std::shared_ptr<Texture>>& textures = m_Prototype->GetTextures();
+	if (textures.empty())
+	{
+		return;
+	}
 
-	onlyStep.AddBindable(IndexBuffer::Resolve(meshTag, m_Indices));
+	const DX::XMVECTOR viewCenter = DX::XMVector3Transform(DX::XMLoadFloat3(&m_WorldBoundingSphere.Center), m_ViewMatrix);
+	const float distance = DX::XMVectorGetZ(viewCenter) - m_WorldBoundingSphere.Radius;
 
-	bool blending = false;
-	for (int i = 0; i < m_Material->NumSupportedMaps; i++)
+	float pixelsPerUv = std::numeric_limits<float>::infinity();
+	if (distance > 0.f)
 	{
-		if (m_Material->HasMaterialMap(static_cast<Material::MapTypes>(i)))
-		{
-			if (i == 0)
-			{
-				auto tex = Texture::Resolve(m_Material->GetMaterialMaps()[i], i);
-				if (tex->HasBlending())
-				{
-					blending = true;
-				}
-				onlyStep.AddBindable(tex);
-			}
-			else
-			{
-				onlyStep.AddBindable(Texture::Resolve(m_Material->GetMaterialMaps()[i], i));
-			}
-		}
-		else
-		{
-			onlyStep.AddBindable(Texture::Resolve(m_Material->GetMaterialMaps()[i], i, Texture::Filter::Point));
-		}
+		const float pixelsPerUnit = 0.5f * Renderer::GetViewportHeight() * DX::XMVectorGetY(m_ProjectionMatrix.r[1]) / distance;
+		const float localRadius = m_Prototype->GetBoundingSphere().Radius;
+		const float scale = localRadius > 0.f ? m_WorldBoundingSphere.Radius / localRadius : 1.f;
+		pixelsPerUv = pixelsPerUnit * scale / m_Prototype->GetUvDensity();
 	}
 
-	onlyStep.AddBindable(std::make_shared<TransformConstantBuffer>());
+	for (const auto& texture : textures)
+	{
+		TextureStreamer::Request(texture.get(), pixelsPerUv);
+	}
+}
 
-	PixelConstantBuffer pcb = {
-		m_Material->GetShininess(),
-		hasNormalMap,
-		hasSpecMap
+// Everything is tested in model space, the clip space planes of the full model-view-projection matrix are
+// the frustum's planes in model space, and the culling tests hold up under any affine transform
+void Mesh::CullMeshlets(std::vector<DrawRange>& drawRanges) const
+{
+	const std::vector<Meshlet>& meshlets = m_Prototype->GetMeshlets();
+	s_CullingStats.Meshlets += static_cast<uint32_t>(meshlets.size());
+
+	const DX::XMMATRIX modelView = m_Transform * m_ViewMatrix;
+	const DX::XMMATRIX clip = DX::XMMatrixTranspose(modelView * m_ProjectionMatrix);
+
+	// Normals point into the frustum, depth is 0 to 1 in Direct3D so the near plane is just the z row
+	const DX::XMVECTOR planes[6] = {
+		DX::XMPlaneNormalize(DX::XMVectorAdd(clip.r[3], clip.r[0])),
+		DX::XMPlaneNormalize(DX::XMVectorSubtract(clip.r[3], clip.r[0])),
+		DX::XMPlaneNormalize(DX::XMVectorAdd(clip.r[3], clip.r[1])),
+		DX::XMPlaneNormalize(DX::XMVectorSubtract(clip.r[3], clip.r[1])),
+		DX::XMPlaneNormalize(clip.r[2]),
+		DX::XMPlaneNormalize(DX::XMVectorSubtract(clip.r[3], clip.r[2])),
 	};
 
-	onlyStep.AddBindable(ConstantBuffer::Resolve<PixelConstantBuffer>(Shader::PIXEL_SHADER, pcb, 1, meshTag));
+	const auto isOutside = [&planes](const DX::BoundingSphere& sphere)
+	{
+		const DX::XMVECTOR center = DX::XMLoadFloat3(&sphere.Center);
+		for (const auto& plane : planes)
+		{
+			if (DX::XMVectorGetX(DX::XMPlaneDotCoord(plane, center)) < -sphere.Radius)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
 
-	if (blending)
+	if (isOutside(m_Prototype->GetBoundingSphere()))
 	{
-		onlyStep.AddBindable(Blender::Resolve(true, Blender::BlendFunc::BLEND_SRC_ALPHA, Blender::BlendFunc::BLEND_INV_SRC_ALPHA, Blender::BlendOp::ADD));
+		s_CullingStats.FrustumCulled += static_cast<uint32_t>(meshlets.size());
+		return;
 	}
-	else
+
+	// Back facing clusters can only be skipped when the rasterizer would have culled them anyway
+	const bool cullBackfaces = GlobalSettings::Rendering::CullType() == GlobalSettings::Rendering::CullBack;
+	const DX::XMVECTOR cameraPosition = DX::XMMatrixInverse(nullptr, modelView).r[3];
+
+	for (const auto& meshlet : meshlets)
 	{
-		onlyStep.AddBindable(Blender::Resolve(false, Blender::BlendFunc::NONE, Blender::BlendFunc::NONE, Blender::BlendOp::NONE));
-	}
+		if (isOutside(meshlet.Bounds))
+		{
+			s_CullingStats.FrustumCulled++;
+			continue;
+		}
 
-	drawTech.AddStep(std::move(onlyStep));
-	AddTechnique(std::move(drawTech));
+		if (cullBackfaces && meshlet.ConeCutoff < 1.f)
+		{
+			const DX::XMVECTOR view = DX::XMVector3Normalize(DX::XMVectorSubtract(DX::XMLoadFloat3(&meshlet.ConeApex), cameraPosition));
+			if (DX::XMVectorGetX(DX::XMVector3Dot(view, DX::XMLoadFloat3(&meshlet.ConeAxis))) >= meshlet.ConeCutoff)
+			{
+				s_CullingStats.BackfaceCulled++;
+				continue;
+			}
+		}
 
+		// Meshlets are stored back to back, so neighbouring visible ones are drawn together
+		if (!drawRanges.empty() && drawRanges.back().StartIndex + drawRanges.back().IndexCount == meshlet.IndexOffset)
+		{
+			drawRanges.back().IndexCount += meshlet.IndexCount;
+		}
+		else
+		{
+			drawRanges.push_back({ meshlet.IndexOffset, meshlet.IndexCount });
+		}
+	}
 }
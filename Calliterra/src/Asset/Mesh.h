@@ -4,69 +4,65 @@
 #include "Renderer/Renderer.h"
 #include "ModelLoader.h"
 #include "Material.h"
+#include "ModelData.h"
+#include "ModelPrototype.h"
 
-struct ModelVertexFull;
-struct ModelVertexSemi;
-class UfbxScene;
+// Meshlets submitted by all meshes since the last ResetCullingStats, and how many of them were skipped
+struct MeshletCullingStats
+{
+	uint32_t Meshlets = 0;
+	uint32_t FrustumCulled = 0;
+	uint32_t BackfaceCulled = 0;
+	uint32_t DrawCalls = 0;
+};
 
+// A single instance of a MeshPrototype. All the mesh owns is its transform and the state derived from it,
+// the GPU resources, material and meshlets are shared with every other instance of the prototype.
 class Mesh : public Drawable
 {
 public:
-	Mesh(int meshIndex, 
-		 const aiScene& ObjModel, 
-		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(), 
-		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f}, 
-		 std::unique_ptr<Material> material = nullptr, 
-		 const std::string& filepath = "");
+	Mesh(std::shared_ptr<const MeshPrototype> prototype,
+		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(),
+		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f});
 
-	Mesh(int meshIndex, 
-		 const rapidobj::Result& ObjModel, 
-		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(), 
-		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f}, 
-		 std::unique_ptr<Material> material = nullptr, 
+	// Convenience for a mesh that doesn't share its prototype with anything
+	Mesh(const MeshData& meshData,
+		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(),
+		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f},
 		 const std::string& filepath = "");
 
-	Mesh(int meshIndex, 
-		 const fastgltf::Asset& gltfModel, 
-		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(), 
-		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f}, 
-		 std::unique_ptr<Material> material = nullptr,
-		 const std::string& filepath = "");
+	// Only the technique of the LOD that fits the mesh's size on screen is submitted. At full detail the
+	// meshlets that are off screen or facing away from the camera are left out of the draw. The textures
+	// are asked for in the resolution the mesh is seen at, see TextureStreamer.
+	void Submit() const override;
 
-	Mesh(int meshIndex, 
-		 const UfbxScene& fbxModel, 
-		 const DX::XMMATRIX& transform = DX::XMMatrixIdentity(), 
-		 DX::XMFLOAT3 color = {-1.f, -1.f, -1.f}, 
-		 std::unique_ptr<Material> material = nullptr,
-		 const std::string& filepath = "");
+	void Update(float dt) override;
+	void SetTransform(const DX::XMMATRIX& transform) override;
 
-	void Submit() const override { Drawable::Submit(); }
+	const MeshPrototype& GetPrototype() const { return *m_Prototype; }
+	const DX::BoundingBox& GetLocalBounds() const { return m_Prototype->GetBounds(); }
+	const DX::BoundingBox& GetWorldBounds() const { return m_WorldBounds; }
+	const DX::BoundingSphere& GetWorldBoundingSphere() const { return m_WorldBoundingSphere; }
 
-	void Update(float dt) override;
+	static const MeshletCullingStats& GetCullingStats() { return s_CullingStats; }
+	static void ResetCullingStats() { s_CullingStats = {}; }
 
 private:
-	void InitBuffers();
-
-	struct PixelConstantBuffer
-	{
-		float SpecularPower;
-		BOOL hasNormalMap;
-		BOOL hasSpecMap;
-		float padding[1];
-	};
+	size_t SelectLod() const;
+	void RequestTextures() const;
+	void CullMeshlets(std::vector<DrawRange>& drawRanges) const;
 
 private:
-	int m_MeshIndex;
-	std::string m_Filepath;
+	std::shared_ptr<const MeshPrototype> m_Prototype;
 
-	const aiScene* m_AssimpModel;
-	const rapidobj::Result* m_ObjModel;
-	const fastgltf::Asset* m_GltfModel;
-	const UfbxScene* m_FbxModel;
+	DX::BoundingBox m_WorldBounds;
+	DX::BoundingSphere m_WorldBoundingSphere;
 
-	std::vector<ModelVertexFull> m_VerticesFull;
-	std::vector<ModelVertexSemi> m_VerticesSemi;
-	std::vector<uint32_t> m_Indices;
-	std::unique_ptr<Material> m_Material;
-};
+	// LOD 0 is used while the mesh covers at least this fraction of the screen's height,
+	// every time the mesh halves in size after that we move down a LOD
+	inline static constexpr float s_LodScreenSize = 0.5f;
 
+	inline static MeshletCullingStats s_CullingStats;
+	// Reused by every Submit so that culling doesn't allocate, the queue copies the ranges it's given
+	inline static std::vector<DrawRange> s_DrawRanges;
+};
@@ -0,0 +1,318 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include <numeric>
+
+namespace
+{
+	// For every vertex, the triangles that use it. Stored as one flat list with offsets into it.
+	struct VertexAdjacency
+	{
+		std::vector<uint32_t> Offsets;
+		std::vector<uint32_t> Triangles;
+
+		VertexAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount)
+			: Offsets(vertexCount + 1, 0), Triangles(indices.size())
+		{
+			for (uint32_t index : indices)
+			{
+				Offsets[index + 1]++;
+			}
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				Offsets[v + 1] += Offsets[v];
+			}
+
+			std::vector<uint32_t> fill(Offsets.begin(), Offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				Triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		uint32_t GetCount(uint32_t vertex) const { return Offsets[vertex + 1] - Offsets[vertex]; }
+	};
+}
+
+void MeshOptimizer::Optimize(MeshData& mesh)
+{
+	if (mesh.Indices.size() < 3 || mesh.Vertices.empty())
+	{
+		return;
+	}
+
+	// Overdraw works on the clusters that the vertex cache ordering produced and vertex fetch works on
+	// the final index order, so the order these run in matters.
+	OptimizeVertexCache(mesh);
+	OptimizeOverdraw(mesh);
+	OptimizeVertexFetch(mesh);
+}
+
+void MeshOptimizer::OptimizeVertexCache(MeshData& mesh)
+{
+	OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+
+	const VertexAdjacency adjacency(indices, vertexCount);
+
+	// Number of triangles that haven't been emitted yet for each vertex
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++)
+	{
+		liveTriangles[v] = adjacency.GetCount(v);
+	}
+
+	std::vector<uint32_t> cacheTime(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> deadEndStack;
+	std::vector<uint32_t> candidates;
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	uint32_t timestamp = s_CacheSize + 1;
+	uint32_t cursor = 0;
+	int64_t fanningVertex = 0;
+
+	while (fanningVertex >= 0)
+	{
+		const uint32_t fan = static_cast<uint32_t>(fanningVertex);
+		candidates.clear();
+
+		// Emit every remaining triangle around the fanning vertex
+		for (uint32_t i = adjacency.Offsets[fan]; i < adjacency.Offsets[fan + 1]; i++)
+		{
+			const uint32_t triangle = adjacency.Triangles[i];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (int c = 0; c < 3; c++)
+			{
+				const uint32_t vertex = indices[triangle * 3 + c];
+				result.push_back(vertex);
+				deadEndStack.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+
+				if (timestamp - cacheTime[vertex] > s_CacheSize)
+				{
+					cacheTime[vertex] = timestamp++;
+				}
+			}
+			emitted[triangle] = true;
+		}
+
+		// Prefer the candidate that has been in the cache the longest, as long as fanning around it
+		// won't push it out of the cache before we are done with it
+		fanningVertex = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t vertex : candidates)
+		{
+			if (liveTriangles[vertex] == 0)
+			{
+				continue;
+			}
+
+			int64_t priority = 0;
+			if (timestamp - cacheTime[vertex] + 2 * liveTriangles[vertex] <= s_CacheSize)
+			{
+				priority = timestamp - cacheTime[vertex];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanningVertex = vertex;
+			}
+		}
+
+		if (fanningVertex >= 0)
+		{
+			continue;
+		}
+
+		// Dead end, go back to the most recently used vertex that still has triangles left
+		while (!deadEndStack.empty())
+		{
+			const uint32_t vertex = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (liveTriangles[vertex] > 0)
+			{
+				fanningVertex = vertex;
+				break;
+			}
+		}
+
+		// Otherwise start over from the next vertex in input order that has triangles left
+		while (fanningVertex < 0 && cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0)
+			{
+				fanningVertex = cursor;
+			}
+			cursor++;
+		}
+	}
+
+	ASSERT(result.size() == triangleCount * 3);
+	indices = std::move(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(MeshData& mesh, float threshold)
+{
+	const std::vector<uint32_t>& indices = mesh.Indices;
+	const size_t triangleCount = indices.size() / 3;
+
+	// Split into clusters at every triangle that misses the cache with all three of its vertices,
+	// moving clusters around then only costs the misses that were already there.
+	std::vector<uint32_t> clusters;
+	{
+		std::vector<uint32_t> cacheTime(mesh.Vertices.size(), 0);
+		uint32_t timestamp = s_CacheSize + 1;
+
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			int misses = 0;
+			for (int c = 0; c < 3; c++)
+			{
+				const uint32_t vertex = indices[t * 3 + c];
+				if (timestamp - cacheTime[vertex] > s_CacheSize)
+				{
+					cacheTime[vertex] = timestamp++;
+					misses++;
+				}
+			}
+
+			if (t == 0 || misses == 3)
+			{
+				clusters.push_back(t);
+			}
+		}
+	}
+
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	DX::XMVECTOR meshCentroid = DX::XMVectorZero();
+	for (const auto& vertex : mesh.Vertices)
+	{
+		meshCentroid = DX::XMVectorAdd(meshCentroid, DX::XMLoadFloat3(&vertex.Position));
+	}
+	meshCentroid = DX::XMVectorScale(meshCentroid, 1.f / mesh.Vertices.size());
+
+	// Clusters that face away from the center of the mesh are likely to occlude the rest of it
+	std::vector<float> sortKeys(clusters.size());
+	for (size_t i = 0; i < clusters.size(); i++)
+	{
+		const uint32_t begin = clusters[i];
+		const uint32_t end = i + 1 < clusters.size() ? clusters[i + 1] : static_cast<uint32_t>(triangleCount);
+
+		DX::XMVECTOR centroid = DX::XMVectorZero();
+		DX::XMVECTOR normal = DX::XMVectorZero();
+		float area = 0.f;
+		for (uint32_t t = begin; t < end; t++)
+		{
+			const DX::XMVECTOR p0 = DX::XMLoadFloat3(&mesh.Vertices[indices[t * 3]].Position);
+			const DX::XMVECTOR p1 = DX::XMLoadFloat3(&mesh.Vertices[indices[t * 3 + 1]].Position);
+			const DX::XMVECTOR p2 = DX::XMLoadFloat3(&mesh.Vertices[indices[t * 3 + 2]].Position);
+
+			// The length of the cross product is twice the triangle's area, so this is area weighted
+			const DX::XMVECTOR faceNormal = DX::XMVector3Cross(DX::XMVectorSubtract(p1, p0), DX::XMVectorSubtract(p2, p0));
+			const float faceArea = DX::XMVectorGetX(DX::XMVector3Length(faceNormal));
+
+			centroid = DX::XMVectorAdd(centroid, DX::XMVectorScale(DX::XMVectorAdd(DX::XMVectorAdd(p0, p1), p2), faceArea / 3.f));
+			normal = DX::XMVectorAdd(normal, faceNormal);
+			area += faceArea;
+		}
+
+		if (area > 0.f)
+		{
+			centroid = DX::XMVectorScale(centroid, 1.f / area);
+		}
+		sortKeys[i] = DX::XMVectorGetX(DX::XMVector3Dot(DX::XMVectorSubtract(centroid, meshCentroid), DX::XMVector3Normalize(normal)));
+	}
+
+	std::vector<uint32_t> order(clusters.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t cluster : order)
+	{
+		const uint32_t begin = clusters[cluster];
+		const uint32_t end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : static_cast<uint32_t>(triangleCount);
+		result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+	}
+
+	const float currentACMR = AnalyzeVertexCache(indices, mesh.Vertices.size()).ACMR;
+	if (AnalyzeVertexCache(result, mesh.Vertices.size()).ACMR > currentACMR * threshold)
+	{
+		return;
+	}
+
+	mesh.Indices = std::move(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh)
+{
+	constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(mesh.Vertices.size(), unused);
+
+	std::vector<ModelVertexFull> vertices;
+	vertices.reserve(mesh.Vertices.size());
+
+	for (auto& index : mesh.Indices)
+	{
+		if (remap[index] == unused)
+		{
+			remap[index] = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(mesh.Vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.shrink_to_fit();
+	mesh.Vertices = std::move(vertices);
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats;
+	if (indices.size() < 3 || vertexCount == 0)
+	{
+		return stats;
+	}
+
+	// A vertex is in the FIFO if fewer than cacheSize misses have happened since it was last inserted
+	std::vector<uint32_t> cacheTime(vertexCount, 0);
+	std::vector<bool> referenced(vertexCount, false);
+	uint32_t timestamp = cacheSize + 1;
+	size_t transformed = 0;
+	size_t uniqueVertices = 0;
+
+	for (uint32_t index : indices)
+	{
+		if (timestamp - cacheTime[index] > cacheSize)
+		{
+			cacheTime[index] = timestamp++;
+			transformed++;
+		}
+
+		if (!referenced[index])
+		{
+			referenced[index] = true;
+			uniqueVertices++;
+		}
+	}
+
+	stats.ACMR = static_cast<float>(transformed) / (indices.size() / 3);
+	stats.ATVR = static_cast<float>(transformed) / uniqueVertices;
+	return stats;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "ModelData.h"
+
+// How well an index buffer makes use of the GPU's post transform vertex cache, simulated as a FIFO.
+//   ACMR: vertices transformed per triangle, 0.5 is the best possible for a regular grid and 3 the worst
+//   ATVR: vertices transformed per unique vertex, 1 is optimal
+struct VertexCacheStats
+{
+	float ACMR = 0.f;
+	float ATVR = 0.f;
+};
+
+// Import time optimizations of a mesh's index and vertex order. They don't change what is drawn,
+// only the order it is drawn in, so that the GPU transforms, shades and fetches as little as possible.
+class MeshOptimizer
+{
+public:
+	// Runs all of the optimizations below in the order they need to be applied
+	static void Optimize(MeshData& mesh);
+
+	// Reorders the triangles for the post transform vertex cache using Tipsify (Sander et al. 2007)
+	static void OptimizeVertexCache(MeshData& mesh);
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+	// Reorders clusters of triangles so that ones facing outwards are drawn first, which lets the depth test
+	// reject more of what's behind them. Clusters are kept intact so the vertex cache ordering survives,
+	// unless the ACMR would end up worse than threshold * the current ACMR, in which case nothing changes.
+	static void OptimizeOverdraw(MeshData& mesh, float threshold = 1.05f);
+
+	// Reorders the vertices in the order they are first referenced by the indices, so that vertex fetches
+	// walk through memory linearly. Vertices that are never referenced are dropped.
+	static void OptimizeVertexFetch(MeshData& mesh);
+
+	static VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = s_CacheSize);
+
+private:
+	// Lower than what current hardware has, but what the cache ends up behaving like is hard to know
+	// and an order that is good for a small cache is also good for a bigger one.
+	inline static constexpr uint32_t s_CacheSize = 16;
+};
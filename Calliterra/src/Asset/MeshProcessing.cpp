@@ -0,0 +1,261 @@
+#include "pch.h"
+#include "MeshProcessing.h"
+#include "VertexKernels.h"
+
+namespace
+{
+	// Hashes/compares the raw bytes of a vertex, ModelVertexFull is tightly packed floats
+	// so there is no padding to worry about.
+	struct VertexBytesHash
+	{
+		size_t operator()(const ModelVertexFull& vertex) const
+		{
+			static_assert(sizeof(ModelVertexFull) == sizeof(float) * 14);
+
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&vertex);
+			size_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < sizeof(ModelVertexFull); i++)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+
+	struct VertexBytesEqual
+	{
+		bool operator()(const ModelVertexFull& a, const ModelVertexFull& b) const
+		{
+			return memcmp(&a, &b, sizeof(ModelVertexFull)) == 0;
+		}
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const DX::XMFLOAT3& p) const
+		{
+			const std::hash<float> hasher;
+			return hasher(p.x) ^ (hasher(p.y) << 1) ^ (hasher(p.z) << 2);
+		}
+	};
+
+	struct PositionEqual
+	{
+		bool operator()(const DX::XMFLOAT3& a, const DX::XMFLOAT3& b) const
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+	};
+}
+
+void MeshProcessing::ConvertToLeftHanded(MeshData& mesh)
+{
+	VertexKernels::FlipHandedness(mesh.Vertices.data(), mesh.Vertices.size());
+
+	for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+	{
+		std::swap(mesh.Indices[i + 1], mesh.Indices[i + 2]);
+	}
+}
+
+void MeshProcessing::ConvertToLeftHanded(NodeData& node)
+{
+	// Mirroring a transform is M' = S * M * S where S = Scale(1, 1, -1)
+	const DX::XMMATRIX mirror = DX::XMMatrixScaling(1.f, 1.f, -1.f);
+	DX::XMStoreFloat4x4(&node.RelativeTransform, mirror * DX::XMLoadFloat4x4(&node.RelativeTransform) * mirror);
+}
+
+void MeshProcessing::GenerateNormals(MeshData& mesh)
+{
+	std::unordered_map<DX::XMFLOAT3, DX::XMFLOAT3, PositionHash, PositionEqual> positionNormals;
+	positionNormals.reserve(mesh.Vertices.size());
+
+	for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+	{
+		const DX::XMFLOAT3& p0 = mesh.Vertices[mesh.Indices[i]].Position;
+		const DX::XMFLOAT3& p1 = mesh.Vertices[mesh.Indices[i + 1]].Position;
+		const DX::XMFLOAT3& p2 = mesh.Vertices[mesh.Indices[i + 2]].Position;
+
+		const DX::XMVECTOR v0 = DX::XMLoadFloat3(&p0);
+		// Not normalized, so larger faces contribute more
+		const DX::XMVECTOR faceNormal = DX::XMVector3Cross(
+			DX::XMVectorSubtract(DX::XMLoadFloat3(&p1), v0),
+			DX::XMVectorSubtract(DX::XMLoadFloat3(&p2), v0)
+		);
+
+		for (const auto* p : { &p0, &p1, &p2 })
+		{
+			auto& normal = positionNormals.try_emplace(*p, DX::XMFLOAT3(0.f, 0.f, 0.f)).first->second;
+			DX::XMStoreFloat3(&normal, DX::XMVectorAdd(DX::XMLoadFloat3(&normal), faceNormal));
+		}
+	}
+
+	for (auto& vertex : mesh.Vertices)
+	{
+		const auto it = positionNormals.find(vertex.Position);
+		if (it != positionNormals.end())
+		{
+			DX::XMStoreFloat3(&vertex.Normal, DX::XMVector3Normalize(DX::XMLoadFloat3(&it->second)));
+		}
+	}
+}
+
+void MeshProcessing::WeldVertices(MeshData& mesh)
+{
+	std::unordered_map<ModelVertexFull, uint32_t, VertexBytesHash, VertexBytesEqual> uniqueVertices;
+	uniqueVertices.reserve(mesh.Vertices.size());
+
+	std::vector<ModelVertexFull> vertices;
+	vertices.reserve(mesh.Vertices.size());
+
+	std::vector<uint32_t> remap(mesh.Vertices.size());
+	for (size_t i = 0; i < mesh.Vertices.size(); i++)
+	{
+		const auto [it, inserted] = uniqueVertices.try_emplace(mesh.Vertices[i], static_cast<uint32_t>(vertices.size()));
+		if (inserted)
+		{
+			vertices.push_back(mesh.Vertices[i]);
+		}
+		remap[i] = it->second;
+	}
+
+	for (auto& index : mesh.Indices)
+	{
+		index = remap[index];
+	}
+
+	vertices.shrink_to_fit();
+	mesh.Vertices = std::move(vertices);
+}
+
+void MeshProcessing::GenerateTangents(MeshData& mesh)
+{
+	std::vector<DX::XMFLOAT3> tangents(mesh.Vertices.size(), { 0.f, 0.f, 0.f });
+	std::vector<DX::XMFLOAT3> bitangents(mesh.Vertices.size(), { 0.f, 0.f, 0.f });
+
+	for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3)
+	{
+		const uint32_t corners[3] = { mesh.Indices[i], mesh.Indices[i + 1], mesh.Indices[i + 2] };
+		const ModelVertexFull& v0 = mesh.Vertices[corners[0]];
+		const ModelVertexFull& v1 = mesh.Vertices[corners[1]];
+		const ModelVertexFull& v2 = mesh.Vertices[corners[2]];
+
+		const DX::XMVECTOR p0 = DX::XMLoadFloat3(&v0.Position);
+		const DX::XMVECTOR p1 = DX::XMLoadFloat3(&v1.Position);
+		const DX::XMVECTOR p2 = DX::XMLoadFloat3(&v2.Position);
+		const DX::XMVECTOR e1 = DX::XMVectorSubtract(p1, p0);
+		const DX::XMVECTOR e2 = DX::XMVectorSubtract(p2, p0);
+
+		const float du1 = v1.Texture.x - v0.Texture.x;
+		const float dv1 = v1.Texture.y - v0.Texture.y;
+		const float du2 = v2.Texture.x - v0.Texture.x;
+		const float dv2 = v2.Texture.y - v0.Texture.y;
+
+		const float det = du1 * dv2 - du2 * dv1;
+		if (std::abs(det) < 1e-12f)
+		{
+			// Degenerate UVs, leave it to the other faces to decide the tangent
+			continue;
+		}
+		const float r = 1.f / det;
+
+		const DX::XMVECTOR faceTangent = DX::XMVector3Normalize(
+			DX::XMVectorScale(DX::XMVectorSubtract(DX::XMVectorScale(e1, dv2), DX::XMVectorScale(e2, dv1)), r)
+		);
+		const DX::XMVECTOR faceBitangent = DX::XMVector3Normalize(
+			DX::XMVectorScale(DX::XMVectorSubtract(DX::XMVectorScale(e2, du1), DX::XMVectorScale(e1, du2)), r)
+		);
+
+		// Weight by the angle at each corner so that how the face is split into triangles doesn't matter
+		const DX::XMVECTOR positions[3] = { p0, p1, p2 };
+		for (int c = 0; c < 3; c++)
+		{
+			const DX::XMVECTOR a = DX::XMVectorSubtract(positions[(c + 1) % 3], positions[c]);
+			const DX::XMVECTOR b = DX::XMVectorSubtract(positions[(c + 2) % 3], positions[c]);
+			const float angle = DX::XMVectorGetX(DX::XMVector3AngleBetweenVectors(a, b));
+
+			DX::XMFLOAT3& tangent = tangents[corners[c]];
+			DX::XMFLOAT3& bitangent = bitangents[corners[c]];
+			DX::XMStoreFloat3(&tangent, DX::XMVectorMultiplyAdd(faceTangent, DX::XMVectorReplicate(angle), DX::XMLoadFloat3(&tangent)));
+			DX::XMStoreFloat3(&bitangent, DX::XMVectorMultiplyAdd(faceBitangent, DX::XMVectorReplicate(angle), DX::XMLoadFloat3(&bitangent)));
+		}
+	}
+
+	for (size_t i = 0; i < mesh.Vertices.size(); i++)
+	{
+		ModelVertexFull& vertex = mesh.Vertices[i];
+		const DX::XMVECTOR normal = DX::XMLoadFloat3(&vertex.Normal);
+
+		// Gram-Schmidt orthogonalize the tangent against the normal
+		DX::XMVECTOR tangent = DX::XMLoadFloat3(&tangents[i]);
+		tangent = DX::XMVectorSubtract(tangent, DX::XMVectorScale(normal, DX::XMVectorGetX(DX::XMVector3Dot(normal, tangent))));
+		if (DX::XMVectorGetX(DX::XMVector3LengthSq(tangent)) < 1e-12f)
+		{
+			// No usable UVs, any vector perpendicular to the normal will do
+			const DX::XMVECTOR axis = std::abs(vertex.Normal.x) < 0.9f ? DX::XMVectorSet(1.f, 0.f, 0.f, 0.f) : DX::XMVectorSet(0.f, 1.f, 0.f, 0.f);
+			tangent = DX::XMVector3Cross(normal, axis);
+		}
+		tangent = DX::XMVector3Normalize(tangent);
+
+		// The bitangent is rebuilt from the normal and tangent, only its handedness is taken from the UVs
+		DX::XMVECTOR bitangent = DX::XMVector3Cross(normal, tangent);
+		if (DX::XMVectorGetX(DX::XMVector3Dot(bitangent, DX::XMLoadFloat3(&bitangents[i]))) < 0.f)
+		{
+			bitangent = DX::XMVectorNegate(bitangent);
+		}
+
+		DX::XMStoreFloat3(&vertex.Tangent, tangent);
+		DX::XMStoreFloat3(&vertex.Bitangent, bitangent);
+	}
+}
+
+void MeshProcessing::ComputeBounds(MeshData& mesh)
+{
+	if (mesh.Vertices.empty())
+	{
+		mesh.Bounds = DX::BoundingBox({ 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f });
+		mesh.BoundingSphere = DX::BoundingSphere({ 0.f, 0.f, 0.f }, 0.f);
+		return;
+	}
+
+	// Two sets of accumulators so consecutive min/max don't have to wait on each other
+	DX::XMVECTOR min0 = DX::XMLoadFloat3(&mesh.Vertices[0].Position);
+	DX::XMVECTOR max0 = min0;
+	DX::XMVECTOR min1 = min0;
+	DX::XMVECTOR max1 = min0;
+
+	const size_t count = mesh.Vertices.size();
+	size_t i = 0;
+	for (; i + 1 < count; i += 2)
+	{
+		const DX::XMVECTOR p0 = DX::XMLoadFloat3(&mesh.Vertices[i].Position);
+		const DX::XMVECTOR p1 = DX::XMLoadFloat3(&mesh.Vertices[i + 1].Position);
+		min0 = DX::XMVectorMin(min0, p0);
+		max0 = DX::XMVectorMax(max0, p0);
+		min1 = DX::XMVectorMin(min1, p1);
+		max1 = DX::XMVectorMax(max1, p1);
+	}
+	if (i < count)
+	{
+		const DX::XMVECTOR p = DX::XMLoadFloat3(&mesh.Vertices[i].Position);
+		min0 = DX::XMVectorMin(min0, p);
+		max0 = DX::XMVectorMax(max0, p);
+	}
+
+	const DX::XMVECTOR boundsMin = DX::XMVectorMin(min0, min1);
+	const DX::XMVECTOR boundsMax = DX::XMVectorMax(max0, max1);
+	const DX::XMVECTOR center = DX::XMVectorScale(DX::XMVectorAdd(boundsMin, boundsMax), 0.5f);
+
+	DX::XMStoreFloat3(&mesh.Bounds.Center, center);
+	DX::XMStoreFloat3(&mesh.Bounds.Extents, DX::XMVectorScale(DX::XMVectorSubtract(boundsMax, boundsMin), 0.5f));
+
+	// Centering the sphere on the box isn't optimal, but it's usually close and only takes one more pass
+	DX::XMVECTOR maxDistanceSq = DX::XMVectorZero();
+	for (const auto& vertex : mesh.Vertices)
+	{
+		maxDistanceSq = DX::XMVectorMax(maxDistanceSq, DX::XMVector3LengthSq(DX::XMVectorSubtract(DX::XMLoadFloat3(&vertex.Position), center)));
+	}
+
+	DX::XMStoreFloat3(&mesh.BoundingSphere.Center, center);
+	mesh.BoundingSphere.Radius = DX::XMVectorGetX(DX::XMVectorSqrt(maxDistanceSq));
+}
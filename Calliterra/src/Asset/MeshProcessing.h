@@ -0,0 +1,26 @@
+#pragma once
+#include "ModelData.h"
+
+// Post processing that our own importers run on the raw mesh data they extract, so that
+// they end up with the same output that Assimp produces with ModelImporter::s_AssimpFlags.
+class MeshProcessing
+{
+public:
+	// Mirrors along the z axis, flips the winding order and flips the v coordinate of the UVs.
+	// This is the same conversion that aiProcess_ConvertToLeftHanded does.
+	static void ConvertToLeftHanded(MeshData& mesh);
+	static void ConvertToLeftHanded(NodeData& node);
+
+	// Smooth normals, faces sharing a position contribute to its normal weighted by their area
+	static void GenerateNormals(MeshData& mesh);
+
+	// Merges vertices that are bitwise identical and remaps the indices to match
+	static void WeldVertices(MeshData& mesh);
+
+	// Per vertex tangents and bitangents in the style of MikkTSpace, face tangents are weighted by
+	// the angle of the corner they contribute to and then orthogonalized against the normal.
+	static void GenerateTangents(MeshData& mesh);
+
+	// Axis aligned bounding box and a bounding sphere centered on it
+	static void ComputeBounds(MeshData& mesh);
+};
@@ -0,0 +1,299 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+#include <numeric>
+
+namespace
+{
+	// Symmetric 4x4 matrix of the plane equations that meet at a vertex, only the upper triangle is stored.
+	// Evaluating it at a point gives the sum of squared distances to those planes.
+	struct Quadric
+	{
+		double A2 = 0, AB = 0, AC = 0, AD = 0;
+		double B2 = 0, BC = 0, BD = 0;
+		double C2 = 0, CD = 0;
+		double D2 = 0;
+		double Weight = 0;
+
+		Quadric() = default;
+
+		Quadric(double a, double b, double c, double d, double weight)
+			: A2(a * a * weight), AB(a * b * weight), AC(a * c * weight), AD(a * d * weight),
+			  B2(b * b * weight), BC(b * c * weight), BD(b * d * weight),
+			  C2(c * c * weight), CD(c * d * weight),
+			  D2(d * d * weight),
+			  Weight(weight)
+		{
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			A2 += other.A2; AB += other.AB; AC += other.AC; AD += other.AD;
+			B2 += other.B2; BC += other.BC; BD += other.BD;
+			C2 += other.C2; CD += other.CD;
+			D2 += other.D2;
+			Weight += other.Weight;
+			return *this;
+		}
+
+		Quadric operator+(const Quadric& other) const
+		{
+			Quadric result = *this;
+			result += other;
+			return result;
+		}
+
+		// Average squared distance, so the result doesn't depend on how much area went into the quadric
+		double Evaluate(const DX::XMFLOAT3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double error =
+				A2 * x * x + 2 * AB * x * y + 2 * AC * x * z + 2 * AD * x +
+				B2 * y * y + 2 * BC * y * z + 2 * BD * y +
+				C2 * z * z + 2 * CD * z +
+				D2;
+
+			return Weight > 0 ? std::abs(error) / Weight : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t Source;
+		uint32_t Target;
+		double Error;
+	};
+
+	DX::XMVECTOR TriangleNormal(const DX::XMFLOAT3& p0, const DX::XMFLOAT3& p1, const DX::XMFLOAT3& p2)
+	{
+		const DX::XMVECTOR v0 = DX::XMLoadFloat3(&p0);
+		return DX::XMVector3Cross(DX::XMVectorSubtract(DX::XMLoadFloat3(&p1), v0), DX::XMVectorSubtract(DX::XMLoadFloat3(&p2), v0));
+	}
+
+	uint64_t EdgeKey(uint32_t a, uint32_t b)
+	{
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<ModelVertexFull>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float targetError)
+{
+	std::vector<uint32_t> result = indices;
+	if (result.size() <= targetIndexCount || vertices.empty())
+	{
+		return result;
+	}
+
+	const size_t vertexCount = vertices.size();
+
+	DX::XMVECTOR boundsMin = DX::XMVectorReplicate(std::numeric_limits<float>::max());
+	DX::XMVECTOR boundsMax = DX::XMVectorReplicate(-std::numeric_limits<float>::max());
+	for (const auto& vertex : vertices)
+	{
+		boundsMin = DX::XMVectorMin(boundsMin, DX::XMLoadFloat3(&vertex.Position));
+		boundsMax = DX::XMVectorMax(boundsMax, DX::XMLoadFloat3(&vertex.Position));
+	}
+	DX::XMFLOAT3 extent;
+	DX::XMStoreFloat3(&extent, DX::XMVectorSubtract(boundsMax, boundsMin));
+	const double maxError = std::pow(static_cast<double>(targetError) * std::max({ extent.x, extent.y, extent.z }), 2.0);
+
+	// Vertices on an open border, or on an attribute seam (which looks like a border since the vertices on
+	// either side are different), can't move without tearing the mesh open so they are locked in place.
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		edgeUses.reserve(result.size());
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				edgeUses[EdgeKey(result[i + e], result[i + (e + 1) % 3])]++;
+			}
+		}
+		for (const auto& [edge, uses] : edgeUses)
+		{
+			if (uses == 1)
+			{
+				locked[static_cast<uint32_t>(edge >> 32)] = true;
+				locked[static_cast<uint32_t>(edge & 0xFFFFFFFF)] = true;
+			}
+		}
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i + 2 < result.size(); i += 3)
+	{
+		const DX::XMVECTOR normal = TriangleNormal(vertices[result[i]].Position, vertices[result[i + 1]].Position, vertices[result[i + 2]].Position);
+		const float area = DX::XMVectorGetX(DX::XMVector3Length(normal)) * 0.5f;
+		if (area <= 0.f)
+		{
+			continue;
+		}
+
+		DX::XMFLOAT3 n;
+		DX::XMStoreFloat3(&n, DX::XMVector3Normalize(normal));
+		const DX::XMFLOAT3& p = vertices[result[i]].Position;
+		const Quadric plane(n.x, n.y, n.z, -(n.x * p.x + n.y * p.y + n.z * p.z), area);
+
+		quadrics[result[i]] += plane;
+		quadrics[result[i + 1]] += plane;
+		quadrics[result[i + 2]] += plane;
+	}
+
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+	std::vector<uint32_t> vertexTriangles;
+
+	// Each pass collapses the cheapest edges that don't overlap each other
+	while (result.size() > targetIndexCount)
+	{
+		const size_t triangleCount = result.size() / 3;
+
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (uint32_t index : result)
+		{
+			triangleOffsets[index + 1]++;
+		}
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			triangleOffsets[v + 1] += triangleOffsets[v];
+		}
+		vertexTriangles.resize(result.size());
+		{
+			std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++)
+			{
+				vertexTriangles[fill[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				const uint32_t a = result[i + e];
+				const uint32_t b = result[i + (e + 1) % 3];
+
+				// Every edge that isn't locked shows up twice, only look at it from one side
+				if (a > b || (locked[a] && locked[b]))
+				{
+					continue;
+				}
+
+				const Quadric merged = quadrics[a] + quadrics[b];
+				const double errorAB = locked[a] ? std::numeric_limits<double>::max() : merged.Evaluate(vertices[b].Position);
+				const double errorBA = locked[b] ? std::numeric_limits<double>::max() : merged.Evaluate(vertices[a].Position);
+
+				collapses.push_back(errorAB <= errorBA ? Collapse{ a, b, errorAB } : Collapse{ b, a, errorBA });
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+		// A collapse removes about two triangles
+		const size_t collapseLimit = std::max<size_t>(1, (triangleCount - targetIndexCount / 3) / 2);
+		size_t collapsed = 0;
+
+		std::iota(remap.begin(), remap.end(), 0);
+		std::fill(touched.begin(), touched.end(), false);
+
+		for (const auto& collapse : collapses)
+		{
+			if (collapse.Error > maxError || collapsed >= collapseLimit)
+			{
+				break;
+			}
+			if (touched[collapse.Source] || touched[collapse.Target])
+			{
+				continue;
+			}
+
+			// Reject the collapse if it would flip any of the triangles that move
+			bool flips = false;
+			for (uint32_t t = triangleOffsets[collapse.Source]; t < triangleOffsets[collapse.Source + 1] && !flips; t++)
+			{
+				const uint32_t* triangle = &result[vertexTriangles[t] * 3];
+				if (triangle[0] == collapse.Target || triangle[1] == collapse.Target || triangle[2] == collapse.Target)
+				{
+					continue;
+				}
+
+				DX::XMFLOAT3 moved[3];
+				for (int c = 0; c < 3; c++)
+				{
+					moved[c] = vertices[triangle[c] == collapse.Source ? collapse.Target : triangle[c]].Position;
+				}
+
+				const DX::XMVECTOR before = TriangleNormal(vertices[triangle[0]].Position, vertices[triangle[1]].Position, vertices[triangle[2]].Position);
+				const DX::XMVECTOR after = TriangleNormal(moved[0], moved[1], moved[2]);
+				flips = DX::XMVectorGetX(DX::XMVector3Dot(before, after)) <= 0.f;
+			}
+			if (flips)
+			{
+				continue;
+			}
+
+			// Everything around the source is off limits for the rest of this pass, the flip check above
+			// assumed that none of it moves
+			for (uint32_t t = triangleOffsets[collapse.Source]; t < triangleOffsets[collapse.Source + 1]; t++)
+			{
+				const uint32_t* triangle = &result[vertexTriangles[t] * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+			}
+
+			remap[collapse.Source] = collapse.Target;
+			quadrics[collapse.Target] += quadrics[collapse.Source];
+			collapsed++;
+		}
+
+		if (collapsed == 0)
+		{
+			break;
+		}
+
+		size_t write = 0;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const uint32_t a = remap[result[i]];
+			const uint32_t b = remap[result[i + 1]];
+			const uint32_t c = remap[result[i + 2]];
+			if (a == b || b == c || c == a)
+			{
+				continue;
+			}
+
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+	}
+
+	return result;
+}
+
+void MeshSimplifier::GenerateLods(MeshData& mesh, const LodOptions& options)
+{
+	ASSERT(options.MaxLods <= s_MaxLods, "The LOD chain is longer than s_MaxLods");
+	ASSERT(options.Reduction > 0.f && options.Reduction < 1.f, "LOD levels have to reduce the triangle count");
+	mesh.LodIndices.clear();
+
+	// Every level is simplified from the full detail mesh, so errors don't build up along the chain
+	for (uint32_t lod = 1; lod < std::min(options.MaxLods, s_MaxLods); lod++)
+	{
+		const size_t previousCount = lod == 1 ? mesh.Indices.size() : mesh.LodIndices.back().size();
+		const size_t targetCount = static_cast<size_t>(mesh.Indices.size() * std::pow(options.Reduction, static_cast<float>(lod))) / 3 * 3;
+
+		std::vector<uint32_t> indices = Simplify(mesh.Vertices, mesh.Indices, targetCount, options.TargetError * lod);
+
+		// Not worth a level of its own if it barely has fewer triangles than the previous one
+		if (indices.empty() || indices.size() > previousCount * 3 / 4)
+		{
+			break;
+		}
+
+		mesh.LodIndices.push_back(std::move(indices));
+	}
+}
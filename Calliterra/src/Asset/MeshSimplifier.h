@@ -0,0 +1,33 @@
+#pragma once
+#include "ModelData.h"
+
+// How MeshSimplifier::GenerateLods builds a mesh's LOD chain
+struct LodOptions
+{
+	// Including the full detail mesh, at most MeshSimplifier::s_MaxLods
+	uint32_t MaxLods = 4;
+	// The share of the full detail mesh's triangles each level aims for is Reduction to the power of the level
+	float Reduction = 0.5f;
+	// Allowed error of the first level (see MeshSimplifier::Simplify), every level after that allows as much again
+	float TargetError = 0.02f;
+
+	bool operator==(const LodOptions&) const = default;
+};
+
+// Mesh simplification using quadric error metrics (Garland and Heckbert 1997). Edges are collapsed onto
+// one of their existing vertices, so the simplified index lists can share the vertex buffer of the mesh.
+class MeshSimplifier
+{
+public:
+	// Returns indices with at most targetIndexCount indices, or as close to it as possible without
+	// exceeding targetError. The error is relative to the size of the mesh, 0.01 is 1% of its extent.
+	static std::vector<uint32_t> Simplify(const std::vector<ModelVertexFull>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float targetError);
+
+	// Builds the mesh's LOD chain, with the default options every level has roughly half of the triangles of
+	// the previous one. The chain stops early when a level can't be simplified enough to be worth it.
+	static void GenerateLods(MeshData& mesh, const LodOptions& options = {});
+
+public:
+	// The longest chain a mesh can have, whatever the options
+	inline static constexpr uint32_t s_MaxLods = 8;
+};
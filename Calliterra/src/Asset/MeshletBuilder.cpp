@@ -0,0 +1,291 @@
+#include "pch.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+
+namespace
+{
+	constexpr uint32_t s_NotInMeshlet = ~0u;
+
+	// Normal cones wider than this (the smallest dot product between the axis and a triangle's normal)
+	// would almost never be culled, so they aren't worth testing
+	constexpr float s_MinConeDot = 0.1f;
+}
+
+// Meshlets are grown greedily from the first triangle that hasn't been used yet, in the order the vertex
+// cache and overdraw optimizations left them in. Each step adds the connected triangle that brings in the
+// fewest new vertices, which keeps meshlets compact and so their bounds tight.
+void MeshletBuilder::Build(MeshData& mesh)
+{
+	mesh.Meshlets.clear();
+
+	const std::vector<uint32_t>& indices = mesh.Indices;
+	const size_t vertexCount = mesh.Vertices.size();
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0 || vertexCount == 0)
+	{
+		return;
+	}
+
+	// For every vertex, the triangles that use it
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+	std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+	for (uint32_t i = 0; i < triangleCount * 3; i++)
+	{
+		triangleOffsets[indices[i] + 1]++;
+	}
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		triangleOffsets[v + 1] += triangleOffsets[v];
+	}
+	{
+		std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			vertexTriangles[fill[indices[i]]++] = i / 3;
+		}
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+	// Position of each vertex in meshletVertices, while it is part of the meshlet being built
+	std::vector<uint32_t> meshletSlot(vertexCount, s_NotInMeshlet);
+	std::vector<uint32_t> meshletVertices;
+	std::vector<uint32_t> meshletTriangles;
+	std::vector<uint32_t> localIndices;
+	meshletVertices.reserve(s_MaxVertices);
+	meshletTriangles.reserve(s_MaxTriangles);
+	localIndices.reserve(s_MaxTriangles * 3);
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleCount * 3);
+
+	const auto countNewVertices = [&](uint32_t triangle)
+	{
+		uint32_t count = 0;
+		for (int c = 0; c < 3; c++)
+		{
+			count += meshletSlot[indices[triangle * 3 + c]] == s_NotInMeshlet;
+		}
+		return count;
+	};
+
+	// Running bounds of the meshlet being built
+	DX::XMVECTOR meshletMin = DX::XMVectorZero();
+	DX::XMVECTOR meshletMax = DX::XMVectorZero();
+
+	const auto addTriangle = [&](uint32_t triangle)
+	{
+		if (meshletTriangles.empty())
+		{
+			meshletMin = meshletMax = DX::XMLoadFloat3(&mesh.Vertices[indices[triangle * 3]].Position);
+		}
+
+		emitted[triangle] = true;
+		meshletTriangles.push_back(triangle);
+		for (int c = 0; c < 3; c++)
+		{
+			const uint32_t vertex = indices[triangle * 3 + c];
+			const DX::XMVECTOR position = DX::XMLoadFloat3(&mesh.Vertices[vertex].Position);
+			meshletMin = DX::XMVectorMin(meshletMin, position);
+			meshletMax = DX::XMVectorMax(meshletMax, position);
+
+			if (meshletSlot[vertex] == s_NotInMeshlet)
+			{
+				meshletSlot[vertex] = static_cast<uint32_t>(meshletVertices.size());
+				meshletVertices.push_back(vertex);
+			}
+		}
+	};
+
+	// The triangles are reordered for the vertex cache within the meshlet, using meshlet local vertex
+	// indices so that Tipsify only has to look at the meshlet's own vertices
+	const auto finishMeshlet = [&]()
+	{
+		localIndices.clear();
+		for (uint32_t triangle : meshletTriangles)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				localIndices.push_back(meshletSlot[indices[triangle * 3 + c]]);
+			}
+		}
+		MeshOptimizer::OptimizeVertexCache(localIndices, meshletVertices.size());
+
+		Meshlet meshlet;
+		meshlet.IndexOffset = static_cast<uint32_t>(result.size());
+		meshlet.IndexCount = static_cast<uint32_t>(localIndices.size());
+		mesh.Meshlets.push_back(meshlet);
+
+		for (uint32_t index : localIndices)
+		{
+			result.push_back(meshletVertices[index]);
+		}
+
+		for (uint32_t vertex : meshletVertices)
+		{
+			meshletSlot[vertex] = s_NotInMeshlet;
+		}
+		meshletVertices.clear();
+		meshletTriangles.clear();
+	};
+
+	// Whether a triangle lies within the meshlet's bounds grown by their own size on every side
+	const auto isNearby = [&](uint32_t triangle)
+	{
+		const DX::XMVECTOR center = DX::XMVectorScale(DX::XMVectorAdd(meshletMin, meshletMax), 0.5f);
+		const DX::XMVECTOR halfSize = DX::XMVectorScale(DX::XMVectorSubtract(meshletMax, meshletMin), 1.5f);
+		for (int c = 0; c < 3; c++)
+		{
+			const DX::XMVECTOR position = DX::XMLoadFloat3(&mesh.Vertices[indices[triangle * 3 + c]].Position);
+			if (!DX::XMVector3InBounds(DX::XMVectorSubtract(position, center), halfSize))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	uint32_t cursor = 0;
+	const auto nextUnusedTriangle = [&]()
+	{
+		while (cursor < triangleCount && emitted[cursor])
+		{
+			cursor++;
+		}
+		return cursor < triangleCount ? cursor : s_NotInMeshlet;
+	};
+
+	for (uint32_t seed = nextUnusedTriangle(); seed != s_NotInMeshlet; seed = nextUnusedTriangle())
+	{
+		addTriangle(seed);
+
+		while (meshletTriangles.size() < s_MaxTriangles)
+		{
+			// Ties go to the triangle that comes first, which keeps the order of the previous optimizations
+			uint32_t best = s_NotInMeshlet;
+			uint32_t bestCost = 4;
+			for (uint32_t vertex : meshletVertices)
+			{
+				for (uint32_t i = triangleOffsets[vertex]; i < triangleOffsets[vertex + 1]; i++)
+				{
+					const uint32_t triangle = vertexTriangles[i];
+					if (emitted[triangle])
+					{
+						continue;
+					}
+
+					const uint32_t cost = countNewVertices(triangle);
+					if (cost < bestCost || (cost == bestCost && triangle < best))
+					{
+						best = triangle;
+						bestCost = cost;
+					}
+				}
+			}
+
+			// Nothing connected is left, carry on with the next triangle in order if it is close by. Meshes that
+			// are made up of lots of small pieces would otherwise end up as lots of tiny meshlets.
+			if (best == s_NotInMeshlet)
+			{
+				best = nextUnusedTriangle();
+				if (best == s_NotInMeshlet || !isNearby(best))
+				{
+					break;
+				}
+				bestCost = countNewVertices(best);
+			}
+
+			if (meshletVertices.size() + bestCost > s_MaxVertices)
+			{
+				break;
+			}
+
+			addTriangle(best);
+		}
+
+		finishMeshlet();
+	}
+
+	ASSERT(result.size() == triangleCount * 3);
+	mesh.Indices = std::move(result);
+
+	for (auto& meshlet : mesh.Meshlets)
+	{
+		meshlet = ComputeBounds(mesh, meshlet.IndexOffset, meshlet.IndexCount);
+	}
+}
+
+// Bounding sphere and normal cone of a range of triangles, the cone is built the same way as meshoptimizer's
+// cluster bounds: the average face normal as the axis, and an apex far enough back along it that every
+// triangle's plane is in front of it
+Meshlet MeshletBuilder::ComputeBounds(const MeshData& mesh, uint32_t indexOffset, uint32_t indexCount)
+{
+	Meshlet meshlet;
+	meshlet.IndexOffset = indexOffset;
+	meshlet.IndexCount = indexCount;
+
+	std::vector<DX::XMFLOAT3> positions(indexCount);
+	for (uint32_t i = 0; i < indexCount; i++)
+	{
+		positions[i] = mesh.Vertices[mesh.Indices[indexOffset + i]].Position;
+	}
+	DX::BoundingSphere::CreateFromPoints(meshlet.Bounds, positions.size(), positions.data(), sizeof(DX::XMFLOAT3));
+
+	// Degenerate triangles can't be seen from any side, they are left out of the cone
+	std::vector<DX::XMVECTOR> normals;
+	std::vector<uint32_t> normalTriangles;
+	normals.reserve(indexCount / 3);
+	normalTriangles.reserve(indexCount / 3);
+	DX::XMVECTOR normalSum = DX::XMVectorZero();
+	for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		const DX::XMVECTOR p0 = DX::XMLoadFloat3(&positions[i]);
+		const DX::XMVECTOR normal = DX::XMVector3Cross(DX::XMVectorSubtract(DX::XMLoadFloat3(&positions[i + 1]), p0), DX::XMVectorSubtract(DX::XMLoadFloat3(&positions[i + 2]), p0));
+		if (DX::XMVectorGetX(DX::XMVector3LengthSq(normal)) <= 0.f)
+		{
+			continue;
+		}
+
+		normals.push_back(DX::XMVector3Normalize(normal));
+		normalTriangles.push_back(i);
+		normalSum = DX::XMVectorAdd(normalSum, normals.back());
+	}
+
+	if (normals.empty() || DX::XMVectorGetX(DX::XMVector3LengthSq(normalSum)) <= 1e-12f)
+	{
+		return meshlet;
+	}
+
+	const DX::XMVECTOR axis = DX::XMVector3Normalize(normalSum);
+
+	float minDot = 1.f;
+	for (const auto& normal : normals)
+	{
+		minDot = std::min(minDot, DX::XMVectorGetX(DX::XMVector3Dot(normal, axis)));
+	}
+
+	if (minDot <= s_MinConeDot)
+	{
+		return meshlet;
+	}
+
+	const DX::XMVECTOR center = DX::XMLoadFloat3(&meshlet.Bounds.Center);
+	float maxT = 0.f;
+	for (size_t t = 0; t < normals.size(); t++)
+	{
+		// Distance along the axis from the center to where it crosses the triangle's plane, minDot keeps
+		// the division well away from zero
+		const DX::XMVECTOR p0 = DX::XMLoadFloat3(&positions[normalTriangles[t]]);
+		const float dc = DX::XMVectorGetX(DX::XMVector3Dot(DX::XMVectorSubtract(center, p0), normals[t]));
+		const float dn = DX::XMVectorGetX(DX::XMVector3Dot(axis, normals[t]));
+		maxT = std::max(maxT, dc / dn);
+	}
+
+	DX::XMStoreFloat3(&meshlet.ConeApex, DX::XMVectorSubtract(center, DX::XMVectorScale(axis, maxT)));
+	DX::XMStoreFloat3(&meshlet.ConeAxis, axis);
+
+	// The cone of normals is minDot = cos(a) wide, the cone of view directions that see none of the
+	// triangles' front faces is 90 degrees narrower on each side, cos(90 - a) = sin(a)
+	meshlet.ConeCutoff = std::sqrt(1.f - minDot * minDot);
+
+	return meshlet;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "ModelData.h"
+
+// Splits a mesh into meshlets, small clusters of connected triangles that are each stored as a contiguous
+// range of the mesh's index buffer. Every meshlet gets a bounding sphere and a normal cone so that clusters
+// which are off screen or entirely back facing can be skipped on the CPU, see Mesh::CullMeshlets.
+class MeshletBuilder
+{
+public:
+	// Regroups mesh.Indices meshlet by meshlet and fills in mesh.Meshlets. The vertices are left alone,
+	// so MeshOptimizer::OptimizeVertexFetch should run afterwards to match the new index order.
+	static void Build(MeshData& mesh);
+
+public:
+	// The sizes that mesh shading hardware is built around, which also keeps the culling granularity sensible
+	inline static constexpr uint32_t s_MaxVertices = 64;
+	inline static constexpr uint32_t s_MaxTriangles = 124;
+
+private:
+	static Meshlet ComputeBounds(const MeshData& mesh, uint32_t indexOffset, uint32_t indexCount);
+};
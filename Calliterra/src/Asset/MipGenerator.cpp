@@ -0,0 +1,398 @@
+#include "pch.h"
+#include "MipGenerator.h"
+#include "Core/ThreadPool.h"
+#include <immintrin.h>
+
+namespace
+{
+	constexpr float s_KaiserRadius = 2.f; // In texels of the smaller level
+	constexpr float s_KaiserBeta = 4.f;
+	constexpr uint32_t s_RowsPerJob = 16;
+	constexpr uint32_t s_SrgbTableSize = 8192;
+
+	float SrgbToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSrgb(float value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+	}
+
+	struct SrgbTables
+	{
+		SrgbTables()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				ToLinear[i] = SrgbToLinear(i / 255.f);
+			}
+			for (uint32_t i = 0; i < s_SrgbTableSize; i++)
+			{
+				ToSrgb[i] = static_cast<uint8_t>(LinearToSrgb(static_cast<float>(i) / (s_SrgbTableSize - 1)) * 255.f + 0.5f);
+			}
+		}
+
+		float ToLinear[256];
+		uint8_t ToSrgb[s_SrgbTableSize];
+	};
+
+	const SrgbTables& GetSrgbTables()
+	{
+		static const SrgbTables tables;
+		return tables;
+	}
+
+	uint32_t Wrap(int32_t index, uint32_t size)
+	{
+		const int32_t wrapped = index % static_cast<int32_t>(size);
+		return static_cast<uint32_t>(wrapped < 0 ? wrapped + static_cast<int32_t>(size) : wrapped);
+	}
+
+	float BesselI0(float x)
+	{
+		float sum = 1.f;
+		float term = 1.f;
+		for (int k = 1; k < 20; k++)
+		{
+			const float factor = x / (2.f * k);
+			term *= factor * factor;
+			sum += term;
+		}
+		return sum;
+	}
+
+	float Kaiser(float t)
+	{
+		if (std::abs(t) >= s_KaiserRadius)
+		{
+			return 0.f;
+		}
+
+		const float sinc = t == 0.f ? 1.f : std::sin(std::numbers::pi_v<float> * t) / (std::numbers::pi_v<float> * t);
+		const float ratio = t / s_KaiserRadius;
+		return sinc * BesselI0(s_KaiserBeta * std::sqrt(1.f - ratio * ratio)) / BesselI0(s_KaiserBeta);
+	}
+
+	// The source texels and weights that make up every texel of the smaller level along one axis. Every
+	// texel has the same number of taps (padded with zero weights) so the kernels have no branches.
+	struct AxisFilter
+	{
+		uint32_t NumTaps = 0;
+		std::vector<uint32_t> Taps;
+		std::vector<float> Weights;
+	};
+
+	AxisFilter BuildAxisFilter(uint32_t srcSize, uint32_t dstSize, MipFilter filter)
+	{
+		const float ratio = static_cast<float>(srcSize) / dstSize;
+
+		std::vector<std::vector<std::pair<int32_t, float>>> texels(dstSize);
+		for (uint32_t x = 0; x < dstSize; x++)
+		{
+			auto& taps = texels[x];
+
+			// An axis that is already 1 texel wide is carried over as is
+			if (srcSize == dstSize)
+			{
+				taps.emplace_back(x, 1.f);
+				continue;
+			}
+
+			if (filter == MipFilter::Box)
+			{
+				// How much of each source texel the footprint [x * ratio, (x + 1) * ratio) covers
+				const float start = x * ratio;
+				const float end = (x + 1) * ratio;
+				for (int32_t i = static_cast<int32_t>(std::floor(start)); i < static_cast<int32_t>(std::ceil(end)); i++)
+				{
+					const float coverage = std::min(end, i + 1.f) - std::max(start, static_cast<float>(i));
+					if (coverage > 0.f)
+					{
+						taps.emplace_back(i, coverage);
+					}
+				}
+			}
+			else
+			{
+				// Distances are measured between texel centers, in texels of the smaller level
+				const float center = (x + 0.5f) * ratio;
+				const float radius = s_KaiserRadius * ratio;
+				for (int32_t i = static_cast<int32_t>(std::ceil(center - radius - 0.5f)); i <= static_cast<int32_t>(std::floor(center + radius - 0.5f)); i++)
+				{
+					const float weight = Kaiser((i + 0.5f - center) / ratio);
+					if (weight != 0.f)
+					{
+						taps.emplace_back(i, weight);
+					}
+				}
+			}
+
+			float sum = 0.f;
+			for (const auto& [index, weight] : taps)
+			{
+				sum += weight;
+			}
+			for (auto& [index, weight] : taps)
+			{
+				weight /= sum;
+			}
+		}
+
+		AxisFilter axis;
+		for (const auto& taps : texels)
+		{
+			axis.NumTaps = std::max(axis.NumTaps, static_cast<uint32_t>(taps.size()));
+		}
+
+		axis.Taps.resize(static_cast<size_t>(dstSize) * axis.NumTaps, 0);
+		axis.Weights.resize(static_cast<size_t>(dstSize) * axis.NumTaps, 0.f);
+		for (uint32_t x = 0; x < dstSize; x++)
+		{
+			for (size_t k = 0; k < texels[x].size(); k++)
+			{
+				axis.Taps[x * axis.NumTaps + k] = Wrap(texels[x][k].first, srcSize);
+				axis.Weights[x * axis.NumTaps + k] = texels[x][k].second;
+			}
+		}
+
+		return axis;
+	}
+
+	void ForEachRowRange(uint32_t numRows, const std::function<void(uint32_t, uint32_t)>& func)
+	{
+		const uint32_t numJobs = (numRows + s_RowsPerJob - 1) / s_RowsPerJob;
+		ThreadPool::ParallelFor(numJobs, [&](uint32_t job)
+		{
+			func(job * s_RowsPerJob, std::min(numRows, (job + 1) * s_RowsPerJob));
+		});
+	}
+
+	// src is srcWidth x height float4 texels, dst becomes dstWidth x height
+	void FilterRows(const float* src, uint32_t srcWidth, uint32_t height, const AxisFilter& filter, float* dst, uint32_t dstWidth)
+	{
+		ForEachRowRange(height, [&](uint32_t firstRow, uint32_t lastRow)
+		{
+			for (uint32_t y = firstRow; y < lastRow; y++)
+			{
+				const float* srcRow = src + static_cast<size_t>(y) * srcWidth * 4;
+				float* dstRow = dst + static_cast<size_t>(y) * dstWidth * 4;
+				for (uint32_t x = 0; x < dstWidth; x++)
+				{
+					const uint32_t* taps = &filter.Taps[static_cast<size_t>(x) * filter.NumTaps];
+					const float* weights = &filter.Weights[static_cast<size_t>(x) * filter.NumTaps];
+
+					__m128 sum = _mm_setzero_ps();
+					for (uint32_t k = 0; k < filter.NumTaps; k++)
+					{
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(srcRow + taps[k] * 4)));
+					}
+					_mm_storeu_ps(dstRow + x * 4, sum);
+				}
+			}
+		});
+	}
+
+	// src is width x srcHeight float4 texels, dst becomes width x dstHeight. Whole source rows are
+	// accumulated at a time so the reads stay sequential. Negative lobes can overshoot, so the result
+	// is clamped back to [0, 1].
+	void FilterColumns(const float* src, uint32_t width, const AxisFilter& filter, float* dst, uint32_t dstHeight)
+	{
+		ForEachRowRange(dstHeight, [&](uint32_t firstRow, uint32_t lastRow)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.f);
+			for (uint32_t y = firstRow; y < lastRow; y++)
+			{
+				float* dstRow = dst + static_cast<size_t>(y) * width * 4;
+				std::fill_n(dstRow, static_cast<size_t>(width) * 4, 0.f);
+
+				for (uint32_t k = 0; k < filter.NumTaps; k++)
+				{
+					const float* srcRow = src + static_cast<size_t>(filter.Taps[static_cast<size_t>(y) * filter.NumTaps + k]) * width * 4;
+					const __m128 weight = _mm_set1_ps(filter.Weights[static_cast<size_t>(y) * filter.NumTaps + k]);
+					for (uint32_t x = 0; x < width; x++)
+					{
+						_mm_storeu_ps(dstRow + x * 4, _mm_add_ps(_mm_loadu_ps(dstRow + x * 4), _mm_mul_ps(weight, _mm_loadu_ps(srcRow + x * 4))));
+					}
+				}
+
+				for (uint32_t x = 0; x < width; x++)
+				{
+					_mm_storeu_ps(dstRow + x * 4, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(dstRow + x * 4), zero), one));
+				}
+			}
+		});
+	}
+
+	// Unpacks every texel to a vector, normalizes it and packs it back, leaving alpha alone
+	void RenormalizeNormals(float* texels, size_t numTexels)
+	{
+		for (size_t i = 0; i < numTexels; i++)
+		{
+			DX::XMFLOAT4* texel = reinterpret_cast<DX::XMFLOAT4*>(texels + i * 4);
+			const DX::XMVECTOR packed = DX::XMLoadFloat4(texel);
+			const DX::XMVECTOR normal = DX::XMVector3Normalize(DX::XMVectorMultiplyAdd(packed, DX::XMVectorReplicate(2.f), DX::XMVectorReplicate(-1.f)));
+			const DX::XMVECTOR repacked = DX::XMVectorMultiplyAdd(normal, DX::XMVectorReplicate(0.5f), DX::XMVectorReplicate(0.5f));
+			DX::XMStoreFloat4(texel, DX::XMVectorSelect(repacked, packed, DX::g_XMSelect0001));
+		}
+	}
+
+	float ComputeCoverage(const float* texels, size_t numTexels, float cutoff, float scale)
+	{
+		size_t passing = 0;
+		for (size_t i = 0; i < numTexels; i++)
+		{
+			passing += texels[i * 4 + 3] * scale >= cutoff;
+		}
+		return static_cast<float>(passing) / numTexels;
+	}
+
+	// Binary searches for the alpha scale that makes the level's coverage match the target. Alpha is only ever
+	// scaled up, since it also drives blending, levels that already cover enough are left as they are.
+	float FindCoverageScale(const float* texels, size_t numTexels, float cutoff, float targetCoverage)
+	{
+		if (ComputeCoverage(texels, numTexels, cutoff, 1.f) >= targetCoverage)
+		{
+			return 1.f;
+		}
+
+		float low = 1.f;
+		float high = 4.f;
+		for (int iteration = 0; iteration < 12; iteration++)
+		{
+			const float scale = (low + high) * 0.5f;
+			if (ComputeCoverage(texels, numTexels, cutoff, scale) < targetCoverage)
+			{
+				low = scale;
+			}
+			else
+			{
+				high = scale;
+			}
+		}
+		return high;
+	}
+
+	void Quantize(const float* texels, uint32_t width, uint32_t height, const MipSettings& settings, float alphaScale, uint8_t* pixels)
+	{
+		const SrgbTables& tables = GetSrgbTables();
+		ForEachRowRange(height, [&](uint32_t firstRow, uint32_t lastRow)
+		{
+			for (size_t i = static_cast<size_t>(firstRow) * width; i < static_cast<size_t>(lastRow) * width; i++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					const float value = texels[i * 4 + c];
+					pixels[i * 4 + c] = settings.IsSrgb
+						? tables.ToSrgb[static_cast<uint32_t>(value * (s_SrgbTableSize - 1) + 0.5f)]
+						: static_cast<uint8_t>(value * 255.f + 0.5f);
+				}
+				pixels[i * 4 + 3] = static_cast<uint8_t>(std::min(texels[i * 4 + 3] * alphaScale, 1.f) * 255.f + 0.5f);
+			}
+		});
+	}
+}
+
+std::vector<MipLevel> MipGenerator::Generate(const uint8_t* pixels, uint32_t width, uint32_t height, const MipSettings& settings)
+{
+	ASSERT(width > 0 && height > 0, "Can't generate mips for an empty image");
+
+	std::vector<MipLevel> levels;
+	levels.reserve(GetNumLevels(width, height));
+	levels.push_back({ width, height, std::vector<uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * 4) });
+	GenerateLevels(pixels, width, height, settings, [&](uint32_t levelWidth, uint32_t levelHeight)
+	{
+		return levels.emplace_back(MipLevel{ levelWidth, levelHeight, std::vector<uint8_t>(static_cast<size_t>(levelWidth) * levelHeight * 4) }).Pixels.data();
+	});
+
+	return levels;
+}
+
+void MipGenerator::GenerateInPlace(uint8_t* chain, uint32_t width, uint32_t height, const MipSettings& settings)
+{
+	ASSERT(width > 0 && height > 0, "Can't generate mips for an empty image");
+
+	uint8_t* next = chain + static_cast<size_t>(width) * height * 4;
+	GenerateLevels(chain, width, height, settings, [&](uint32_t levelWidth, uint32_t levelHeight)
+	{
+		uint8_t* level = next;
+		next += static_cast<size_t>(levelWidth) * levelHeight * 4;
+		return level;
+	});
+}
+
+size_t MipGenerator::GetChainSize(uint32_t width, uint32_t height)
+{
+	size_t size = 0;
+	for (uint32_t i = 0; i < GetNumLevels(width, height); i++)
+	{
+		size += static_cast<size_t>(std::max(1u, width >> i)) * std::max(1u, height >> i) * 4;
+	}
+	return size;
+}
+
+// Every level after the top one, each is quantized straight into the memory getLevel returns for it
+void MipGenerator::GenerateLevels(const uint8_t* pixels, uint32_t width, uint32_t height, const MipSettings& settings,
+	const std::function<uint8_t*(uint32_t, uint32_t)>& getLevel)
+{
+	const uint32_t numLevels = GetNumLevels(width, height);
+	const size_t numTexels = static_cast<size_t>(width) * height;
+
+	const SrgbTables& tables = GetSrgbTables();
+	std::vector<float> level(numTexels * 4);
+	size_t alphaPassing = 0;
+	for (size_t i = 0; i < numTexels * 4; i++)
+	{
+		const bool isColor = settings.IsSrgb && i % 4 != 3;
+		level[i] = isColor ? tables.ToLinear[pixels[i]] : pixels[i] / 255.f;
+	}
+	for (size_t i = 0; i < numTexels; i++)
+	{
+		alphaPassing += level[i * 4 + 3] >= settings.AlphaCutoff;
+	}
+	const float targetCoverage = static_cast<float>(alphaPassing) / numTexels;
+
+	std::vector<float> rows;
+	std::vector<float> next;
+	for (uint32_t i = 1; i < numLevels; i++)
+	{
+		const uint32_t nextWidth = std::max(1u, width / 2);
+		const uint32_t nextHeight = std::max(1u, height / 2);
+
+		rows.resize(static_cast<size_t>(nextWidth) * height * 4);
+		next.resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+		FilterRows(level.data(), width, height, BuildAxisFilter(width, nextWidth, settings.Filter), rows.data(), nextWidth);
+		FilterColumns(rows.data(), nextWidth, BuildAxisFilter(height, nextHeight, settings.Filter), next.data(), nextHeight);
+
+		width = nextWidth;
+		height = nextHeight;
+		std::swap(level, next);
+
+		const size_t numLevelTexels = static_cast<size_t>(width) * height;
+		if (settings.IsNormalMap)
+		{
+			RenormalizeNormals(level.data(), numLevelTexels);
+		}
+
+		// The scale only goes into this level's pixels, the next level is still filtered from the real alpha
+		const float alphaScale = settings.AlphaCutoff > 0.f
+			? FindCoverageScale(level.data(), numLevelTexels, settings.AlphaCutoff, targetCoverage)
+			: 1.f;
+
+		Quantize(level.data(), width, height, settings, alphaScale, getLevel(width, height));
+	}
+}
+
+uint32_t MipGenerator::GetNumLevels(uint32_t width, uint32_t height)
+{
+	uint32_t numLevels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+		numLevels++;
+	}
+	return numLevels;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+enum class MipFilter
+{
+	Box,   // Average of the texels each mip texel covers
+	Kaiser // Kaiser windowed sinc, keeps distant mips sharper than the box filter without much ringing
+};
+
+struct MipSettings
+{
+	MipFilter Filter = MipFilter::Kaiser;
+	// RGB is stored sRGB encoded and is filtered in linear space, alpha is always filtered as is
+	bool IsSrgb = true;
+	// Texels are unit vectors packed into RGB, they are renormalized on every level
+	bool IsNormalMap = false;
+	// Alpha tested textures get each mip's alpha scaled so that the fraction of texels passing this cutoff
+	// stays the same as on the top level, otherwise cutouts (chains, leaves) thin out and vanish in the
+	// distance. 0 turns it off.
+	float AlphaCutoff = 0.f;
+};
+
+struct MipLevel
+{
+	uint32_t Width;
+	uint32_t Height;
+	std::vector<uint8_t> Pixels; // Tightly packed RGBA8
+};
+
+// Builds full mip chains on the CPU from decoded RGBA8 images, so textures can be created immutable with
+// every level supplied up front instead of relying on the device's GenerateMips.
+//
+// Levels are filtered from the previous one in linear float, one texel per SSE register. The filter is
+// separable and wraps around the edges like the samplers do, and the rows of each level are split up
+// over the ThreadPool.
+class MipGenerator
+{
+public:
+	// Every level from the top one (an exact copy of pixels) down to 1x1
+	static std::vector<MipLevel> Generate(const uint8_t* pixels, uint32_t width, uint32_t height, const MipSettings& settings);
+	// chain starts with the top level and has room for every other level after it, tightly packed and
+	// largest first (GetChainSize bytes in all). The levels are written straight into it.
+	static void GenerateInPlace(uint8_t* chain, uint32_t width, uint32_t height, const MipSettings& settings);
+
+	static uint32_t GetNumLevels(uint32_t width, uint32_t height);
+	static size_t GetChainSize(uint32_t width, uint32_t height);
+
+private:
+	static void GenerateLevels(const uint8_t* pixels, uint32_t width, uint32_t height, const MipSettings& settings,
+		const std::function<uint8_t*(uint32_t, uint32_t)>& getLevel);
+};
@@ -1,37 +1,78 @@
 #include "pch.h"
 #include "Model.h"
 
-Model::Model(std::unique_ptr<Node> root, std::unordered_map<int, std::unique_ptr<Mesh>> meshes, const DX::XMMATRIX& transform, DX::XMFLOAT3 color)
-	: m_Root(std::move(root)), m_Meshes(std::move(meshes)), Drawable(transform, color)
+Model::Model(std::shared_ptr<const ModelPrototype> prototype, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::shared_ptr<const ModelData> cpuData)
+	: m_Prototype(std::move(prototype)), m_CpuData(std::move(cpuData)), Drawable(transform, color)
+{
+	Instantiate();
+}
+
+Model::Model(std::shared_ptr<AsyncModelLoad> pendingLoad, const DX::XMMATRIX& transform, DX::XMFLOAT3 color)
+	: m_PendingLoad(std::move(pendingLoad)), Drawable(transform, color)
 {
-	m_Root->ApplyTransformations(m_Transform);
 }
 
 void Model::Submit() const
 {
-	m_Root->Submit();
+	if (m_Root)
+	{
+		m_Root->Submit();
+	}
 }
 
 void Model::Update(float dt)
 {
+	if (m_PendingLoad && m_PendingLoad->IsComplete())
+	{
+		FinishLoading();
+	}
 }
 
 void Model::SetTransform(const DX::XMMATRIX& transform)
 {
 	m_Transform = transform;
-	m_Root->SetModelTransform(m_Transform);
+	if (m_Root)
+	{
+		m_Root->SetModelTransform(m_Transform);
+	}
 }
 
 void Model::SetProjectionMatrix(const DX::XMMATRIX& transform)
 {
 	m_ProjectionMatrix = transform;
 
-	m_Root->SetProjectionMatrix(transform);
+	if (m_Root)
+	{
+		m_Root->SetProjectionMatrix(transform);
+	}
 }
 
 void Model::SetViewMatrix(const DX::XMMATRIX& transform)
 {
 	m_ViewMatrix = transform;
 
-	m_Root->SetViewMatrix(transform);
+	if (m_Root)
+	{
+		m_Root->SetViewMatrix(transform);
+	}
+}
+
+void Model::Instantiate()
+{
+	m_Meshes = m_Prototype->CreateMeshes(m_Transform, m_Color);
+	m_Root = m_Prototype->CreateNodes(m_Meshes);
+	m_Root->ApplyTransformations(m_Transform);
+}
+
+// The prototype the ModelLoader uploaded for us is ready. The matrices set while we were loading were
+// only stored, so they need to be pushed down now.
+void Model::FinishLoading()
+{
+	m_Prototype = m_PendingLoad->Prototype;
+	m_CpuData = m_PendingLoad->Data;
+	m_PendingLoad = nullptr;
+
+	Instantiate();
+	m_Root->SetViewMatrix(m_ViewMatrix);
+	m_Root->SetProjectionMatrix(m_ProjectionMatrix);
 }
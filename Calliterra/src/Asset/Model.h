@@ -2,11 +2,18 @@
 #include "Renderer/Drawable.h"
 #include "Node.h"
 #include "Mesh.h"
+#include "ModelPrototype.h"
 
+struct AsyncModelLoad;
+struct ModelData;
+
+// An instance of a ModelPrototype, see ModelLoader::GetModel. The model owns its node tree and a Mesh per
+// mesh of the prototype, which is only what it needs to be placed and culled on its own.
 class Model : public Drawable
 {
 public:
-	Model(std::unique_ptr<Node> root, std::unordered_map<int, std::unique_ptr<Mesh>> meshes, const DX::XMMATRIX& transform, DX::XMFLOAT3 color);
+	Model(std::shared_ptr<const ModelPrototype> prototype, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, std::shared_ptr<const ModelData> cpuData = nullptr);
+	Model(std::shared_ptr<AsyncModelLoad> pendingLoad, const DX::XMMATRIX& transform, DX::XMFLOAT3 color);
 
 	void Submit() const override;
 
@@ -16,8 +23,27 @@ public:
 	void SetViewMatrix(const DX::XMMATRIX& transform) override;
 	void SetProjectionMatrix(const DX::XMMATRIX& transform) override;
 
+	bool IsLoaded() const { return m_Root != nullptr; }
+
+	// World space bounds of the whole model, only valid once the model has loaded
+	bool HasBounds() const { return m_Root && m_Root->HasBounds(); }
+	const DX::BoundingBox& GetBounds() const { return m_Root->GetBounds(); }
+
+	// Only available if the model was loaded with ModelResidency::KeepCpuData
+	const ModelData* GetCpuData() const { return m_CpuData.get(); }
+
 private:
+	void Instantiate();
+	void FinishLoading();
+
+private:
+	std::shared_ptr<const ModelPrototype> m_Prototype = nullptr;
 	std::unique_ptr<Node> m_Root;
 	std::unordered_map<int, std::unique_ptr<Mesh>> m_Meshes;
+
+	std::shared_ptr<const ModelData> m_CpuData = nullptr;
+
+	// Only set while the model is being loaded asynchronously, until then m_Root is null
+	std::shared_ptr<AsyncModelLoad> m_PendingLoad = nullptr;
 };
 
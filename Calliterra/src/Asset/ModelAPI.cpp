@@ -21,6 +21,11 @@ ModelAPI::ModelAPI(std::shared_ptr<FbxAPI> modelAPI)
 {
 }
 
+ModelAPI::ModelAPI(std::shared_ptr<CookedAPI> modelAPI)
+	: m_API(Cooked), m_Cooked(modelAPI)
+{
+}
+
 ModelAPI::API ModelAPI::GetAPI()
 {
 	return m_API;
@@ -46,4 +51,7 @@ std::shared_ptr<FbxAPI> ModelAPI::GetFbx()
 	return m_Fbx;
 }
 
-
+std::shared_ptr<CookedAPI> ModelAPI::GetCooked()
+{
+	return m_Cooked;
+}
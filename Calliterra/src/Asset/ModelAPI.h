@@ -5,8 +5,11 @@
 #include <fastgltf/core.hpp>
 #include <ufbx.h>
 
+#include "ModelData.h"
+
 class UfbxScene;
 
+using CookedAPI = ModelData;
 using AssimpAPI = aiScene;
 using ObjAPI = rapidobj::Result;
 using GltfAPI = fastgltf::Asset;
@@ -21,7 +24,8 @@ public:
 		Assimp,
 		Obj,
 		Gltf,
-		Fbx
+		Fbx,
+		Cooked
 	};
 	
 public:
@@ -30,12 +34,14 @@ public:
 	ModelAPI(std::shared_ptr<ObjAPI> modelAPI);
 	ModelAPI(std::shared_ptr<GltfAPI> modelAPI);
 	ModelAPI(std::shared_ptr<FbxAPI> modelAPI);
+	ModelAPI(std::shared_ptr<CookedAPI> modelAPI);
 
 	API GetAPI();
 	std::shared_ptr<AssimpAPI> GetAssimp();
 	std::shared_ptr<ObjAPI> GetObj();
 	std::shared_ptr<GltfAPI> GetGltf();
 	std::shared_ptr<FbxAPI> GetFbx();
+	std::shared_ptr<CookedAPI> GetCooked();
 
 private:
 	API m_API = API::None;
@@ -44,6 +50,7 @@ private:
 	std::shared_ptr<ObjAPI> m_Obj = nullptr;
 	std::shared_ptr<GltfAPI> m_Gltf = nullptr;
 	std::shared_ptr<FbxAPI> m_Fbx = nullptr;
+	std::shared_ptr<CookedAPI> m_Cooked = nullptr;
 };
 
 // Wrapper class for ufbx_scene to support RAII
@@ -0,0 +1,200 @@
+#include "pch.h"
+#include "ModelCache.h"
+#include "Core/BinaryStream.h"
+#include "Core/MappedFile.h"
+#include "Core/VirtualFileSystem.h"
+#include "Core/ImportProfiler.h"
+#include "MeshSimplifier.h"
+
+// File layout:
+//   Header   | magic, version, import flags, LOD options, source write time, source path
+//   Materials| count, then per material: shininess, then per map: has map, path
+//   Meshes   | count, then per mesh: index, material index, vertices, indices, LOD count and LOD indices, bounds, meshlets
+//   Nodes    | count, then per node (pre-order): name, transform, mesh indices, child count
+std::shared_ptr<ModelData> ModelCache::Load(const std::filesystem::path& sourcePath, uint32_t importFlags, const LodOptions& lodOptions)
+{
+	const std::filesystem::path cachePath = GetCachePath(sourcePath);
+	if (!std::filesystem::exists(cachePath))
+	{
+		return nullptr;
+	}
+
+	MappedFile file(cachePath);
+	if (!file.IsOpen())
+	{
+		return nullptr;
+	}
+	ImportProfiler::AddBytesRead(file.GetSize());
+
+	BinaryReader reader(file.GetData(), file.GetSize());
+
+	if (reader.Read<uint32_t>() != s_Magic ||
+		reader.Read<uint32_t>() != s_Version ||
+		reader.Read<uint32_t>() != importFlags ||
+		reader.Read<LodOptions>() != lodOptions ||
+		reader.Read<int64_t>() != GetSourceWriteTime(sourcePath) ||
+		reader.ReadString() != sourcePath.generic_string())
+	{
+		LOG_DEBUG("Model cache entry for {} is out of date", sourcePath.string());
+		return nullptr;
+	}
+
+	std::shared_ptr<ModelData> model = std::make_shared<ModelData>();
+
+	const uint32_t numMaterials = reader.Read<uint32_t>();
+	std::vector<std::shared_ptr<const Material>> materials(numMaterials);
+	for (auto& material : materials)
+	{
+		std::shared_ptr<Material> newMaterial = std::make_shared<Material>();
+		newMaterial->SetShininess(reader.Read<float>());
+		for (int i = 0; i < Material::NumSupportedMaps; i++)
+		{
+			const bool hasMap = reader.Read<uint8_t>() != 0;
+			newMaterial->SetMaterialMap(static_cast<Material::MapTypes>(i), reader.ReadString(), hasMap);
+		}
+		material = std::move(newMaterial);
+	}
+
+	const uint32_t numMeshes = reader.Read<uint32_t>();
+	model->Meshes.resize(numMeshes);
+	for (auto& mesh : model->Meshes)
+	{
+		mesh.MeshIndex = reader.Read<int32_t>();
+
+		const uint32_t materialIndex = reader.Read<uint32_t>();
+		if (materialIndex >= materials.size())
+		{
+			LOG_WARN("Model cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+			return nullptr;
+		}
+		mesh.MeshMaterial = materials[materialIndex];
+
+		mesh.Vertices = reader.ReadVector<ModelVertexFull>();
+		mesh.Indices = reader.ReadVector<uint32_t>();
+
+		const uint32_t numLods = reader.Read<uint32_t>();
+		if (numLods >= lodOptions.MaxLods)
+		{
+			LOG_WARN("Model cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+			return nullptr;
+		}
+		mesh.LodIndices.resize(numLods);
+		for (auto& lod : mesh.LodIndices)
+		{
+			lod = reader.ReadVector<uint32_t>();
+		}
+
+		mesh.Bounds = reader.Read<DX::BoundingBox>();
+		mesh.BoundingSphere = reader.Read<DX::BoundingSphere>();
+		mesh.Meshlets = reader.ReadVector<Meshlet>();
+		if (!mesh.Meshlets.empty() && static_cast<size_t>(mesh.Meshlets.back().IndexOffset) + mesh.Meshlets.back().IndexCount != mesh.Indices.size())
+		{
+			LOG_WARN("Model cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+			return nullptr;
+		}
+	}
+
+	const uint32_t numNodes = reader.Read<uint32_t>();
+	model->Nodes.resize(numNodes);
+	for (auto& node : model->Nodes)
+	{
+		node.Name = reader.ReadString();
+		node.RelativeTransform = reader.Read<DX::XMFLOAT4X4>();
+		node.MeshIndices = reader.ReadVector<int>();
+		node.NumChildren = reader.Read<uint32_t>();
+	}
+
+	if (!reader.IsValid() || model->Nodes.empty())
+	{
+		LOG_WARN("Model cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+		return nullptr;
+	}
+
+	return model;
+}
+
+void ModelCache::Store(const std::filesystem::path& sourcePath, uint32_t importFlags, const LodOptions& lodOptions, const ModelData& model)
+{
+	BinaryWriter writer;
+
+	writer.Write(s_Magic);
+	writer.Write(s_Version);
+	writer.Write(importFlags);
+	writer.Write(lodOptions);
+	writer.Write(GetSourceWriteTime(sourcePath));
+	writer.WriteString(sourcePath.generic_string());
+
+	// Meshes that share a material (see ModelImporter::ShareMaterials) reference the same table entry
+	std::vector<const Material*> materials;
+	std::vector<uint32_t> materialIndices;
+	materialIndices.reserve(model.Meshes.size());
+	for (const auto& mesh : model.Meshes)
+	{
+		auto it = std::find(materials.begin(), materials.end(), mesh.MeshMaterial.get());
+		if (it == materials.end())
+		{
+			it = materials.insert(materials.end(), mesh.MeshMaterial.get());
+		}
+		materialIndices.push_back(static_cast<uint32_t>(it - materials.begin()));
+	}
+
+	writer.Write(static_cast<uint32_t>(materials.size()));
+	for (const Material* material : materials)
+	{
+		writer.Write(material->GetShininess());
+		for (int i = 0; i < Material::NumSupportedMaps; i++)
+		{
+			const auto mapType = static_cast<Material::MapTypes>(i);
+			writer.Write(static_cast<uint8_t>(material->HasMaterialMap(mapType)));
+			writer.WriteString(material->GetMaterialMap(mapType));
+		}
+	}
+
+	writer.Write(static_cast<uint32_t>(model.Meshes.size()));
+	for (size_t m = 0; m < model.Meshes.size(); m++)
+	{
+		const MeshData& mesh = model.Meshes[m];
+		writer.Write(static_cast<int32_t>(mesh.MeshIndex));
+		writer.Write(materialIndices[m]);
+
+		writer.WriteVector(mesh.Vertices);
+		writer.WriteVector(mesh.Indices);
+
+		writer.Write(static_cast<uint32_t>(mesh.LodIndices.size()));
+		for (const auto& lod : mesh.LodIndices)
+		{
+			writer.WriteVector(lod);
+		}
+
+		writer.Write(mesh.Bounds);
+		writer.Write(mesh.BoundingSphere);
+		writer.WriteVector(mesh.Meshlets);
+	}
+
+	writer.Write(static_cast<uint32_t>(model.Nodes.size()));
+	for (const auto& node : model.Nodes)
+	{
+		writer.WriteString(node.Name);
+		writer.Write(node.RelativeTransform);
+		writer.WriteVector(node.MeshIndices);
+		writer.Write(node.NumChildren);
+	}
+
+	if (!writer.SaveToFile(GetCachePath(sourcePath)))
+	{
+		LOG_WARN("Failed to write model cache entry for {}", sourcePath.string());
+	}
+}
+
+std::filesystem::path ModelCache::GetCachePath(const std::filesystem::path& sourcePath)
+{
+	// The full path is stored (and checked) inside the entry, so a hash collision only costs a re-import
+	const size_t hash = std::hash<std::string>{}(sourcePath.generic_string());
+	return s_CacheDirectory / std::format("{:016x}.cmdl", hash);
+}
+
+// Sources packed into an archive keep the write time they were packed with
+int64_t ModelCache::GetSourceWriteTime(const std::filesystem::path& sourcePath)
+{
+	return VirtualFileSystem::GetWriteTime(sourcePath);
+}
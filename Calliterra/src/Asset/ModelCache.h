@@ -0,0 +1,25 @@
+#pragma once
+#include "ModelData.h"
+#include "MeshSimplifier.h"
+
+// On disk cache of fully imported models. Importing through Assimp (especially with post processing)
+// is slow, so once a model has been imported we write out its ModelData in a binary format that
+// can be read back with a single memory mapped read on the next launch.
+//
+// Cache entries are keyed by the source path, and are only considered valid if the source file's
+// last write time, the import flags and the LOD options match what the entry was cooked with.
+class ModelCache
+{
+public:
+	static std::shared_ptr<ModelData> Load(const std::filesystem::path& sourcePath, uint32_t importFlags, const LodOptions& lodOptions);
+	static void Store(const std::filesystem::path& sourcePath, uint32_t importFlags, const LodOptions& lodOptions, const ModelData& model);
+
+private:
+	static std::filesystem::path GetCachePath(const std::filesystem::path& sourcePath);
+	static int64_t GetSourceWriteTime(const std::filesystem::path& sourcePath);
+
+private:
+	inline static const std::filesystem::path s_CacheDirectory = "cache/models";
+	inline static constexpr uint32_t s_Magic = 0x4C444D43; // "CMDL"
+	inline static constexpr uint32_t s_Version = 7;
+};
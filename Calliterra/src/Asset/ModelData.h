@@ -0,0 +1,104 @@
+#pragma once
+#include "Material.h"
+
+struct ModelVertexFull
+{
+	DX::XMFLOAT3 Position;
+	DX::XMFLOAT3 Normal;
+	DX::XMFLOAT3 Tangent;
+	DX::XMFLOAT3 Bitangent;
+	DX::XMFLOAT2 Texture;
+};
+
+// Quantized version of ModelVertexFull, 20 bytes instead of 56. See VertexPacking for the encoding.
+//   Position:   16 bit unorm relative to the mesh bounds, w holds the bitangent sign (0 = -1, 1 = +1)
+//   Normal:     octahedral encoded, 16 bit snorm
+//   Tangent:    octahedral encoded, 16 bit snorm, the bitangent is rebuilt from the normal and tangent
+//   Texture:    half floats
+struct ModelVertexPacked
+{
+	uint16_t Position[4];
+	int16_t Normal[2];
+	int16_t Tangent[2];
+	uint16_t Texture[2];
+};
+
+struct ModelVertexSemi
+{
+	DX::XMFLOAT3 Position;
+	DX::XMFLOAT3 Normal;
+	DX::XMFLOAT2 Texture;
+};
+
+// A cluster of connected triangles that is stored as a contiguous range of its mesh's Indices (LOD 0 only).
+// Everything is in model space, see MeshletBuilder.
+struct Meshlet
+{
+	uint32_t IndexOffset = 0;
+	uint32_t IndexCount = 0;
+	DX::BoundingSphere Bounds;
+
+	// Normal cone: the whole cluster faces away from a camera at p if
+	//   dot(normalize(ConeApex - p), ConeAxis) >= ConeCutoff
+	// A cutoff of 1 means the normals are too spread out for the test to ever pass.
+	DX::XMFLOAT3 ConeApex = { 0.f, 0.f, 0.f };
+	DX::XMFLOAT3 ConeAxis = { 0.f, 0.f, 0.f };
+	float ConeCutoff = 1.f;
+};
+
+// CPU side geometry and material of a single mesh. This is everything a Mesh needs to
+// create its GPU resources, so it can be built on a worker thread ahead of time.
+struct MeshData
+{
+	int MeshIndex = -1;
+	std::vector<ModelVertexFull> Vertices;
+	std::vector<uint32_t> Indices;
+	// Simplified versions of Indices, from most to least detailed. They index into the same Vertices.
+	std::vector<std::vector<uint32_t>> LodIndices;
+	std::vector<Meshlet> Meshlets;
+	// Meshes of a model that use the same material share a single instance of it
+	std::shared_ptr<const Material> MeshMaterial;
+
+	// Model space bounds of Vertices
+	DX::BoundingBox Bounds;
+	DX::BoundingSphere BoundingSphere;
+
+	size_t GetGeometrySize() const
+	{
+		size_t size = Vertices.size() * sizeof(ModelVertexFull) + Indices.size() * sizeof(uint32_t);
+		for (const auto& lod : LodIndices)
+		{
+			size += lod.size() * sizeof(uint32_t);
+		}
+		size += Meshlets.size() * sizeof(Meshlet);
+		return size;
+	}
+};
+
+// A single node of the model hierarchy. Nodes are stored flattened in pre-order,
+// a node's children directly follow it (and all of their own descendants).
+struct NodeData
+{
+	std::string Name;
+	DX::XMFLOAT4X4 RelativeTransform;
+	std::vector<int> MeshIndices;
+	uint32_t NumChildren = 0;
+};
+
+// Fully processed, API independent representation of a model. This is what gets
+// written to and read from the model cache.
+struct ModelData
+{
+	std::vector<MeshData> Meshes;
+	std::vector<NodeData> Nodes;
+
+	size_t GetGeometrySize() const
+	{
+		size_t size = 0;
+		for (const auto& mesh : Meshes)
+		{
+			size += mesh.GetGeometrySize();
+		}
+		return size;
+	}
+};
@@ -0,0 +1,1169 @@
+#include "pch.h"
+#include "ModelImporter.h"
+
+#include <map>
+#include <numeric>
+#include <assimp/IOSystem.hpp>
+#include <assimp/MemoryIOWrapper.h>
+#include "fastgltf/tools.hpp"
+#include "fastgltf/math.hpp"
+
+#include "ModelCache.h"
+#include "MeshProcessing.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "VertexKernels.h"
+#include "Core/ImportProfiler.h"
+#include "Core/ThreadPool.h"
+#include "Core/Timer.h"
+#include "Core/VirtualFileSystem.h"
+
+namespace
+{
+	// Lets rapidobj parse an obj that is already in memory
+	class MemoryStreamBuffer : public std::streambuf
+	{
+	public:
+		MemoryStreamBuffer(std::string_view text)
+		{
+			char* begin = const_cast<char*>(text.data());
+			setg(begin, begin, begin + text.size());
+		}
+	};
+
+	// The first mtllib statement of an obj, relative to the obj's directory
+	std::string_view FindMaterialLibrary(std::string_view obj)
+	{
+		constexpr std::string_view keyword = "mtllib";
+		for (size_t pos = obj.find(keyword); pos != std::string_view::npos; pos = obj.find(keyword, pos + keyword.size()))
+		{
+			if (pos != 0 && obj[pos - 1] != '\n')
+			{
+				continue;
+			}
+
+			const size_t begin = obj.find_first_not_of(" \t", pos + keyword.size());
+			const size_t end = obj.find_first_of("\r\n", begin);
+			if (begin == std::string_view::npos)
+			{
+				return {};
+			}
+
+			std::string_view name = obj.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+			return name.substr(0, name.find_last_not_of(" \t") + 1);
+		}
+
+		return {};
+	}
+
+	// Hands Assimp the files it asks for from the VirtualFileSystem, so it can read from the asset archive too
+	class AssetIOStream : public Assimp::MemoryIOStream
+	{
+	public:
+		// Moving the file doesn't move its data, so the pointer handed to the MemoryIOStream stays valid
+		AssetIOStream(AssetFile&& file)
+			: MemoryIOStream(file.GetData(), file.GetSize()), m_File(std::move(file))
+		{
+		}
+
+	private:
+		AssetFile m_File;
+	};
+
+	class AssetIOSystem : public Assimp::IOSystem
+	{
+	public:
+		bool Exists(const char* filepath) const override
+		{
+			return VirtualFileSystem::Exists(filepath);
+		}
+
+		char getOsSeparator() const override
+		{
+			return '/';
+		}
+
+		Assimp::IOStream* Open(const char* filepath, const char* mode) override
+		{
+			if (std::strchr(mode, 'w'))
+			{
+				return nullptr;
+			}
+
+			AssetFile file = VirtualFileSystem::Open(filepath);
+			return file.IsOpen() ? new AssetIOStream(std::move(file)) : nullptr;
+		}
+
+		void Close(Assimp::IOStream* file) override
+		{
+			delete file;
+		}
+	};
+}
+
+//==============================Cooked==================================
+#pragma region cooked
+
+std::shared_ptr<ModelData> ModelImporter::LoadModelCooked(const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("LoadModelCooked", filepath.string());
+	Timer timer;
+	const uint32_t importFlags = GetImportFlags(filepath);
+
+	std::shared_ptr<ModelData> model;
+	{
+		PROFILE_IMPORT_STAGE("ModelCache::Load");
+		model = ModelCache::Load(filepath, importFlags, s_LodOptions);
+	}
+
+	if (model)
+	{
+		RecordGeometry(*model);
+		LOG_INFO("Loaded {} from model cache in {:.2f}ms", filepath.string(), timer.GetElapsedInMilliseconds());
+		return model;
+	}
+
+	model = ImportModel(filepath);
+	OptimizeModel(*model, filepath);
+	RecordGeometry(*model);
+	const double importTime = timer.GetElapsedInMilliseconds();
+
+	{
+		PROFILE_IMPORT_STAGE("ModelCache::Store");
+		ModelCache::Store(filepath, importFlags, s_LodOptions, *model);
+	}
+	LOG_INFO("Imported {} in {:.2f}ms (cache written in {:.2f}ms)", filepath.string(), importTime, timer.GetElapsedInMilliseconds() - importTime);
+
+	return model;
+}
+
+// Picks the importer based on the file extension. Our own importers are a lot faster than Assimp
+// for the formats they support, everything else goes through Assimp.
+std::shared_ptr<ModelData> ModelImporter::ImportModel(const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("Import", filepath.string());
+
+	std::shared_ptr<ModelData> model;
+#if FAST_MODEL_LOADING
+	const std::string extension = GetExtension(filepath);
+	if (extension == ".obj")
+	{
+		model = ImportModelObj(filepath);
+	}
+	else if (extension == ".gltf" || extension == ".glb")
+	{
+		model = ImportModelGltf(filepath);
+	}
+	else if (extension == ".fbx")
+	{
+		model = ImportModelFbx(filepath);
+	}
+#endif
+
+	if (!model)
+	{
+		model = ImportModelAssimp(filepath);
+	}
+
+	ShareMaterials(*model);
+	return model;
+}
+
+uint32_t ModelImporter::GetImportFlags(const std::filesystem::path& filepath)
+{
+#if FAST_MODEL_LOADING
+	const std::string extension = GetExtension(filepath);
+	if (extension == ".obj" || extension == ".gltf" || extension == ".glb" || extension == ".fbx")
+	{
+		return s_NativeImportFlags;
+	}
+#endif
+
+	return s_AssimpFlags;
+}
+
+std::string ModelImporter::GetExtension(const std::filesystem::path& filepath)
+{
+	std::string extension = filepath.extension().string();
+
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+    [](unsigned char c){ return std::tolower(c); });
+
+	return extension;
+}
+
+// Files often define the same material more than once (an FBX material per mesh, an OBJ exported from
+// several files, ...), so meshes whose materials have the same contents are made to share a single one.
+// This is the model's material table, it's what gets written to the model cache.
+void ModelImporter::ShareMaterials(ModelData& model)
+{
+	std::unordered_map<Material, std::shared_ptr<const Material>, Material::Hasher> materials;
+	for (auto& mesh : model.Meshes)
+	{
+		mesh.MeshMaterial = materials.try_emplace(*mesh.MeshMaterial, mesh.MeshMaterial).first->second;
+	}
+}
+
+// Counts the model's geometry towards its import profile
+void ModelImporter::RecordGeometry(const ModelData& model)
+{
+	size_t numVertices = 0;
+	size_t numTriangles = 0;
+	for (const auto& mesh : model.Meshes)
+	{
+		numVertices += mesh.Vertices.size();
+		numTriangles += mesh.Indices.size() / 3;
+	}
+
+	ImportProfiler::AddGeometry(numVertices, numTriangles);
+	ImportProfiler::AddBytesAllocated(model.GetGeometrySize());
+}
+
+// Times our own importer against Assimp for the same file, bypassing the model cache.
+// Both sides include the post processing needed to produce the final ModelData.
+void ModelImporter::BenchmarkImport(const std::filesystem::path& filepath, int iterations)
+{
+	auto countGeometry = [](const ModelData& model)
+	{
+		size_t numVertices = 0;
+		size_t numIndices = 0;
+		for (const auto& mesh : model.Meshes)
+		{
+			numVertices += mesh.Vertices.size();
+			numIndices += mesh.Indices.size();
+		}
+		return std::make_pair(numVertices, numIndices);
+	};
+
+	double nativeTime = 0.0;
+	double assimpTime = 0.0;
+	std::shared_ptr<ModelData> native;
+	std::shared_ptr<ModelData> assimp;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		Timer timer;
+		native = ImportModel(filepath);
+		nativeTime += timer.GetElapsedInMilliseconds();
+
+		timer.Reset();
+		assimp = ImportModelAssimp(filepath);
+		assimpTime += timer.GetElapsedInMilliseconds();
+	}
+
+	const auto [nativeVertices, nativeIndices] = countGeometry(*native);
+	const auto [assimpVertices, assimpIndices] = countGeometry(*assimp);
+
+	LOG_INFO("Import benchmark for {} ({} iterations)", filepath.string(), iterations);
+	LOG_INFO("  Native: {:.2f}ms, {} meshes, {} vertices, {} indices", nativeTime / iterations, native->Meshes.size(), nativeVertices, nativeIndices);
+	LOG_INFO("  Assimp: {:.2f}ms, {} meshes, {} vertices, {} indices", assimpTime / iterations, assimp->Meshes.size(), assimpVertices, assimpIndices);
+	LOG_INFO("  Speed-up: {:.2f}x", assimpTime / nativeTime);
+}
+
+void ModelImporter::BenchmarkLoading(const std::vector<std::filesystem::path>& filepaths, int iterations)
+{
+	// The same work LoadModelCooked does on a cache miss, without writing the cache
+	auto importModel = [](const std::filesystem::path& filepath)
+	{
+		std::shared_ptr<ModelData> model = ImportModel(filepath);
+		OptimizeModel(*model, filepath);
+		return model;
+	};
+
+	// Makes sure every model has a cache entry to load
+	for (const auto& filepath : filepaths)
+	{
+		LoadModelCooked(filepath);
+	}
+
+	double serialTime = 0.0;
+	double parallelTime = 0.0;
+	double cachedTime = 0.0;
+	size_t numMeshes = 0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		Timer timer;
+		for (const auto& filepath : filepaths)
+		{
+			importModel(filepath);
+		}
+		serialTime += timer.GetElapsedInMilliseconds();
+
+		timer.Reset();
+		std::vector<std::future<std::shared_ptr<ModelData>>> loads;
+		for (const auto& filepath : filepaths)
+		{
+			loads.push_back(ThreadPool::Submit([&importModel, filepath]() { return importModel(filepath); }));
+		}
+		numMeshes = 0;
+		for (auto& load : loads)
+		{
+			numMeshes += load.get()->Meshes.size();
+		}
+		parallelTime += timer.GetElapsedInMilliseconds();
+
+		timer.Reset();
+		for (const auto& filepath : filepaths)
+		{
+			ModelCache::Load(filepath, GetImportFlags(filepath), s_LodOptions);
+		}
+		cachedTime += timer.GetElapsedInMilliseconds();
+	}
+
+	// Each import already spreads its meshes over the ThreadPool, the parallel run overlaps whole models on
+	// top of that
+	LOG_INFO("Loading benchmark for {} models ({} meshes, {} iterations, {} workers)", filepaths.size(), numMeshes, iterations, ThreadPool::GetNumThreads());
+	LOG_INFO("  Serial: {:.2f}ms", serialTime / iterations);
+	LOG_INFO("  ThreadPool: {:.2f}ms ({:.2f}x)", parallelTime / iterations, serialTime / parallelTime);
+	LOG_INFO("  Model cache: {:.2f}ms ({:.2f}x)", cachedTime / iterations, serialTime / cachedTime);
+}
+
+// Every map starts off pointing at a placeholder texture, importers only overwrite the maps they find
+std::unique_ptr<Material> ModelImporter::CreateDefaultMaterial()
+{
+	std::unique_ptr<Material> material = std::make_unique<Material>();
+	material->SetMaterialMap(Material::Albedo, "assets/textures/missing_textures/missing_texture.png", false);
+	material->SetMaterialMap(Material::Specular, "assets/textures/missing_textures/missing_map.png", false);
+	material->SetMaterialMap(Material::Normal, "assets/textures/missing_textures/missing_map.png", false);
+
+	return material;
+}
+
+// Our own importers hand over the raw, right handed data. This applies the same post processing that
+// Assimp does for us with s_AssimpFlags so all importers produce identical looking results.
+void ModelImporter::ProcessMeshData(MeshData& mesh, bool hasNormals)
+{
+	MeshProcessing::ConvertToLeftHanded(mesh);
+	if (!hasNormals)
+	{
+		MeshProcessing::GenerateNormals(mesh);
+	}
+	MeshProcessing::WeldVertices(mesh);
+	MeshProcessing::GenerateTangents(mesh);
+}
+
+// Reorders the geometry of every mesh for the vertex cache, overdraw and vertex fetch, builds its
+// LOD chain and computes its bounds. This only happens on import, the result is what ends up in the model cache.
+void ModelImporter::OptimizeModel(ModelData& model, const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("Optimize", filepath.string());
+	Timer timer;
+
+	std::vector<VertexCacheStats> before(model.Meshes.size());
+	std::vector<VertexCacheStats> after(model.Meshes.size());
+	ThreadPool::ParallelFor(static_cast<uint32_t>(model.Meshes.size()), [&](uint32_t i)
+	{
+		MeshData& mesh = model.Meshes[i];
+		before[i] = MeshOptimizer::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+		MeshOptimizer::Optimize(mesh);
+
+		// Meshlets regroup the triangles, so the vertices have to be put back in the order they are now fetched in
+		MeshletBuilder::Build(mesh);
+		MeshOptimizer::OptimizeVertexFetch(mesh);
+		after[i] = MeshOptimizer::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+
+		// The LODs reuse the vertices, which are already in the order the full detail mesh fetches them
+		MeshSimplifier::GenerateLods(mesh, s_LodOptions);
+		for (auto& lod : mesh.LodIndices)
+		{
+			MeshOptimizer::OptimizeVertexCache(lod, mesh.Vertices.size());
+		}
+
+		MeshProcessing::ComputeBounds(mesh);
+	});
+
+	// Weighted by triangle count, so the numbers are what they would be if the model was a single mesh
+	size_t triangles = 0;
+	size_t vertices = 0;
+	double transformedBefore = 0.0;
+	double transformedAfter = 0.0;
+	for (size_t i = 0; i < model.Meshes.size(); i++)
+	{
+		const size_t meshTriangles = model.Meshes[i].Indices.size() / 3;
+		triangles += meshTriangles;
+		vertices += model.Meshes[i].Vertices.size();
+		transformedBefore += before[i].ACMR * meshTriangles;
+		transformedAfter += after[i].ACMR * meshTriangles;
+	}
+
+	if (triangles == 0 || vertices == 0)
+	{
+		return;
+	}
+
+	size_t meshlets = 0;
+	for (const auto& mesh : model.Meshes)
+	{
+		meshlets += mesh.Meshlets.size();
+	}
+
+	LOG_INFO("Optimized {} in {:.2f}ms: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} meshlets ({:.1f} triangles each)", filepath.string(), timer.GetElapsedInMilliseconds(),
+		transformedBefore / triangles, transformedAfter / triangles, transformedBefore / vertices, transformedAfter / vertices,
+		meshlets, meshlets > 0 ? static_cast<double>(triangles) / meshlets : 0.0);
+}
+
+#pragma endregion
+
+//==============================Assimp==================================
+#pragma region assimp 
+
+std::shared_ptr<ModelData> ModelImporter::ImportModelAssimp(const std::filesystem::path& filepath)
+{
+	// Everything we need gets copied out of the scene, so the importer (which owns the scene) 
+	// only has to live as long as this function.
+	Assimp::Importer importer;
+	importer.SetIOHandler(new AssetIOSystem()); // The importer takes ownership
+	const aiScene* scene = nullptr;
+	{
+		PROFILE_IMPORT_STAGE("Assimp::ReadFile");
+		scene = importer.ReadFile(filepath.string(), s_AssimpFlags);
+	}
+	ASSERT(scene, importer.GetErrorString());
+
+	std::shared_ptr<ModelData> model = std::make_shared<ModelData>();
+	model->Meshes = GetModelMeshData(*scene, filepath);
+	model->Nodes = GetModelNodeData(*scene);
+
+	return model;
+}
+
+// Extracts the vertices, indices and material of every mesh in the scene. Each mesh is
+// independent of the others so they are spread across the ThreadPool.
+std::vector<MeshData> ModelImporter::GetModelMeshData(const aiScene& model, const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("GetModelMeshData", filepath.string());
+	std::vector<MeshData> meshData(model.mNumMeshes);
+
+	// Meshes reference the scene's materials by index, each one is only built once
+	std::vector<std::shared_ptr<const Material>> materials(model.mNumMaterials);
+	for (uint32_t i = 0; i < model.mNumMaterials; i++)
+	{
+		materials[i] = GetMeshMaterial(model, i, filepath);
+	}
+
+	ThreadPool::ParallelFor(model.mNumMeshes, [&](uint32_t i)
+	{
+		MeshData& data = meshData[i];
+		data.MeshIndex = static_cast<int>(i);
+		data.MeshMaterial = materials[model.mMeshes[i]->mMaterialIndex];
+		data.Vertices = GetMeshVertexVectorFull(model, i);
+		data.Indices = GetMeshIndexVector(model, i);
+	});
+
+	return meshData;
+}
+
+std::unique_ptr<Material> ModelImporter::GetMeshMaterial(const aiScene& model, int materialIndex, const std::filesystem::path& filepath)
+{
+	std::string parentPath = filepath.parent_path().string() + "/";
+	std::string missingTex = "assets/textures/missing_textures/missing_texture.png";
+	std::string missingMap = "assets/textures/missing_textures/missing_map.png";
+
+	aiString aiTexturePath;
+	std::unique_ptr<Material> material = std::make_unique<Material>();
+	const aiMaterial& aiMaterial = *model.mMaterials[materialIndex];
+
+	// Get the albedo/diffuse map
+	bool hasAlbedoMap = aiMaterial.GetTexture(AI_MATKEY_BASE_COLOR_TEXTURE, &aiTexturePath) == AI_SUCCESS;
+	material->SetMaterialMap(Material::Albedo, missingTex, false);
+	if (!hasAlbedoMap)
+	{
+		hasAlbedoMap = aiMaterial.GetTexture(aiTextureType_DIFFUSE, 0, &aiTexturePath) == AI_SUCCESS;
+		if (hasAlbedoMap)
+		{
+			material->SetMaterialMap(Material::Albedo, parentPath + aiTexturePath.C_Str(), true);
+		}
+	}
+	else
+	{
+		material->SetMaterialMap(Material::Albedo, parentPath + aiTexturePath.C_Str(), true);
+	}
+
+	// Get the specular map, otherwise default the shininess
+	material->SetMaterialMap(Material::Specular, missingMap, false);
+	bool hasSpecularMap = aiMaterial.GetTexture(aiTextureType_SPECULAR, 0, &aiTexturePath) == AI_SUCCESS;
+	if (hasSpecularMap)
+	{
+		material->SetMaterialMap(Material::Specular, parentPath + aiTexturePath.C_Str(), true);
+	}
+	else
+	{
+		float shininess = 1.f;
+		if (aiMaterial.Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS)
+		{
+			material->SetShininess(shininess);
+		}
+	}
+
+	// Normal map
+	material->SetMaterialMap(Material::Normal, missingMap, false);
+	bool hasNormalMap = aiMaterial.GetTexture(aiTextureType_NORMALS, 0, &aiTexturePath) == AI_SUCCESS;
+	if (hasNormalMap)
+	{
+		material->SetMaterialMap(Material::Normal, parentPath + aiTexturePath.C_Str(), true);
+	}
+
+	return material;
+}
+
+std::vector<ModelVertexFull> ModelImporter::GetMeshVertexVectorFull(const aiScene& objModel, int meshIndex)
+{
+	const auto mesh = objModel.mMeshes[meshIndex];
+	std::vector<ModelVertexFull> vertices(mesh->mNumVertices);
+	if (vertices.empty())
+	{
+		return vertices;
+	}
+
+	constexpr size_t stride = VertexKernels::Stride<ModelVertexFull>();
+	VertexKernels::InterleaveFloat3(&mesh->mVertices[0].x, mesh->mNumVertices, &vertices[0].Position.x, stride);
+	VertexKernels::InterleaveFloat3(&mesh->mNormals[0].x, mesh->mNumVertices, &vertices[0].Normal.x, stride);
+	if (mesh->HasTangentsAndBitangents())
+	{
+		VertexKernels::InterleaveFloat3(&mesh->mTangents[0].x, mesh->mNumVertices, &vertices[0].Tangent.x, stride);
+		VertexKernels::InterleaveFloat3(&mesh->mBitangents[0].x, mesh->mNumVertices, &vertices[0].Bitangent.x, stride);
+	}
+	if (mesh->HasTextureCoords(0))
+	{
+		VertexKernels::InterleaveFloat2(&mesh->mTextureCoords[0][0].x, mesh->mNumVertices, &vertices[0].Texture.x, stride, 3);
+	}
+
+	return vertices;
+}
+
+std::vector<ModelVertexSemi> ModelImporter::GetMeshVertexVectorSemi(const aiScene& objModel, int meshIndex)
+{
+	const auto mesh = objModel.mMeshes[meshIndex];
+	std::vector<ModelVertexSemi> vertices(mesh->mNumVertices);
+	if (vertices.empty())
+	{
+		return vertices;
+	}
+
+	constexpr size_t stride = VertexKernels::Stride<ModelVertexSemi>();
+	VertexKernels::InterleaveFloat3(&mesh->mVertices[0].x, mesh->mNumVertices, &vertices[0].Position.x, stride);
+	VertexKernels::InterleaveFloat3(&mesh->mNormals[0].x, mesh->mNumVertices, &vertices[0].Normal.x, stride);
+	if (mesh->HasTextureCoords(0))
+	{
+		VertexKernels::InterleaveFloat2(&mesh->mTextureCoords[0][0].x, mesh->mNumVertices, &vertices[0].Texture.x, stride, 3);
+	}
+
+	return vertices;
+}
+
+std::vector<uint32_t> ModelImporter::GetMeshIndexVector(const aiScene& objModel, int meshIndex)
+{
+	const auto mesh = objModel.mMeshes[meshIndex];
+	std::vector<uint32_t> indices;
+
+	indices.reserve(mesh->mNumFaces * 3);
+	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+	{
+		const auto& face = mesh->mFaces[i];
+		ASSERT(face.mNumIndices == 3);
+
+		indices.push_back(face.mIndices[0]);
+		indices.push_back(face.mIndices[1]);
+		indices.push_back(face.mIndices[2]);
+	}
+
+	return indices;
+}
+
+std::vector<NodeData> ModelImporter::GetModelNodeData(const aiScene& model)
+{
+	std::vector<NodeData> nodes;
+	ParseNodeData(*model.mRootNode, nodes);
+
+	return nodes;
+}
+
+void ModelImporter::ParseNodeData(const aiNode& node, std::vector<NodeData>& nodes)
+{
+	NodeData& data = nodes.emplace_back();
+	data.Name = node.mName.C_Str();
+	data.NumChildren = node.mNumChildren;
+	DX::XMStoreFloat4x4(&data.RelativeTransform, DX::XMMatrixTranspose(DX::XMLoadFloat4x4(
+		reinterpret_cast<const DX::XMFLOAT4X4*>(&node.mTransformation)
+	)));
+
+	for (unsigned int i = 0; i < node.mNumMeshes; i++)
+	{
+		data.MeshIndices.push_back(static_cast<int>(node.mMeshes[i]));
+	}
+
+	// data is a reference into nodes, so it must not be touched after this point
+	for (unsigned int i = 0; i < node.mNumChildren; i++)
+	{
+		ParseNodeData(*node.mChildren[i], nodes);
+	}
+}
+#pragma endregion
+
+//==============================Obj====================================
+#pragma region obj
+std::shared_ptr<rapidobj::Result> ModelImporter::LoadModelObj(const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("Parse obj", filepath.string());
+	const AssetFile file = VirtualFileSystem::Open(filepath);
+	ASSERT(file.IsOpen(), "Failed to open " + filepath.string());
+
+	// rapidobj would look for the material library on disk, so we find it ourselves and pass it in
+	const std::string_view materialLibraryName = FindMaterialLibrary(file.GetText());
+	const AssetFile materialLibrary = materialLibraryName.empty() ? AssetFile() : VirtualFileSystem::Open(filepath.parent_path() / materialLibraryName);
+	if (!materialLibraryName.empty() && !materialLibrary.IsOpen())
+	{
+		LOG_WARN("Material library {} of {} wasn't found", materialLibraryName, filepath.string());
+	}
+
+	MemoryStreamBuffer buffer(file.GetText());
+	std::istream stream(&buffer);
+	std::shared_ptr<rapidobj::Result> model = std::make_shared<rapidobj::Result>(rapidobj::ParseStream(stream,
+		materialLibrary.IsOpen() ? rapidobj::MaterialLibrary::String(materialLibrary.GetText()) : rapidobj::MaterialLibrary::Ignore()));
+	ASSERT(!model->error, model->error.code.message());
+	ASSERT_VERIFY(Triangulate(*model.get()), model->error.code.message());
+
+	return model;
+}
+
+std::shared_ptr<ModelData> ModelImporter::ImportModelObj(const std::filesystem::path& filepath)
+{
+	std::shared_ptr<rapidobj::Result> obj = LoadModelObj(filepath);
+
+	// Each shape is independent of the others so they are spread across the ThreadPool
+	std::vector<std::vector<MeshData>> shapeMeshes(obj->shapes.size());
+	{
+		PROFILE_IMPORT("GetShapeMeshData", filepath.string());
+		ThreadPool::ParallelFor(static_cast<uint32_t>(obj->shapes.size()), [&](uint32_t i)
+		{
+			shapeMeshes[i] = GetShapeMeshData(*obj, i, filepath);
+		});
+	}
+
+	// Obj files have no hierarchy, so every mesh hangs off of a single root node
+	std::shared_ptr<ModelData> model = std::make_shared<ModelData>();
+	NodeData& root = model->Nodes.emplace_back();
+	root.Name = "Root";
+	DX::XMStoreFloat4x4(&root.RelativeTransform, DX::XMMatrixIdentity());
+
+	for (auto& meshes : shapeMeshes)
+	{
+		for (auto& mesh : meshes)
+		{
+			mesh.MeshIndex = static_cast<int>(model->Meshes.size());
+			root.MeshIndices.push_back(mesh.MeshIndex);
+			model->Meshes.push_back(std::move(mesh));
+		}
+	}
+
+	return model;
+}
+
+// A shape can use several materials, but a mesh only has one. Like Assimp we split the shape
+// up into one mesh per material it uses.
+std::vector<MeshData> ModelImporter::GetShapeMeshData(const rapidobj::Result& objModel, int shapeIndex, const std::filesystem::path& filepath)
+{
+	const rapidobj::Mesh& shapeMesh = objModel.shapes[shapeIndex].mesh;
+	const auto& attributes = objModel.attributes;
+
+	// Split the corners by material first, ordered so that the meshes come out in the same order every time.
+	// Every corner becomes its own vertex, WeldVertices merges the duplicates afterwards.
+	std::map<int, std::vector<rapidobj::Index>> materialCorners;
+	for (size_t face = 0; face < shapeMesh.num_face_vertices.size(); face++)
+	{
+		ASSERT(shapeMesh.num_face_vertices[face] == 3);
+
+		const int materialIndex = shapeMesh.material_ids.empty() ? -1 : shapeMesh.material_ids[face];
+		std::vector<rapidobj::Index>& corners = materialCorners[materialIndex];
+		corners.insert(corners.end(), shapeMesh.indices.begin() + face * 3, shapeMesh.indices.begin() + face * 3 + 3);
+	}
+
+	static_assert(sizeof(rapidobj::Index) == sizeof(int32_t) * 3);
+	constexpr size_t indexStride = sizeof(rapidobj::Index) / sizeof(int32_t);
+	constexpr size_t stride = VertexKernels::Stride<ModelVertexFull>();
+
+	std::vector<MeshData> meshes;
+	meshes.reserve(materialCorners.size());
+	for (auto& [materialIndex, corners] : materialCorners)
+	{
+		MeshData mesh;
+		mesh.Vertices.resize(corners.size());
+		mesh.Indices.resize(corners.size());
+		std::iota(mesh.Indices.begin(), mesh.Indices.end(), 0);
+
+		VertexKernels::GatherFloat3(attributes.positions.data(), attributes.positions.size() / 3, &corners[0].position_index, indexStride,
+			corners.size(), &mesh.Vertices[0].Position.x, stride);
+		VertexKernels::GatherFloat3(attributes.normals.data(), attributes.normals.size() / 3, &corners[0].normal_index, indexStride,
+			corners.size(), &mesh.Vertices[0].Normal.x, stride);
+		VertexKernels::GatherFloat2(attributes.texcoords.data(), attributes.texcoords.size() / 2, &corners[0].texcoord_index, indexStride,
+			corners.size(), &mesh.Vertices[0].Texture.x, stride);
+
+		const bool hasNormals = std::all_of(corners.begin(), corners.end(), [](const rapidobj::Index& index) { return index.normal_index >= 0; });
+
+		mesh.MeshMaterial = GetMeshMaterial(objModel, materialIndex, filepath);
+		ProcessMeshData(mesh, hasNormals);
+		meshes.push_back(std::move(mesh));
+	}
+
+	return meshes;
+}
+
+std::unique_ptr<Material> ModelImporter::GetMeshMaterial(const rapidobj::Result& objModel, int materialIndex, const std::filesystem::path& filepath)
+{
+	std::unique_ptr<Material> material = CreateDefaultMaterial();
+	if (materialIndex < 0 || materialIndex >= static_cast<int>(objModel.materials.size()))
+	{
+		return material;
+	}
+
+	const std::string parentPath = filepath.parent_path().string() + "/";
+	const rapidobj::Material& objMaterial = objModel.materials[materialIndex];
+
+	if (!objMaterial.diffuse_texname.empty())
+	{
+		material->SetMaterialMap(Material::Albedo, parentPath + objMaterial.diffuse_texname, true);
+	}
+
+	if (!objMaterial.specular_texname.empty())
+	{
+		material->SetMaterialMap(Material::Specular, parentPath + objMaterial.specular_texname, true);
+	}
+	else
+	{
+		material->SetShininess(objMaterial.shininess);
+	}
+
+	if (!objMaterial.normal_texname.empty())
+	{
+		material->SetMaterialMap(Material::Normal, parentPath + objMaterial.normal_texname, true);
+	}
+
+	return material;
+}
+#pragma endregion
+
+
+
+//==============================Gltf===================================
+#pragma region gltf
+std::shared_ptr<fastgltf::Asset> ModelImporter::LoadModelGltf(const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("Parse glTF", filepath.string());
+
+	// External buffers are still loaded from the directory on disk, only embedded buffers and glb files
+	// can be read from the asset archive
+	const AssetFile file = VirtualFileSystem::Open(filepath);
+	ASSERT(file.IsOpen(), "Failed to open " + filepath.string());
+
+	auto gltfFile = fastgltf::GltfDataBuffer::FromBytes(reinterpret_cast<const std::byte*>(file.GetData()), file.GetSize());
+	ASSERT(bool(gltfFile), fastgltf::getErrorMessage(gltfFile.error()));
+
+	// Models can be imported from several threads at once and a parser isn't thread safe, so each import gets its own
+	fastgltf::Parser parser(s_GltfSupportedExtensions);
+	auto asset = (parser.loadGltf(gltfFile.get(), filepath.parent_path(), s_GltfOptions));
+	ASSERT(asset.error() == fastgltf::Error::None, fastgltf::getErrorMessage(asset.error()));
+
+	return std::make_shared<fastgltf::Asset>(std::move(asset.get()));
+}
+
+std::shared_ptr<ModelData> ModelImporter::ImportModelGltf(const std::filesystem::path& filepath)
+{
+	std::shared_ptr<fastgltf::Asset> asset = LoadModelGltf(filepath);
+
+	// Like Assimp, every primitive becomes its own mesh. gltfMeshes maps a glTF mesh to the meshes of its primitives.
+	std::vector<std::pair<size_t, size_t>> primitives;
+	std::vector<std::vector<int>> gltfMeshes(asset->meshes.size());
+	for (size_t i = 0; i < asset->meshes.size(); i++)
+	{
+		for (size_t j = 0; j < asset->meshes[i].primitives.size(); j++)
+		{
+			if (asset->meshes[i].primitives[j].type == fastgltf::PrimitiveType::Triangles)
+			{
+				gltfMeshes[i].push_back(static_cast<int>(primitives.size()));
+				primitives.emplace_back(i, j);
+			}
+		}
+	}
+
+	std::shared_ptr<ModelData> model = std::make_shared<ModelData>();
+	model->Meshes.resize(primitives.size());
+	{
+		PROFILE_IMPORT("GetPrimitiveMeshData", filepath.string());
+		ThreadPool::ParallelFor(static_cast<uint32_t>(primitives.size()), [&](uint32_t i)
+		{
+			model->Meshes[i] = GetPrimitiveMeshData(*asset, primitives[i].first, primitives[i].second, filepath);
+			model->Meshes[i].MeshIndex = static_cast<int>(i);
+		});
+	}
+
+	ASSERT(!asset->scenes.empty(), "glTF file has no scenes!");
+	const auto& sceneNodes = asset->scenes[asset->defaultScene.value_or(0)].nodeIndices;
+	if (sceneNodes.size() == 1)
+	{
+		ParseNodeData(*asset, asset->nodes[sceneNodes[0]], gltfMeshes, model->Nodes);
+	}
+	else
+	{
+		// A scene can have several root nodes, but we need exactly one
+		NodeData& root = model->Nodes.emplace_back();
+		root.Name = "Root";
+		root.NumChildren = static_cast<uint32_t>(sceneNodes.size());
+		DX::XMStoreFloat4x4(&root.RelativeTransform, DX::XMMatrixIdentity());
+
+		for (size_t nodeIndex : sceneNodes)
+		{
+			ParseNodeData(*asset, asset->nodes[nodeIndex], gltfMeshes, model->Nodes);
+		}
+	}
+
+	return model;
+}
+
+MeshData ModelImporter::GetPrimitiveMeshData(const fastgltf::Asset& gltfModel, size_t meshIndex, size_t primitiveIndex, const std::filesystem::path& filepath)
+{
+	const fastgltf::Primitive& primitive = gltfModel.meshes[meshIndex].primitives[primitiveIndex];
+	MeshData mesh;
+
+	auto* positionIt = primitive.findAttribute("POSITION");
+	ASSERT(positionIt != primitive.attributes.end()); // A mesh primitive is required to hold the POSITION attribute
+	ASSERT(primitive.indicesAccessor.has_value()); // We specify GenerateMeshIndices, so we should always have indices
+
+	// Attributes are copied out tightly packed (which fastgltf can do with a plain memcpy for most
+	// buffers) and then interleaved into the vertices
+	static_assert(sizeof(fastgltf::math::fvec3) == sizeof(float) * 3 && sizeof(fastgltf::math::fvec2) == sizeof(float) * 2);
+	constexpr size_t stride = VertexKernels::Stride<ModelVertexFull>();
+
+	const auto& positionAccessor = gltfModel.accessors[positionIt->accessorIndex];
+	mesh.Vertices.resize(positionAccessor.count);
+	if (mesh.Vertices.empty())
+	{
+		return mesh;
+	}
+
+	std::vector<fastgltf::math::fvec3> float3s(positionAccessor.count);
+	fastgltf::copyFromAccessor<fastgltf::math::fvec3>(gltfModel, positionAccessor, float3s.data());
+	VertexKernels::InterleaveFloat3(float3s[0].data(), float3s.size(), &mesh.Vertices[0].Position.x, stride);
+
+	bool hasNormals = false;
+	auto* normalIt = primitive.findAttribute("NORMAL");
+	if (normalIt != primitive.attributes.end())
+	{
+		hasNormals = true;
+		fastgltf::copyFromAccessor<fastgltf::math::fvec3>(gltfModel, gltfModel.accessors[normalIt->accessorIndex], float3s.data());
+		VertexKernels::InterleaveFloat3(float3s[0].data(), float3s.size(), &mesh.Vertices[0].Normal.x, stride);
+	}
+
+	auto* texCoordIt = primitive.findAttribute("TEXCOORD_0");
+	if (texCoordIt != primitive.attributes.end())
+	{
+		std::vector<fastgltf::math::fvec2> float2s(positionAccessor.count);
+		fastgltf::copyFromAccessor<fastgltf::math::fvec2>(gltfModel, gltfModel.accessors[texCoordIt->accessorIndex], float2s.data());
+		VertexKernels::InterleaveFloat2(float2s[0].data(), float2s.size(), &mesh.Vertices[0].Texture.x, stride);
+
+		// glTF already has its UV origin in the top left like Direct3D, this cancels out the
+		// flip that the handedness conversion does for the other formats
+		VertexKernels::FlipTexcoordV(mesh.Vertices.data(), mesh.Vertices.size());
+	}
+
+	const auto& indexAccessor = gltfModel.accessors[primitive.indicesAccessor.value()];
+	mesh.Indices.resize(indexAccessor.count);
+	fastgltf::copyFromAccessor<std::uint32_t>(gltfModel, indexAccessor, mesh.Indices.data());
+
+	mesh.MeshMaterial = GetMeshMaterial(gltfModel, primitive.materialIndex, filepath);
+	ProcessMeshData(mesh, hasNormals);
+
+	return mesh;
+}
+
+std::unique_ptr<Material> ModelImporter::GetMeshMaterial(const fastgltf::Asset& gltfModel, std::optional<size_t> materialIndex, const std::filesystem::path& filepath)
+{
+	std::unique_ptr<Material> material = CreateDefaultMaterial();
+	if (!materialIndex.has_value())
+	{
+		return material;
+	}
+
+	// glTF materials are metallic/roughness so there is no specular map to pick up
+	const fastgltf::Material& gltfMaterial = gltfModel.materials[materialIndex.value()];
+	if (gltfMaterial.pbrData.baseColorTexture.has_value())
+	{
+		const std::string texturePath = GetTexturePath(gltfModel, gltfMaterial.pbrData.baseColorTexture->textureIndex, filepath);
+		if (!texturePath.empty())
+		{
+			material->SetMaterialMap(Material::Albedo, texturePath, true);
+		}
+	}
+
+	if (gltfMaterial.normalTexture.has_value())
+	{
+		const std::string texturePath = GetTexturePath(gltfModel, gltfMaterial.normalTexture->textureIndex, filepath);
+		if (!texturePath.empty())
+		{
+			material->SetMaterialMap(Material::Normal, texturePath, true);
+		}
+	}
+
+	return material;
+}
+
+std::string ModelImporter::GetTexturePath(const fastgltf::Asset& gltfModel, size_t textureIndex, const std::filesystem::path& filepath)
+{
+	const fastgltf::Texture& texture = gltfModel.textures[textureIndex];
+	if (!texture.imageIndex.has_value())
+	{
+		return "";
+	}
+
+	// Textures are created from a filepath, so images embedded in the file (e.g. in a .glb) aren't supported
+	const fastgltf::Image& image = gltfModel.images[texture.imageIndex.value()];
+	if (const auto* uri = std::get_if<fastgltf::sources::URI>(&image.data))
+	{
+		return filepath.parent_path().string() + "/" + std::string(uri->uri.path());
+	}
+
+	return "";
+}
+
+void ModelImporter::ParseNodeData(const fastgltf::Asset& gltfModel, const fastgltf::Node& node, const std::vector<std::vector<int>>& gltfMeshes, std::vector<NodeData>& nodes)
+{
+	NodeData& data = nodes.emplace_back();
+	data.Name = node.name.c_str();
+	data.NumChildren = static_cast<uint32_t>(node.children.size());
+	DX::XMStoreFloat4x4(&data.RelativeTransform, GetNodeTransform(node));
+	MeshProcessing::ConvertToLeftHanded(data);
+
+	if (node.meshIndex.has_value())
+	{
+		data.MeshIndices = gltfMeshes[node.meshIndex.value()];
+	}
+
+	// data is a reference into nodes, so it must not be touched after this point
+	for (size_t childIndex : node.children)
+	{
+		ParseNodeData(gltfModel, gltfModel.nodes[childIndex], gltfMeshes, nodes);
+	}
+}
+
+DX::XMMATRIX ModelImporter::GetNodeTransform(const fastgltf::Node& node)
+{
+	if (const auto* matrix = std::get_if<fastgltf::math::fmat4x4>(&node.transform))
+	{
+		// glTF matrices are column major and meant for column vectors. Reading one as row major
+		// transposes it, which is exactly what we need for DirectXMath's row vectors.
+		return DX::XMLoadFloat4x4(reinterpret_cast<const DX::XMFLOAT4X4*>(matrix));
+	}
+
+	const auto& trs = std::get<fastgltf::TRS>(node.transform);
+	return
+		DX::XMMatrixScaling(trs.scale.x(), trs.scale.y(), trs.scale.z()) *
+		DX::XMMatrixRotationQuaternion(DX::XMVectorSet(trs.rotation.x(), trs.rotation.y(), trs.rotation.z(), trs.rotation.w())) *
+		DX::XMMatrixTranslation(trs.translation.x(), trs.translation.y(), trs.translation.z());
+}
+#pragma endregion
+
+
+
+//===============================Fbx===================================
+#pragma region fbx
+std::shared_ptr<UfbxScene> ModelImporter::LoadModelFbx(const std::filesystem::path& filepath)
+{
+	PROFILE_IMPORT("Parse fbx", filepath.string());
+
+	ufbx_load_opts opts = { }; // Optional, pass NULL for defaults
+	ufbx_error error; // Optional, pass NULL if you don't care about errors
+
+	const AssetFile file = VirtualFileSystem::Open(filepath);
+	ASSERT(file.IsOpen(), "Failed to open " + filepath.string());
+
+	// Relative paths in the file (e.g. textures) are resolved against this
+	const std::string filename = filepath.generic_string();
+	opts.filename.data = filename.c_str();
+	opts.filename.length = filename.length();
+
+	std::shared_ptr<UfbxScene> scene = std::make_shared<UfbxScene>(ufbx_load_memory(file.GetData(), file.GetSize(), &opts, &error));
+	ASSERT(scene.get(), error.description.data);
+
+	return scene;
+}
+
+std::shared_ptr<ModelData> ModelImporter::ImportModelFbx(const std::filesystem::path& filepath)
+{
+	std::shared_ptr<UfbxScene> scene = LoadModelFbx(filepath);
+	const ufbx_mesh_list fbxMeshes = scene->Meshes();
+
+	std::vector<std::vector<MeshData>> meshParts(fbxMeshes.count);
+	{
+		PROFILE_IMPORT("GetFbxMeshData", filepath.string());
+		ThreadPool::ParallelFor(static_cast<uint32_t>(fbxMeshes.count), [&](uint32_t i)
+		{
+			meshParts[i] = GetFbxMeshData(*fbxMeshes.data[i], filepath);
+		});
+	}
+
+	// fbxMeshIndices maps an fbx mesh to the meshes it was split into
+	std::shared_ptr<ModelData> model = std::make_shared<ModelData>();
+	std::vector<std::vector<int>> fbxMeshIndices(fbxMeshes.count);
+	for (size_t i = 0; i < meshParts.size(); i++)
+	{
+		for (auto& mesh : meshParts[i])
+		{
+			mesh.MeshIndex = static_cast<int>(model->Meshes.size());
+			fbxMeshIndices[i].push_back(mesh.MeshIndex);
+			model->Meshes.push_back(std::move(mesh));
+		}
+	}
+
+	ParseNodeData(*scene->Root_node(), fbxMeshIndices, model->Nodes);
+
+	return model;
+}
+
+// Faces are triangulated and split up by material, one mesh per material the fbx mesh uses
+std::vector<MeshData> ModelImporter::GetFbxMeshData(const ufbx_mesh& fbxMesh, const std::filesystem::path& filepath)
+{
+	const size_t numParts = std::max<size_t>(1, fbxMesh.materials.count);
+	std::vector<MeshData> parts(numParts);
+
+	// Collect the corners of every part first, each corner becomes its own vertex until WeldVertices merges them
+	std::vector<std::vector<uint32_t>> partCorners(numParts);
+	std::vector<uint32_t> triIndices(fbxMesh.max_face_triangles * 3);
+	for (size_t i = 0; i < fbxMesh.faces.count; i++)
+	{
+		const uint32_t part = fbxMesh.face_material.count > 0 ? std::min<uint32_t>(fbxMesh.face_material.data[i], static_cast<uint32_t>(numParts - 1)) : 0;
+
+		const uint32_t numTris = ufbx_triangulate_face(triIndices.data(), triIndices.size(), &fbxMesh, fbxMesh.faces.data[i]);
+		partCorners[part].insert(partCorners[part].end(), triIndices.begin(), triIndices.begin() + numTris * 3);
+	}
+
+	// ufbx stores every attribute as values plus a per corner index into them
+	constexpr size_t stride = VertexKernels::Stride<ModelVertexFull>();
+	std::vector<int32_t> attributeIndices;
+	const auto gatherFloat3 = [&](const ufbx_vertex_vec3& attribute, const std::vector<uint32_t>& corners, float* dst)
+	{
+		VertexKernels::GatherIndices(attribute.indices.data, corners.data(), corners.size(), attributeIndices.data());
+		VertexKernels::GatherFloat3(&attribute.values.data[0].x, attribute.values.count, attributeIndices.data(), 1, corners.size(), dst, stride);
+	};
+
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		const std::vector<uint32_t>& corners = partCorners[i];
+		MeshData& mesh = parts[i];
+		if (corners.empty())
+		{
+			continue;
+		}
+
+		mesh.Vertices.resize(corners.size());
+		mesh.Indices.resize(corners.size());
+		std::iota(mesh.Indices.begin(), mesh.Indices.end(), 0);
+		attributeIndices.resize(corners.size());
+
+		gatherFloat3(fbxMesh.vertex_position, corners, &mesh.Vertices[0].Position.x);
+		if (fbxMesh.vertex_normal.exists)
+		{
+			gatherFloat3(fbxMesh.vertex_normal, corners, &mesh.Vertices[0].Normal.x);
+		}
+		if (fbxMesh.vertex_uv.exists)
+		{
+			VertexKernels::GatherIndices(fbxMesh.vertex_uv.indices.data, corners.data(), corners.size(), attributeIndices.data());
+			VertexKernels::GatherFloat2(&fbxMesh.vertex_uv.values.data[0].x, fbxMesh.vertex_uv.values.count, attributeIndices.data(), 1,
+				corners.size(), &mesh.Vertices[0].Texture.x, stride);
+		}
+	}
+
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		parts[i].MeshMaterial = GetMeshMaterial(i < fbxMesh.materials.count ? fbxMesh.materials.data[i] : nullptr, filepath);
+		ProcessMeshData(parts[i], fbxMesh.vertex_normal.exists);
+	}
+
+	// Materials that no face uses would leave us with empty meshes
+	std::erase_if(parts, [](const MeshData& mesh) { return mesh.Indices.empty(); });
+
+	return parts;
+}
+
+std::unique_ptr<Material> ModelImporter::GetMeshMaterial(const ufbx_material* fbxMaterial, const std::filesystem::path& filepath)
+{
+	std::unique_ptr<Material> material = CreateDefaultMaterial();
+	if (!fbxMaterial)
+	{
+		return material;
+	}
+
+	const std::string albedoPath = GetTexturePath(fbxMaterial->fbx.diffuse_color.texture, filepath);
+	if (!albedoPath.empty())
+	{
+		material->SetMaterialMap(Material::Albedo, albedoPath, true);
+	}
+
+	const std::string specularPath = GetTexturePath(fbxMaterial->fbx.specular_color.texture, filepath);
+	if (!specularPath.empty())
+	{
+		material->SetMaterialMap(Material::Specular, specularPath, true);
+	}
+	else if (fbxMaterial->fbx.specular_exponent.has_value)
+	{
+		material->SetShininess(static_cast<float>(fbxMaterial->fbx.specular_exponent.value_real));
+	}
+
+	const std::string normalPath = GetTexturePath(fbxMaterial->fbx.normal_map.texture, filepath);
+	if (!normalPath.empty())
+	{
+		material->SetMaterialMap(Material::Normal, normalPath, true);
+	}
+
+	return material;
+}
+
+std::string ModelImporter::GetTexturePath(const ufbx_texture* texture, const std::filesystem::path& filepath)
+{
+	if (!texture)
+	{
+		return "";
+	}
+
+	// The absolute filename usually points to wherever the artist exported from, so prefer the relative one
+	if (texture->relative_filename.length > 0)
+	{
+		return filepath.parent_path().string() + "/" + std::string(texture->relative_filename.data, texture->relative_filename.length);
+	}
+
+	return std::string(texture->filename.data, texture->filename.length);
+}
+
+void ModelImporter::ParseNodeData(const ufbx_node& node, const std::vector<std::vector<int>>& fbxMeshIndices, std::vector<NodeData>& nodes)
+{
+	NodeData& data = nodes.emplace_back();
+	data.Name = std::string(node.name.data, node.name.length);
+	data.NumChildren = static_cast<uint32_t>(node.children.count);
+	DX::XMStoreFloat4x4(&data.RelativeTransform, GetNodeTransform(node));
+	MeshProcessing::ConvertToLeftHanded(data);
+
+	if (node.mesh != nullptr)
+	{
+		data.MeshIndices = fbxMeshIndices[node.mesh->typed_id];
+	}
+
+	// data is a reference into nodes, so it must not be touched after this point
+	for (size_t i = 0; i < node.children.count; i++)
+	{
+		ParseNodeData(*node.children.data[i], fbxMeshIndices, nodes);
+	}
+}
+
+DX::XMMATRIX ModelImporter::GetNodeTransform(const ufbx_node& node)
+{
+	// ufbx matrices are affine 4x3 matrices for column vectors, so each column becomes a row
+	const ufbx_matrix& m = node.node_to_parent;
+	return DX::XMMATRIX(
+		m.cols[0].x, m.cols[0].y, m.cols[0].z, 0.f,
+		m.cols[1].x, m.cols[1].y, m.cols[1].z, 0.f,
+		m.cols[2].x, m.cols[2].y, m.cols[2].z, 0.f,
+		m.cols[3].x, m.cols[3].y, m.cols[3].z, 1.f
+	);
+}
+#pragma endregion
+
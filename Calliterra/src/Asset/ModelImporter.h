@@ -0,0 +1,116 @@
+#pragma once
+
+#include <rapidobj/rapidobj.hpp>
+#include <fastgltf/core.hpp>
+#include <ufbx.h>
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+
+#include "Material.h"
+#include "ModelData.h"
+#include "ModelAPI.h"
+#include "MeshSimplifier.h"
+
+// When enabled obj, gltf/glb and fbx files are imported with rapidobj, fastgltf and ufbx instead of Assimp.
+// Their output goes through MeshProcessing so it matches what Assimp would have given us.
+#define FAST_MODEL_LOADING 1
+
+// Turns model files into ModelData, either by reading them back from the ModelCache or by importing and
+// optimizing them. Nothing in here touches the renderer, so it can be used without a graphics device
+// (see the Importer project), the ModelLoader then takes care of creating the GPU resources.
+class ModelImporter
+{
+public:
+	using Obj = rapidobj::Result;
+	using Gltf = fastgltf::Asset;
+	using Fbx = UfbxScene;
+
+	// Tries the on disk model cache first, and only falls back to a full import
+	// (which then gets written back to the cache) when there is no valid entry.
+	static std::shared_ptr<ModelData> LoadModelCooked(const std::filesystem::path& filepath);
+
+	// Imports the model bypassing the model cache
+	static std::shared_ptr<ModelData> ImportModel(const std::filesystem::path& filepath);
+	static void OptimizeModel(ModelData& model, const std::filesystem::path& filepath);
+
+	// How OptimizeModel builds the LOD chains. Models cached with other options are imported again. Only set
+	// this while nothing is being imported.
+	static void SetLodOptions(const LodOptions& options) { s_LodOptions = options; }
+	static const LodOptions& GetLodOptions() { return s_LodOptions; }
+
+	static std::vector<MeshData> GetModelMeshData(const aiScene& model, const std::filesystem::path& filepath);
+	static std::vector<NodeData> GetModelNodeData(const aiScene& model);
+
+	static std::vector<ModelVertexFull> GetMeshVertexVectorFull(const aiScene& objModel, int meshIndex);
+	static std::vector<ModelVertexSemi> GetMeshVertexVectorSemi(const aiScene& objModel, int meshIndex);
+	static std::vector<uint32_t> GetMeshIndexVector(const aiScene& objModel, int meshIndex);
+
+	static void BenchmarkImport(const std::filesystem::path& filepath, int iterations = 5);
+	// Times importing the models one after the other against importing them all at once on the ThreadPool,
+	// and both against loading them from the model cache
+	static void BenchmarkLoading(const std::vector<std::filesystem::path>& filepaths, int iterations = 3);
+
+private:
+	static std::shared_ptr<ModelData> ImportModelAssimp(const std::filesystem::path& filepath);
+	static std::shared_ptr<ModelData> ImportModelObj(const std::filesystem::path& filepath);
+	static std::shared_ptr<ModelData> ImportModelGltf(const std::filesystem::path& filepath);
+	static std::shared_ptr<ModelData> ImportModelFbx(const std::filesystem::path& filepath);
+
+	static std::shared_ptr<rapidobj::Result> LoadModelObj(const std::filesystem::path& filepath);
+	static std::shared_ptr<fastgltf::Asset> LoadModelGltf(const std::filesystem::path& filepath);
+	static std::shared_ptr<UfbxScene> LoadModelFbx(const std::filesystem::path& filepath);
+
+	static uint32_t GetImportFlags(const std::filesystem::path& filepath);
+	static std::string GetExtension(const std::filesystem::path& filepath);
+	static void ShareMaterials(ModelData& model);
+	static void RecordGeometry(const ModelData& model);
+
+	static std::unique_ptr<Material> CreateDefaultMaterial();
+	static void ProcessMeshData(MeshData& mesh, bool hasNormals);
+
+	static std::vector<MeshData> GetShapeMeshData(const rapidobj::Result& objModel, int shapeIndex, const std::filesystem::path& filepath);
+	static MeshData GetPrimitiveMeshData(const fastgltf::Asset& gltfModel, size_t meshIndex, size_t primitiveIndex, const std::filesystem::path& filepath);
+	static std::vector<MeshData> GetFbxMeshData(const ufbx_mesh& fbxMesh, const std::filesystem::path& filepath);
+
+	static std::unique_ptr<Material> GetMeshMaterial(const aiScene& model, int materialIndex, const std::filesystem::path& filepath);
+	static std::unique_ptr<Material> GetMeshMaterial(const rapidobj::Result& objModel, int materialIndex, const std::filesystem::path& filepath);
+	static std::unique_ptr<Material> GetMeshMaterial(const fastgltf::Asset& gltfModel, std::optional<size_t> materialIndex, const std::filesystem::path& filepath);
+	static std::unique_ptr<Material> GetMeshMaterial(const ufbx_material* fbxMaterial, const std::filesystem::path& filepath);
+
+	static std::string GetTexturePath(const fastgltf::Asset& gltfModel, size_t textureIndex, const std::filesystem::path& filepath);
+	static std::string GetTexturePath(const ufbx_texture* texture, const std::filesystem::path& filepath);
+
+	static void ParseNodeData(const aiNode& node, std::vector<NodeData>& nodes);
+	static void ParseNodeData(const fastgltf::Asset& gltfModel, const fastgltf::Node& node, const std::vector<std::vector<int>>& gltfMeshes, std::vector<NodeData>& nodes);
+	static void ParseNodeData(const ufbx_node& node, const std::vector<std::vector<int>>& fbxMeshIndices, std::vector<NodeData>& nodes);
+
+	static DX::XMMATRIX GetNodeTransform(const fastgltf::Node& node);
+	static DX::XMMATRIX GetNodeTransform(const ufbx_node& node);
+
+private:
+	inline static constexpr auto s_GltfSupportedExtensions =
+		fastgltf::Extensions::KHR_mesh_quantization |
+		fastgltf::Extensions::KHR_texture_transform |
+		fastgltf::Extensions::KHR_materials_variants;
+
+	inline static constexpr auto s_GltfOptions =
+		fastgltf::Options::DontRequireValidAssetMember |
+		fastgltf::Options::AllowDouble |
+		fastgltf::Options::LoadExternalBuffers |
+		fastgltf::Options::GenerateMeshIndices;
+
+	inline static constexpr uint32_t s_AssimpFlags =
+		aiProcess_Triangulate | // Make sure everything is triangles
+		aiProcess_JoinIdenticalVertices | // Each mesh will contain unique vertices
+		aiProcess_ConvertToLeftHanded | // Convert to Direct3D friendly data
+		aiProcess_GenSmoothNormals | // Generate normals if we don't already have them
+		aiProcess_GenUVCoords | // Generate UVs if we don't already have them
+		aiProcess_CalcTangentSpace; // Calculate Tangents and Bitangents
+
+	// Used as the cache key for models imported by our own importers. Assimp flags are never 0
+	// (we always triangulate) so entries from the two import paths can't be mixed up.
+	inline static constexpr uint32_t s_NativeImportFlags = 0;
+
+	inline static LodOptions s_LodOptions;
+};
@@ -1,61 +1,56 @@
 #include "pch.h"
 #include "ModelLoader.h"
-
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include "fastgltf/tools.hpp"
-#include "fastgltf/math.hpp"
+#include "ModelImporter.h"
 
 #include "Material.h"
+#include "MaterialInstance.h"
 #include "ModelAPI.h"
 #include "Model.h"
-
+#include "TextureDecoder.h"
+#include "Core/ImportProfiler.h"
+#include "Core/ThreadPool.h"
+#include "Core/Timer.h"
 
 void ModelLoader::Init()
 {
-	s_AssimpImporter = std::make_unique<Assimp::Importer>();
 }
 
 void ModelLoader::Shutdown()
 {
-	s_AssimpImporter.release();
+	// Background imports may still be running on the ThreadPool, let them finish before tearing down
+	for (auto& load : s_PendingLoads)
+	{
+		if (load->Future.valid())
+		{
+			load->Future.wait();
+		}
+	}
+	s_PendingLoads.clear();
+
+	s_Models.clear();
+	s_Prototypes.clear();
+	s_ReleasedModels.clear();
 }
 // Loads the modelAPI from a filepath and stores it into an unordered_map,
 // if it already exists inside the map then just return it.
 ModelAPI ModelLoader::LoadModel(const std::filesystem::path& filepath)
 {
-	std::string extension = filepath.extension().string();
-
-	std::transform(extension.begin(), extension.end(), extension.begin(),
-    [](unsigned char c){ return std::tolower(c); });
-
 	std::string key = filepath.string();
+	PROFILE_IMPORT("ModelLoader::LoadModel", key);
+
+	// Models can be loaded from the ThreadPool (see LoadModelAsync) so access to the map is guarded.
+	// The lock isn't held during the load itself, so two threads loading the same new model will
+	// both import it, which is wasteful but harmless.
+	std::unique_lock lock(s_ModelsMutex);
 	const auto i = s_Models.find(key);
 
 	if (i == s_Models.end())
 	{
-		ModelAPI model;
-#if FAST_MODEL_LOADING
-		if (extension == ".obj")
-		{
-			model = ModelAPI(LoadModelObj(filepath));
-		}
-		else if (extension == ".gltf" || extension == ".glb")
-		{
-			model = ModelAPI(LoadModelGltf(filepath));
-		}
-		else if (extension == ".fbx")
-		{
-			model = ModelAPI(LoadModelFbx(filepath));
-		}
-		else
-		{
-			ASSERT(false, "Unsupported model type!");
-		}
-#else
-		model = ModelAPI(LoadModelAssimp(filepath));
-#endif
+		lock.unlock();
+
+		ModelAPI model = ModelAPI(ModelImporter::LoadModelCooked(filepath));
 
+		lock.lock();
 		s_Models[key] = model;
 		return model;
 	}
@@ -67,587 +62,288 @@ ModelAPI ModelLoader::LoadModel(const std::filesystem::path& filepath)
 }
 
 // Returns a model that is ready to be used given the parameters. Internally calls LoadModel() so
-// this function is all you need if you want a model.
-Model ModelLoader::GetModel(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color)
+// this function is all you need if you want a model. Once a file has been uploaded its prototype is
+// reused, so further models of it only have to create their own transforms.
+Model ModelLoader::GetModel(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, ModelResidency residency)
 {
-	ModelAPI modelAPI = LoadModel(filepath);
-
-	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
-	std::unique_ptr<Node> root;
-
-#if FAST_MODEL_LOADING
-	switch (modelAPI.GetAPI())
-	{
-	case ModelAPI::Obj:
-	{
-		meshes = GetModelMeshes(*modelAPI.GetObj(), transform, color, filepath.string());
-		root = std::move(ParseNode(*modelAPI.GetObj(), meshes));
-		break;
-	}
-	case ModelAPI::Gltf:
-	{
-		meshes = GetModelMeshes(*modelAPI.GetGltf(), transform, color, filepath.string());
-		fastgltf::Node gltfRoot = ModelLoader::GetRootNode(*modelAPI.GetGltf());
-		root = std::move(ParseNode(*modelAPI.GetGltf(), gltfRoot, meshes));
-		break;
-	}
-	case ModelAPI::Fbx:
+	std::shared_ptr<ModelPrototype> prototype = FindPrototype(filepath);
+	if (prototype && !prototype->IsComplete())
 	{
-		meshes = GetModelMeshes(*modelAPI.GetFbx(), transform, color, filepath.string());
-		root = std::move(ParseNode(*modelAPI.GetFbx(), *modelAPI.GetFbx()->Root_node(), meshes));
-		break;
+		prototype = nullptr;
 	}
-	}
-#else
-	meshes = GetModelMeshes(*modelAPI.GetAssimp(), transform, color, filepath.string());
-	aiNode* aiRoot = modelAPI.GetAssimp()->mRootNode;
-	int nextId = 0;
-	root = std::move(ParseNode(*modelAPI.GetAssimp(), nextId, *aiRoot, meshes));
-#endif
-
-	return Model(std::move(root), std::move(meshes), transform, color);
-
-}
-//==============================Assimp==================================
-#pragma region assimp 
 
-std::shared_ptr<aiScene> ModelLoader::LoadModelAssimp(const std::filesystem::path& filepath)
-{
-	// Each importer should be responsible for one model, so before loading a model we'll 
-	// free the old one and instantiate a new one. We need to do this because we need the 
-	// lifetime of the importer to be longer than the scope of this function. 
-	// Not doing this results in an exception thrown upon application exit.
-	if (!s_AssimpImporter)
+	if (prototype && residency == ModelResidency::GpuOnly)
 	{
-		s_AssimpImporter = std::make_unique<Assimp::Importer>();
+		return Model(prototype, transform, color);
 	}
-	else
-	{
-		s_AssimpImporter.release();
-		s_AssimpImporter = std::make_unique<Assimp::Importer>();
-	}
-	ASSERT(s_AssimpImporter, "ModelLoader must be initialized before trying to load model!");
-
-	const auto flags = 
-		aiProcess_Triangulate | // Make sure everything is triangles
-		aiProcess_JoinIdenticalVertices | // Each mesh will contain unique vertices
-		aiProcess_ConvertToLeftHanded | // Convert to Direct3D friendly data
-		aiProcess_GenSmoothNormals | // Generate normals if we don't already have them
-		aiProcess_GenUVCoords | // Generate UVs if we don't already have them
-		aiProcess_CalcTangentSpace; // Calculate Tangents and Bitangents
-	
-	//Assimp::Importer importer;
-	const aiScene* scene = s_AssimpImporter->ReadFile(filepath.string(), flags);
-	ASSERT(scene, s_AssimpImporter->GetErrorString());
-
-	return std::make_shared<aiScene>(*scene);
-}
 
-std::unordered_map<int, std::unique_ptr<Mesh>> ModelLoader::GetModelMeshes(const aiScene& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::filesystem::path& filepath)
-{
-	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
-	std::string parentPath = filepath.parent_path().string() + "/";
-	std::string missingTex = "assets/textures/missing_textures/missing_texture.png";
-	std::string missingMap = "assets/textures/missing_textures/missing_map.png";
+	std::shared_ptr<ModelData> model = LoadModel(filepath).GetCooked();
 
-	for (unsigned int i = 0; i < model.mNumMeshes; i++)
+	const bool uploaded = prototype == nullptr;
+	if (uploaded)
 	{
-		aiString aiTexturePath;
-		int materialIndex = model.mMeshes[i]->mMaterialIndex;
-		std::unique_ptr<Material> material = std::make_unique<Material>();
-		aiMaterial& aiMaterial = *model.mMaterials[materialIndex];
-
-		// Get the albedo/diffuse map
-		bool hasAlbedoMap = aiMaterial.GetTexture(AI_MATKEY_BASE_COLOR_TEXTURE, &aiTexturePath) == AI_SUCCESS;
-		material->SetMaterialMap(Material::Albedo, missingTex, false);
-		if (!hasAlbedoMap)
-		{
-			hasAlbedoMap = aiMaterial.GetTexture(aiTextureType_DIFFUSE, 0, &aiTexturePath) == AI_SUCCESS;
-			if (hasAlbedoMap)
-			{
-				material->SetMaterialMap(Material::Albedo, parentPath + aiTexturePath.C_Str(), true);
-			}
-		}
-		else
-		{
-			material->SetMaterialMap(Material::Albedo, parentPath + aiTexturePath.C_Str(), true);
-		}
-	
-		// Get the specular map, otherwise default the shininess
-		material->SetMaterialMap(Material::Specular, missingMap, false);
-		bool hasSpecularMap = aiMaterial.GetTexture(aiTextureType_SPECULAR, 0, &aiTexturePath) == AI_SUCCESS;
-		if (hasSpecularMap)
+		PrefetchTextures(*model);
+		prototype = std::make_shared<ModelPrototype>(filepath, *model);
+		for (const auto& mesh : model->Meshes)
 		{
-			material->SetMaterialMap(Material::Specular, parentPath + aiTexturePath.C_Str(), true);
-		}
-		else
-		{
-			float shininess = 1.f;
-			if (aiMaterial.Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS)
-			{
-				material->SetShininess(shininess);
-			}
+			prototype->AddMesh(mesh);
 		}
-
-		// Normal map
-		material->SetMaterialMap(Material::Normal, missingMap, false);
-		bool hasNormalMap = aiMaterial.GetTexture(aiTextureType_NORMALS, 0, &aiTexturePath) == AI_SUCCESS;
-		if (hasNormalMap)
-		{
-			material->SetMaterialMap(Material::Normal, parentPath + aiTexturePath.C_Str(), true);
-		}
-
-		meshes[i] = std::make_unique<Mesh>(i, model, transform, color, std::move(material), filepath.string());
+		s_Prototypes[filepath.string()] = prototype;
 	}
 
-	return meshes;
-}
+	ReleaseModelData(filepath, model, residency, uploaded);
+	std::shared_ptr<ModelData> cpuData = residency == ModelResidency::KeepCpuData ? std::move(model) : nullptr;
 
-std::vector<ModelVertexFull> ModelLoader::GetMeshVertexVectorFull(const aiScene& objModel, int meshIndex)
-{
-	const auto mesh = objModel.mMeshes[meshIndex];
-	std::vector<ModelVertexFull> vertices;
-
-	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
-	{
-		vertices.emplace_back(
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mVertices[i]),
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mNormals[i]),
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mTangents[i]),
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mBitangents[i]),
-			*reinterpret_cast<DX::XMFLOAT2*>(&mesh->mTextureCoords[0][i])
-		);
-	}
-
-	return vertices;
-}
-
-std::vector<ModelVertexSemi> ModelLoader::GetMeshVertexVectorSemi(const aiScene& objModel, int meshIndex)
-{
-	const auto mesh = objModel.mMeshes[meshIndex];
-	std::vector<ModelVertexSemi> vertices;
-
-	for (unsigned int i = 0; i < mesh->mNumVertices; i++)
-	{
-		vertices.emplace_back(
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mVertices[i]),
-			*reinterpret_cast<DX::XMFLOAT3*>(&mesh->mNormals[i]),
-			*reinterpret_cast<DX::XMFLOAT2*>(&mesh->mTextureCoords[0][i])
-		);
-	}
-
-	return vertices;
-}
-
-std::vector<uint32_t> ModelLoader::GetMeshIndexVector(const aiScene& objModel, int meshIndex)
-{
-	const auto mesh = objModel.mMeshes[meshIndex];
-	std::vector<uint32_t> indices;
-
-	indices.reserve(mesh->mNumFaces * 3);
-	for (unsigned int i = 0; i < mesh->mNumFaces; i++)
-	{
-		const auto& face = mesh->mFaces[i];
-		ASSERT(face.mNumIndices == 3);
-
-		indices.push_back(face.mIndices[0]);
-		indices.push_back(face.mIndices[1]);
-		indices.push_back(face.mIndices[2]);
-	}
-
-	return indices;
+	return Model(prototype, transform, color, std::move(cpuData));
 }
 
-std::unique_ptr<Node> ModelLoader::ParseNode(const aiScene& model, int nextId, const aiNode& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes)
+// Returns a model straight away that draws nothing until it has finished loading. Parsing happens on
+// the ThreadPool, and the GPU resources are created over the next frames by ProcessPendingLoads().
+// Models of a file that has already been uploaded are ready immediately.
+std::unique_ptr<Model> ModelLoader::LoadModelAsync(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, ModelResidency residency)
 {
-	std::vector<Mesh*> currentMeshes;
-	const auto transform = DX::XMMatrixTranspose(DX::XMLoadFloat4x4(
-		reinterpret_cast<const DX::XMFLOAT4X4*>(&node.mTransformation)
-	));
-
-	for (unsigned int i = 0; i < node.mNumMeshes; i++)
+	if (std::shared_ptr<ModelPrototype> prototype = FindPrototype(filepath); prototype && prototype->IsComplete() && residency == ModelResidency::GpuOnly)
 	{
-		currentMeshes.push_back(modelMeshes.at(node.mMeshes[i]).get());
+		return std::make_unique<Model>(prototype, transform, color);
 	}
 
-	std::unique_ptr<Node> nextNode = std::make_unique<Node>(nextId++, node.mName.C_Str(), transform, std::move(currentMeshes));
-	for (unsigned int i = 0; i < node.mNumChildren; i++)
+	std::shared_ptr<AsyncModelLoad> load = std::make_shared<AsyncModelLoad>();
+	load->Filepath = filepath;
+	load->Residency = residency;
+	load->Future = ThreadPool::Submit([filepath]()
 	{
-		nextNode->AddChild(ParseNode(model, nextId, *node.mChildren[i], modelMeshes));
-	}
-
-	return std::move(nextNode);
-
-}
+		std::shared_ptr<ModelData> model = LoadModel(filepath).GetCooked();
+		PrefetchTextures(*model);
+		return model;
+	});
 
-//==============================Obj====================================
-#pragma region obj
-std::shared_ptr<rapidobj::Result> ModelLoader::LoadModelObj(const std::filesystem::path& filepath)
-{
-	std::shared_ptr<rapidobj::Result> model = std::make_shared<rapidobj::Result>(rapidobj::ParseFile(filepath));
-	ASSERT(!model->error, model->error.code.message());
-	ASSERT_VERIFY(Triangulate(*model.get()), model->error.code.message());
+	s_PendingLoads.push_back(load);
 
-	return model;
+	return std::make_unique<Model>(std::move(load), transform, color);
 }
 
-std::unordered_map<int, std::unique_ptr<Mesh>> ModelLoader::GetModelMeshes(const rapidobj::Result& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::filesystem::path& filepath)
+// Uploads the prototypes of models whose CPU side data is ready. Meshes are created one at a time until
+// the budget runs out, at least one mesh is always created so loading can't stall completely.
+void ModelLoader::ProcessPendingLoads(double budgetMs)
 {
-	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
+	Timer timer;
+	bool createdMesh = false;
 
-	for (int i = 0; i < model.shapes.size(); i++)
+	for (auto it = s_PendingLoads.begin(); it != s_PendingLoads.end();)
 	{
-		int materialIndex = model.shapes[i].mesh.material_ids[0];
-		std::unique_ptr<Material> material = std::make_unique<Material>();
+		AsyncModelLoad& load = **it;
+		const std::string key = load.Filepath.string();
 
-		if (model.materials[materialIndex].diffuse_texname != "")
+		// The model was destroyed before it finished loading. Nothing else can finish the prototype it was
+		// uploading, so the next load of the file starts over.
+		if (it->use_count() == 1)
 		{
-			material->SetMaterialMap(Material::Albedo, filepath.parent_path().string() + "/" + model.materials[materialIndex].diffuse_texname, true);
-		}
-		if (model.materials[materialIndex].specular_texname != "")
-		{
-			material->SetMaterialMap(Material::Specular, filepath.parent_path().string() + "/" + model.materials[materialIndex].specular_texname, true);
+			if (load.BuildsPrototype && !load.Prototype->IsComplete() && FindPrototype(load.Filepath) == load.Prototype)
+			{
+				s_Prototypes.erase(key);
+			}
+			it = s_PendingLoads.erase(it);
+			continue;
 		}
-		else
+
+		if (!load.Data)
 		{
-			material->SetShininess(model.materials[materialIndex].shininess);
+			if (load.Future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				it++;
+				continue;
+			}
+			load.Data = load.Future.get();
 		}
 
-		meshes[i] = std::make_unique<Mesh>(i, model, transform, color, std::move(material), filepath.string());
-	}
-
-	return meshes;
-}
-
-std::vector<ModelVertexSemi> ModelLoader::GetMeshVertexVector(const rapidobj::Result& objModel, int meshIndex)
-{
-	const rapidobj::Mesh& mesh = objModel.shapes[meshIndex].mesh;
-	std::vector<ModelVertexSemi> vertices;
-
-	for (int i = 0; i < objModel.shapes[meshIndex].mesh.num_face_vertices.size(); i++)
-	{
-		ASSERT(objModel.shapes[meshIndex].mesh.num_face_vertices[i] == 3);
-
-		for (int j = 0; j < 3; j++)
+		if (!load.Prototype)
 		{
-			int posIndex = mesh.indices[i * 3 + j].position_index;
-			int normIndex = mesh.indices[i * 3 + j].normal_index;
-			int texIndex = mesh.indices[i * 3 + j].texcoord_index;
-
-			DX::XMFLOAT3 pos;
-			DX::XMFLOAT3 norm;
-			DX::XMFLOAT2 tex;
-
-			pos.x = objModel.attributes.positions[posIndex * 3];
-			pos.y = objModel.attributes.positions[posIndex * 3 + 1];
-			pos.z = objModel.attributes.positions[posIndex * 3 + 2];
-
-			norm.x = objModel.attributes.normals[normIndex * 3];
-			norm.y = objModel.attributes.normals[normIndex * 3 + 1];
-			norm.z = objModel.attributes.normals[normIndex * 3 + 2];
-
-			tex.x = objModel.attributes.texcoords[texIndex * 2];
-			tex.y = objModel.attributes.texcoords[texIndex * 2 + 1];
+			std::shared_ptr<ModelPrototype> prototype = FindPrototype(load.Filepath);
+			if (prototype && !prototype->IsComplete())
+			{
+				// Another load is uploading the same file, rather than uploading it twice wait for it
+				it++;
+				continue;
+			}
 
-			if (s_FlipUVs)
+			if (!prototype)
 			{
-				DX::XMStoreFloat2(&tex, DX::XMVector2Transform(DX::XMLoadFloat2(&tex), DX::XMMatrixRotationX(DX::XMConvertToRadians(180)) * DX::XMMatrixTranslation(0.f, 1.f, 0.f)));
+				prototype = std::make_shared<ModelPrototype>(load.Filepath, *load.Data);
+				s_Prototypes[key] = prototype;
+				load.BuildsPrototype = true;
 			}
-			vertices.push_back({ pos, norm, tex });
+			load.Prototype = std::move(prototype);
 		}
 
-	}
-
-	ASSERT(vertices.size() == mesh.num_face_vertices.size() * 3);
-
-	return vertices;
-}
-
-std::vector<uint32_t> ModelLoader::GetMeshIndexVector(const rapidobj::Result& objModel, int meshIndex)
-{
-	std::vector<uint32_t> indices(objModel.shapes[meshIndex].mesh.num_face_vertices.size() * 3);
-
-	std::generate(indices.begin(), indices.end(), [index = 0]() mutable { return index++; });
-
-	return indices;
-}
-
-std::unique_ptr<Node> ModelLoader::ParseNode(const rapidobj::Result& model, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes)
-{
-	std::vector<Mesh*> currentMeshes;
-	for (auto& mesh : modelMeshes)
-	{
-		currentMeshes.push_back(mesh.second.get());
-	}
-	
-	std::unique_ptr<Node> root = std::make_unique<Node>(0, "Root", DX::XMMatrixIdentity(), std::move(currentMeshes));
-
-	return std::move(root);
-}
-#pragma endregion
-
-
-
-//==============================Gltf===================================
-#pragma region gltf
-std::shared_ptr<fastgltf::Asset> ModelLoader::LoadModelGltf(const std::filesystem::path& filepath)
-{
-	auto gltfFile = fastgltf::MappedGltfFile::FromPath(filepath);
-	ASSERT(bool(gltfFile), fastgltf::getErrorMessage(gltfFile.error()));
-
-	auto asset = (s_GltfParser.loadGltf(gltfFile.get(), filepath.parent_path(), s_GltfOptions));
-	ASSERT(asset.error() == fastgltf::Error::None, fastgltf::getErrorMessage(asset.error()));
-
-	return std::make_shared<fastgltf::Asset>(std::move(asset.get()));
-}
-
-std::unordered_map<int, std::unique_ptr<Mesh>> ModelLoader::GetModelMeshes(const fastgltf::Asset& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::string& filepath)
-{
-	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
-
-	for (int i = 0; i < model.meshes.size(); i++)
-	{
-		std::unique_ptr<Material> material = std::make_unique<Material>();
-		meshes[i] = std::make_unique<Mesh>(i, model, transform, color, std::move(material), filepath);
-	}
-
-	return meshes;
-}
-
-std::vector<ModelVertexSemi> ModelLoader::GetMeshVertexVector(const fastgltf::Asset& objModel, int meshIndex)
-{
-	std::vector<ModelVertexSemi> vertices;
+		while (!load.Prototype->IsComplete())
+		{
+			if (createdMesh && timer.GetElapsedInMilliseconds() >= budgetMs)
+			{
+				return;
+			}
 
-	for (auto it = objModel.meshes[meshIndex].primitives.begin(); it < objModel.meshes[meshIndex].primitives.end(); it++)
-	{
-		DX::XMFLOAT3 position;
-		DX::XMFLOAT3 normal;
+			// Creating the mesh would block on its textures, come back to it next frame
+			const MeshData& data = load.Data->Meshes[load.Prototype->GetNumMeshes()];
+			if (!AreTexturesReady(data))
+			{
+				break;
+			}
 
-		auto* positionIt = it->findAttribute("POSITION");
-		ASSERT(positionIt != it->attributes.end()); // A mesh primitive is required to hold the POSITION attribute
-		ASSERT(it->indicesAccessor.has_value()); // We specify GenerateMeshIndices, so we should always have indices
+			load.Prototype->AddMesh(data);
+			createdMesh = true;
+		}
 
-		auto& positionAccessor = objModel.accessors[positionIt->accessorIndex];
-		if (!positionAccessor.bufferViewIndex.has_value())
+		if (!load.Prototype->IsComplete())
 		{
+			it++;
 			continue;
 		}
 
-		fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(objModel, positionAccessor, [&](fastgltf::math::fvec3 pos, std::size_t idx) {
-			position.x = pos.x();
-			position.y = pos.y();
-			position.z = pos.z();
-			
-			vertices.push_back({ position, {} });
-		});
+		load.Finished = true;
+		LOG_INFO("Finished loading {}", key);
 
-		auto* normalIt = it->findAttribute("NORMAL");
-		ASSERT(normalIt != it->attributes.end()); // A mesh primitive is required to hold the POSITION attribute
-		ASSERT(it->indicesAccessor.has_value()); // We specify GenerateMeshIndices, so we should always have indices
-
-		auto& normalAccessor = objModel.accessors[normalIt->accessorIndex];
-		if (!normalAccessor.bufferViewIndex.has_value())
+		// Whatever is left in Data gets handed over to the Model
+		ReleaseModelData(load.Filepath, load.Data, load.Residency, load.BuildsPrototype);
+		if (load.Residency == ModelResidency::GpuOnly)
 		{
-			continue;
+			load.Data = nullptr;
 		}
 
-		fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(objModel, normalAccessor, [&](fastgltf::math::fvec3 norm, std::size_t idx) {
-			normal.x = norm.x();
-			normal.y = norm.y();
-			normal.z = norm.z();
-			
-			vertices[idx].Normal = normal;
-		});
-
-		vertices.push_back({ position, normal });
+		it = s_PendingLoads.erase(it);
+		if (s_PendingLoads.empty())
+		{
+			LogMemoryReport();
+		}
 	}
-	
-	return vertices;
 }
 
-std::vector<uint32_t> ModelLoader::GetMeshIndexVector(const fastgltf::Asset& objModel, int meshIndex)
+std::shared_ptr<ModelPrototype> ModelLoader::FindPrototype(const std::filesystem::path& filepath)
 {
-	std::vector<uint32_t> indices;
-	for (auto it = objModel.meshes[meshIndex].primitives.begin(); it < objModel.meshes[meshIndex].primitives.end(); it++)
-	{
-		auto& indexAccessor = objModel.accessors[it->indicesAccessor.value()];
-		ASSERT(indexAccessor.bufferViewIndex.has_value());
-
-		indices.resize(indexAccessor.count);
-
-		fastgltf::copyFromAccessor<std::uint32_t>(objModel, indexAccessor, indices.data());
-	}
-
-	return indices;
+	const auto i = s_Prototypes.find(filepath.string());
+	return i != s_Prototypes.end() ? i->second : nullptr;
 }
 
-std::unique_ptr<Node> ModelLoader::ParseNode(const fastgltf::Asset& model, const fastgltf::Node& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes)
+// Called once a model's GPU resources exist. The loader's own reference to the CPU side data is
+// dropped, so unless the model asked to keep it the data is freed along with the last reference.
+// Loading the same model again is cheap since it only has to be read back from the model cache.
+// uploaded is false when the model reused a prototype that was already on the GPU.
+void ModelLoader::ReleaseModelData(const std::filesystem::path& filepath, const std::shared_ptr<ModelData>& model, ModelResidency residency, bool uploaded)
 {
-	DX::XMMATRIX transform = GetMeshTransform(model, node);
-
-	std::vector<Mesh*> currentMesh;
-	currentMesh.push_back(modelMeshes.at(static_cast<int>(node.meshIndex.value())).get());
-
-	std::unique_ptr<Node> nextNode = std::make_unique<Node>(static_cast<int>(node.meshIndex.value()), node.name.c_str(), transform, std::move(currentMesh));
-	for (int i = 0; i < node.children.size(); i++)
 	{
-		nextNode->AddChild(ParseNode(model, model.nodes[node.children[i]], modelMeshes));
+		std::scoped_lock lock(s_ModelsMutex);
+		s_Models.erase(filepath.string());
 	}
 
-	return std::move(nextNode);
+	const size_t geometrySize = model->GetGeometrySize();
+	s_ReleasedModels.push_back({ model, geometrySize, uploaded });
 
+	if (residency == ModelResidency::GpuOnly && uploaded)
+	{
+		LOG_DEBUG("Released {:.2f}MB of CPU side geometry for {}", geometrySize / (1024.0 * 1024.0), filepath.string());
+	}
 }
 
-#pragma warning(disable:4715) // Disable warning about no return for all control paths since we are always guarenteed to return
-const fastgltf::Node& ModelLoader::GetRootNode(const fastgltf::Asset& model)
+// Before the residency policy the model map held on to the data of every model it loaded, which is
+// exactly the data of the uploaded models here. Whether that data is still resident now is measured
+// by whether it is still alive, since the only thing keeping it alive is whoever is still using it.
+void ModelLoader::LogMemoryReport()
 {
-	std::map<size_t, size_t> nodeMap;
-	for (size_t i = 0; i < model.nodes.size(); i++)
+	constexpr double toMB = 1.0 / (1024.0 * 1024.0);
+
+	size_t loadingBytes = 0;
 	{
-		nodeMap[i] = -1;
-		for (int j = 0; j < model.nodes[i].children.size(); j++)
+		std::scoped_lock lock(s_ModelsMutex);
+		for (auto& [filepath, model] : s_Models)
 		{
-			nodeMap[model.nodes[i].children[j]] = i;
+			loadingBytes += model.GetCooked() ? model.GetCooked()->GetGeometrySize() : 0;
 		}
 	}
 
-	for (auto it = nodeMap.begin(); it != nodeMap.end(); it++)
+	size_t uploadedBytes = 0;
+	size_t aliveBytes = 0;
+	std::unordered_set<const ModelData*> alive;
+	for (const ReleasedModel& released : s_ReleasedModels)
 	{
-		if (it->second == -1) return model.nodes[it->first];
-	}
-
-	ASSERT(false, "No Root node found!");
-	#pragma warning(default:4715)
-}
+		if (released.Uploaded)
+		{
+			uploadedBytes += released.GeometryBytes;
+		}
 
-DX::XMMATRIX ModelLoader::GetMeshTransform(const fastgltf::Asset& model, const fastgltf::Node& node)
-{
-	DX::XMMATRIX transform;
-	if (auto value = std::get_if<fastgltf::math::fmat4x4>(&node.transform))
-	{
-		transform = DX::XMMatrixTranspose(DX::XMLoadFloat4x4(reinterpret_cast<const DX::XMFLOAT4X4*>(&node.transform)));
-	}
-	else
-	{
-		auto trs = std::get<fastgltf::TRS>(node.transform);
-		transform =
-			DX::XMMatrixScaling(trs.scale.x(), trs.scale.y(), trs.scale.z()) *
-			DX::XMMatrixRotationRollPitchYaw(trs.rotation.x(), trs.rotation.y(), trs.rotation.z()) *
-			DX::XMMatrixTranslation(trs.translation.x(), trs.translation.y(), trs.translation.z());
+		// A model that is kept can be handed over more than once
+		if (std::shared_ptr<const ModelData> data = released.Data.lock(); data && alive.insert(data.get()).second)
+		{
+			aliveBytes += released.GeometryBytes;
+		}
 	}
 
-	return transform;
-}
-#pragma endregion
-
+	const size_t residentBytes = aliveBytes + loadingBytes;
+	const size_t withoutPolicyBytes = uploadedBytes + loadingBytes;
 
-
-//===============================Fbx===================================
-#pragma region fbx
-std::shared_ptr<UfbxScene> ModelLoader::LoadModelFbx(const std::filesystem::path& filepath)
-{
-	ufbx_load_opts opts = { }; // Optional, pass NULL for defaults
-	ufbx_error error; // Optional, pass NULL if you don't care about errors
-
-	std::shared_ptr<UfbxScene> scene = std::make_shared<UfbxScene>(ufbx_load_file(ufbx_string_view(filepath.generic_string().c_str(), filepath.generic_string().length()), &opts, &error));
-	ASSERT(scene.get(), error.description.data);
-
-	return scene;
+	LOG_INFO("Model memory report");
+	LOG_INFO("  Geometry uploaded to GPU:   {:.2f}MB", uploadedBytes * toMB);
+	LOG_INFO("  CPU resident (kept/loading): {:.2f}MB ({:.2f}MB/{:.2f}MB)", residentBytes * toMB, aliveBytes * toMB, loadingBytes * toMB);
+	LOG_INFO("  CPU resident without policy: {:.2f}MB", withoutPolicyBytes * toMB);
+	LOG_INFO("  Saved:                      {:.2f}MB", (withoutPolicyBytes - std::min(withoutPolicyBytes, residentBytes)) * toMB);
+	LOG_INFO("  Distinct materials:         {}", MaterialInstance::GetNumInstances());
 }
 
-std::unordered_map<int, std::unique_ptr<Mesh>> ModelLoader::GetModelMeshes(const UfbxScene& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::string& filepath)
+// Times placing instances of a model whose prototype has already been uploaded
+void ModelLoader::BenchmarkInstancing(const std::filesystem::path& filepath, int instances)
 {
-	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
+	Timer timer;
+	Model first = GetModel(filepath, DX::XMMatrixIdentity(), { 1.f, 1.f, 1.f });
+	const double firstTime = timer.GetElapsedInMilliseconds();
+
+	std::vector<Model> models;
+	models.reserve(instances);
 
-	for (const auto& mesh : model.Meshes())
+	timer.Reset();
+	for (int i = 0; i < instances; i++)
 	{
-		int meshIndex = mesh->element_id;
-		meshes[meshIndex] = std::make_unique<Mesh>(meshIndex, model, transform, color, nullptr, filepath);
+		models.push_back(GetModel(filepath, DX::XMMatrixTranslation(static_cast<float>(i), 0.f, 0.f), { 1.f, 1.f, 1.f }));
 	}
+	const double instanceTime = timer.GetElapsedInMilliseconds();
 
-	return meshes;
+	LOG_INFO("Instancing benchmark for {} ({} instances)", filepath.string(), instances);
+	LOG_INFO("  First model: {:.2f}ms", firstTime);
+	LOG_INFO("  Per instance: {:.2f}us", instanceTime * 1000.0 / instances);
 }
 
-std::vector<ModelVertexSemi> ModelLoader::GetMeshVertexVector(const UfbxScene& objModel, int meshIndex)
-{
-	std::vector<ModelVertexSemi> vertices;
-	const auto& mesh = reinterpret_cast<ufbx_mesh*>(objModel.Elements()[meshIndex]);
-
-	std::vector<uint32_t> tri_indices;
-	tri_indices.resize(mesh->max_face_triangles * 3);
+//==============================Textures================================
+#pragma region textures
 
-	for (ufbx_face face : mesh->faces)
+// Kicks off cooking every texture used by the model's materials so that by the time the meshes
+// create their textures they are (hopefully) ready to be uploaded.
+void ModelLoader::PrefetchTextures(const ModelData& model)
+{
+	std::vector<std::pair<std::string, TextureUsage>> textures;
+	for (const auto& mesh : model.Meshes)
 	{
-
-		// Triangulate the face into tri_indices[]
-		uint32_t num_tris = ufbx_triangulate_face(tri_indices.data(), tri_indices.size(), mesh, face);
-
-		for (uint32_t i = 0; i < num_tris * 3; i++)
+		const auto& filepaths = mesh.MeshMaterial->GetMaterialMaps();
+		for (uint32_t i = 0; i < filepaths.size(); i++)
 		{
-			uint32_t index = tri_indices[i];
-
-            ufbx_vec3 position = mesh->vertex_position[index];
-            ufbx_vec3 normal = mesh->vertex_normal[index];
-
-			vertices.push_back({ {position.x, position.y, position.z}, {normal.x, normal.y, normal.z} });
+			std::pair<std::string, TextureUsage> texture = { filepaths[i], TextureDecoder::GetUsage(i) };
+			if (std::find(textures.begin(), textures.end(), texture) == textures.end())
+			{
+				textures.push_back(std::move(texture));
+			}
 		}
+	}
 
-    }
-	ASSERT(vertices.size() == mesh->num_triangles * 3);
-
-	return vertices;
-}
-
-std::vector<uint32_t> ModelLoader::GetMeshIndexVector(const UfbxScene& objModel, std::vector<ModelVertexSemi>& vertices, int meshIndex)
-{
-	std::vector<uint32_t> indices;
-	const auto& mesh = reinterpret_cast<ufbx_mesh*>(objModel.Elements()[meshIndex]);
-	indices.resize(mesh->num_triangles * 3);
-
-	ufbx_vertex_stream stream[1] = { {vertices.data(), vertices.size(), sizeof(ModelVertexSemi)} };
-
-	uint32_t num_vertices = static_cast<uint32_t>(ufbx_generate_indices(stream, 1, indices.data(), indices.size(), nullptr, nullptr));
-
-	vertices.resize(num_vertices);
-	return indices;
-
+	TextureDecoder::Prefetch(textures);
 }
 
-std::unique_ptr<Node> ModelLoader::ParseNode(const UfbxScene& model, const ufbx_node& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes)
+bool ModelLoader::AreTexturesReady(const MeshData& mesh)
 {
-	DX::XMMATRIX transform = GetNodeTransform(node);
-
-	std::vector<Mesh*> currentMesh;
-	std::unique_ptr<Node> nextNode;
-	if (node.mesh != nullptr)
+	const auto& filepaths = mesh.MeshMaterial->GetMaterialMaps();
+	for (uint32_t i = 0; i < filepaths.size(); i++)
 	{
-		currentMesh.push_back(modelMeshes.at(node.mesh->element_id).get());
-		nextNode = std::make_unique<Node>(node.mesh->element_id, node.name.data, transform, std::move(currentMesh));
-	}
-	else
-	{
-		ASSERT(DX::XMMatrixIsIdentity(transform));
-		nextNode = std::make_unique<Node>();
-	}
-
-	for (int i = 0; i < node.children.count; i++)
-	{
-		nextNode->AddChild(ParseNode(model, *node.children[i], modelMeshes));
+		if (!TextureDecoder::IsReady(filepaths[i], TextureDecoder::GetUsage(i)))
+		{
+			return false;
+		}
 	}
-	return std::move(nextNode);
-}
 
-
-DX::XMMATRIX ModelLoader::GetNodeTransform(const ufbx_node& node)
-{
-	DX::XMMATRIX transform;
-	auto trs = node.local_transform;
-	transform =
-		DX::XMMatrixScaling(trs.scale.x, trs.scale.y, trs.scale.z) *
-		DX::XMMatrixRotationQuaternion({ trs.rotation.x, trs.rotation.y, trs.rotation.z }) *
-		DX::XMMatrixTranslation(trs.translation.x, trs.translation.y, trs.translation.z);
-
-	return transform;
+	return true;
 }
 #pragma endregion
-
@@ -1,101 +1,89 @@
 #pragma once
 
-#include <rapidobj/rapidobj.hpp>
-#include <fastgltf/core.hpp>
-#include <ufbx.h>
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
+#include <future>
+#include <mutex>
 
 #include "Mesh.h"
+#include "Material.h"
+#include "ModelData.h"
 #include "ModelAPI.h"
+#include "ModelPrototype.h"
 
-// Currently we will turn this off and use Assimp for our model loading needs.
-// At some point we will want to write our own data transformation functions to 
-// utilize the faster model loading libraries to work with Lefthanded systems (and more!)
-#define FAST_MODEL_LOADING 0
+// When enabled meshes upload their vertices as ModelVertexPacked and are drawn with the BPhongMapPacked shaders
+#define PACKED_MODEL_VERTICES 1
 
 class Model;
 
-struct ModelVertexFull
+// Whether a model's CPU side data is kept once its GPU resources have been created. By default it is
+// released, only subsystems that need to read the geometry (picking, collision, ...) should ask to keep it.
+enum class ModelResidency
 {
-	DX::XMFLOAT3 Position;
-	DX::XMFLOAT3 Normal;
-	DX::XMFLOAT3 Tangent;
-	DX::XMFLOAT3 Bitangent;
-	DX::XMFLOAT2 Texture;
+	GpuOnly,
+	KeepCpuData
 };
 
-struct ModelVertexSemi
+// State of a model that is being loaded in the background. The import (or cache read) happens on
+// the ThreadPool, after which ModelLoader::ProcessPendingLoads() uploads the file's ModelPrototype a few
+// meshes at a time on the main thread. Shared between the ModelLoader and the Model that is waiting on it.
+struct AsyncModelLoad
 {
-	DX::XMFLOAT3 Position;
-	DX::XMFLOAT3 Normal;
-	DX::XMFLOAT2 Texture;
-};
+	std::filesystem::path Filepath;
+	ModelResidency Residency = ModelResidency::GpuOnly;
+
+	std::future<std::shared_ptr<ModelData>> Future;
+	std::shared_ptr<ModelData> Data = nullptr;
+
+	// Only one load uploads a file's prototype, loads of the same file that come in meanwhile wait for it
+	std::shared_ptr<ModelPrototype> Prototype = nullptr;
+	bool BuildsPrototype = false;
+	bool Finished = false;
 
+	bool IsComplete() const { return Finished; }
+};
 
 class ModelLoader
 {
 public:
-	using Obj = rapidobj::Result;
-	using Gltf = fastgltf::Asset;
-	using Fbx = UfbxScene;
-
 	static void Init();
 	static void Shutdown();
 
 	static ModelAPI LoadModel(const std::filesystem::path& filepath);
-	static Model GetModel(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color);
+	static Model GetModel(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, ModelResidency residency = ModelResidency::GpuOnly);
 
-	static std::vector<ModelVertexFull> GetMeshVertexVectorFull(const aiScene& objModel, int meshIndex);
-	static std::vector<ModelVertexSemi> GetMeshVertexVectorSemi(const aiScene& objModel, int meshIndex);
-	static std::vector<ModelVertexSemi> GetMeshVertexVector(const rapidobj::Result& objModel, int meshIndex);
-	static std::vector<ModelVertexSemi> GetMeshVertexVector(const fastgltf::Asset& objModel, int meshIndex);
-	static std::vector<ModelVertexSemi> GetMeshVertexVector(const UfbxScene& objModel, int meshIndex);
+	static std::unique_ptr<Model> LoadModelAsync(const std::filesystem::path& filepath, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, ModelResidency residency = ModelResidency::GpuOnly);
+	static void ProcessPendingLoads(double budgetMs = s_UploadBudgetMs);
+	static bool HasPendingLoads() { return !s_PendingLoads.empty(); }
 
-	static std::vector<uint32_t> GetMeshIndexVector(const aiScene& objModel, int meshIndex);
-	static std::vector<uint32_t> GetMeshIndexVector(const rapidobj::Result& objModel, int meshIndex);
-	static std::vector<uint32_t> GetMeshIndexVector(const fastgltf::Asset& objModel, int meshIndex);
-	static std::vector<uint32_t> GetMeshIndexVector(const UfbxScene& objModel, std::vector<ModelVertexSemi>& vertices, int meshIndex);
+	static void BenchmarkInstancing(const std::filesystem::path& filepath, int instances = 500);
+	static void LogMemoryReport();
 
 private:
-	static std::shared_ptr<aiScene> LoadModelAssimp(const std::filesystem::path& filepath);
-	static std::shared_ptr<rapidobj::Result> LoadModelObj(const std::filesystem::path& filepath);
-	static std::shared_ptr<fastgltf::Asset> LoadModelGltf(const std::filesystem::path& filepath);
-	static std::shared_ptr<UfbxScene> LoadModelFbx(const std::filesystem::path& filepath);
-
-	static std::unordered_map<int, std::unique_ptr<Mesh>> GetModelMeshes(const aiScene& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::filesystem::path& filepath);
-	static std::unordered_map<int, std::unique_ptr<Mesh>> GetModelMeshes(const rapidobj::Result& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::filesystem::path& filepath);
-	static std::unordered_map<int, std::unique_ptr<Mesh>> GetModelMeshes(const fastgltf::Asset& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::string& filepath);
-	static std::unordered_map<int, std::unique_ptr<Mesh>> GetModelMeshes(const UfbxScene& model, const DX::XMMATRIX& transform, DX::XMFLOAT3 color, const std::string& filepath);
+	static void ReleaseModelData(const std::filesystem::path& filepath, const std::shared_ptr<ModelData>& model, ModelResidency residency, bool uploaded);
+	static std::shared_ptr<ModelPrototype> FindPrototype(const std::filesystem::path& filepath);
 
-	static std::unique_ptr<Node> ParseNode(const aiScene& model, int nextId, const aiNode& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes);
-	static std::unique_ptr<Node> ParseNode(const rapidobj::Result& model, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes);
-	static std::unique_ptr<Node> ParseNode(const fastgltf::Asset& model, const fastgltf::Node& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes);
-	static std::unique_ptr<Node> ParseNode(const UfbxScene& model, const ufbx_node& node, const std::unordered_map<int, std::unique_ptr<Mesh>>& modelMeshes);
-
-	static const fastgltf::Node& GetRootNode(const fastgltf::Asset& model);
-
-	static DX::XMMATRIX GetMeshTransform(const fastgltf::Asset& model, const fastgltf::Node& node);
-	static DX::XMMATRIX GetNodeTransform(const ufbx_node& node);
+	static void PrefetchTextures(const ModelData& model);
+	static bool AreTexturesReady(const MeshData& mesh);
 
 private:
-	inline static constexpr auto s_GltfSupportedExtensions =
-		fastgltf::Extensions::KHR_mesh_quantization |
-		fastgltf::Extensions::KHR_texture_transform |
-		fastgltf::Extensions::KHR_materials_variants;
-
-	inline static constexpr auto s_GltfOptions =
-		fastgltf::Options::DontRequireValidAssetMember |
-		fastgltf::Options::AllowDouble |
-		fastgltf::Options::LoadExternalBuffers |
-		fastgltf::Options::LoadExternalImages |
-		fastgltf::Options::GenerateMeshIndices;
-
-	inline static fastgltf::Parser s_GltfParser = fastgltf::Parser(s_GltfSupportedExtensions);
-	inline static constexpr bool s_FlipUVs = true;
-
 	// Map used to cache models to prevent reloading ones we've previously loaded
 	inline static std::unordered_map<std::string, ModelAPI> s_Models;
-	inline static std::unique_ptr<Assimp::Importer> s_AssimpImporter = nullptr;
+	inline static std::mutex s_ModelsMutex;
+
+	// Prototypes of every file that has been uploaded (or is being uploaded), only used from the main thread
+	inline static std::unordered_map<std::string, std::shared_ptr<ModelPrototype>> s_Prototypes;
+
+	// The CPU side data of every model that has been handed over to ReleaseModelData, the memory report
+	// checks which of them are still alive
+	struct ReleasedModel
+	{
+		std::weak_ptr<const ModelData> Data;
+		size_t GeometryBytes = 0;
+		bool Uploaded = false;
+	};
+	inline static std::vector<ReleasedModel> s_ReleasedModels;
+
+	// Time per frame that ProcessPendingLoads() is allowed to spend creating GPU resources
+	inline static constexpr double s_UploadBudgetMs = 4.0;
+	inline static std::vector<std::shared_ptr<AsyncModelLoad>> s_PendingLoads;
 };
 
@@ -0,0 +1,166 @@
+#include "pch.h"
+#include "ModelPrototype.h"
+#include "Mesh.h"
+#include "Node.h"
+#include "VertexPacking.h"
+#include "MaterialInstance.h"
+#include "Core/ImportProfiler.h"
+
+MeshPrototype::MeshPrototype(const MeshData& meshData, const std::string& filepath)
+	: m_MeshIndex(meshData.MeshIndex),
+	  m_Filepath(filepath),
+	  m_MaterialInstance(MaterialInstance::Resolve(*meshData.MeshMaterial)),
+	  m_Meshlets(meshData.Meshlets),
+	  m_Bounds(meshData.Bounds),
+	  m_BoundingSphere(meshData.BoundingSphere)
+{
+	PROFILE_IMPORT("MeshPrototype", filepath);
+	InitBuffers(meshData);
+}
+
+// The geometry is only read while creating the buffers, the prototype doesn't keep a copy of it
+void MeshPrototype::InitBuffers(const MeshData& meshData)
+{
+	std::vector<std::shared_ptr<Bindable>> bindables;
+
+	using namespace std::string_literals;
+	auto meshTag = m_Filepath + "%" + std::to_string(m_MeshIndex);
+
+#if PACKED_MODEL_VERTICES
+	auto vShader = Shader::Resolve("assets/shaders/BPhongMapPackedVS.hlsl", Shader::VERTEX_SHADER);
+	bindables.push_back(vShader);
+	bindables.push_back(Shader::Resolve("assets/shaders/BPhongMapPS.hlsl", Shader::PIXEL_SHADER));
+
+	VertexQuantization quantization;
+	const std::vector<ModelVertexPacked> packedVertices = VertexPacking::PackVertices(meshData.Vertices, quantization);
+	auto vBuff = VertexBuffer::Resolve(meshTag, packedVertices);
+
+	vBuff->CreateLayout({
+		{"POSITION", 0, ShaderDataType::UShort4Norm},
+		{"NORMAL", 0, ShaderDataType::Short2Norm},
+		{"TANGENT", 0, ShaderDataType::Short2Norm},
+		{"TEXCOORD", 0, ShaderDataType::Half2},
+		}, vShader.get());
+	bindables.push_back(vBuff);
+
+	bindables.push_back(ConstantBuffer::Resolve<VertexQuantization>(Shader::VERTEX_SHADER, quantization, 1, meshTag));
+#else
+	auto vShader = Shader::Resolve("assets/shaders/BPhongMapVS.hlsl", Shader::VERTEX_SHADER);
+	bindables.push_back(vShader);
+	bindables.push_back(Shader::Resolve("assets/shaders/BPhongMapPS.hlsl", Shader::PIXEL_SHADER));
+
+	auto vBuff = VertexBuffer::Resolve(meshTag, meshData.Vertices);
+
+	vBuff->CreateLayout({
+		{"POSITION", 0, ShaderDataType::Float3},
+		{"NORMAL", 0, ShaderDataType::Float3},
+		{"TANGENT", 0, ShaderDataType::Float3},
+		{"BITANGENT", 0, ShaderDataType::Float3},
+		{"TEXCOORD", 0, ShaderDataType::Float2},
+		}, vShader.get());
+	bindables.push_back(vBuff);
+#endif
+
+	if (!GetTextures().empty())
+	{
+		m_UvDensity = ComputeUvDensity(meshData);
+	}
+
+	// The LODs only differ in which index buffer they draw with
+	for (size_t lod = 0; lod <= meshData.LodIndices.size(); lod++)
+	{
+		std::shared_ptr<IndexBuffer> iBuff = lod == 0
+			? IndexBuffer::Resolve(meshTag, meshData.Indices)
+			: IndexBuffer::Resolve(meshTag + "#lod" + std::to_string(lod), meshData.LodIndices[lod - 1]);
+
+		auto lodBindables = std::make_shared<std::vector<std::shared_ptr<Bindable>>>(bindables);
+		lodBindables->push_back(iBuff);
+		m_Lods.push_back({ std::move(lodBindables), iBuff->GetCount() });
+	}
+}
+
+// Ratio of the area the triangles cover in UV space to the area they cover in model space. Its square
+// root is how many UV units a model space unit spans on average, which is what the streamer needs to
+// turn the mesh's size on screen into a mip.
+float MeshPrototype::ComputeUvDensity(const MeshData& meshData)
+{
+	double uvArea = 0.0;
+	double modelArea = 0.0;
+	for (size_t i = 0; i + 2 < meshData.Indices.size(); i += 3)
+	{
+		const ModelVertexFull& v0 = meshData.Vertices[meshData.Indices[i]];
+		const ModelVertexFull& v1 = meshData.Vertices[meshData.Indices[i + 1]];
+		const ModelVertexFull& v2 = meshData.Vertices[meshData.Indices[i + 2]];
+
+		const DX::XMVECTOR p0 = DX::XMLoadFloat3(&v0.Position);
+		const DX::XMVECTOR edgeA = DX::XMVectorSubtract(DX::XMLoadFloat3(&v1.Position), p0);
+		const DX::XMVECTOR edgeB = DX::XMVectorSubtract(DX::XMLoadFloat3(&v2.Position), p0);
+		modelArea += 0.5 * DX::XMVectorGetX(DX::XMVector3Length(DX::XMVector3Cross(edgeA, edgeB)));
+
+		const float uA = v1.Texture.x - v0.Texture.x;
+		const float vA = v1.Texture.y - v0.Texture.y;
+		const float uB = v2.Texture.x - v0.Texture.x;
+		const float vB = v2.Texture.y - v0.Texture.y;
+		uvArea += 0.5 * std::abs(uA * vB - uB * vA);
+	}
+
+	if (modelArea <= 0.0 || uvArea <= 0.0)
+	{
+		return 1.f;
+	}
+
+	return static_cast<float>(std::sqrt(uvArea / modelArea));
+}
+
+ModelPrototype::ModelPrototype(const std::filesystem::path& filepath, const ModelData& model)
+	: m_Filepath(filepath), m_Nodes(model.Nodes), m_NumMeshes(model.Meshes.size())
+{
+	m_Meshes.reserve(m_NumMeshes);
+}
+
+void ModelPrototype::AddMesh(const MeshData& meshData)
+{
+	ASSERT(!IsComplete(), "All of the prototype's meshes have already been added");
+	m_Meshes.push_back(std::make_shared<MeshPrototype>(meshData, m_Filepath.string()));
+}
+
+std::unordered_map<int, std::unique_ptr<Mesh>> ModelPrototype::CreateMeshes(const DX::XMMATRIX& transform, DX::XMFLOAT3 color) const
+{
+	std::unordered_map<int, std::unique_ptr<Mesh>> meshes;
+	meshes.reserve(m_Meshes.size());
+	for (const auto& mesh : m_Meshes)
+	{
+		meshes[mesh->GetMeshIndex()] = std::make_unique<Mesh>(mesh, transform, color);
+	}
+
+	return meshes;
+}
+
+std::unique_ptr<Node> ModelPrototype::CreateNodes(const std::unordered_map<int, std::unique_ptr<Mesh>>& meshes) const
+{
+	int nodeIndex = 0;
+	return CreateNode(nodeIndex, meshes);
+}
+
+// Nodes are stored in pre-order, so each node is immediately followed by its children's subtrees.
+// The node's position in that order doubles as its id.
+std::unique_ptr<Node> ModelPrototype::CreateNode(int& nodeIndex, const std::unordered_map<int, std::unique_ptr<Mesh>>& meshes) const
+{
+	const int id = nodeIndex++;
+	const NodeData& node = m_Nodes[id];
+
+	std::vector<Mesh*> currentMeshes;
+	currentMeshes.reserve(node.MeshIndices.size());
+	for (int meshIndex : node.MeshIndices)
+	{
+		currentMeshes.push_back(meshes.at(meshIndex).get());
+	}
+
+	std::unique_ptr<Node> nextNode = std::make_unique<Node>(id, node.Name, DX::XMLoadFloat4x4(&node.RelativeTransform), std::move(currentMeshes));
+	for (uint32_t i = 0; i < node.NumChildren; i++)
+	{
+		nextNode->AddChild(CreateNode(nodeIndex, meshes));
+	}
+
+	return nextNode;
+}
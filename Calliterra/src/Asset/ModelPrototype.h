@@ -0,0 +1,85 @@
+#pragma once
+#include "Renderer/Bindable.h"
+#include "Renderer/Texture.h"
+#include "ModelData.h"
+#include "Material.h"
+#include "MaterialInstance.h"
+
+class Mesh;
+class Node;
+
+// The parts of a mesh that are the same for every instance of it: its material, model space bounds,
+// meshlets and the bindables of each LOD (everything except the per instance transform). The material's
+// bindables aren't part of the LODs, they're shared with every other mesh that uses the same material.
+class MeshPrototype
+{
+public:
+	struct Lod
+	{
+		std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> Bindables;
+		uint32_t IndexCount = 0;
+	};
+
+public:
+	// Creates the GPU resources, so this has to be called on the main thread
+	MeshPrototype(const MeshData& meshData, const std::string& filepath);
+
+	int GetMeshIndex() const { return m_MeshIndex; }
+	const std::string& GetFilepath() const { return m_Filepath; }
+	const Material& GetMaterial() const { return m_MaterialInstance->GetMaterial(); }
+	const std::shared_ptr<const MaterialInstance>& GetMaterialInstance() const { return m_MaterialInstance; }
+	const std::vector<Lod>& GetLods() const { return m_Lods; }
+	const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+	const DX::BoundingBox& GetBounds() const { return m_Bounds; }
+	const DX::BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+
+	// The material maps the mesh actually has, placeholders for missing maps aren't included
+	const std::vector<std::shared_ptr<Texture>>& GetTextures() const { return m_MaterialInstance->GetTextures(); }
+	// Average UV units per model space unit, how densely the textures are laid out over the surface
+	float GetUvDensity() const { return m_UvDensity; }
+
+private:
+	void InitBuffers(const MeshData& meshData);
+	static float ComputeUvDensity(const MeshData& meshData);
+
+private:
+	int m_MeshIndex;
+	std::string m_Filepath;
+
+	std::shared_ptr<const MaterialInstance> m_MaterialInstance;
+	std::vector<Lod> m_Lods;
+	std::vector<Meshlet> m_Meshlets;
+	float m_UvDensity = 1.f;
+
+	DX::BoundingBox m_Bounds;
+	DX::BoundingSphere m_BoundingSphere;
+};
+
+// Everything needed to create Models of a file once its meshes have been uploaded, without going back to
+// its ModelData. The ModelLoader builds one per file and every Model of that file shares it, so a new
+// instance only has to create its transforms and node tree.
+class ModelPrototype
+{
+public:
+	ModelPrototype(const std::filesystem::path& filepath, const ModelData& model);
+
+	// Meshes are added one at a time so that uploading them can be spread out over several frames
+	void AddMesh(const MeshData& meshData);
+	bool IsComplete() const { return m_Meshes.size() == m_NumMeshes; }
+	size_t GetNumMeshes() const { return m_Meshes.size(); }
+
+	// The per instance part of a Model, a Mesh for each of our meshes and the node tree that places them
+	std::unordered_map<int, std::unique_ptr<Mesh>> CreateMeshes(const DX::XMMATRIX& transform, DX::XMFLOAT3 color) const;
+	std::unique_ptr<Node> CreateNodes(const std::unordered_map<int, std::unique_ptr<Mesh>>& meshes) const;
+
+	const std::filesystem::path& GetFilepath() const { return m_Filepath; }
+
+private:
+	std::unique_ptr<Node> CreateNode(int& nodeIndex, const std::unordered_map<int, std::unique_ptr<Mesh>>& meshes) const;
+
+private:
+	std::filesystem::path m_Filepath;
+	std::vector<NodeData> m_Nodes;
+	size_t m_NumMeshes;
+	std::vector<std::shared_ptr<const MeshPrototype>> m_Meshes;
+};
@@ -43,6 +43,41 @@ void Node::ApplyTransformations(const DX::XMMATRIX& transform)
 	{
 		child->ApplyTransformations(accumulatedTransform);
 	}
+
+	UpdateBounds();
+}
+
+// Merges the world space bounds of our meshes and children. Children have already updated theirs by the
+// time this is called, so the whole hierarchy is refreshed in the same pass that applies the transforms.
+void Node::UpdateBounds()
+{
+	m_HasBounds = false;
+
+	const auto merge = [this](const DX::BoundingBox& bounds)
+	{
+		if (m_HasBounds)
+		{
+			DX::BoundingBox::CreateMerged(m_Bounds, m_Bounds, bounds);
+		}
+		else
+		{
+			m_Bounds = bounds;
+			m_HasBounds = true;
+		}
+	};
+
+	for (const auto& mesh : m_Meshes)
+	{
+		merge(mesh->GetWorldBounds());
+	}
+
+	for (const auto& child : m_Children)
+	{
+		if (child->HasBounds())
+		{
+			merge(child->GetBounds());
+		}
+	}
 }
 
 void Node::SetAppliedTransformation(const DX::XMMATRIX& transform)
@@ -15,6 +15,7 @@ public:
 	void SetAppliedTransformation(const DX::XMMATRIX& transform);
 
 	void AddChild(std::unique_ptr<Node> child); 
+	void UpdateBounds();
 
 	void SetProjectionMatrix(const DX::XMMATRIX& projMatrix);
 	void SetViewMatrix(const DX::XMMATRIX& viewMatrix);
@@ -26,6 +27,10 @@ public:
 	const std::string& GetName() const { return m_Name; }
 	int GetId() const { return m_Id; }
 
+	// World space bounds of everything in this node's subtree, empty nodes have none
+	bool HasBounds() const { return m_HasBounds; }
+	const DX::BoundingBox& GetBounds() const { return m_Bounds; }
+
 private:
 	int m_Id;
 	std::string m_Name;
@@ -35,5 +40,8 @@ private:
 	DX::XMMATRIX m_RelativeTransform = DX::XMMatrixIdentity();
 	DX::XMMATRIX m_ModelTransform = DX::XMMatrixIdentity();
 	DX::XMMATRIX m_AppliedTransform = DX::XMMatrixIdentity();
+
+	DX::BoundingBox m_Bounds;
+	bool m_HasBounds = false;
 };
 
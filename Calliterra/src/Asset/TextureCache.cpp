@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "TextureCache.h"
+#include "Core/BinaryStream.h"
+#include "Core/VirtualFileSystem.h"
+#include "Core/ImportProfiler.h"
+
+// File layout:
+//   Header   | magic, version, usage, source write time, source path
+//   Texture  | format, has alpha, mips (width, height, row pitch, offset and size of each)
+//   Data     | every mip's data back to back, starting on a s_DataAlignment boundary
+std::shared_ptr<CookedTexture> TextureCache::Load(const std::filesystem::path& sourcePath, TextureUsage usage)
+{
+	const std::filesystem::path cachePath = GetCachePath(sourcePath, usage);
+	if (!std::filesystem::exists(cachePath))
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<CookedTexture> texture = std::make_shared<CookedTexture>();
+	texture->File = MappedFile(cachePath);
+	if (!texture->File.IsOpen())
+	{
+		return nullptr;
+	}
+	ImportProfiler::AddBytesRead(texture->File.GetSize());
+
+	BinaryReader reader(texture->File.GetData(), texture->File.GetSize());
+
+	if (reader.Read<uint32_t>() != s_Magic ||
+		reader.Read<uint32_t>() != s_Version ||
+		reader.Read<TextureUsage>() != usage ||
+		reader.Read<int64_t>() != GetSourceWriteTime(sourcePath) ||
+		reader.ReadString() != sourcePath.generic_string())
+	{
+		LOG_DEBUG("Texture cache entry for {} is out of date", sourcePath.string());
+		return nullptr;
+	}
+
+	texture->Format = reader.Read<TextureFormat>();
+	texture->HasAlpha = reader.Read<uint8_t>() != 0;
+	texture->Mips = reader.ReadVector<CookedTexture::Mip>();
+
+	const uint32_t dataSize = reader.Read<uint32_t>();
+	reader.Align(s_DataAlignment);
+	texture->Data = static_cast<const uint8_t*>(reader.Skip(dataSize));
+
+	if (!reader.IsValid() || texture->Mips.empty() || texture->Format > TextureFormat::BC7)
+	{
+		LOG_WARN("Texture cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+		return nullptr;
+	}
+
+	for (const auto& mip : texture->Mips)
+	{
+		if (static_cast<size_t>(mip.Offset) + mip.Size > dataSize || mip.Size != TextureCompressor::GetSize(texture->Format, mip.Width, mip.Height))
+		{
+			LOG_WARN("Texture cache entry for {} is corrupt, it will be rebuilt", sourcePath.string());
+			return nullptr;
+		}
+	}
+
+	return texture;
+}
+
+void TextureCache::Store(const std::filesystem::path& sourcePath, TextureUsage usage, const CookedTexture& texture)
+{
+	const CookedTexture::Mip& lastMip = texture.Mips.back();
+	const uint32_t dataSize = lastMip.Offset + lastMip.Size;
+
+	BinaryWriter writer;
+
+	writer.Write(s_Magic);
+	writer.Write(s_Version);
+	writer.Write(usage);
+	writer.Write(GetSourceWriteTime(sourcePath));
+	writer.WriteString(sourcePath.generic_string());
+
+	writer.Write(texture.Format);
+	writer.Write(static_cast<uint8_t>(texture.HasAlpha));
+	writer.WriteVector(texture.Mips);
+
+	writer.Write(dataSize);
+	writer.Align(s_DataAlignment);
+	writer.WriteBytes(texture.Data, dataSize);
+
+	if (!writer.SaveToFile(GetCachePath(sourcePath, usage)))
+	{
+		LOG_WARN("Failed to write texture cache entry for {}", sourcePath.string());
+	}
+}
+
+std::filesystem::path TextureCache::GetCachePath(const std::filesystem::path& sourcePath, TextureUsage usage)
+{
+	// The full path and usage are stored (and checked) inside the entry, so a hash collision only costs a re-cook
+	const size_t hash = std::hash<std::string>{}(sourcePath.generic_string());
+	return s_CacheDirectory / std::format("{:016x}_{}.ctex", hash, static_cast<uint32_t>(usage));
+}
+
+// Sources packed into an archive keep the write time they were packed with
+int64_t TextureCache::GetSourceWriteTime(const std::filesystem::path& sourcePath)
+{
+	return VirtualFileSystem::GetWriteTime(sourcePath);
+}
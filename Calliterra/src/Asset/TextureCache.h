@@ -0,0 +1,26 @@
+#pragma once
+#include "TextureDecoder.h"
+
+// On disk cache of cooked textures, the texture equivalent of the ModelCache. Block compressing every mip
+// of a texture takes far longer than decoding it, so it is only done once and the result is written out in
+// a layout that can be handed straight to the graphics API from a memory mapped file.
+//
+// Cache entries are keyed by the source path and usage, and are only considered valid if the source
+// file's last write time matches what the entry was cooked with.
+class TextureCache
+{
+public:
+	static std::shared_ptr<CookedTexture> Load(const std::filesystem::path& sourcePath, TextureUsage usage);
+	static void Store(const std::filesystem::path& sourcePath, TextureUsage usage, const CookedTexture& texture);
+
+private:
+	static std::filesystem::path GetCachePath(const std::filesystem::path& sourcePath, TextureUsage usage);
+	static int64_t GetSourceWriteTime(const std::filesystem::path& sourcePath);
+
+private:
+	inline static const std::filesystem::path s_CacheDirectory = "cache/textures";
+	inline static constexpr uint32_t s_Magic = 0x58455443; // "CTEX"
+	inline static constexpr uint32_t s_Version = 2;
+	// Mip data starts on this boundary so it can be read in place
+	inline static constexpr size_t s_DataAlignment = 16;
+};
@@ -0,0 +1,735 @@
+#include "pch.h"
+#include "TextureCompressor.h"
+#include "Core/ThreadPool.h"
+
+namespace
+{
+	// Interpolation weights (out of 64) of BC7's 4 bit indices
+	constexpr uint32_t s_BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// How far from the first to the second endpoint each BC1 palette entry is (in 4 colour mode)
+	constexpr float s_BC1Weights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+	constexpr uint32_t s_BC7Mode6 = 1 << 6;
+
+	// Bit streams in the layout used by the BC formats, least significant bit of the first byte first
+	class BlockWriter
+	{
+	public:
+		BlockWriter(uint8_t* data, size_t size) : m_Data(data) { memset(m_Data, 0, size); }
+
+		void Write(uint32_t value, uint32_t numBits)
+		{
+			for (uint32_t i = 0; i < numBits; i++, m_Position++)
+			{
+				m_Data[m_Position >> 3] |= static_cast<uint8_t>(((value >> i) & 1) << (m_Position & 7));
+			}
+		}
+
+	private:
+		uint8_t* m_Data;
+		uint32_t m_Position = 0;
+	};
+
+	class BlockReader
+	{
+	public:
+		BlockReader(const uint8_t* data) : m_Data(data) {}
+
+		uint32_t Read(uint32_t numBits)
+		{
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < numBits; i++, m_Position++)
+			{
+				value |= ((m_Data[m_Position >> 3] >> (m_Position & 7)) & 1u) << i;
+			}
+			return value;
+		}
+
+	private:
+		const uint8_t* m_Data;
+		uint32_t m_Position = 0;
+	};
+
+	void LoadBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t texels[16][4])
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t py = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t px = std::min(blockX * 4 + x, width - 1);
+				memcpy(texels[y * 4 + x], pixels + (static_cast<size_t>(py) * width + px) * 4, 4);
+			}
+		}
+	}
+
+	void StoreBlock(const uint8_t texels[16][4], uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY)
+	{
+		for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+		{
+			for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+			{
+				memcpy(pixels + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4, texels[y * 4 + x], 4);
+			}
+		}
+	}
+
+	// Endpoints of the line through the block's texels along the direction they vary the most,
+	// found by power iteration on the covariance matrix
+	template<uint32_t Channels>
+	void FitPrincipalAxis(const uint8_t texels[16][4], float start[4], float end[4])
+	{
+		float mean[Channels] = {};
+		float minValue[Channels];
+		float maxValue[Channels];
+		std::fill_n(minValue, Channels, 255.f);
+		std::fill_n(maxValue, Channels, 0.f);
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < Channels; c++)
+			{
+				mean[c] += texels[i][c];
+				minValue[c] = std::min(minValue[c], static_cast<float>(texels[i][c]));
+				maxValue[c] = std::max(maxValue[c], static_cast<float>(texels[i][c]));
+			}
+		}
+
+		float axis[Channels];
+		float axisLength = 0.f;
+		for (uint32_t c = 0; c < Channels; c++)
+		{
+			mean[c] /= 16.f;
+			axis[c] = maxValue[c] - minValue[c];
+			axisLength += axis[c] * axis[c];
+		}
+
+		std::fill_n(start, 4, 255.f);
+		std::fill_n(end, 4, 255.f);
+
+		// Every texel is the same
+		if (axisLength == 0.f)
+		{
+			std::copy_n(mean, Channels, start);
+			std::copy_n(mean, Channels, end);
+			return;
+		}
+
+		float covariance[Channels][Channels] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t a = 0; a < Channels; a++)
+			{
+				for (uint32_t b = a; b < Channels; b++)
+				{
+					covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+				}
+			}
+		}
+		for (uint32_t a = 0; a < Channels; a++)
+		{
+			for (uint32_t b = 0; b < a; b++)
+			{
+				covariance[a][b] = covariance[b][a];
+			}
+		}
+
+		// The diagonal of the bounding box is a good first guess, so a few iterations are plenty
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[Channels] = {};
+			float largest = 0.f;
+			for (uint32_t a = 0; a < Channels; a++)
+			{
+				for (uint32_t b = 0; b < Channels; b++)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+				largest = std::max(largest, std::abs(next[a]));
+			}
+
+			if (largest == 0.f)
+			{
+				break;
+			}
+
+			for (uint32_t c = 0; c < Channels; c++)
+			{
+				axis[c] = next[c] / largest;
+			}
+		}
+
+		axisLength = 0.f;
+		for (uint32_t c = 0; c < Channels; c++)
+		{
+			axisLength += axis[c] * axis[c];
+		}
+		axisLength = std::sqrt(axisLength);
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = -std::numeric_limits<float>::max();
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float t = 0.f;
+			for (uint32_t c = 0; c < Channels; c++)
+			{
+				t += (texels[i][c] - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t / axisLength);
+			maxT = std::max(maxT, t / axisLength);
+		}
+
+		for (uint32_t c = 0; c < Channels; c++)
+		{
+			start[c] = std::clamp(mean[c] + minT * axis[c] / axisLength, 0.f, 255.f);
+			end[c] = std::clamp(mean[c] + maxT * axis[c] / axisLength, 0.f, 255.f);
+		}
+	}
+
+	// Picks the closest palette entry for every texel and returns the total squared error
+	template<uint32_t Channels>
+	float AssignIndices(const uint8_t texels[16][4], const float palette[][4], uint32_t numColors, uint8_t indices[16])
+	{
+		float totalError = 0.f;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			for (uint32_t p = 0; p < numColors; p++)
+			{
+				float error = 0.f;
+				for (uint32_t c = 0; c < Channels; c++)
+				{
+					const float diff = texels[i][c] - palette[p][c];
+					error += diff * diff;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = static_cast<uint8_t>(p);
+				}
+			}
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	// Least squares endpoints for the given indices, where weights[index] is how far from the start to the
+	// end endpoint that palette entry is. Returns false if every texel uses the same weight.
+	template<uint32_t Channels>
+	bool RefineEndpoints(const uint8_t texels[16][4], const uint8_t indices[16], const float* weights, float start[4], float end[4])
+	{
+		float aa = 0.f;
+		float ab = 0.f;
+		float bb = 0.f;
+		float startSum[Channels] = {};
+		float endSum[Channels] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			const float t = weights[indices[i]];
+			const float s = 1.f - t;
+			aa += s * s;
+			ab += s * t;
+			bb += t * t;
+			for (uint32_t c = 0; c < Channels; c++)
+			{
+				startSum[c] += s * texels[i][c];
+				endSum[c] += t * texels[i][c];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (uint32_t c = 0; c < Channels; c++)
+		{
+			start[c] = std::clamp((bb * startSum[c] - ab * endSum[c]) / determinant, 0.f, 255.f);
+			end[c] = std::clamp((aa * endSum[c] - ab * startSum[c]) / determinant, 0.f, 255.f);
+		}
+
+		return true;
+	}
+
+	uint16_t To565(const float color[4])
+	{
+		const uint32_t r = static_cast<uint32_t>(color[0] * 31.f / 255.f + 0.5f);
+		const uint32_t g = static_cast<uint32_t>(color[1] * 63.f / 255.f + 0.5f);
+		const uint32_t b = static_cast<uint32_t>(color[2] * 31.f / 255.f + 0.5f);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void From565(uint16_t packed, float color[4])
+	{
+		const uint32_t r = packed >> 11;
+		const uint32_t g = (packed >> 5) & 63;
+		const uint32_t b = packed & 31;
+		color[0] = static_cast<float>((r << 3) | (r >> 2));
+		color[1] = static_cast<float>((g << 2) | (g >> 4));
+		color[2] = static_cast<float>((b << 3) | (b >> 2));
+		color[3] = 255.f;
+	}
+
+	void BC1Palette(uint16_t color0, uint16_t color1, float palette[4][4])
+	{
+		From565(color0, palette[0]);
+		From565(color1, palette[1]);
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			if (color0 > color1)
+			{
+				palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+				palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2.f;
+				palette[3][c] = 0.f;
+			}
+		}
+		palette[2][3] = 255.f;
+		palette[3][3] = color0 > color1 ? 255.f : 0.f;
+	}
+
+	// The endpoint and p-bit whose expanded value (endpoint << 1 | p-bit) is closest to color
+	void QuantizeBC7Endpoint(const float color[4], uint32_t endpoint[4], uint32_t& pBit)
+	{
+		float bestError = std::numeric_limits<float>::max();
+		for (uint32_t p = 0; p < 2; p++)
+		{
+			uint32_t quantized[4];
+			float error = 0.f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				quantized[c] = static_cast<uint32_t>(std::clamp((color[c] - p) / 2.f + 0.5f, 0.f, 127.f));
+				const float diff = static_cast<float>((quantized[c] << 1) | p) - color[c];
+				error += diff * diff;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pBit = p;
+				std::copy_n(quantized, 4, endpoint);
+			}
+		}
+	}
+
+	void BC7Palette(const uint32_t endpoint0[4], uint32_t pBit0, const uint32_t endpoint1[4], uint32_t pBit1, float palette[16][4])
+	{
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			const uint32_t e0 = (endpoint0[c] << 1) | pBit0;
+			const uint32_t e1 = (endpoint1[c] << 1) | pBit1;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				palette[i][c] = static_cast<float>(((64 - s_BC7Weights[i]) * e0 + s_BC7Weights[i] * e1 + 32) >> 6);
+			}
+		}
+	}
+}
+
+std::vector<uint8_t> TextureCompressor::Compress(TextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height)
+{
+	ASSERT(width > 0 && height > 0, "Can't compress an empty image");
+
+	if (format == TextureFormat::RGBA8)
+	{
+		return std::vector<uint8_t>(pixels, pixels + GetSize(format, width, height));
+	}
+
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	const uint32_t blockSize = GetBlockSize(format);
+	std::vector<uint8_t> data(GetSize(format, width, height));
+
+	// Blocks don't depend on each other, so rows of them are spread out over the workers
+	ThreadPool::ParallelFor(blocksY, [&](uint32_t blockY)
+	{
+		uint8_t texels[16][4];
+		for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+		{
+			LoadBlock(pixels, width, height, blockX, blockY, texels);
+			uint8_t* block = data.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+			switch (format)
+			{
+			case TextureFormat::BC1:
+				EncodeBC1(texels, block);
+				break;
+			case TextureFormat::BC3:
+				EncodeBC4(texels, 3, block);
+				EncodeBC1(texels, block + 8);
+				break;
+			case TextureFormat::BC5:
+				EncodeBC4(texels, 0, block);
+				EncodeBC4(texels, 1, block + 8);
+				break;
+			case TextureFormat::BC7:
+				EncodeBC7(texels, block);
+				break;
+			case TextureFormat::RGBA8:
+				// Copied as is above
+				break;
+			}
+		}
+	});
+
+	return data;
+}
+
+std::vector<uint8_t> TextureCompressor::Decompress(TextureFormat format, const uint8_t* data, uint32_t width, uint32_t height)
+{
+	if (format == TextureFormat::RGBA8)
+	{
+		return std::vector<uint8_t>(data, data + GetSize(format, width, height));
+	}
+
+	const uint32_t blocksX = (width + 3) / 4;
+	const uint32_t blocksY = (height + 3) / 4;
+	const uint32_t blockSize = GetBlockSize(format);
+	std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+	for (uint32_t blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+		{
+			const uint8_t* block = data + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+			uint8_t texels[16][4];
+
+			switch (format)
+			{
+			case TextureFormat::BC1:
+				DecodeBC1(block, texels);
+				break;
+			case TextureFormat::BC3:
+				DecodeBC1(block + 8, texels);
+				DecodeBC4(block, 3, texels);
+				break;
+			case TextureFormat::BC5:
+				DecodeBC4(block, 0, texels);
+				DecodeBC4(block + 8, 1, texels);
+				for (auto& texel : texels)
+				{
+					texel[2] = 0;
+					texel[3] = 255;
+				}
+				break;
+			case TextureFormat::BC7:
+				DecodeBC7(block, texels);
+				break;
+			case TextureFormat::RGBA8:
+				// Copied as is above
+				break;
+			}
+
+			StoreBlock(texels, pixels.data(), width, height, blockX, blockY);
+		}
+	}
+
+	return pixels;
+}
+
+uint32_t TextureCompressor::GetBlockSize(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::RGBA8:
+		return 4;
+	case TextureFormat::BC1:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+uint32_t TextureCompressor::GetRowPitch(TextureFormat format, uint32_t width)
+{
+	if (!IsBlockCompressed(format))
+	{
+		return width * GetBlockSize(format);
+	}
+
+	return std::max(1u, (width + 3) / 4) * GetBlockSize(format);
+}
+
+uint32_t TextureCompressor::GetSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+	if (!IsBlockCompressed(format))
+	{
+		return GetRowPitch(format, width) * height;
+	}
+
+	return GetRowPitch(format, width) * std::max(1u, (height + 3) / 4);
+}
+
+double TextureCompressor::MeanSquaredError(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, uint32_t numChannels)
+{
+	const size_t numTexels = static_cast<size_t>(width) * height;
+	double error = 0.0;
+	for (size_t i = 0; i < numTexels; i++)
+	{
+		for (uint32_t c = 0; c < numChannels; c++)
+		{
+			const double diff = static_cast<double>(a[i * 4 + c]) - b[i * 4 + c];
+			error += diff * diff;
+		}
+	}
+
+	return numTexels > 0 ? error / (numTexels * numChannels) : 0.0;
+}
+
+double TextureCompressor::GetPsnr(double meanSquaredError)
+{
+	if (meanSquaredError <= 0.0)
+	{
+		return std::numeric_limits<double>::infinity();
+	}
+
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+uint32_t TextureCompressor::GetNumChannels(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1:
+		return 3;
+	case TextureFormat::BC5:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+// Always writes a 4 colour block (color0 > color1) since BC3 interprets its colour block that way regardless,
+// except for single colour blocks where every index is 0 and the mode doesn't matter
+void TextureCompressor::EncodeBC1(const uint8_t texels[16][4], uint8_t* block)
+{
+	float start[4];
+	float end[4];
+	FitPrincipalAxis<3>(texels, start, end);
+
+	uint16_t bestColors[2] = {};
+	uint8_t bestIndices[16] = {};
+	float bestError = std::numeric_limits<float>::max();
+
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		uint16_t color0 = To565(start);
+		uint16_t color1 = To565(end);
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+			std::swap_ranges(start, start + 4, end);
+		}
+
+		float palette[4][4];
+		BC1Palette(color0, color1, palette);
+
+		uint8_t indices[16] = {};
+		const float error = AssignIndices<3>(texels, palette, color0 == color1 ? 1 : 4, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			bestColors[0] = color0;
+			bestColors[1] = color1;
+			std::copy_n(indices, 16, bestIndices);
+		}
+
+		if (error == 0.f || color0 == color1 || !RefineEndpoints<3>(texels, indices, s_BC1Weights, start, end))
+		{
+			break;
+		}
+	}
+
+	BlockWriter writer(block, 8);
+	writer.Write(bestColors[0], 16);
+	writer.Write(bestColors[1], 16);
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		writer.Write(bestIndices[i], 2);
+	}
+}
+
+// Uses the 8 value mode, with the largest value first. The values are evenly spaced, so the closest one
+// can be worked out directly instead of searched for.
+void TextureCompressor::EncodeBC4(const uint8_t texels[16][4], uint32_t channel, uint8_t* block)
+{
+	uint8_t minValue = 255;
+	uint8_t maxValue = 0;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		minValue = std::min(minValue, texels[i][channel]);
+		maxValue = std::max(maxValue, texels[i][channel]);
+	}
+
+	BlockWriter writer(block, 8);
+	writer.Write(maxValue, 8);
+	writer.Write(minValue, 8);
+
+	const float range = static_cast<float>(maxValue - minValue);
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		uint32_t index = 0;
+		if (range > 0.f)
+		{
+			// 0 is the max value and 7 the min, the entries between them are stored as 2-7
+			const uint32_t step = static_cast<uint32_t>((maxValue - texels[i][channel]) * 7.f / range + 0.5f);
+			index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+		}
+		writer.Write(index, 3);
+	}
+}
+
+// Mode 6: one subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices
+void TextureCompressor::EncodeBC7(const uint8_t texels[16][4], uint8_t* block)
+{
+	float weights[16];
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		weights[i] = s_BC7Weights[i] / 64.f;
+	}
+
+	float start[4];
+	float end[4];
+	FitPrincipalAxis<4>(texels, start, end);
+
+	uint32_t bestEndpoints[2][4] = {};
+	uint32_t bestPBits[2] = {};
+	uint8_t bestIndices[16] = {};
+	float bestError = std::numeric_limits<float>::max();
+
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		uint32_t endpoints[2][4];
+		uint32_t pBits[2];
+		QuantizeBC7Endpoint(start, endpoints[0], pBits[0]);
+		QuantizeBC7Endpoint(end, endpoints[1], pBits[1]);
+
+		float palette[16][4];
+		BC7Palette(endpoints[0], pBits[0], endpoints[1], pBits[1], palette);
+
+		uint8_t indices[16] = {};
+		const float error = AssignIndices<4>(texels, palette, 16, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			std::copy_n(&endpoints[0][0], 8, &bestEndpoints[0][0]);
+			std::copy_n(pBits, 2, bestPBits);
+			std::copy_n(indices, 16, bestIndices);
+		}
+
+		if (error == 0.f || !RefineEndpoints<4>(texels, indices, weights, start, end))
+		{
+			break;
+		}
+	}
+
+	// The first index is stored without its top bit, which is implied to be 0
+	if (bestIndices[0] & 8)
+	{
+		std::swap_ranges(bestEndpoints[0], bestEndpoints[0] + 4, bestEndpoints[1]);
+		std::swap(bestPBits[0], bestPBits[1]);
+		for (auto& index : bestIndices)
+		{
+			index = 15 - index;
+		}
+	}
+
+	BlockWriter writer(block, 16);
+	writer.Write(s_BC7Mode6, 7);
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		writer.Write(bestEndpoints[0][c], 7);
+		writer.Write(bestEndpoints[1][c], 7);
+	}
+	writer.Write(bestPBits[0], 1);
+	writer.Write(bestPBits[1], 1);
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		writer.Write(bestIndices[i], i == 0 ? 3 : 4);
+	}
+}
+
+void TextureCompressor::DecodeBC1(const uint8_t* block, uint8_t texels[16][4])
+{
+	BlockReader reader(block);
+	const uint16_t color0 = static_cast<uint16_t>(reader.Read(16));
+	const uint16_t color1 = static_cast<uint16_t>(reader.Read(16));
+
+	float palette[4][4];
+	BC1Palette(color0, color1, palette);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		const uint32_t index = reader.Read(2);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			texels[i][c] = static_cast<uint8_t>(palette[index][c] + 0.5f);
+		}
+	}
+}
+
+void TextureCompressor::DecodeBC4(const uint8_t* block, uint32_t channel, uint8_t texels[16][4])
+{
+	BlockReader reader(block);
+	const uint32_t value0 = reader.Read(8);
+	const uint32_t value1 = reader.Read(8);
+
+	uint32_t palette[8] = { value0, value1 };
+	for (uint32_t i = 2; i < 8; i++)
+	{
+		if (value0 > value1)
+		{
+			palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+		}
+		else if (i < 6)
+		{
+			palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+		}
+		else
+		{
+			palette[i] = i == 6 ? 0 : 255;
+		}
+	}
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		texels[i][channel] = static_cast<uint8_t>(palette[reader.Read(3)]);
+	}
+}
+
+void TextureCompressor::DecodeBC7(const uint8_t* block, uint8_t texels[16][4])
+{
+	BlockReader reader(block);
+	if (reader.Read(7) != s_BC7Mode6)
+	{
+		memset(texels, 0, 16 * 4);
+		return;
+	}
+
+	uint32_t endpoints[2][4];
+	for (uint32_t c = 0; c < 4; c++)
+	{
+		endpoints[0][c] = reader.Read(7);
+		endpoints[1][c] = reader.Read(7);
+	}
+	const uint32_t pBit0 = reader.Read(1);
+	const uint32_t pBit1 = reader.Read(1);
+
+	float palette[16][4];
+	BC7Palette(endpoints[0], pBit0, endpoints[1], pBit1, palette);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		const uint32_t index = reader.Read(i == 0 ? 3 : 4);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			texels[i][c] = static_cast<uint8_t>(palette[index][c]);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// Formats a texture can be cooked to. The BC formats store 4x4 blocks of texels in 8 (BC1) or 16 bytes.
+enum class TextureFormat : uint32_t
+{
+	RGBA8,
+	BC1, // RGB, 4 bits per texel
+	BC3, // RGBA, BC1 colour plus a BC4 alpha block, 8 bits per texel
+	BC5, // Two BC4 channels (normal map X and Y), 8 bits per texel
+	BC7  // RGBA, 8 bits per texel, much better colour quality than BC1
+};
+
+// CPU block compression encoder. It doesn't touch the graphics device, so it can run on the ThreadPool
+// during import and be checked headlessly with Decompress().
+//
+// The encoders aim for decent quality at a speed that is fine for a one time cook, not for the best
+// possible quality: colour endpoints come from the principal axis of the block and are refined once
+// with a least squares fit, and BC7 only uses mode 6 (one subset, RGBA, 16 colour palette).
+class TextureCompressor
+{
+public:
+	// Compresses a tightly packed RGBA8 image. Sides that aren't a multiple of 4 are padded by repeating the
+	// edge texels, which is what D3D expects for the smallest mips.
+	static std::vector<uint8_t> Compress(TextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height);
+
+	// Decodes back to RGBA8, only understands the block modes that Compress() writes. Channels a format
+	// doesn't store come back as 0 (BC5 blue) or 255 (alpha).
+	static std::vector<uint8_t> Decompress(TextureFormat format, const uint8_t* data, uint32_t width, uint32_t height);
+
+	static bool IsBlockCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+	// Bytes per 4x4 block, or per texel for RGBA8
+	static uint32_t GetBlockSize(TextureFormat format);
+	static uint32_t GetRowPitch(TextureFormat format, uint32_t width);
+	static uint32_t GetSize(TextureFormat format, uint32_t width, uint32_t height);
+
+	// Mean squared error per channel between two RGBA8 images, only the first numChannels channels are compared
+	static double MeanSquaredError(const uint8_t* a, const uint8_t* b, uint32_t width, uint32_t height, uint32_t numChannels = 4);
+	// Peak signal to noise ratio in dB of a mean squared error between 8 bit channels, infinite if there was no error
+	static double GetPsnr(double meanSquaredError);
+	// How many of the RGBA channels a format keeps, which are the ones worth comparing. BC1's 1 bit alpha isn't used.
+	static uint32_t GetNumChannels(TextureFormat format);
+
+private:
+	static void EncodeBC1(const uint8_t texels[16][4], uint8_t* block);
+	static void EncodeBC4(const uint8_t texels[16][4], uint32_t channel, uint8_t* block);
+	static void EncodeBC7(const uint8_t texels[16][4], uint8_t* block);
+
+	static void DecodeBC1(const uint8_t* block, uint8_t texels[16][4]);
+	static void DecodeBC4(const uint8_t* block, uint32_t channel, uint8_t texels[16][4]);
+	static void DecodeBC7(const uint8_t* block, uint8_t texels[16][4]);
+};
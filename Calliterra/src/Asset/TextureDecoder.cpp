@@ -0,0 +1,221 @@
+#include "pch.h"
+#include "TextureDecoder.h"
+#include "TextureCache.h"
+#include "MipGenerator.h"
+#include "Material.h"
+#include "Core/ThreadPool.h"
+#include "Core/VirtualFileSystem.h"
+#include "Core/ImportProfiler.h"
+#include "stb_image.h"
+#include "stb_image_target.h"
+
+TextureUsage TextureDecoder::GetUsage(uint32_t slot)
+{
+	switch (slot)
+	{
+	case Material::Specular:
+		return TextureUsage::Specular;
+	case Material::Normal:
+		return TextureUsage::NormalMap;
+	default:
+		return TextureUsage::Color;
+	}
+}
+
+void TextureDecoder::Prefetch(const std::vector<std::pair<std::string, TextureUsage>>& textures)
+{
+	std::scoped_lock lock(s_Mutex);
+	for (const auto& [filepath, usage] : textures)
+	{
+		const std::string key = GetKey(filepath, usage);
+		if (s_Pending.contains(key) || s_Acquired.contains(key))
+		{
+			continue;
+		}
+
+		s_Pending[key] = ThreadPool::Submit([filepath, usage]() { return Cook(filepath, usage); }).share();
+	}
+}
+
+std::shared_ptr<CookedTexture> TextureDecoder::Acquire(const std::string& filepath, TextureUsage usage)
+{
+	const std::string key = GetKey(filepath, usage);
+
+	std::shared_future<std::shared_ptr<CookedTexture>> pending;
+	{
+		std::scoped_lock lock(s_Mutex);
+		s_Acquired.insert(key);
+
+		const auto it = s_Pending.find(key);
+		if (it != s_Pending.end())
+		{
+			pending = std::move(it->second);
+			s_Pending.erase(it);
+		}
+	}
+
+	if (pending.valid())
+	{
+		return pending.get();
+	}
+
+	return Cook(filepath, usage);
+}
+
+bool TextureDecoder::IsReady(const std::string& filepath, TextureUsage usage)
+{
+	std::scoped_lock lock(s_Mutex);
+	const auto it = s_Pending.find(GetKey(filepath, usage));
+
+	return it == s_Pending.end() || it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void TextureDecoder::Shutdown()
+{
+	std::scoped_lock lock(s_Mutex);
+	for (auto& [key, pending] : s_Pending)
+	{
+		pending.wait();
+	}
+	s_Pending.clear();
+	s_Acquired.clear();
+}
+
+// Builds the full mip chain from the decoded image and compresses every level. D3D only allows block
+// compressed textures whose top level is a whole number of blocks, anything else stays RGBA8.
+std::shared_ptr<CookedTexture> TextureDecoder::Cook(const std::string& filepath, TextureUsage usage)
+{
+	PROFILE_IMPORT("TextureDecoder::Cook", filepath);
+	{
+		PROFILE_IMPORT_STAGE("TextureCache::Load");
+		if (std::shared_ptr<CookedTexture> cached = TextureCache::Load(filepath, usage))
+		{
+			return cached;
+		}
+	}
+
+	Timer timer;
+	std::shared_ptr<DecodedImage> image = Decode(filepath);
+	const uint32_t width = static_cast<uint32_t>(image->Width);
+	const uint32_t height = static_cast<uint32_t>(image->Height);
+	const size_t numTexels = static_cast<size_t>(width) * height;
+
+	std::shared_ptr<CookedTexture> texture = std::make_shared<CookedTexture>();
+	if (usage != TextureUsage::NormalMap)
+	{
+		for (size_t i = 0; i < numTexels && !texture->HasAlpha; i++)
+		{
+			texture->HasAlpha = image->Pixels[i * 4 + 3] != 255;
+		}
+	}
+
+	if (width % 4 != 0 || height % 4 != 0)
+	{
+		texture->Format = TextureFormat::RGBA8;
+	}
+	else if (usage == TextureUsage::NormalMap)
+	{
+		texture->Format = TextureFormat::BC5;
+	}
+	else
+	{
+		texture->Format = texture->HasAlpha ? TextureFormat::BC3 : TextureFormat::BC7;
+	}
+
+	// Specular maps keep the specular power in alpha, only albedo alpha is used for alpha testing
+	MipSettings mipSettings;
+	mipSettings.IsSrgb = usage != TextureUsage::NormalMap;
+	mipSettings.IsNormalMap = usage == TextureUsage::NormalMap;
+	mipSettings.AlphaCutoff = usage == TextureUsage::Color && texture->HasAlpha ? s_AlphaTestCutoff : 0.f;
+
+	std::vector<MipLevel> mips;
+	{
+		PROFILE_IMPORT_STAGE("Generate mips");
+		mips = MipGenerator::Generate(image->Pixels, width, height, mipSettings);
+		for (const auto& mip : mips)
+		{
+			ImportProfiler::AddBytesAllocated(mip.Pixels.size());
+		}
+	}
+	image.reset();
+	const double mipTime = timer.GetElapsedInMilliseconds();
+
+	{
+		PROFILE_IMPORT_STAGE("Compress");
+		for (const auto& mip : mips)
+		{
+			std::vector<uint8_t> data = TextureCompressor::Compress(texture->Format, mip.Pixels.data(), mip.Width, mip.Height);
+			texture->Mips.push_back({ mip.Width, mip.Height, TextureCompressor::GetRowPitch(texture->Format, mip.Width), static_cast<uint32_t>(texture->Storage.size()), static_cast<uint32_t>(data.size()) });
+			texture->Storage.insert(texture->Storage.end(), data.begin(), data.end());
+		}
+	}
+	texture->Data = texture->Storage.data();
+	ImportProfiler::AddBytesAllocated(texture->Storage.size());
+
+	LOG_DEBUG("Cooked {} ({} mips) in {:.2f}ms, {:.2f}ms of it decoding and generating mips", filepath, texture->Mips.size(), timer.GetElapsedInMilliseconds(), mipTime);
+
+	{
+		PROFILE_IMPORT_STAGE("TextureCache::Store");
+		TextureCache::Store(filepath, usage, *texture);
+	}
+
+	// Streamed textures hold on to their cooked data for as long as they live, so it's better off in the
+	// mapped cache entry where the OS can page it out than in our own memory
+	if (std::shared_ptr<CookedTexture> cached = TextureCache::Load(filepath, usage))
+	{
+		return cached;
+	}
+
+	return texture;
+}
+
+std::shared_ptr<DecodedImage> TextureDecoder::Decode(const std::string& filepath)
+{
+	PROFILE_IMPORT("Decode", filepath);
+	LOG_DEBUG("Decoding {}", filepath);
+
+	const AssetFile file = VirtualFileSystem::Open(filepath);
+	ASSERT(file.IsOpen(), "Failed to open " + filepath);
+
+	std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+	if (!stbi_info_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &image->Width, &image->Height, &image->NumChannels))
+	{
+		ASSERT(false, stbi_failure_reason());
+		return image;
+	}
+
+	// Like the cube map faces, the image is decoded straight into pooled memory. The extra byte is stb_image's
+	// slack, see stbi_set_output_target.
+	const size_t size = static_cast<size_t>(image->Width) * image->Height * s_DesiredChannels;
+	image->Staging = BufferPool::Acquire(size + 1);
+	ImportProfiler::AddBytesAllocated(image->Staging.GetSize());
+
+	int width, height, numChannels;
+	stbi_set_output_target(image->Staging.GetData(), size);
+	stbi_uc* pixels = stbi_load_from_memory(file.GetData(), static_cast<int>(file.GetSize()), &width, &height, &numChannels, s_DesiredChannels);
+	stbi_set_output_target(nullptr, 0);
+	ASSERT(pixels, stbi_failure_reason());
+
+	const bool isValid = pixels && width == image->Width && height == image->Height;
+	if (pixels != image->Staging.GetData())
+	{
+		// stb_image needed another buffer of the same size along the way and returned that one
+		if (isValid)
+		{
+			memcpy(image->Staging.GetData(), pixels, size);
+		}
+		stbi_image_free(pixels);
+	}
+
+	if (isValid)
+	{
+		image->Pixels = image->Staging.GetData();
+	}
+
+	return image;
+}
+
+std::string TextureDecoder::GetKey(const std::string& filepath, TextureUsage usage)
+{
+	return filepath + "#" + std::to_string(static_cast<uint32_t>(usage));
+}
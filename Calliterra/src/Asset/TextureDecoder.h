@@ -0,0 +1,88 @@
+#pragma once
+#include <future>
+#include <mutex>
+#include "TextureCompressor.h"
+#include "Core/MappedFile.h"
+#include "Core/BufferPool.h"
+
+// Decoded RGBA8 pixels of an image file, they go back to the BufferPool once the last reference goes away
+struct DecodedImage
+{
+	BufferPool::Buffer Staging;
+	unsigned char* Pixels = nullptr; // Into Staging
+	int Width = 0;
+	int Height = 0;
+	int NumChannels = 0; // Channels in the source file, Pixels always holds 4
+};
+
+// What a texture holds decides the format it is cooked to
+enum class TextureUsage : uint32_t
+{
+	Color,     // BC7, or BC3 if any texel isn't fully opaque. Alpha is used for alpha testing.
+	NormalMap, // BC5, only X and Y are kept and the shader rebuilds Z
+	Specular   // Same formats as Color, but alpha holds the specular power
+};
+
+// A texture that is ready to be uploaded as is: every mip level, block compressed where the size allows it.
+// The data is either owned or points straight into a memory mapped cache entry.
+struct CookedTexture
+{
+	struct Mip
+	{
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t RowPitch;
+		uint32_t Offset; // Into Data
+		uint32_t Size;
+	};
+
+	const uint8_t* GetMipData(size_t mip) const { return Data + Mips[mip].Offset; }
+
+	TextureFormat Format = TextureFormat::RGBA8;
+	bool HasAlpha = false;
+	std::vector<Mip> Mips;
+
+	const uint8_t* Data = nullptr;
+	std::vector<uint8_t> Storage;
+	MappedFile File;
+};
+
+// Decoding image files, generating their mips and block compressing them is by far the slowest part of
+// creating a texture. Textures that we know we'll need (e.g. every map of a model's materials) can be
+// prefetched and cooked on the ThreadPool, and the result is kept in the TextureCache so later launches
+// only have to map it. Textures then only have to Acquire() the cooked texture and upload it.
+class TextureDecoder
+{
+public:
+	// Textures are bound to the slot of their material map type, so the slot tells us what they hold
+	static TextureUsage GetUsage(uint32_t slot);
+
+	static void Prefetch(const std::vector<std::pair<std::string, TextureUsage>>& textures);
+
+	// Returns the cooked texture, waiting on it if it's still being cooked. Textures that were
+	// never prefetched are cooked on the calling thread.
+	static std::shared_ptr<CookedTexture> Acquire(const std::string& filepath, TextureUsage usage);
+
+	// True if acquiring the texture right now won't have to wait on it being cooked
+	static bool IsReady(const std::string& filepath, TextureUsage usage);
+
+	static void Shutdown();
+
+	// Only decodes the image, for comparing the cooked texture against its source
+	static std::shared_ptr<DecodedImage> Decode(const std::string& filepath);
+
+private:
+	static std::shared_ptr<CookedTexture> Cook(const std::string& filepath, TextureUsage usage);
+	static std::string GetKey(const std::string& filepath, TextureUsage usage);
+
+private:
+	inline static constexpr int s_DesiredChannels = 4;
+	// Matches the clip() in BPhongMapPS.hlsl
+	inline static constexpr float s_AlphaTestCutoff = 0.1f;
+
+	inline static std::unordered_map<std::string, std::shared_future<std::shared_ptr<CookedTexture>>> s_Pending;
+	// Textures that have already been handed out, prefetching them again would only waste memory
+	// since the texture has already been created.
+	inline static std::unordered_set<std::string> s_Acquired;
+	inline static std::mutex s_Mutex;
+};
@@ -0,0 +1,650 @@
+#include "pch.h"
+#include "VertexKernels.h"
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#define AVX2_FUNCTION
+#else
+	// GCC and Clang only allow AVX intrinsics in functions that are compiled for AVX, the rest of the file
+	// mustn't be or the compiler would be free to use AVX on CPUs that don't have it
+	#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+	constexpr size_t FullStride = sizeof(ModelVertexFull) / sizeof(float);
+	constexpr float s_Zeros[2] = {};
+	static_assert(sizeof(ModelVertexFull) == sizeof(float) * 14);
+
+	// What to do with every float of 4 consecutive ModelVertexFull, which lines up with 7 AVX (or 14 SSE)
+	// registers. Sign holds -0.f where the value gets negated, Offset is added afterwards.
+	struct VertexPattern
+	{
+		alignas(32) float Sign[FullStride * 4];
+		alignas(32) float Offset[FullStride * 4];
+	};
+
+	constexpr VertexPattern MakePattern(const float(&sign)[FullStride], const float(&offset)[FullStride])
+	{
+		VertexPattern pattern = {};
+		for (size_t i = 0; i < FullStride * 4; i++)
+		{
+			pattern.Sign[i] = sign[i % FullStride];
+			pattern.Offset[i] = offset[i % FullStride];
+		}
+		return pattern;
+	}
+
+	//                                          Position      Normal        Tangent       Bitangent     Texture
+	constexpr VertexPattern s_FlipTexcoordV = MakePattern(
+		{ 0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, -0.f },
+		{ 0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 1.f });
+	constexpr VertexPattern s_FlipHandedness = MakePattern(
+		{ 0.f, 0.f, -0.f, 0.f, 0.f, -0.f, 0.f, 0.f, -0.f, 0.f, 0.f, -0.f, 0.f, -0.f },
+		{ 0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 0.f, 0.f,  0.f, 1.f });
+
+	void ApplyPatternScalar(float* data, size_t floatCount, const VertexPattern& pattern)
+	{
+		for (size_t i = 0; i < floatCount; i++)
+		{
+			const size_t lane = i % FullStride;
+			data[i] = (std::signbit(pattern.Sign[lane]) ? -data[i] : data[i]) + pattern.Offset[lane];
+		}
+	}
+
+	// Returns the number of vertices that were processed
+	size_t ApplyPatternSSE(ModelVertexFull* vertices, size_t count, const VertexPattern& pattern)
+	{
+		constexpr size_t registers = FullStride * 2 / 4;
+
+		__m128 sign[registers];
+		__m128 offset[registers];
+		for (size_t r = 0; r < registers; r++)
+		{
+			sign[r] = _mm_load_ps(&pattern.Sign[r * 4]);
+			offset[r] = _mm_load_ps(&pattern.Offset[r * 4]);
+		}
+
+		float* data = &vertices[0].Position.x;
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			float* block = data + i * FullStride;
+			for (size_t r = 0; r < registers; r++)
+			{
+				const __m128 value = _mm_loadu_ps(block + r * 4);
+				_mm_storeu_ps(block + r * 4, _mm_add_ps(_mm_xor_ps(value, sign[r]), offset[r]));
+			}
+		}
+
+		return i;
+	}
+
+	AVX2_FUNCTION size_t ApplyPatternAVX2(ModelVertexFull* vertices, size_t count, const VertexPattern& pattern)
+	{
+		constexpr size_t registers = FullStride * 4 / 8;
+
+		__m256 sign[registers];
+		__m256 offset[registers];
+		for (size_t r = 0; r < registers; r++)
+		{
+			sign[r] = _mm256_load_ps(&pattern.Sign[r * 8]);
+			offset[r] = _mm256_load_ps(&pattern.Offset[r * 8]);
+		}
+
+		float* data = &vertices[0].Position.x;
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			float* block = data + i * FullStride;
+			for (size_t r = 0; r < registers; r++)
+			{
+				const __m256 value = _mm256_loadu_ps(block + r * 8);
+				_mm256_storeu_ps(block + r * 8, _mm256_add_ps(_mm256_xor_ps(value, sign[r]), offset[r]));
+			}
+		}
+
+		_mm256_zeroupper();
+		return i;
+	}
+
+	void ApplyPattern(ModelVertexFull* vertices, size_t count, const VertexPattern& pattern, bool avx2)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		size_t done = avx2 ? ApplyPatternAVX2(vertices, count, pattern) : 0;
+		done += ApplyPatternSSE(vertices + done, count - done, pattern);
+		ApplyPatternScalar(&vertices[done].Position.x, (count - done) * FullStride, pattern);
+	}
+
+	// Returns how many of the indices it gathered, always a multiple of 8
+	AVX2_FUNCTION size_t GatherIndicesAVX2(const uint32_t* table, const uint32_t* indices, size_t count, int32_t* out)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 4));
+		}
+
+		_mm256_zeroupper();
+		return i;
+	}
+
+	// Writes xyz without touching the float after it, which belongs to the next attribute
+	inline void StoreFloat3(float* dst, __m128 value)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(dst), value);
+		_mm_store_ss(dst + 2, _mm_movehl_ps(value, value));
+	}
+
+	inline __m128 LoadFloat3(const float* src)
+	{
+		return _mm_set_ps(0.f, src[2], src[1], src[0]);
+	}
+
+	inline __m128 LoadFloat2(const float* src)
+	{
+		return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(src)));
+	}
+
+	// Splits 4 tightly packed float3s (3 registers worth) into one register each, w is left over from the loads
+	inline void LoadFloat3x4(const float* src, __m128(&out)[4])
+	{
+		const __m128 a = _mm_loadu_ps(src);     // x0 y0 z0 x1
+		const __m128 b = _mm_loadu_ps(src + 4); // y1 z1 x2 y2
+		const __m128 c = _mm_loadu_ps(src + 8); // z2 x3 y3 z3
+
+		const __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 3));
+		out[0] = a;
+		out[1] = _mm_shuffle_ps(ab, ab, _MM_SHUFFLE(3, 3, 2, 1));
+		out[2] = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2));
+		out[3] = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 2, 1));
+	}
+
+	// Loads the indices of 4 vertices and a mask of the ones that are inside [0, srcCount)
+	inline __m128i LoadIndices4(const int32_t* indices, size_t indexStride, size_t srcCount, __m128i& inRange)
+	{
+		const __m128i index = _mm_setr_epi32(indices[0], indices[indexStride], indices[indexStride * 2], indices[indexStride * 3]);
+		inRange = _mm_and_si128(
+			_mm_cmpgt_epi32(index, _mm_set1_epi32(-1)),
+			_mm_cmpgt_epi32(_mm_set1_epi32(static_cast<int32_t>(srcCount)), index));
+		return index;
+	}
+
+	// Loads the indices of 8 vertices and a mask of the ones that are inside [0, srcCount)
+	AVX2_FUNCTION inline __m256i LoadIndices8(const int32_t* indices, size_t indexStride, size_t srcCount, __m256i& inRange)
+	{
+		const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int32_t>(indexStride)));
+		const __m256i index = _mm256_i32gather_epi32(reinterpret_cast<const int*>(indices), offsets, 4);
+		inRange = _mm256_and_si256(
+			_mm256_cmpgt_epi32(index, _mm256_set1_epi32(-1)),
+			_mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(srcCount)), index));
+		return index;
+	}
+
+	// The gathers return how many vertices they processed, always a multiple of 4 or 8. Lanes with an index
+	// out of range aren't loaded from at all, the masked gathers leave them at zero.
+	size_t GatherFloat3SSE(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+	{
+		const int32_t last = static_cast<int32_t>(srcCount) - 1;
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i inRange;
+			const __m128i index = LoadIndices4(indices + i * indexStride, indexStride, srcCount, inRange);
+
+			alignas(16) int32_t lanes[4];
+			alignas(16) int32_t masks[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+			_mm_store_si128(reinterpret_cast<__m128i*>(masks), inRange);
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				__m128 value = _mm_setzero_ps();
+				if (masks[lane])
+				{
+					// Loading 4 floats reads one past the element, so the last one is loaded on its own
+					const float* element = src + lanes[lane] * 3;
+					value = lanes[lane] == last ? LoadFloat3(element) : _mm_loadu_ps(element);
+				}
+				StoreFloat3(dst + (i + lane) * dstStride, value);
+			}
+		}
+
+		return i;
+	}
+
+	AVX2_FUNCTION size_t GatherFloat3AVX2(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i inRange;
+			const __m256i index = LoadIndices8(indices + i * indexStride, indexStride, srcCount, inRange);
+			const __m256i offset = _mm256_add_epi32(index, _mm256_add_epi32(index, index));
+			const __m256 mask = _mm256_castsi256_ps(inRange);
+
+			const __m256 x = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src, offset, mask, 4);
+			const __m256 y = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src + 1, offset, mask, 4);
+			const __m256 z = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src + 2, offset, mask, 4);
+
+			// Back to one xyz per register, vertex n in the low half and n + 4 in the high half
+			const __m256 xyLow = _mm256_unpacklo_ps(x, y);  // x0 y0 x1 y1 | x4 y4 x5 y5
+			const __m256 xyHigh = _mm256_unpackhi_ps(x, y); // x2 y2 x3 y3 | x6 y6 x7 y7
+			const __m256 zLow = _mm256_unpacklo_ps(z, z);   // z0 z0 z1 z1 | z4 z4 z5 z5
+			const __m256 zHigh = _mm256_unpackhi_ps(z, z);  // z2 z2 z3 z3 | z6 z6 z7 z7
+			const __m256 vertices[4] =
+			{
+				_mm256_shuffle_ps(xyLow, zLow, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xyLow, zLow, _MM_SHUFFLE(3, 2, 3, 2)),
+				_mm256_shuffle_ps(xyHigh, zHigh, _MM_SHUFFLE(1, 0, 1, 0)),
+				_mm256_shuffle_ps(xyHigh, zHigh, _MM_SHUFFLE(3, 2, 3, 2))
+			};
+
+			for (size_t n = 0; n < 4; n++)
+			{
+				StoreFloat3(dst + (i + n) * dstStride, _mm256_castps256_ps128(vertices[n]));
+				StoreFloat3(dst + (i + n + 4) * dstStride, _mm256_extractf128_ps(vertices[n], 1));
+			}
+		}
+
+		_mm256_zeroupper();
+		return i;
+	}
+
+	size_t GatherFloat2SSE(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i inRange;
+			const __m128i index = LoadIndices4(indices + i * indexStride, indexStride, srcCount, inRange);
+
+			alignas(16) int32_t lanes[4];
+			alignas(16) int32_t masks[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+			_mm_store_si128(reinterpret_cast<__m128i*>(masks), inRange);
+
+			// Two vertices per register
+			const __m128 first = _mm_loadh_pi(
+				masks[0] ? LoadFloat2(src + lanes[0] * 2) : _mm_setzero_ps(),
+				reinterpret_cast<const __m64*>(masks[1] ? src + lanes[1] * 2 : s_Zeros));
+			const __m128 second = _mm_loadh_pi(
+				masks[2] ? LoadFloat2(src + lanes[2] * 2) : _mm_setzero_ps(),
+				reinterpret_cast<const __m64*>(masks[3] ? src + lanes[3] * 2 : s_Zeros));
+
+			_mm_storel_pi(reinterpret_cast<__m64*>(dst + i * dstStride), first);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(dst + (i + 1) * dstStride), first);
+			_mm_storel_pi(reinterpret_cast<__m64*>(dst + (i + 2) * dstStride), second);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(dst + (i + 3) * dstStride), second);
+		}
+
+		return i;
+	}
+
+	AVX2_FUNCTION size_t GatherFloat2AVX2(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i inRange;
+			const __m256i index = LoadIndices8(indices + i * indexStride, indexStride, srcCount, inRange);
+			const __m256i offset = _mm256_add_epi32(index, index);
+			const __m256 mask = _mm256_castsi256_ps(inRange);
+
+			const __m256 x = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src, offset, mask, 4);
+			const __m256 y = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), src + 1, offset, mask, 4);
+			const __m256 xyLow = _mm256_unpacklo_ps(x, y);  // x0 y0 x1 y1 | x4 y4 x5 y5
+			const __m256 xyHigh = _mm256_unpackhi_ps(x, y); // x2 y2 x3 y3 | x6 y6 x7 y7
+
+			const __m128 pairs[4] =
+			{
+				_mm256_castps256_ps128(xyLow),
+				_mm256_castps256_ps128(xyHigh),
+				_mm256_extractf128_ps(xyLow, 1),
+				_mm256_extractf128_ps(xyHigh, 1)
+			};
+			for (size_t n = 0; n < 4; n++)
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(dst + (i + n * 2) * dstStride), pairs[n]);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(dst + (i + n * 2 + 1) * dstStride), pairs[n]);
+			}
+		}
+
+		_mm256_zeroupper();
+		return i;
+	}
+}
+
+void VertexKernels::InterleaveFloat3(const float* src, size_t count, float* dst, size_t dstStride)
+{
+	// 4 vertices are exactly 3 registers, so the loads never read past the end
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 values[4];
+		LoadFloat3x4(src + i * 3, values);
+		for (size_t n = 0; n < 4; n++)
+		{
+			StoreFloat3(dst + (i + n) * dstStride, values[n]);
+		}
+	}
+
+	for (; i < count; i++)
+	{
+		StoreFloat3(dst + i * dstStride, LoadFloat3(src + i * 3));
+	}
+}
+
+void VertexKernels::InterleaveFloat2(const float* src, size_t count, float* dst, size_t dstStride, size_t srcStride)
+{
+	size_t i = 0;
+	if (srcStride == 2)
+	{
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 first = _mm_loadu_ps(src + i * 2);      // x0 y0 x1 y1
+			const __m128 second = _mm_loadu_ps(src + i * 2 + 4); // x2 y2 x3 y3
+			_mm_storel_pi(reinterpret_cast<__m64*>(dst + i * dstStride), first);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(dst + (i + 1) * dstStride), first);
+			_mm_storel_pi(reinterpret_cast<__m64*>(dst + (i + 2) * dstStride), second);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(dst + (i + 3) * dstStride), second);
+		}
+	}
+	else if (srcStride == 3)
+	{
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 values[4];
+			LoadFloat3x4(src + i * 3, values);
+			for (size_t n = 0; n < 4; n++)
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(dst + (i + n) * dstStride), values[n]);
+			}
+		}
+	}
+
+	for (; i < count; i++)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(dst + i * dstStride), LoadFloat2(src + i * srcStride));
+	}
+}
+
+void VertexKernels::GatherFloat3(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+{
+	size_t i = 0;
+	if (srcCount > 0)
+	{
+		i = HasAVX2() ? GatherFloat3AVX2(src, srcCount, indices, indexStride, count, dst, dstStride) : 0;
+		i += GatherFloat3SSE(src, srcCount, indices + i * indexStride, indexStride, count - i, dst + i * dstStride, dstStride);
+	}
+
+	for (; i < count; i++)
+	{
+		const int32_t index = indices[i * indexStride];
+		const bool inRange = index >= 0 && static_cast<size_t>(index) < srcCount;
+		StoreFloat3(dst + i * dstStride, inRange ? LoadFloat3(src + index * 3) : _mm_setzero_ps());
+	}
+}
+
+void VertexKernels::GatherFloat2(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride)
+{
+	size_t i = 0;
+	if (srcCount > 0)
+	{
+		i = HasAVX2() ? GatherFloat2AVX2(src, srcCount, indices, indexStride, count, dst, dstStride) : 0;
+		i += GatherFloat2SSE(src, srcCount, indices + i * indexStride, indexStride, count - i, dst + i * dstStride, dstStride);
+	}
+
+	for (; i < count; i++)
+	{
+		const int32_t index = indices[i * indexStride];
+		const bool inRange = index >= 0 && static_cast<size_t>(index) < srcCount;
+		_mm_storel_pi(reinterpret_cast<__m64*>(dst + i * dstStride), inRange ? LoadFloat2(src + index * 2) : _mm_setzero_ps());
+	}
+}
+
+void VertexKernels::GatherIndices(const uint32_t* table, const uint32_t* indices, size_t count, int32_t* out)
+{
+	size_t i = HasAVX2() ? GatherIndicesAVX2(table, indices, count, out) : 0;
+	for (; i < count; i++)
+	{
+		out[i] = static_cast<int32_t>(table[indices[i]]);
+	}
+}
+
+void VertexKernels::FlipTexcoordV(ModelVertexFull* vertices, size_t count)
+{
+	ApplyPattern(vertices, count, s_FlipTexcoordV, HasAVX2());
+}
+
+void VertexKernels::FlipHandedness(ModelVertexFull* vertices, size_t count)
+{
+	ApplyPattern(vertices, count, s_FlipHandedness, HasAVX2());
+}
+
+void VertexKernels::RunBenchmarks(size_t vertexCount, int iterations)
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> values(-100.f, 100.f);
+	std::uniform_int_distribution<int32_t> indexValues(0, static_cast<int32_t>(vertexCount) - 1);
+
+	std::vector<float> float3s(vertexCount * 3);
+	std::vector<float> float2s(vertexCount * 2);
+	std::vector<int32_t> indices(vertexCount);
+	std::vector<uint32_t> table(vertexCount);
+	std::vector<int32_t> gathered(vertexCount);
+	std::vector<ModelVertexFull> vertices(vertexCount);
+	for (auto& value : float3s) value = values(random);
+	for (auto& value : float2s) value = values(random);
+	for (auto& index : indices) index = indexValues(random);
+	for (auto& index : table) index = static_cast<uint32_t>(indexValues(random));
+
+	const auto time = [iterations](const std::function<void()>& func)
+	{
+		Timer timer;
+		for (int i = 0; i < iterations; i++)
+		{
+			func();
+		}
+		return timer.GetElapsedInMilliseconds() / iterations;
+	};
+
+	const auto report = [](const char* name, double scalarMs, double simdMs)
+	{
+		LOG_INFO("  {:<18} scalar {:7.3f}ms  simd {:7.3f}ms  ({:.2f}x)", name, scalarMs, simdMs, scalarMs / simdMs);
+	};
+
+	LOG_INFO("Vertex kernel benchmarks ({} vertices, AVX2 {})", vertexCount, HasAVX2() ? "on" : "off");
+
+	report("InterleaveFloat3",
+		time([&]() { for (size_t i = 0; i < vertexCount; i++) vertices[i].Position = { float3s[i * 3], float3s[i * 3 + 1], float3s[i * 3 + 2] }; }),
+		time([&]() { InterleaveFloat3(float3s.data(), vertexCount, &vertices[0].Position.x, FullStride); }));
+
+	report("InterleaveFloat2",
+		time([&]() { for (size_t i = 0; i < vertexCount; i++) vertices[i].Texture = { float2s[i * 2], float2s[i * 2 + 1] }; }),
+		time([&]() { InterleaveFloat2(float2s.data(), vertexCount, &vertices[0].Texture.x, FullStride); }));
+
+	report("GatherFloat3",
+		time([&]() { for (size_t i = 0; i < vertexCount; i++) { const float* p = &float3s[indices[i] * 3]; vertices[i].Normal = { p[0], p[1], p[2] }; } }),
+		time([&]() { GatherFloat3(float3s.data(), vertexCount, indices.data(), 1, vertexCount, &vertices[0].Normal.x, FullStride); }));
+
+	report("GatherFloat2",
+		time([&]() { for (size_t i = 0; i < vertexCount; i++) { const float* p = &float2s[indices[i] * 2]; vertices[i].Texture = { p[0], p[1] }; } }),
+		time([&]() { GatherFloat2(float2s.data(), vertexCount, indices.data(), 1, vertexCount, &vertices[0].Texture.x, FullStride); }));
+
+	report("GatherIndices",
+		time([&]() { for (size_t i = 0; i < vertexCount; i++) gathered[i] = static_cast<int32_t>(table[indices[i]]); }),
+		time([&]() { GatherIndices(table.data(), reinterpret_cast<const uint32_t*>(indices.data()), vertexCount, gathered.data()); }));
+
+	report("FlipTexcoordV",
+		time([&]() { for (auto& vertex : vertices) vertex.Texture.y = 1.f - vertex.Texture.y; }),
+		time([&]() { FlipTexcoordV(vertices.data(), vertexCount); }));
+
+	report("FlipHandedness",
+		time([&]() {
+			for (auto& vertex : vertices)
+			{
+				vertex.Position.z = -vertex.Position.z;
+				vertex.Normal.z = -vertex.Normal.z;
+				vertex.Tangent.z = -vertex.Tangent.z;
+				vertex.Bitangent.z = -vertex.Bitangent.z;
+				vertex.Texture.y = 1.f - vertex.Texture.y;
+			}
+		}),
+		time([&]() { FlipHandedness(vertices.data(), vertexCount); }));
+}
+
+// The inputs cover what the SIMD loops hand over to their scalar tails: counts that aren't a multiple of the
+// register width, strided indices that are negative or past the end and Assimp's float3 UVs
+bool VertexKernels::MatchesScalar()
+{
+	constexpr size_t indexStride = 2;
+	bool matches = true;
+
+	for (size_t count : { 1, 3, 4, 7, 8, 13, 1021 })
+	{
+		std::mt19937 random(static_cast<uint32_t>(count));
+		std::uniform_real_distribution<float> values(-100.f, 100.f);
+		std::uniform_int_distribution<int32_t> indexValues(-2, static_cast<int32_t>(count) + 1);
+		std::uniform_int_distribution<uint32_t> tableIndexValues(0, count > 0 ? static_cast<uint32_t>(count) - 1 : 0);
+
+		std::vector<float> float3s(count * 3);
+		std::vector<float> float2s(count * 2);
+		std::vector<int32_t> indices(count * indexStride);
+		std::vector<uint32_t> table(count);
+		std::vector<uint32_t> tableIndices(count);
+		std::vector<ModelVertexFull> vertices(count);
+		for (auto& value : float3s) value = values(random);
+		for (auto& value : float2s) value = values(random);
+		for (auto& index : indices) index = indexValues(random);
+		for (auto& index : table) index = tableIndexValues(random);
+		for (auto& index : tableIndices) index = tableIndexValues(random);
+		for (size_t i = 0; i < count * FullStride; i++) (&vertices[0].Position.x)[i] = values(random);
+
+		const auto inRange = [count](int32_t index) { return index >= 0 && static_cast<size_t>(index) < count; };
+
+		// Both sides start from the same vertices, so whatever a kernel isn't supposed to write has to match as well
+		const auto check = [&](const char* name, const std::function<void(ModelVertexFull*)>& scalar, const std::function<void(ModelVertexFull*)>& kernel)
+		{
+			std::vector<ModelVertexFull> expected = vertices;
+			std::vector<ModelVertexFull> actual = vertices;
+			scalar(expected.data());
+			kernel(actual.data());
+
+			const float* expectedFloats = reinterpret_cast<const float*>(expected.data());
+			const float* actualFloats = reinterpret_cast<const float*>(actual.data());
+			for (size_t i = 0; i < count * FullStride; i++)
+			{
+				if (expectedFloats[i] != actualFloats[i])
+				{
+					LOG_ERROR("{} doesn't match the scalar loop for {} vertices, float {} of vertex {} is {} instead of {}",
+						name, count, i % FullStride, i / FullStride, actualFloats[i], expectedFloats[i]);
+					matches = false;
+					return;
+				}
+			}
+		};
+
+		check("InterleaveFloat3",
+			[&](ModelVertexFull* v) { for (size_t i = 0; i < count; i++) v[i].Position = { float3s[i * 3], float3s[i * 3 + 1], float3s[i * 3 + 2] }; },
+			[&](ModelVertexFull* v) { InterleaveFloat3(float3s.data(), count, &v[0].Position.x, FullStride); });
+
+		check("InterleaveFloat2",
+			[&](ModelVertexFull* v) { for (size_t i = 0; i < count; i++) v[i].Texture = { float2s[i * 2], float2s[i * 2 + 1] }; },
+			[&](ModelVertexFull* v) { InterleaveFloat2(float2s.data(), count, &v[0].Texture.x, FullStride); });
+
+		check("InterleaveFloat2 (float3 source)",
+			[&](ModelVertexFull* v) { for (size_t i = 0; i < count; i++) v[i].Texture = { float3s[i * 3], float3s[i * 3 + 1] }; },
+			[&](ModelVertexFull* v) { InterleaveFloat2(float3s.data(), count, &v[0].Texture.x, FullStride, 3); });
+
+		check("GatherFloat3",
+			[&](ModelVertexFull* v)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const int32_t index = indices[i * indexStride];
+					v[i].Normal = inRange(index) ? DX::XMFLOAT3(float3s[index * 3], float3s[index * 3 + 1], float3s[index * 3 + 2]) : DX::XMFLOAT3(0.f, 0.f, 0.f);
+				}
+			},
+			[&](ModelVertexFull* v) { GatherFloat3(float3s.data(), count, indices.data(), indexStride, count, &v[0].Normal.x, FullStride); });
+
+		check("GatherFloat2",
+			[&](ModelVertexFull* v)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const int32_t index = indices[i * indexStride];
+					v[i].Texture = inRange(index) ? DX::XMFLOAT2(float2s[index * 2], float2s[index * 2 + 1]) : DX::XMFLOAT2(0.f, 0.f);
+				}
+			},
+			[&](ModelVertexFull* v) { GatherFloat2(float2s.data(), count, indices.data(), indexStride, count, &v[0].Texture.x, FullStride); });
+
+		check("FlipTexcoordV",
+			[&](ModelVertexFull* v) { for (size_t i = 0; i < count; i++) v[i].Texture.y = 1.f - v[i].Texture.y; },
+			[&](ModelVertexFull* v) { FlipTexcoordV(v, count); });
+
+		check("FlipHandedness",
+			[&](ModelVertexFull* v)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					v[i].Position.z = -v[i].Position.z;
+					v[i].Normal.z = -v[i].Normal.z;
+					v[i].Tangent.z = -v[i].Tangent.z;
+					v[i].Bitangent.z = -v[i].Bitangent.z;
+					v[i].Texture.y = 1.f - v[i].Texture.y;
+				}
+			},
+			[&](ModelVertexFull* v) { FlipHandedness(v, count); });
+
+		std::vector<int32_t> gathered(count);
+		GatherIndices(table.data(), tableIndices.data(), count, gathered.data());
+		for (size_t i = 0; i < count; i++)
+		{
+			if (gathered[i] != static_cast<int32_t>(table[tableIndices[i]]))
+			{
+				LOG_ERROR("GatherIndices doesn't match the scalar loop for {} indices, index {} is {} instead of {}", count, i, gathered[i], table[tableIndices[i]]);
+				matches = false;
+				break;
+			}
+		}
+	}
+
+	return matches;
+}
+
+bool VertexKernels::HasAVX2()
+{
+#ifndef _MSC_VER
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+#else
+	static const bool hasAVX2 = []()
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+
+		// The OS also has to save the upper halves of the registers for us
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+#endif
+
+	return hasAVX2;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "ModelData.h"
+
+// Bulk conversions that the importers run over whole attribute streams instead of one vertex at a time.
+// Strides are in floats, so writing positions into ModelVertexFull is
+//   InterleaveFloat3(positions, count, &vertices[0].Position.x, VertexKernels::Stride<ModelVertexFull>());
+//
+// Everything has an SSE implementation, the kernels that benefit from it also have an AVX2 one that is
+// picked at runtime if the CPU supports it.
+class VertexKernels
+{
+public:
+	template<typename Vertex>
+	static constexpr size_t Stride() { return sizeof(Vertex) / sizeof(float); }
+
+	// dst[i * dstStride] = src[i] for tightly packed float3/float2 sources (Assimp keeps its UVs as float3, hence srcStride)
+	static void InterleaveFloat3(const float* src, size_t count, float* dst, size_t dstStride);
+	static void InterleaveFloat2(const float* src, size_t count, float* dst, size_t dstStride, size_t srcStride = 2);
+
+	// dst[i * dstStride] = src[indices[i * indexStride]], negative indices write zeros.
+	// srcCount is the number of float3/float2 elements in src.
+	static void GatherFloat3(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride);
+	static void GatherFloat2(const float* src, size_t srcCount, const int32_t* indices, size_t indexStride, size_t count, float* dst, size_t dstStride);
+
+	// out[i] = table[indices[i]], for attributes that are indexed twice (e.g. ufbx's per corner index into an attribute's index list)
+	static void GatherIndices(const uint32_t* table, const uint32_t* indices, size_t count, int32_t* out);
+
+	// v = 1 - v
+	static void FlipTexcoordV(ModelVertexFull* vertices, size_t count);
+
+	// Negates the z of every direction and position and flips v, the per vertex part of a right to left handed conversion
+	static void FlipHandedness(ModelVertexFull* vertices, size_t count);
+
+	// Times every kernel against a plain scalar loop and logs the results
+	static void RunBenchmarks(size_t vertexCount = 1 << 20, int iterations = 10);
+	// Runs every kernel and its scalar loop over the same input and logs where they differ. Only checks the
+	// SSE or AVX2 path this CPU picks.
+	static bool MatchesScalar();
+
+private:
+	static bool HasAVX2();
+};
@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "VertexPacking.h"
+#include <DirectXPackedVector.h>
+
+std::vector<ModelVertexPacked> VertexPacking::PackVertices(const std::vector<ModelVertexFull>& vertices, VertexQuantization& quantization)
+{
+	DX::XMVECTOR boundsMin = DX::XMVectorReplicate(std::numeric_limits<float>::max());
+	DX::XMVECTOR boundsMax = DX::XMVectorReplicate(-std::numeric_limits<float>::max());
+	for (const auto& vertex : vertices)
+	{
+		const DX::XMVECTOR position = DX::XMLoadFloat3(&vertex.Position);
+		boundsMin = DX::XMVectorMin(boundsMin, position);
+		boundsMax = DX::XMVectorMax(boundsMax, position);
+	}
+	if (vertices.empty())
+	{
+		boundsMin = DX::XMVectorZero();
+		boundsMax = DX::XMVectorZero();
+	}
+
+	// A flat mesh has no extent along one of the axes, anything non zero keeps the division valid
+	const DX::XMVECTOR extent = DX::XMVectorMax(DX::XMVectorSubtract(boundsMax, boundsMin), DX::XMVectorReplicate(1e-6f));
+	const DX::XMVECTOR invExtent = DX::XMVectorReciprocal(extent);
+
+	DX::XMStoreFloat3(&quantization.BoundsMin, boundsMin);
+	DX::XMStoreFloat3(&quantization.BoundsExtent, extent);
+	quantization.Padding0 = 0.f;
+	quantization.Padding1 = 0.f;
+
+	std::vector<ModelVertexPacked> packed(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const ModelVertexFull& vertex = vertices[i];
+		ModelVertexPacked& out = packed[i];
+
+		DX::XMFLOAT3 position;
+		DX::XMStoreFloat3(&position, DX::XMVectorMultiply(DX::XMVectorSubtract(DX::XMLoadFloat3(&vertex.Position), boundsMin), invExtent));
+		out.Position[0] = ToUNorm16(position.x);
+		out.Position[1] = ToUNorm16(position.y);
+		out.Position[2] = ToUNorm16(position.z);
+
+		// The shader rebuilds the bitangent as cross(normal, tangent), so only which way it points is kept
+		const DX::XMVECTOR normal = DX::XMLoadFloat3(&vertex.Normal);
+		const DX::XMVECTOR tangent = DX::XMLoadFloat3(&vertex.Tangent);
+		const float handedness = DX::XMVectorGetX(DX::XMVector3Dot(DX::XMVector3Cross(normal, tangent), DX::XMLoadFloat3(&vertex.Bitangent)));
+		out.Position[3] = handedness < 0.f ? 0 : std::numeric_limits<uint16_t>::max();
+
+		const DX::XMFLOAT2 octNormal = EncodeOctahedral(vertex.Normal);
+		out.Normal[0] = ToSNorm16(octNormal.x);
+		out.Normal[1] = ToSNorm16(octNormal.y);
+
+		const DX::XMFLOAT2 octTangent = EncodeOctahedral(vertex.Tangent);
+		out.Tangent[0] = ToSNorm16(octTangent.x);
+		out.Tangent[1] = ToSNorm16(octTangent.y);
+
+		out.Texture[0] = DX::PackedVector::XMConvertFloatToHalf(vertex.Texture.x);
+		out.Texture[1] = DX::PackedVector::XMConvertFloatToHalf(vertex.Texture.y);
+	}
+
+	return packed;
+}
+
+DX::XMFLOAT2 VertexPacking::EncodeOctahedral(const DX::XMFLOAT3& direction)
+{
+	const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+	if (length == 0.f)
+	{
+		return { 0.f, 0.f };
+	}
+
+	DX::XMFLOAT2 result = { direction.x / length, direction.y / length };
+
+	// The lower half of the octahedron is folded over onto the corners
+	if (direction.z < 0.f)
+	{
+		const float x = result.x;
+		result.x = (1.f - std::abs(result.y)) * (x >= 0.f ? 1.f : -1.f);
+		result.y = (1.f - std::abs(x)) * (result.y >= 0.f ? 1.f : -1.f);
+	}
+
+	return result;
+}
+
+uint16_t VertexPacking::ToUNorm16(float value)
+{
+	return static_cast<uint16_t>(std::clamp(value, 0.f, 1.f) * 65535.f + 0.5f);
+}
+
+int16_t VertexPacking::ToSNorm16(float value)
+{
+	return static_cast<int16_t>(std::round(std::clamp(value, -1.f, 1.f) * 32767.f));
+}
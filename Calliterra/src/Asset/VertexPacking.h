@@ -0,0 +1,26 @@
+#pragma once
+#include "ModelData.h"
+
+// What the vertex shader needs to turn the quantized positions back into model space,
+// laid out so it can be uploaded as a constant buffer as is.
+struct VertexQuantization
+{
+	DX::XMFLOAT3 BoundsMin;
+	float Padding0;
+	DX::XMFLOAT3 BoundsExtent;
+	float Padding1;
+};
+
+// Converts ModelVertexFull into the ModelVertexPacked format that the BPhongMapPacked shaders decode.
+class VertexPacking
+{
+public:
+	static std::vector<ModelVertexPacked> PackVertices(const std::vector<ModelVertexFull>& vertices, VertexQuantization& quantization);
+
+	// Maps a unit vector onto an octahedron and unfolds it into [-1, 1]^2
+	static DX::XMFLOAT2 EncodeOctahedral(const DX::XMFLOAT3& direction);
+
+private:
+	static uint16_t ToUNorm16(float value);
+	static int16_t ToSNorm16(float value);
+};
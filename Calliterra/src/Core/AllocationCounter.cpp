@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+
+#ifndef DISTRIBUTION
+
+namespace
+{
+	thread_local uint64_t t_Allocations = 0;
+}
+
+// The nothrow variants end up in these, only the aligned ones keep their own. The array and sized ones would
+// as well, but a runtime that replaces them itself (e.g. AddressSanitizer's) would then free what malloc allocated.
+void* operator new(std::size_t size)
+{
+	t_Allocations++;
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+	return t_Allocations;
+}
+
+bool AllocationCounter::IsEnabled()
+{
+	return true;
+}
+
+#else
+
+uint64_t AllocationCounter::GetCount()
+{
+	return 0;
+}
+
+bool AllocationCounter::IsEnabled()
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+
+// Counts the heap allocations made through operator new, to check that a stretch of code doesn't allocate
+// (e.g. render submission once the scene has been drawn a few times). The count is per thread, so work
+// running on the ThreadPool at the same time doesn't show up. Distribution builds don't replace
+// operator new and always report 0.
+class AllocationCounter
+{
+public:
+	// Allocations made by the calling thread so far
+	static uint64_t GetCount();
+	static bool IsEnabled();
+};
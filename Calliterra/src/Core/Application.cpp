@@ -3,6 +3,12 @@
 
 #include "Window.h"
 #include "Renderer/Renderer.h"
+#include "ThreadPool.h"
+#include "Asset/TextureDecoder.h"
+#include "Renderer/TextureStreamer.h"
+#include "VirtualFileSystem.h"
+#include "ImportProfiler.h"
+#include "BufferPool.h"
 
 Application::Application()
 {
@@ -22,6 +28,14 @@ Application::Application()
 	// m_Window->SetEventCallback(std::bind(&Application::OnEvent, this, std::placeholders::_1));
 	m_Window->SetEventCallback([this](Event& e) { return this->OnEvent(e); });
 
+	// Distribution builds ship the packed assets instead of the assets directory, without an archive
+	// everything is read from the loose files
+	VirtualFileSystem::Mount(s_AssetArchivePath);
+
+	// Records where the time loading assets goes, written out on exit
+	STRIP_DEBUG(ImportProfiler::SetEnabled(true));
+
+	ThreadPool::Init();
 	Renderer::Init(m_Window->GetGraphicsContext());
 	ModelLoader::Init();
 
@@ -32,7 +46,15 @@ Application::Application()
 Application::~Application()
 {
 	m_ModelLoader.Shutdown();
+	TextureStreamer::Shutdown();
+	TextureDecoder::Shutdown();
+	BufferPool::Clear();
 	Renderer::Shutdown();
+	ThreadPool::Shutdown();
+	VirtualFileSystem::Unmount();
+
+	STRIP_DEBUG(ImportProfiler::WriteJson(s_ImportProfilePath));
+	STRIP_DEBUG(ImportProfiler::WriteChromeTrace(s_ImportTracePath));
 }
 
 void Application::OnEvent(Event& e)
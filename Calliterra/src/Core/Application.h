@@ -37,6 +37,11 @@ private:
 	double m_LastFrameTime = 0.0;
 	inline static DeltaTime s_DeltaTime = DeltaTime();
 	inline static Timer s_ApplicationTimer = Timer();
+	// Written next to the executable by AssetPacker
+	inline static const char* s_AssetArchivePath = "assets.cpak";
+	// Open the trace in chrome://tracing or ui.perfetto.dev
+	inline static const char* s_ImportProfilePath = "cache/import_profile.json";
+	inline static const char* s_ImportTracePath = "cache/import_trace.json";
 	std::unique_ptr<Sandbox> m_Sandbox;
 	ImGuiManager m_ImGui;
 	ModelLoader m_ModelLoader;
@@ -1,10 +1,15 @@
 #pragma once
 
 #ifdef DEBUG
-	#define DEBUGBREAK() __debugbreak()
+	#ifdef _WIN32
+		#define DEBUGBREAK() __debugbreak()
+		#include <winerror.h>
+		#include <comdef.h>
+	#else
+		#include <csignal>
+		#define DEBUGBREAK() std::raise(SIGTRAP)
+	#endif
 	#define ENABLE_ASSERTS
-	#include <winerror.h>
-	#include <comdef.h>
 
 #else
 	#define DEBUGBREAK()
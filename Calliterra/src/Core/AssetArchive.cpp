@@ -0,0 +1,229 @@
+#include "pch.h"
+#include "AssetArchive.h"
+#include "BinaryStream.h"
+#include "Compression.h"
+
+AssetArchive::AssetArchive(const std::filesystem::path& filepath)
+	: m_File(filepath)
+{
+	if (!m_File.IsOpen())
+	{
+		return;
+	}
+
+	m_Data = static_cast<const uint8_t*>(m_File.GetData());
+	const size_t size = m_File.GetSize();
+
+	Header header = {};
+	BinaryReader reader(m_Data, size);
+	reader.ReadBytes(&header, sizeof(header));
+
+	const auto fits = [size](uint64_t offset, uint64_t bytes) { return offset <= size && bytes <= size - offset; };
+	if (!reader.IsValid() || header.Magic != s_Magic || header.Version != s_Version ||
+		!fits(header.EntriesOffset, static_cast<uint64_t>(header.NumEntries) * sizeof(Entry)) ||
+		!fits(header.SlotsOffset, static_cast<uint64_t>(header.NumSlots) * sizeof(uint32_t)) ||
+		!fits(header.PathsOffset, header.PathsSize) ||
+		(header.NumSlots & (header.NumSlots - 1)) != 0 || header.NumSlots <= header.NumEntries)
+	{
+		LOG_ERROR("{} is not a valid asset archive", filepath.string());
+		m_File = MappedFile();
+		m_Data = nullptr;
+		return;
+	}
+
+	m_Entries = reinterpret_cast<const Entry*>(m_Data + header.EntriesOffset);
+	m_Slots = reinterpret_cast<const uint32_t*>(m_Data + header.SlotsOffset);
+	m_Paths = reinterpret_cast<const char*>(m_Data + header.PathsOffset);
+	m_NumEntries = header.NumEntries;
+	m_NumSlots = header.NumSlots;
+
+	const auto reject = [this, &filepath]()
+		{
+			LOG_ERROR("{} is corrupt", filepath.string());
+			m_File = MappedFile();
+			m_Data = nullptr;
+			m_Entries = nullptr;
+			m_Slots = nullptr;
+			m_Paths = nullptr;
+			m_NumEntries = 0;
+			m_NumSlots = 0;
+		};
+
+	for (size_t i = 0; i < m_NumEntries; i++)
+	{
+		const Entry& entry = m_Entries[i];
+		if (!fits(entry.Offset, entry.StoredSize) || static_cast<uint64_t>(entry.PathOffset) + entry.PathLength > header.PathsSize)
+		{
+			reject();
+			return;
+		}
+	}
+
+	// Find indexes the entries with the slot values and stops probing at the first empty slot, so every value
+	// has to be an entry and no more slots can be taken than there are entries
+	size_t numTakenSlots = 0;
+	for (size_t slot = 0; slot < m_NumSlots; slot++)
+	{
+		if (m_Slots[slot] > m_NumEntries)
+		{
+			reject();
+			return;
+		}
+		numTakenSlots += m_Slots[slot] != 0 ? 1 : 0;
+	}
+
+	if (numTakenSlots > m_NumEntries)
+	{
+		reject();
+	}
+}
+
+const AssetArchive::Entry* AssetArchive::Find(const std::filesystem::path& filepath) const
+{
+	if (m_NumSlots == 0)
+	{
+		return nullptr;
+	}
+
+	const std::string path = NormalizePath(filepath);
+	const uint64_t hash = HashPath(path);
+	const size_t mask = m_NumSlots - 1;
+
+	// The table is never full, so we always hit an empty slot eventually
+	for (size_t slot = hash & mask; m_Slots[slot] != 0; slot = (slot + 1) & mask)
+	{
+		const Entry& entry = m_Entries[m_Slots[slot] - 1];
+		if (entry.Hash == hash && GetPath(entry) == path)
+		{
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
+std::string_view AssetArchive::GetPath(const Entry& entry) const
+{
+	return std::string_view(m_Paths + entry.PathOffset, entry.PathLength);
+}
+
+std::string AssetArchive::NormalizePath(const std::filesystem::path& filepath)
+{
+	std::string path = filepath.lexically_normal().generic_string();
+	if (path.starts_with("./"))
+	{
+		path.erase(0, 2);
+	}
+
+	std::transform(path.begin(), path.end(), path.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return path;
+}
+
+// FNV-1a
+uint64_t AssetArchive::HashPath(std::string_view normalizedPath)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : normalizedPath)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+bool AssetArchive::Write(const std::filesystem::path& archivePath, const std::vector<SourceFile>& files, bool compress)
+{
+	std::vector<Entry> entries(files.size());
+	std::vector<std::vector<uint8_t>> data(files.size());
+	std::string paths;
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		Entry& entry = entries[i];
+		const std::string path = NormalizePath(files[i].ArchivePath);
+		entry.Hash = HashPath(path);
+		entry.PathOffset = static_cast<uint32_t>(paths.size());
+		entry.PathLength = static_cast<uint32_t>(path.size());
+		entry.Compression = EntryCompression::None;
+		paths += path;
+
+		std::error_code error;
+		const auto writeTime = std::filesystem::last_write_time(files[i].Filepath, error);
+		entry.WriteTime = error ? 0 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+		std::vector<uint8_t>& contents = data[i];
+		contents.resize(std::filesystem::file_size(files[i].Filepath, error));
+		std::ifstream file(files[i].Filepath, std::ios::binary);
+		if (error || !file || !file.read(reinterpret_cast<char*>(contents.data()), contents.size()))
+		{
+			LOG_ERROR("Failed to read {}", files[i].Filepath.string());
+			return false;
+		}
+		entry.Size = contents.size();
+
+		if (compress)
+		{
+			std::vector<uint8_t> compressed = Compression::Compress(contents.data(), contents.size());
+			if (!compressed.empty() && compressed.size() < contents.size() * s_MinCompressionRatio)
+			{
+				entry.Compression = EntryCompression::Lz;
+				contents = std::move(compressed);
+			}
+		}
+		entry.StoredSize = contents.size();
+	}
+
+	// Twice as many slots as entries keeps the probe sequences short
+	size_t numSlots = 1;
+	while (numSlots < entries.size() * 2 + 1)
+	{
+		numSlots *= 2;
+	}
+
+	std::vector<uint32_t> slots(numSlots, 0);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		size_t slot = entries[i].Hash & (numSlots - 1);
+		while (slots[slot] != 0)
+		{
+			if (entries[slots[slot] - 1].Hash == entries[i].Hash && paths.compare(entries[i].PathOffset, entries[i].PathLength, paths, entries[slots[slot] - 1].PathOffset, entries[slots[slot] - 1].PathLength) == 0)
+			{
+				LOG_ERROR("{} was added to the archive twice", files[i].ArchivePath);
+				return false;
+			}
+			slot = (slot + 1) & (numSlots - 1);
+		}
+		slots[slot] = static_cast<uint32_t>(i + 1);
+	}
+
+	Header header = {};
+	header.Magic = s_Magic;
+	header.Version = s_Version;
+	header.NumEntries = static_cast<uint32_t>(entries.size());
+	header.NumSlots = static_cast<uint32_t>(numSlots);
+	header.EntriesOffset = sizeof(Header);
+	header.SlotsOffset = header.EntriesOffset + entries.size() * sizeof(Entry);
+	header.PathsOffset = header.SlotsOffset + slots.size() * sizeof(uint32_t);
+	header.PathsSize = paths.size();
+
+	uint64_t offset = (header.PathsOffset + header.PathsSize + s_PageSize - 1) / s_PageSize * s_PageSize;
+	for (auto& entry : entries)
+	{
+		entry.Offset = offset;
+		offset = (offset + entry.StoredSize + s_PageSize - 1) / s_PageSize * s_PageSize;
+	}
+
+	BinaryWriter writer;
+	writer.Write(header);
+	writer.WriteBytes(entries.data(), entries.size() * sizeof(Entry));
+	writer.WriteBytes(slots.data(), slots.size() * sizeof(uint32_t));
+	writer.WriteBytes(paths.data(), paths.size());
+	for (const auto& contents : data)
+	{
+		writer.Align(s_PageSize);
+		writer.WriteBytes(contents.data(), contents.size());
+	}
+
+	return writer.SaveToFile(archivePath);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <filesystem>
+#include "MappedFile.h"
+
+// Every file under the asset directory packed into a single file that is memory mapped as a whole, so
+// startup doesn't have to open (and the OS doesn't have to look up) hundreds of loose files.
+//
+// File layout:
+//   Header   | magic, version, entry count, slot count, offsets of the entries, slots and paths
+//   Entries  | per file: path hash, data offset, stored and original size, source write time, path, compression
+//   Slots    | open addressed hash table of entry index + 1 (0 is empty), probed linearly from hash & (count - 1)
+//   Paths    | normalized paths of the entries back to back, used to tell hash collisions apart
+//   Data     | every entry starts on a page boundary so uncompressed entries can be handed out as is
+class AssetArchive
+{
+public:
+	enum class EntryCompression : uint32_t
+	{
+		None,
+		Lz // See Compression
+	};
+
+	struct Entry
+	{
+		uint64_t Hash;
+		uint64_t Offset;
+		uint64_t StoredSize;
+		uint64_t Size;
+		int64_t WriteTime;
+		uint32_t PathOffset;
+		uint32_t PathLength;
+		EntryCompression Compression;
+		uint32_t Padding;
+	};
+
+	struct SourceFile
+	{
+		std::filesystem::path Filepath;
+		// What the file is looked up as once it's in the archive
+		std::string ArchivePath;
+	};
+
+public:
+	AssetArchive() = default;
+	AssetArchive(const std::filesystem::path& filepath);
+
+	bool IsOpen() const { return m_File.IsOpen(); }
+	size_t GetNumEntries() const { return m_NumEntries; }
+
+	const Entry* Find(const std::filesystem::path& filepath) const;
+	std::string_view GetPath(const Entry& entry) const;
+	// Points straight into the mapping, compressed entries still need to be decompressed
+	const uint8_t* GetData(const Entry& entry) const { return m_Data + entry.Offset; }
+	const Entry& GetEntry(size_t index) const { return m_Entries[index]; }
+
+	// Paths are looked up case insensitively with forward slashes, the same way Windows would find the loose file
+	static std::string NormalizePath(const std::filesystem::path& filepath);
+	static uint64_t HashPath(std::string_view normalizedPath);
+
+	// Entries that compress to less than s_MinCompressionRatio of their size are stored compressed if compress is set
+	static bool Write(const std::filesystem::path& archivePath, const std::vector<SourceFile>& files, bool compress);
+
+private:
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t NumEntries;
+		uint32_t NumSlots;
+		uint64_t EntriesOffset;
+		uint64_t SlotsOffset;
+		uint64_t PathsOffset;
+		uint64_t PathsSize;
+	};
+
+private:
+	MappedFile m_File;
+	const uint8_t* m_Data = nullptr;
+	const Entry* m_Entries = nullptr;
+	const uint32_t* m_Slots = nullptr;
+	const char* m_Paths = nullptr;
+	size_t m_NumEntries = 0;
+	size_t m_NumSlots = 0;
+
+	inline static constexpr uint32_t s_Magic = 0x4B415043; // "CPAK"
+	inline static constexpr uint32_t s_Version = 1;
+	inline static constexpr size_t s_PageSize = 4096;
+	inline static constexpr float s_MinCompressionRatio = 0.9f;
+};
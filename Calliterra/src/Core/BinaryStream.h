@@ -0,0 +1,158 @@
+#pragma once
+#include <fstream>
+#include <filesystem>
+
+// Helpers for writing and reading the engine's binary cache files. All data is
+// written in native byte order since caches never leave the machine that made them.
+class BinaryWriter
+{
+public:
+	template<typename Type>
+	void Write(const Type& value)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		m_Buffer.insert(m_Buffer.end(), bytes, bytes + sizeof(Type));
+	}
+
+	template<typename Type>
+	void WriteVector(const std::vector<Type>& values)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		Write(static_cast<uint32_t>(values.size()));
+		WriteBytes(values.data(), values.size() * sizeof(Type));
+	}
+
+	void WriteString(const std::string& str)
+	{
+		Write(static_cast<uint32_t>(str.size()));
+		WriteBytes(str.data(), str.size());
+	}
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		const char* bytes = static_cast<const char*>(data);
+		m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+	}
+
+	// Pads the buffer with zeros until its size is a multiple of alignment
+	void Align(size_t alignment)
+	{
+		m_Buffer.resize((m_Buffer.size() + alignment - 1) / alignment * alignment, 0);
+	}
+
+	bool SaveToFile(const std::filesystem::path& filepath) const
+	{
+		std::error_code error;
+		std::filesystem::create_directories(filepath.parent_path(), error);
+
+		std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+
+		file.write(m_Buffer.data(), m_Buffer.size());
+		return file.good();
+	}
+
+	size_t GetSize() const { return m_Buffer.size(); }
+	const std::vector<char>& GetBuffer() const { return m_Buffer; }
+
+private:
+	std::vector<char> m_Buffer;
+};
+
+// Reads back data written by BinaryWriter. Reading past the end of the data won't crash,
+// instead the reader is flagged as invalid and returns zeroed values.
+class BinaryReader
+{
+public:
+	BinaryReader(const void* data, size_t size)
+		: m_Data(static_cast<const char*>(data)), m_Size(size)
+	{
+	}
+
+	template<typename Type>
+	Type Read()
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		Type value = {};
+		ReadBytes(&value, sizeof(Type));
+		return value;
+	}
+
+	template<typename Type>
+	std::vector<Type> ReadVector()
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		const uint32_t count = Read<uint32_t>();
+		if (!CanRead(static_cast<size_t>(count) * sizeof(Type)))
+		{
+			m_Valid = false;
+			return {};
+		}
+
+		std::vector<Type> values(count);
+		ReadBytes(values.data(), count * sizeof(Type));
+		return values;
+	}
+
+	std::string ReadString()
+	{
+		const uint32_t length = Read<uint32_t>();
+		if (!CanRead(length))
+		{
+			m_Valid = false;
+			return {};
+		}
+
+		std::string str(m_Data + m_Offset, length);
+		m_Offset += length;
+		return str;
+	}
+
+	void ReadBytes(void* dest, size_t size)
+	{
+		if (!CanRead(size))
+		{
+			m_Valid = false;
+			return;
+		}
+
+		memcpy(dest, m_Data + m_Offset, size);
+		m_Offset += size;
+	}
+
+	// Returns a pointer into the underlying data and skips over it, avoids a copy when the caller
+	// only needs to look at the bytes (e.g. straight from a memory mapped file)
+	const void* Skip(size_t size)
+	{
+		if (!CanRead(size))
+		{
+			m_Valid = false;
+			return nullptr;
+		}
+
+		const void* ptr = m_Data + m_Offset;
+		m_Offset += size;
+		return ptr;
+	}
+
+	void Align(size_t alignment)
+	{
+		m_Offset = std::min(m_Size, (m_Offset + alignment - 1) / alignment * alignment);
+	}
+
+	bool IsValid() const { return m_Valid; }
+	size_t GetOffset() const { return m_Offset; }
+
+private:
+	bool CanRead(size_t size) const { return m_Valid && size <= m_Size - m_Offset; }
+
+private:
+	const char* m_Data;
+	size_t m_Size;
+	size_t m_Offset = 0;
+	bool m_Valid = true;
+};
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "BufferPool.h"
+
+BufferPool::Buffer::~Buffer()
+{
+	if (m_Data)
+	{
+		Release(std::move(m_Data), m_Capacity);
+	}
+}
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept
+	: m_Data(std::move(other.m_Data)), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+{
+	other.m_Size = 0;
+	other.m_Capacity = 0;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_Data)
+		{
+			Release(std::move(m_Data), m_Capacity);
+		}
+		m_Data = std::move(other.m_Data);
+		m_Size = std::exchange(other.m_Size, 0);
+		m_Capacity = std::exchange(other.m_Capacity, 0);
+	}
+	return *this;
+}
+
+BufferPool::Buffer BufferPool::Acquire(size_t size)
+{
+	Buffer buffer;
+	buffer.m_Size = size;
+
+	{
+		std::scoped_lock lock(s_Mutex);
+		auto best = s_FreeBuffers.end();
+		for (auto it = s_FreeBuffers.begin(); it != s_FreeBuffers.end(); ++it)
+		{
+			if (it->Capacity >= size && (best == s_FreeBuffers.end() || it->Capacity < best->Capacity))
+			{
+				best = it;
+			}
+		}
+
+		if (best != s_FreeBuffers.end())
+		{
+			buffer.m_Data = std::move(best->Data);
+			buffer.m_Capacity = best->Capacity;
+			s_FreeBuffers.erase(best);
+			return buffer;
+		}
+	}
+
+	buffer.m_Data = std::make_unique_for_overwrite<uint8_t[]>(size);
+	buffer.m_Capacity = size;
+	return buffer;
+}
+
+void BufferPool::Clear()
+{
+	std::scoped_lock lock(s_Mutex);
+	s_FreeBuffers.clear();
+}
+
+void BufferPool::Release(std::unique_ptr<uint8_t[]> data, size_t capacity)
+{
+	std::scoped_lock lock(s_Mutex);
+	s_FreeBuffers.push_back({ std::move(data), capacity });
+	if (s_FreeBuffers.size() > s_MaxFreeBuffers)
+	{
+		const auto smallest = std::min_element(s_FreeBuffers.begin(), s_FreeBuffers.end(),
+			[](const FreeBuffer& a, const FreeBuffer& b) { return a.Capacity < b.Capacity; });
+		s_FreeBuffers.erase(smallest);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <mutex>
+
+// Keeps large short lived buffers (e.g. the staging memory a texture is created from) around for the next
+// load instead of freeing them, so loading a run of assets doesn't allocate and fault in the same memory
+// over and over. Thread safe.
+class BufferPool
+{
+public:
+	// Goes back to the pool when it's destroyed. The contents are uninitialized.
+	class Buffer
+	{
+	public:
+		Buffer() = default;
+		~Buffer();
+
+		Buffer(Buffer&& other) noexcept;
+		Buffer& operator=(Buffer&& other) noexcept;
+
+		uint8_t* GetData() const { return m_Data.get(); }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		friend class BufferPool;
+		std::unique_ptr<uint8_t[]> m_Data;
+		size_t m_Size = 0;
+		size_t m_Capacity = 0;
+	};
+
+	// Reuses the smallest pooled buffer that fits, otherwise allocates a new one
+	static Buffer Acquire(size_t size);
+	static void Clear();
+
+private:
+	static void Release(std::unique_ptr<uint8_t[]> data, size_t capacity);
+
+private:
+	struct FreeBuffer
+	{
+		std::unique_ptr<uint8_t[]> Data;
+		size_t Capacity;
+	};
+
+	inline static std::mutex s_Mutex;
+	inline static std::vector<FreeBuffer> s_FreeBuffers;
+
+	// Beyond this the smallest buffers are freed when more come back
+	inline static constexpr size_t s_MaxFreeBuffers = 4;
+};
@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "Compression.h"
+
+namespace
+{
+	uint32_t Read32(const uint8_t* ptr)
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+}
+
+std::vector<uint8_t> Compression::Compress(const void* data, size_t size)
+{
+	const uint8_t* src = static_cast<const uint8_t*>(data);
+	std::vector<uint8_t> out;
+	if (size < s_MinMatch * 4)
+	{
+		return out;
+	}
+	out.reserve(size / 2);
+
+	// Most recent position of every hashed 4 byte sequence, greedy matching against it is
+	// what keeps compression fast enough to pack the whole asset directory in a few seconds
+	std::vector<uint32_t> table(1u << s_HashBits, 0);
+	const auto hash = [](uint32_t sequence) { return (sequence * 2654435761u) >> (32 - s_HashBits); };
+
+	// Matches stop short of the end so the last sequence always has a few literals to emit
+	const size_t matchLimit = size - s_MinMatch;
+	size_t literalStart = 0;
+	size_t pos = 0;
+	while (pos < matchLimit)
+	{
+		const uint32_t sequence = Read32(src + pos);
+		const uint32_t h = hash(sequence);
+		const size_t candidate = table[h];
+		table[h] = static_cast<uint32_t>(pos);
+
+		if (candidate >= pos || pos - candidate > s_MaxOffset || Read32(src + candidate) != sequence)
+		{
+			pos++;
+			continue;
+		}
+
+		size_t matchLength = s_MinMatch;
+		while (pos + matchLength < matchLimit && src[candidate + matchLength] == src[pos + matchLength])
+		{
+			matchLength++;
+		}
+
+		const size_t literalLength = pos - literalStart;
+		const size_t tokenMatch = matchLength - s_MinMatch;
+		out.push_back(static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(tokenMatch, 15)));
+		if (literalLength >= 15)
+		{
+			WriteLength(out, literalLength - 15);
+		}
+		out.insert(out.end(), src + literalStart, src + pos);
+
+		const uint16_t offset = static_cast<uint16_t>(pos - candidate);
+		out.push_back(static_cast<uint8_t>(offset & 0xFF));
+		out.push_back(static_cast<uint8_t>(offset >> 8));
+		if (tokenMatch >= 15)
+		{
+			WriteLength(out, tokenMatch - 15);
+		}
+
+		pos += matchLength;
+		literalStart = pos;
+
+		if (out.size() >= size)
+		{
+			return {};
+		}
+	}
+
+	const size_t literalLength = size - literalStart;
+	out.push_back(static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4));
+	if (literalLength >= 15)
+	{
+		WriteLength(out, literalLength - 15);
+	}
+	out.insert(out.end(), src + literalStart, src + size);
+
+	if (out.size() >= size)
+	{
+		return {};
+	}
+
+	return out;
+}
+
+bool Compression::Decompress(const void* src, size_t srcSize, void* dst, size_t dstSize)
+{
+	const uint8_t* in = static_cast<const uint8_t*>(src);
+	const uint8_t* inEnd = in + srcSize;
+	uint8_t* out = static_cast<uint8_t*>(dst);
+	uint8_t* outStart = out;
+	uint8_t* outEnd = out + dstSize;
+
+	const auto readLength = [&](size_t length) -> size_t
+	{
+		if (length != 15)
+		{
+			return length;
+		}
+
+		uint8_t extra;
+		do
+		{
+			if (in >= inEnd)
+			{
+				return std::numeric_limits<size_t>::max();
+			}
+			extra = *in++;
+			length += extra;
+		} while (extra == 255);
+
+		return length;
+	};
+
+	while (in < inEnd)
+	{
+		const uint8_t token = *in++;
+
+		const size_t literalLength = readLength(token >> 4);
+		if (literalLength > static_cast<size_t>(inEnd - in) || literalLength > static_cast<size_t>(outEnd - out))
+		{
+			return false;
+		}
+		memcpy(out, in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		// The last sequence ends with its literals
+		if (in == inEnd)
+		{
+			break;
+		}
+
+		if (inEnd - in < 2)
+		{
+			return false;
+		}
+		const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+		in += 2;
+
+		const size_t matchLength = readLength(token & 0xF);
+		if (matchLength == std::numeric_limits<size_t>::max() || offset == 0 || offset > static_cast<size_t>(out - outStart) ||
+			matchLength + s_MinMatch > static_cast<size_t>(outEnd - out))
+		{
+			return false;
+		}
+
+		// Matches may overlap what they're writing (e.g. a run of a single byte), so copy forward one byte at a time then
+		const uint8_t* match = out - offset;
+		if (offset >= matchLength + s_MinMatch)
+		{
+			memcpy(out, match, matchLength + s_MinMatch);
+			out += matchLength + s_MinMatch;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength + s_MinMatch; i++)
+			{
+				*out++ = *match++;
+			}
+		}
+	}
+
+	return out == outEnd;
+}
+
+void Compression::WriteLength(std::vector<uint8_t>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back(static_cast<uint8_t>(length));
+}
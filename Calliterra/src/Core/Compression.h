@@ -0,0 +1,25 @@
+#pragma once
+
+// A small LZ77 codec in the spirit of LZ4, used for asset archive entries. It trades ratio for a decoder that
+// is little more than a memcpy loop, since entries are decompressed on the loading threads at startup.
+//
+// A block is a series of sequences, each one a run of literals followed by a match:
+//   token (literal length << 4 | match length - 4), [extra literal length], literals, offset (u16), [extra match length]
+// Lengths of 15 or more continue in the following bytes, each adding up to 255. The last sequence has no match.
+class Compression
+{
+public:
+	// Returns an empty vector if the data doesn't compress
+	static std::vector<uint8_t> Compress(const void* data, size_t size);
+	// The decompressed size is not part of the block, it has to be stored alongside it.
+	// Returns false if the block is corrupt or doesn't decompress to exactly dstSize bytes.
+	static bool Decompress(const void* src, size_t srcSize, void* dst, size_t dstSize);
+
+private:
+	static void WriteLength(std::vector<uint8_t>& out, size_t length);
+
+private:
+	inline static constexpr size_t s_MinMatch = 4;
+	inline static constexpr size_t s_MaxOffset = 65535;
+	inline static constexpr uint32_t s_HashBits = 16;
+};
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "FrameArena.h"
+
+FrameArena::FrameArena(size_t blockSize)
+	: m_BlockSize(blockSize)
+{
+}
+
+void FrameArena::Reset()
+{
+	m_CurrentBlock = 0;
+	m_Offset = 0;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (const auto& block : m_Blocks)
+	{
+		capacity += block.Size;
+	}
+	return capacity;
+}
+
+// Blocks that are too small for the allocation are skipped for the rest of the frame, a new block is only
+// added once every block has been used up
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	for (; m_CurrentBlock < m_Blocks.size(); m_CurrentBlock++, m_Offset = 0)
+	{
+		Block& block = m_Blocks[m_CurrentBlock];
+		const uintptr_t base = reinterpret_cast<uintptr_t>(block.Memory.get());
+		const uintptr_t aligned = (base + m_Offset + alignment - 1) & ~(alignment - 1);
+		if (aligned + size <= base + block.Size)
+		{
+			m_Offset = aligned + size - base;
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+
+	const size_t blockSize = std::max(m_BlockSize, size + alignment);
+	m_Blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+	m_CurrentBlock = m_Blocks.size() - 1;
+	m_Offset = 0;
+	return Allocate(size, alignment);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <span>
+
+// Linear allocator for data that only has to live until the end of the frame. Reset hands the memory out
+// again from the start and keeps the blocks, so once they've grown to fit a frame nothing is allocated.
+class FrameArena
+{
+public:
+	FrameArena(size_t blockSize = 64 * 1024);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Nothing is destroyed on Reset, so only trivial types can be stored
+	template<typename Type>
+	std::span<const Type> Copy(std::span<const Type> source)
+	{
+		static_assert(std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>);
+		if (source.empty())
+		{
+			return {};
+		}
+
+		Type* destination = static_cast<Type*>(Allocate(source.size_bytes(), alignof(Type)));
+		std::uninitialized_copy(source.begin(), source.end(), destination);
+		return { destination, source.size() };
+	}
+
+	void Reset();
+	size_t GetCapacity() const;
+
+private:
+	void* Allocate(size_t size, size_t alignment);
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> Memory;
+		size_t Size;
+	};
+
+	std::vector<Block> m_Blocks;
+	size_t m_BlockSize;
+	size_t m_CurrentBlock = 0;
+	size_t m_Offset = 0;
+};
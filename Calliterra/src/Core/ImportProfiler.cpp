@@ -0,0 +1,288 @@
+#include "pch.h"
+#include "ImportProfiler.h"
+#include <fstream>
+#include <limits>
+
+namespace
+{
+	std::string EscapeJson(std::string_view text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (char c : text)
+		{
+			switch (c)
+			{
+			case '"':  escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\r': escaped += "\\r"; break;
+			case '\t': escaped += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					escaped += std::format("\\u{:04x}", static_cast<int>(c));
+				}
+				else
+				{
+					escaped += c;
+				}
+			}
+		}
+		return escaped;
+	}
+
+	// Total length of a set of [start, end) intervals without counting overlaps twice
+	int64_t GetCoveredTime(std::vector<std::pair<int64_t, int64_t>>& intervals)
+	{
+		std::sort(intervals.begin(), intervals.end());
+
+		int64_t covered = 0;
+		int64_t end = std::numeric_limits<int64_t>::min();
+		for (const auto& [start, stop] : intervals)
+		{
+			if (start >= end)
+			{
+				covered += stop - start;
+				end = stop;
+			}
+			else if (stop > end)
+			{
+				covered += stop - end;
+				end = stop;
+			}
+		}
+		return covered;
+	}
+}
+
+ImportProfiler::Scope::Scope(const char* stage, const std::string& asset)
+{
+	if (!s_Enabled)
+	{
+		return;
+	}
+
+	std::vector<std::string>& assets = GetAssetStack();
+	std::string current = asset.empty() && !assets.empty() ? assets.back() : asset;
+	m_Outermost = assets.empty() || assets.back() != current;
+	assets.push_back(std::move(current));
+
+	m_Stage = stage;
+	m_Active = true;
+	m_Start = Now();
+}
+
+ImportProfiler::Scope::~Scope()
+{
+	if (!m_Active)
+	{
+		return;
+	}
+
+	const int64_t duration = Now() - m_Start;
+	std::vector<std::string>& assets = GetAssetStack();
+
+	{
+		std::scoped_lock lock(s_Mutex);
+		s_Events.push_back({ m_Stage, std::move(assets.back()), GetThreadId(), m_Outermost, m_Start, duration });
+	}
+	assets.pop_back();
+}
+
+void ImportProfiler::AddBytesRead(size_t bytes)
+{
+	if (!s_Enabled)
+	{
+		return;
+	}
+
+	std::scoped_lock lock(s_Mutex);
+	GetCurrentStats()->BytesRead += bytes;
+}
+
+void ImportProfiler::AddBytesAllocated(size_t bytes)
+{
+	if (!s_Enabled)
+	{
+		return;
+	}
+
+	std::scoped_lock lock(s_Mutex);
+	GetCurrentStats()->BytesAllocated += bytes;
+}
+
+void ImportProfiler::AddGeometry(size_t vertices, size_t triangles)
+{
+	if (!s_Enabled)
+	{
+		return;
+	}
+
+	std::scoped_lock lock(s_Mutex);
+	AssetStats* stats = GetCurrentStats();
+	stats->Vertices += vertices;
+	stats->Triangles += triangles;
+}
+
+// {
+//   "totalMs": ...,
+//   "assets": [ { "name", "wallMs", "bytesRead", "bytesAllocated", "vertices", "triangles", "stages": { stage: ms } } ]
+// }
+// Stage times are inclusive of the stages nested in them. An asset's wall time is how long any of its outermost
+// stages were running, so work done for it on several threads at once isn't counted more than once.
+bool ImportProfiler::WriteJson(const std::filesystem::path& filepath)
+{
+	std::map<std::string, AssetStats> stats = BuildStats();
+
+	double totalMs = 0.0;
+	{
+		std::scoped_lock lock(s_Mutex);
+		std::vector<std::pair<int64_t, int64_t>> intervals;
+		for (const Event& event : s_Events)
+		{
+			if (event.Outermost)
+			{
+				intervals.emplace_back(event.Start, event.Start + event.Duration);
+			}
+		}
+		totalMs = GetCoveredTime(intervals) / 1e3;
+	}
+
+	if (filepath.has_parent_path())
+	{
+		std::filesystem::create_directories(filepath.parent_path());
+	}
+	std::ofstream file(filepath, std::ios::trunc);
+	if (!file)
+	{
+		LOG_ERROR("Failed to write import profile to {}", filepath.string());
+		return false;
+	}
+
+	file << std::format("{{\n  \"totalMs\": {:.3f},\n  \"assets\": [", totalMs);
+
+	bool firstAsset = true;
+	for (const auto& [asset, assetStats] : stats)
+	{
+		file << (firstAsset ? "\n" : ",\n");
+		firstAsset = false;
+
+		file << std::format("    {{\n      \"name\": \"{}\",\n      \"wallMs\": {:.3f},\n      \"bytesRead\": {},\n      \"bytesAllocated\": {},\n      \"vertices\": {},\n      \"triangles\": {},\n      \"stages\": {{",
+			EscapeJson(asset), assetStats.WallMs, assetStats.BytesRead, assetStats.BytesAllocated, assetStats.Vertices, assetStats.Triangles);
+
+		bool firstStage = true;
+		for (const auto& [stage, ms] : assetStats.StageMs)
+		{
+			file << std::format("{}\n        \"{}\": {:.3f}", firstStage ? "" : ",", EscapeJson(stage), ms);
+			firstStage = false;
+		}
+		file << (firstStage ? "}\n    }" : "\n      }\n    }");
+	}
+
+	file << "\n  ]\n}\n";
+	return static_cast<bool>(file);
+}
+
+// Chrome's trace event format, every stage is a complete ("X") event on the thread it ran on
+bool ImportProfiler::WriteChromeTrace(const std::filesystem::path& filepath)
+{
+	if (filepath.has_parent_path())
+	{
+		std::filesystem::create_directories(filepath.parent_path());
+	}
+	std::ofstream file(filepath, std::ios::trunc);
+	if (!file)
+	{
+		LOG_ERROR("Failed to write import trace to {}", filepath.string());
+		return false;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	std::scoped_lock lock(s_Mutex);
+	for (size_t i = 0; i < s_Events.size(); i++)
+	{
+		const Event& event = s_Events[i];
+		file << std::format("{}\n{{\"name\":\"{}\",\"cat\":\"import\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,\"tid\":{},\"args\":{{\"asset\":\"{}\"}}}}",
+			i == 0 ? "" : ",", EscapeJson(event.Stage), event.Start, event.Duration, event.ThreadId, EscapeJson(event.Asset));
+	}
+
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+void ImportProfiler::LogSummary()
+{
+	std::map<std::string, AssetStats> stats = BuildStats();
+
+	std::vector<std::pair<std::string, const AssetStats*>> sorted;
+	for (const auto& [asset, assetStats] : stats)
+	{
+		sorted.emplace_back(asset, &assetStats);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second->WallMs > b.second->WallMs; });
+
+	LOG_INFO("Import profile ({} assets)", sorted.size());
+	for (const auto& [asset, assetStats] : sorted)
+	{
+		LOG_INFO("  {}: {:.2f}ms, {:.2f}MB read, {:.2f}MB allocated, {} vertices, {} triangles", asset.empty() ? "<none>" : asset, assetStats->WallMs,
+			assetStats->BytesRead / (1024.0 * 1024.0), assetStats->BytesAllocated / (1024.0 * 1024.0), assetStats->Vertices, assetStats->Triangles);
+	}
+}
+
+void ImportProfiler::Reset()
+{
+	std::scoped_lock lock(s_Mutex);
+	s_Events.clear();
+	s_Counters.clear();
+}
+
+int64_t ImportProfiler::Now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+// Small ids read better in a trace than the platform's thread ids
+uint32_t ImportProfiler::GetThreadId()
+{
+	thread_local const uint32_t id = s_NextThreadId++;
+	return id;
+}
+
+std::vector<std::string>& ImportProfiler::GetAssetStack()
+{
+	thread_local std::vector<std::string> assets;
+	return assets;
+}
+
+// Expects s_Mutex to be held
+ImportProfiler::AssetStats* ImportProfiler::GetCurrentStats()
+{
+	const std::vector<std::string>& assets = GetAssetStack();
+	return &s_Counters[assets.empty() ? std::string() : assets.back()];
+}
+
+std::map<std::string, ImportProfiler::AssetStats> ImportProfiler::BuildStats()
+{
+	std::scoped_lock lock(s_Mutex);
+
+	std::map<std::string, AssetStats> stats = s_Counters;
+	std::map<std::string, std::vector<std::pair<int64_t, int64_t>>> intervals;
+	for (const Event& event : s_Events)
+	{
+		AssetStats& assetStats = stats[event.Asset];
+		assetStats.StageMs[event.Stage] += event.Duration / 1e3;
+		if (event.Outermost)
+		{
+			intervals[event.Asset].emplace_back(event.Start, event.Start + event.Duration);
+		}
+	}
+
+	for (auto& [asset, assetIntervals] : intervals)
+	{
+		stats[asset].WallMs = GetCoveredTime(assetIntervals) / 1e3;
+	}
+
+	return stats;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+
+// Records how long every stage of loading an asset takes (parsing, optimizing, decoding, uploading, compiling, ...)
+// along with how many bytes were read and allocated for it and how much geometry it produced, so a slow load
+// can be pinned on the stage responsible. The results can be written out as a per asset breakdown in JSON, or
+// as a Chrome trace (chrome://tracing, ui.perfetto.dev) that shows every stage on the thread it ran on.
+//
+// Stages are timed with PROFILE_IMPORT scopes. Recording is off unless SetEnabled() is called, in which
+// case a scope costs a single atomic load.
+class ImportProfiler
+{
+public:
+	// Times everything between its construction and destruction as a stage of loading asset. Scopes nest, a
+	// scope without an asset belongs to the asset of the enclosing scope on the same thread. Counters added
+	// while a scope is open are attributed to its asset.
+	class Scope
+	{
+	public:
+		Scope(const char* stage, const std::string& asset = "");
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* m_Stage = nullptr;
+		bool m_Active = false;
+		bool m_Outermost = false;
+		int64_t m_Start = 0;
+	};
+
+	static void SetEnabled(bool enabled) { s_Enabled = enabled; }
+	static bool IsEnabled() { return s_Enabled; }
+
+	static void AddBytesRead(size_t bytes);
+	// CPU side memory produced by the load: imported geometry, decoded pixels, cooked mips, ...
+	static void AddBytesAllocated(size_t bytes);
+	static void AddGeometry(size_t vertices, size_t triangles);
+
+	static bool WriteJson(const std::filesystem::path& filepath);
+	static bool WriteChromeTrace(const std::filesystem::path& filepath);
+	static void LogSummary();
+	static void Reset();
+
+private:
+	struct Event
+	{
+		const char* Stage;
+		std::string Asset;
+		uint32_t ThreadId;
+		bool Outermost;
+		int64_t Start; // Microseconds since s_Epoch
+		int64_t Duration;
+	};
+
+	struct AssetStats
+	{
+		double WallMs = 0.0;
+		std::map<std::string, double> StageMs;
+		size_t BytesRead = 0;
+		size_t BytesAllocated = 0;
+		size_t Vertices = 0;
+		size_t Triangles = 0;
+	};
+
+	static int64_t Now();
+	static uint32_t GetThreadId();
+	static std::vector<std::string>& GetAssetStack();
+	static AssetStats* GetCurrentStats();
+	static std::map<std::string, AssetStats> BuildStats();
+
+private:
+	inline static std::atomic<bool> s_Enabled = false;
+	inline static const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+	inline static std::mutex s_Mutex;
+	inline static std::vector<Event> s_Events;
+	// Counters only, the timings are worked out from s_Events when writing the results
+	inline static std::map<std::string, AssetStats> s_Counters;
+	inline static std::atomic<uint32_t> s_NextThreadId = 0;
+};
+
+#define INTERNAL_PROFILE_IMPORT_NAME_IMPL(line) importProfilerScope##line
+#define INTERNAL_PROFILE_IMPORT_NAME(line) INTERNAL_PROFILE_IMPORT_NAME_IMPL(line)
+
+// Profiles the rest of the enclosing block as a stage of loading asset
+#define PROFILE_IMPORT(stage, asset) ImportProfiler::Scope INTERNAL_PROFILE_IMPORT_NAME(__LINE__)(stage, asset)
+// Profiles the rest of the enclosing block as a stage of the asset that is currently being loaded
+#define PROFILE_IMPORT_STAGE(stage) ImportProfiler::Scope INTERNAL_PROFILE_IMPORT_NAME(__LINE__)(stage)
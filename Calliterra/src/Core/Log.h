@@ -1,6 +1,8 @@
 #pragma once
 
-#define SPDLOG_WCHAR_TO_UTF8_SUPPORT
+#ifdef _WIN32
+	#define SPDLOG_WCHAR_TO_UTF8_SUPPORT
+#endif
 #include <spdlog/spdlog.h>
 
 class Log
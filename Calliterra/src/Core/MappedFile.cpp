@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& filepath)
+{
+	m_File = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_File, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return;
+	}
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+	m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_Mapping)
+	{
+		Close();
+		return;
+	}
+
+	m_Data = MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_Data)
+	{
+		Close();
+	}
+}
+
+#else
+MappedFile::MappedFile(const std::filesystem::path& filepath)
+{
+	m_File = open(filepath.c_str(), O_RDONLY);
+	if (m_File == -1)
+	{
+		return;
+	}
+
+	struct stat fileStat;
+	if (fstat(m_File, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		Close();
+		return;
+	}
+	m_Size = static_cast<size_t>(fileStat.st_size);
+
+	void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return;
+	}
+
+	m_Data = data;
+	madvise(data, m_Size, MADV_SEQUENTIAL);
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_File(other.m_File), m_Data(other.m_Data), m_Size(other.m_Size)
+{
+#ifdef _WIN32
+	m_Mapping = other.m_Mapping;
+	other.m_File = INVALID_HANDLE_VALUE;
+	other.m_Mapping = nullptr;
+#else
+	other.m_File = -1;
+#endif
+	other.m_Data = nullptr;
+	other.m_Size = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		std::swap(m_File, other.m_File);
+#ifdef _WIN32
+		std::swap(m_Mapping, other.m_Mapping);
+#endif
+		std::swap(m_Data, other.m_Data);
+		std::swap(m_Size, other.m_Size);
+	}
+	return *this;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+	}
+
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = nullptr;
+	}
+
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_Data)
+	{
+		munmap(const_cast<void*>(m_Data), m_Size);
+		m_Data = nullptr;
+	}
+
+	if (m_File != -1)
+	{
+		close(m_File);
+		m_File = -1;
+	}
+#endif
+
+	m_Size = 0;
+}
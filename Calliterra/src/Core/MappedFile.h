@@ -0,0 +1,34 @@
+#pragma once
+#include <filesystem>
+
+// Read-only memory mapping of an entire file. The mapping stays valid for the
+// lifetime of the object.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const std::filesystem::path& filepath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool IsOpen() const { return m_Data != nullptr; }
+	const void* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	void Close();
+
+private:
+#ifdef _WIN32
+	HANDLE m_File = INVALID_HANDLE_VALUE;
+	HANDLE m_Mapping = nullptr;
+#else
+	int m_File = -1;
+#endif
+	const void* m_Data = nullptr;
+	size_t m_Size = 0;
+};
@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+void ThreadPool::Init(uint32_t numThreads)
+{
+	ASSERT(s_Workers.empty(), "ThreadPool has already been initialized!");
+
+	if (numThreads == 0)
+	{
+		// Leave one core for the main/render thread, hardware_concurrency is 0 when it can't be determined
+		numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	}
+
+	s_Stopping = false;
+	s_Workers.reserve(numThreads);
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		s_Workers.emplace_back(&ThreadPool::WorkerLoop);
+	}
+
+	LOG_INFO("ThreadPool Initialized with {} workers", numThreads);
+}
+
+void ThreadPool::Shutdown()
+{
+	{
+		std::scoped_lock lock(s_QueueMutex);
+		s_Stopping = true;
+	}
+	s_QueueCondition.notify_all();
+
+	for (auto& worker : s_Workers)
+	{
+		worker.join();
+	}
+	s_Workers.clear();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (s_Workers.empty() || count == 1)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	// Every job (including the caller) pulls the next index off a shared counter
+	// so uneven work such as one huge mesh amongst many small ones balances itself.
+	// The state is shared with the jobs because they can still be queued behind other work (e.g. a model
+	// import) when the caller returns, they then find no indices left and never touch func.
+	struct State
+	{
+		std::atomic<uint32_t> NextIndex = 0;
+		std::atomic<uint32_t> Finished = 0;
+		std::mutex ErrorMutex;
+		std::exception_ptr Error;
+	};
+	auto state = std::make_shared<State>();
+	auto work = [state, count, &func]()
+	{
+		for (uint32_t i = state->NextIndex++; i < count; i = state->NextIndex++)
+		{
+			try
+			{
+				func(i);
+			}
+			catch (...)
+			{
+				std::scoped_lock lock(state->ErrorMutex);
+				if (!state->Error)
+				{
+					state->Error = std::current_exception();
+				}
+			}
+
+			if (++state->Finished == count)
+			{
+				state->Finished.notify_all();
+			}
+		}
+	};
+
+	const uint32_t numJobs = std::min(count - 1, GetNumThreads());
+	for (uint32_t i = 0; i < numJobs; i++)
+	{
+		Submit(work);
+	}
+
+	work();
+
+	// Only the indices other threads are still working on are left, the caller doesn't pick up unrelated
+	// jobs from the queue while it waits. Nested ParallelFor calls can't deadlock since every index that has
+	// been taken is already running.
+	for (uint32_t finished = state->Finished; finished < count; finished = state->Finished)
+	{
+		state->Finished.wait(finished);
+	}
+
+	if (state->Error)
+	{
+		std::rethrow_exception(state->Error);
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock lock(s_QueueMutex);
+			s_QueueCondition.wait(lock, []() { return s_Stopping || !s_Jobs.empty(); });
+
+			if (s_Stopping && s_Jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(s_Jobs.front());
+			s_Jobs.pop();
+		}
+
+		job();
+	}
+}
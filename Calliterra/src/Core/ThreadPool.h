@@ -0,0 +1,58 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+
+// A fixed set of worker threads shared by the engine for CPU side work that
+// doesn't need to touch the graphics device (asset parsing, decoding, etc).
+// Work is submitted as a callable and a std::future is returned for the result.
+class ThreadPool
+{
+public:
+	static void Init(uint32_t numThreads = 0);
+	static void Shutdown();
+
+	template<typename Func>
+	static auto Submit(Func&& func) -> std::future<std::invoke_result_t<Func>>
+	{
+		using ReturnType = std::invoke_result_t<Func>;
+
+		// std::function requires copyable callables so the packaged task is kept behind a shared_ptr
+		auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<Func>(func));
+		std::future<ReturnType> result = task->get_future();
+
+		// If the pool was never initialized we just run the work inline
+		if (s_Workers.empty())
+		{
+			(*task)();
+			return result;
+		}
+
+		{
+			std::scoped_lock lock(s_QueueMutex);
+			s_Jobs.emplace([task]() { (*task)(); });
+		}
+		s_QueueCondition.notify_one();
+
+		return result;
+	}
+
+	// Runs func(i) for every i in [0, count) across the workers and blocks until all have finished.
+	// The calling thread helps out with the indices (and nothing else) so this is safe to call from a worker
+	// thread as well.
+	static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+	static uint32_t GetNumThreads() { return static_cast<uint32_t>(s_Workers.size()); }
+
+private:
+	static void WorkerLoop();
+
+private:
+	inline static std::vector<std::thread> s_Workers;
+	inline static std::queue<std::function<void()>> s_Jobs;
+	inline static std::mutex s_QueueMutex;
+	inline static std::condition_variable s_QueueCondition;
+	inline static bool s_Stopping = false;
+};
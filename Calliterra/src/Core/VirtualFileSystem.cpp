@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "VirtualFileSystem.h"
+#include "Compression.h"
+#include "ImportProfiler.h"
+
+bool VirtualFileSystem::Mount(const std::filesystem::path& archivePath)
+{
+	if (!std::filesystem::exists(archivePath))
+	{
+		return false;
+	}
+
+	std::unique_ptr<AssetArchive> archive = std::make_unique<AssetArchive>(archivePath);
+	if (!archive->IsOpen())
+	{
+		return false;
+	}
+
+	LOG_INFO("Mounted {} ({} files)", archivePath.string(), archive->GetNumEntries());
+	s_Archive = std::move(archive);
+	return true;
+}
+
+void VirtualFileSystem::Unmount()
+{
+	s_Archive.reset();
+}
+
+AssetFile VirtualFileSystem::Open(const std::filesystem::path& filepath)
+{
+	AssetFile file;
+
+	if (const AssetArchive::Entry* entry = s_Archive ? s_Archive->Find(filepath) : nullptr)
+	{
+		switch (entry->Compression)
+		{
+		case AssetArchive::EntryCompression::None:
+			file.m_Data = s_Archive->GetData(*entry);
+			file.m_Size = entry->Size;
+			ImportProfiler::AddBytesRead(entry->Size);
+			return file;
+		case AssetArchive::EntryCompression::Lz:
+			ImportProfiler::AddBytesRead(entry->StoredSize);
+			file.m_Storage.resize(entry->Size);
+			if (!Compression::Decompress(s_Archive->GetData(*entry), entry->StoredSize, file.m_Storage.data(), file.m_Storage.size()))
+			{
+				LOG_ERROR("Archive entry {} is corrupt", filepath.string());
+				return AssetFile();
+			}
+			file.m_Data = file.m_Storage.data();
+			file.m_Size = file.m_Storage.size();
+			return file;
+		}
+	}
+
+	file.m_File = MappedFile(filepath);
+	if (file.m_File.IsOpen())
+	{
+		file.m_Data = static_cast<const uint8_t*>(file.m_File.GetData());
+		file.m_Size = file.m_File.GetSize();
+		ImportProfiler::AddBytesRead(file.m_Size);
+	}
+	else if (std::filesystem::exists(filepath))
+	{
+		// Empty files can't be mapped, hand out an empty but open file
+		static const uint8_t empty = 0;
+		file.m_Data = &empty;
+	}
+
+	return file;
+}
+
+bool VirtualFileSystem::Exists(const std::filesystem::path& filepath)
+{
+	return (s_Archive && s_Archive->Find(filepath)) || std::filesystem::exists(filepath);
+}
+
+int64_t VirtualFileSystem::GetWriteTime(const std::filesystem::path& filepath)
+{
+	if (const AssetArchive::Entry* entry = s_Archive ? s_Archive->Find(filepath) : nullptr)
+	{
+		return entry->WriteTime;
+	}
+
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(filepath, error);
+	if (error)
+	{
+		return 0;
+	}
+
+	return static_cast<int64_t>(writeTime.time_since_epoch().count());
+}
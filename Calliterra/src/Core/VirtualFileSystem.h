@@ -0,0 +1,50 @@
+#pragma once
+#include <filesystem>
+#include "AssetArchive.h"
+
+// The contents of a file opened through the VirtualFileSystem. Uncompressed archive entries point straight
+// into the archive's mapping, compressed ones are decompressed into memory the file owns and loose files are
+// mapped on their own.
+class AssetFile
+{
+public:
+	AssetFile() = default;
+
+	AssetFile(const AssetFile&) = delete;
+	AssetFile& operator=(const AssetFile&) = delete;
+	AssetFile(AssetFile&&) = default;
+	AssetFile& operator=(AssetFile&&) = default;
+
+	bool IsOpen() const { return m_Data != nullptr; }
+	const uint8_t* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+	std::string_view GetText() const { return std::string_view(reinterpret_cast<const char*>(m_Data), m_Size); }
+
+private:
+	friend class VirtualFileSystem;
+
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+	std::vector<uint8_t> m_Storage;
+	MappedFile m_File;
+};
+
+// Where assets are read from. Once an archive is mounted every path is looked up in it first, anything that
+// isn't in it (or everything, when no archive is mounted) is read as a loose file relative to the working directory.
+//
+// Mounting isn't thread safe, it should happen once at startup before anything is loaded.
+class VirtualFileSystem
+{
+public:
+	static bool Mount(const std::filesystem::path& archivePath);
+	static void Unmount();
+	static bool IsMounted() { return s_Archive && s_Archive->IsOpen(); }
+
+	static AssetFile Open(const std::filesystem::path& filepath);
+	static bool Exists(const std::filesystem::path& filepath);
+	// In the same units as the caches store, 0 if the file doesn't exist
+	static int64_t GetWriteTime(const std::filesystem::path& filepath);
+
+private:
+	inline static std::unique_ptr<AssetArchive> s_Archive;
+};
@@ -4,6 +4,10 @@
 #include <backends/imgui_impl_win32.h>
 #include <backends/imgui_impl_dx11.h>
 #include "Core/GlobalSettings.h"
+#include "Asset/Mesh.h"
+#include "Renderer/TextureStreamer.h"
+#include "Sandbox/Sandbox.h"
+#include "Core/AllocationCounter.h"
 
 static std::string YawToDirection(float yawInDegrees)
 {
@@ -104,7 +108,7 @@ void ImGuiManager::DebugGui(DeltaTime dt, const Camera& camera)
 		// TODO: Implement .ttf font file for high quality font for higher font scaling
 		// https://github.com/ocornut/imgui/issues/1018#issuecomment-1891041578 
 
-		ImVec2 guiSize = { 175.f, 150.f };
+		ImVec2 guiSize = { 175.f, 320.f };
 
 		ImGui::SetNextWindowPos({ m_WindowWidth - guiSize.x, 0 });
 		ImGui::SetNextWindowSize(guiSize);
@@ -120,6 +124,25 @@ void ImGuiManager::DebugGui(DeltaTime dt, const Camera& camera)
 		ImGui::Text("(%.2f, %.2f, %.2f)", cameraPos.x, cameraPos.y, cameraPos.z);
 		ImGui::Text(YawToDirection(DX::XMConvertToDegrees(camera.GetYaw())).c_str());
 
+		const MeshletCullingStats& culling = Mesh::GetCullingStats();
+		const float meshlets = static_cast<float>(std::max(culling.Meshlets, 1u));
+		ImGui::Text("Meshlets: %u", culling.Meshlets);
+		ImGui::Text("Frustum Culled: %.1f%%", 100.f * culling.FrustumCulled / meshlets);
+		ImGui::Text("Backface Culled: %.1f%%", 100.f * culling.BackfaceCulled / meshlets);
+		ImGui::Text("Mesh Draw Calls: %u", culling.DrawCalls);
+
+		const BindStats& binds = Renderer::GetBindStats();
+		ImGui::Text("Binds: %u (%u skipped)", binds.Issued, binds.Skipped);
+		ImGui::Text("Retained Steps: %zu", Renderer::GetRenderQueue().GetNumRetained());
+		if (AllocationCounter::IsEnabled())
+		{
+			ImGui::Text("Frame Allocations: %llu", Sandbox::GetFrameAllocations());
+		}
+
+		const TextureStreamingStats& streaming = TextureStreamer::GetStats();
+		ImGui::Text("Textures: %u (%u loading)", streaming.Textures, streaming.Loading);
+		ImGui::Text("Texture Memory: %.1f / %.0f MB", streaming.ResidentMemory / (1024.f * 1024.f), streaming.Budget / (1024.f * 1024.f));
+
 		ImGui::End();
 	}
 }
@@ -7,17 +7,19 @@ class DX11ConstantBuffer : public ConstantBuffer
 {
 public:
 	DX11ConstantBuffer(DX11Context& context, Shader::ShaderType shaderType, const Type& constants, uint32_t slot = 0)
-		: m_Context(context), m_Slot(slot)
+		: m_Context(context), m_ShaderType(shaderType), m_Slot(slot)
 	{
 		InitBufferWithData(constants);
 	}
 
 	DX11ConstantBuffer(DX11Context& context, Shader::ShaderType shaderType, uint32_t slot = 0)
-		: m_Context(context), m_Slot(slot)
+		: m_Context(context), m_ShaderType(shaderType), m_Slot(slot)
 	{
 		InitBufferWithoutData();
 	}
 
+	uint32_t GetBindSlot() const override { return BindSlot::ForConstantBuffer(m_ShaderType, m_Slot); }
+
 	void Update(const Type& constants)
 	{
 		D3D11_MAPPED_SUBRESOURCE mappedSubresource;
@@ -38,6 +40,7 @@ public:
 protected:
 	DX11Context& m_Context;
 	ComPtr<ID3D11Buffer> m_ConstantBuffer;
+	Shader::ShaderType m_ShaderType;
 	uint32_t m_Slot;
 
 private:
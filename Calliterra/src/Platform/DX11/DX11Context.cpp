@@ -31,10 +31,10 @@ void DX11Context::SwapBuffers()
 	ASSERT_HR(m_SwapChain->Present(m_VSyncEnabled, 0));
 }
 
-void DX11Context::DrawIndexed(uint32_t indexCount)
+void DX11Context::DrawIndexed(uint32_t indexCount, uint32_t startIndex)
 {
 
-	m_DeviceContext->DrawIndexed(indexCount, 0, 0);
+	m_DeviceContext->DrawIndexed(indexCount, startIndex, 0);
 }
 
 std::shared_ptr<RenderTarget> DX11Context::GetBackBufferTarget() const
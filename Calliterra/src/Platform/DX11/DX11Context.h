@@ -30,7 +30,7 @@ public:
 
 	void ToggleFullscreen() override;
 
-	void DrawIndexed(uint32_t indexCount);
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex);
 
 	ID3D11Device& GetDevice() const { return *m_Device.Get(); }
 	ID3D11DeviceContext& GetDeviceContext() const { return *m_DeviceContext.Get(); }
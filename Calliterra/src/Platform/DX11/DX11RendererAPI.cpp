@@ -7,7 +7,7 @@ void DX11RendererAPI::Init(std::shared_ptr<GraphicsContext> context)
 	LOG_INFO("DX11 Renderer Initialized");
 }
 
-void DX11RendererAPI::DrawIndexed(uint32_t indexCount)
+void DX11RendererAPI::DrawIndexed(uint32_t indexCount, uint32_t startIndex)
 {
-	m_Context->DrawIndexed(indexCount);
+	m_Context->DrawIndexed(indexCount, startIndex);
 }
@@ -8,7 +8,7 @@ class DX11RendererAPI : public RendererAPI
 {
 public:
 	void Init(std::shared_ptr<GraphicsContext> context) override;
-	void DrawIndexed(uint32_t indexCount) override;
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex) override;
 
 private:
 	std::shared_ptr<DX11Context> m_Context;
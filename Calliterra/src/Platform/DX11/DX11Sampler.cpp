@@ -0,0 +1,42 @@
+#include "pch.h"
+#include "DX11Sampler.h"
+
+#pragma warning(disable:4715)
+D3D11_FILTER FilterToD3D(Texture::Filter filter)
+{
+	switch (filter)
+	{
+	case Texture::Filter::Point:
+		return D3D11_FILTER_MIN_MAG_MIP_POINT;
+	case Texture::Filter::Linear:
+		return D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	case Texture::Filter::Anisotropic:
+		return D3D11_FILTER_ANISOTROPIC;
+	}
+
+	ASSERT(false, "Filter not supported");
+	#pragma warning(default:4715)
+}
+
+DX11Sampler::DX11Sampler(DX11Context& context, Texture::Filter filter, uint32_t slot)
+	: m_Context(context), m_Slot(slot)
+{
+	D3D11_SAMPLER_DESC samplerDesc = {};
+	samplerDesc.Filter = FilterToD3D(filter);
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MaxAnisotropy = D3D11_REQ_MAXANISOTROPY;
+	samplerDesc.MipLODBias = 0.f;
+	samplerDesc.MinLOD = 0.f;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	ASSERT_HR(
+		m_Context.GetDevice().CreateSamplerState(&samplerDesc, &m_SamplerState)
+	);
+}
+
+void DX11Sampler::Bind() const
+{
+	m_Context.GetDeviceContext().PSSetSamplers(m_Slot, 1, m_SamplerState.GetAddressOf());
+}
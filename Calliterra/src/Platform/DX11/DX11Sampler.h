@@ -0,0 +1,20 @@
+#pragma once
+#include "Renderer/Sampler.h"
+#include "DX11Context.h"
+
+D3D11_FILTER FilterToD3D(Texture::Filter filter);
+
+class DX11Sampler : public Sampler
+{
+public:
+	DX11Sampler(DX11Context& context, Texture::Filter filter, uint32_t slot = 0);
+
+	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForSampler(m_Slot); }
+
+private:
+	DX11Context& m_Context;
+	uint32_t m_Slot;
+
+	ComPtr<ID3D11SamplerState> m_SamplerState;
+};
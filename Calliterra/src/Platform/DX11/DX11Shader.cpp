@@ -1,5 +1,51 @@
 #include "pch.h"
 #include "DX11Shader.h"
+#include "Core/VirtualFileSystem.h"
+#include "Core/ImportProfiler.h"
+
+namespace
+{
+	// Resolves #includes through the VirtualFileSystem, relative to the file doing the including like
+	// D3D_COMPILE_STANDARD_FILE_INCLUDE would
+	class ShaderInclude : public ID3DInclude
+	{
+	public:
+		ShaderInclude(const std::filesystem::path& directory)
+			: m_Directory(directory)
+		{
+		}
+
+		HRESULT __stdcall Open(D3D_INCLUDE_TYPE includeType, LPCSTR fileName, LPCVOID parentData, LPCVOID* data, UINT* bytes) override
+		{
+			const auto parent = m_Directories.find(parentData);
+			const std::filesystem::path filepath = (parent != m_Directories.end() ? parent->second : m_Directory) / fileName;
+
+			AssetFile file = VirtualFileSystem::Open(filepath);
+			if (!file.IsOpen())
+			{
+				return E_FAIL;
+			}
+
+			*data = file.GetData();
+			*bytes = static_cast<UINT>(file.GetSize());
+			m_Directories[*data] = filepath.parent_path();
+			m_Files.push_back(std::move(file));
+
+			return S_OK;
+		}
+
+		// The files are kept open until the shader has been compiled
+		HRESULT __stdcall Close(LPCVOID data) override
+		{
+			return S_OK;
+		}
+
+	private:
+		std::filesystem::path m_Directory;
+		std::unordered_map<LPCVOID, std::filesystem::path> m_Directories;
+		std::vector<AssetFile> m_Files;
+	};
+}
 
 DX11Shader::DX11Shader(DX11Context& context, const std::string& filepath, Shader::ShaderType type)
 	: m_DX11Context(context), m_Filepath(filepath), m_ShaderType(type)
@@ -12,14 +58,17 @@ DX11Shader::DX11Shader(DX11Context& context, const std::string& filepath, Shader
 		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
-		std::wstring filePathWide = std::wstring(m_Filepath.begin(), m_Filepath.end());
-		LPCWSTR filePathWideCString = filePathWide.c_str();
-
+		const AssetFile source = VirtualFileSystem::Open(m_Filepath);
+		ASSERT(source.IsOpen(), "Failed to open " + m_Filepath);
+		ShaderInclude include(std::filesystem::path(m_Filepath).parent_path());
 
-		HRESULT hr = D3DCompileFromFile(
-			filePathWideCString,
+		PROFILE_IMPORT("Compile shader", m_Filepath);
+		HRESULT hr = D3DCompile(
+			source.GetData(),
+			source.GetSize(),
+			m_Filepath.c_str(),
 			nullptr,
-			D3D_COMPILE_STANDARD_FILE_INCLUDE,
+			&include,
 			"main",
 			ShaderTypeToCompilerTarget().c_str(),
 			shaderFlags,
@@ -8,6 +8,7 @@ public:
 	DX11Shader(DX11Context& context, const std::string& filepath, Shader::ShaderType type);
 
 	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForShader(m_ShaderType); }
 
 	ComPtr<ID3DBlob> GetCompiledShaderByteCode() { return m_CompiledShader; }
 private:
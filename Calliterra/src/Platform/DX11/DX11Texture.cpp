@@ -1,21 +1,34 @@
 #include "pch.h"
 #include "DX11Texture.h"
+#include "Renderer/Sampler.h"
+#include "Asset/TextureDecoder.h"
+#include "Renderer/TextureStreamer.h"
+#include "Core/VirtualFileSystem.h"
+#include "Core/ThreadPool.h"
+#include "Core/ImportProfiler.h"
+#include "Core/BufferPool.h"
+#include "Asset/MipGenerator.h"
 #include "stb_image.h"
+#include "stb_image_target.h"
 
 #pragma warning(disable:4715)
-D3D11_FILTER FilterToD3D(Texture::Filter filter)
+DXGI_FORMAT TextureFormatToDXGI(TextureFormat format)
 {
-	switch (filter)
+	switch (format)
 	{
-	case Texture::Filter::Point:
-		return D3D11_FILTER_MIN_MAG_MIP_POINT;
-	case Texture::Filter::Linear:
-		return D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-	case Texture::Filter::Anisotropic:
-		return D3D11_FILTER_ANISOTROPIC;
+	case TextureFormat::RGBA8:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case TextureFormat::BC1:
+		return DXGI_FORMAT_BC1_UNORM;
+	case TextureFormat::BC3:
+		return DXGI_FORMAT_BC3_UNORM;
+	case TextureFormat::BC5:
+		return DXGI_FORMAT_BC5_UNORM;
+	case TextureFormat::BC7:
+		return DXGI_FORMAT_BC7_UNORM;
 	}
 
-	ASSERT(false, "Filter not supported");
+	ASSERT(false, "Texture format not supported");
 	#pragma warning(default:4715)
 }
 
@@ -23,67 +36,112 @@ DX11Texture::DX11Texture(DX11Context& context, const std::string& filepath, uint
 	: m_DX11Context(context), m_Filepath(filepath), m_Slot(slot)
 {
 	LOG_DEBUG("Loading {}", filepath);
-	m_TextureData = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_NumChannels, m_DesiredChannels);
-	ASSERT(m_TextureData);
 
-	if (m_NumChannels == 1 || m_NumChannels == 4)
+	// The texture has most likely already been cooked on the ThreadPool (or read from the TextureCache), so
+	// all that's left here is the upload. Only the mip tail is created up front, the TextureStreamer loads
+	// the more detailed mips once something using the texture is drawn close enough to need them.
 	{
-		m_HasAlpha = true;
+		PROFILE_IMPORT("TextureDecoder::Acquire", filepath);
+		m_Source = TextureDecoder::Acquire(filepath, TextureDecoder::GetUsage(slot));
 	}
+	m_Width = m_Source->Mips[0].Width;
+	m_Height = m_Source->Mips[0].Height;
+	m_HasAlpha = m_Source->HasAlpha;
+	m_MipTail = TextureStreamer::GetMipTail(m_Width, m_Height, static_cast<uint32_t>(m_Source->Mips.size()), m_Source->Format);
+	m_ResidentMip = m_MipTail;
+
+	{
+		PROFILE_IMPORT("Upload", filepath);
+		CreateMipResources(m_ResidentMip, m_Texture, m_TextureView);
+	}
+
+	m_Sampler = Sampler::Resolve(filter);
+}
+
+void DX11Texture::Bind() const
+{
+	m_DX11Context.GetDeviceContext().PSSetShaderResources(m_Slot, 1, m_TextureView.GetAddressOf());
+}
+
+size_t DX11Texture::GetMemorySize(uint32_t firstMip) const
+{
+	size_t size = 0;
+	for (size_t i = firstMip; i < m_Source->Mips.size(); i++)
+	{
+		size += m_Source->Mips[i].Size;
+	}
+
+	return size;
+}
+
+// The device is free threaded so the new texture can be created on a worker, but binding it has to wait
+// for the main thread. Every mip is recreated from the mapped cache data rather than copied over from the
+// current texture, which keeps the textures immutable.
+void DX11Texture::StreamMips(uint32_t firstMip)
+{
+	ComPtr<ID3D11Texture2D> texture;
+	ComPtr<ID3D11ShaderResourceView> textureView;
+	CreateMipResources(firstMip, texture, textureView);
+
+	std::scoped_lock lock(m_PendingMutex);
+	m_PendingTexture = std::move(texture);
+	m_PendingTextureView = std::move(textureView);
+	m_PendingMip = firstMip;
+}
+
+bool DX11Texture::CommitStreamedMips()
+{
+	std::scoped_lock lock(m_PendingMutex);
+	if (!m_PendingTextureView)
+	{
+		return false;
+	}
+
+	m_Texture = std::move(m_PendingTexture);
+	m_TextureView = std::move(m_PendingTextureView);
+	m_ResidentMip = m_PendingMip;
+
+	return true;
+}
+
+void DX11Texture::CreateMipResources(uint32_t firstMip, ComPtr<ID3D11Texture2D>& texture, ComPtr<ID3D11ShaderResourceView>& textureView) const
+{
+	const CookedTexture::Mip& top = m_Source->Mips[firstMip];
 
-	// Note: It might be worthwhile to first generate the mips on a staging texture then create another
-	// immutable texture with only BIND_SHADER_RESOURCE to allow the driver to optimize. We then copy
-	// over the data from the first texture onto the new one.
 	D3D11_TEXTURE2D_DESC textureDesc = {};
-	textureDesc.Width = m_Width;
-	textureDesc.Height = m_Height;
-	textureDesc.MipLevels = 0; // 0 will generate all mip levels
+	textureDesc.Width = top.Width;
+	textureDesc.Height = top.Height;
+	textureDesc.MipLevels = static_cast<UINT>(m_Source->Mips.size() - firstMip);
 	textureDesc.ArraySize = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.Format = TextureFormatToDXGI(m_Source->Format);
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.SampleDesc.Quality = 0;
-	textureDesc.Usage = D3D11_USAGE_DEFAULT;
-	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 	textureDesc.CPUAccessFlags = 0;
-	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+	textureDesc.MiscFlags = 0;
+
+	std::vector<D3D11_SUBRESOURCE_DATA> data(textureDesc.MipLevels);
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		data[i].pSysMem = m_Source->GetMipData(firstMip + i);
+		data[i].SysMemPitch = m_Source->Mips[firstMip + i].RowPitch;
+		data[i].SysMemSlicePitch = 0;
+	}
  
 	ASSERT_HR(
-		m_DX11Context.GetDevice().CreateTexture2D(&textureDesc, nullptr, &m_Texture)
+		m_DX11Context.GetDevice().CreateTexture2D(&textureDesc, data.data(), &texture)
 	);
 
-	m_DX11Context.GetDeviceContext().UpdateSubresource(m_Texture.Get(), 0, nullptr, m_TextureData, m_Width * m_DesiredChannels, 0);
-
 	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Format = textureDesc.Format;
 	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Texture2D.MostDetailedMip = 0;
 	srvDesc.Texture2D.MipLevels = -1; // -1 will use all mip levels
 
-ASSERT_HR(
-		m_DX11Context.GetDevice().CreateShaderResourceView(m_Texture.Get(), &srvDesc, &m_TextureView)
-	);
-
-	D3D11_SAMPLER_DESC samplerDesc = {};
-	samplerDesc.Filter = FilterToD3D(filter);
-	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.MaxAnisotropy = D3D11_REQ_MAXANISOTROPY;
-	samplerDesc.MipLODBias = 0.f;
-	samplerDesc.MinLOD = 0.f;
-	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
 	ASSERT_HR(
-		m_DX11Context.GetDevice().CreateSamplerState(&samplerDesc, &m_SamplerState)
+		m_DX11Context.GetDevice().CreateShaderResourceView(texture.Get(), &srvDesc, &textureView)
 	);
-
-	m_DX11Context.GetDeviceContext().GenerateMips(m_TextureView.Get());
-}
-
-void DX11Texture::Bind() const
-{
-	m_DX11Context.GetDeviceContext().PSSetSamplers(0, 1, m_SamplerState.GetAddressOf());
-	m_DX11Context.GetDeviceContext().PSSetShaderResources(m_Slot, 1, m_TextureView.GetAddressOf());
 }
 
 
@@ -93,72 +151,135 @@ void DX11Texture::Bind() const
 DX11TextureCube::DX11TextureCube(DX11Context& context, const std::string& mapDir, uint32_t slot, Filter filter)
 	: m_Context(context), m_Slot(slot)
 {
-	int width;
-	int height;
-	int numChannels;
-	const int desiredChannels = 4;
-	
-	std::array<unsigned char*, 6> textureData;
+	PROFILE_IMPORT("Load cube map", mapDir);
+	Timer timer;
+
+	// Only the headers are read up front, so the whole cube map can go into one pooled allocation that the
+	// faces are decoded straight into from the ThreadPool
+	std::array<AssetFile, 6> files;
+	std::array<int, 6> widths = {};
+	std::array<int, 6> heights = {};
+	for (int i = 0; i < 6; i++)
+	{
+		const std::string filepath = mapDir + s_Faces[i];
+		files[i] = VirtualFileSystem::Open(filepath);
+		int numChannels;
+		if (!files[i].IsOpen() || !stbi_info_from_memory(files[i].GetData(), static_cast<int>(files[i].GetSize()), &widths[i], &heights[i], &numChannels))
+		{
+			ASSERT(false, "Failed to open " + filepath);
+			return;
+		}
+
+		if (widths[i] != heights[i] || widths[i] != widths[0])
+		{
+			LOG_ERROR("Cube map face {} is {}x{}, every face has to be square and the same size", filepath, widths[i], heights[i]);
+			ASSERT(false);
+			return;
+		}
+	}
+
+	const uint32_t size = static_cast<uint32_t>(widths[0]);
+	const uint32_t numMips = MipGenerator::GetNumLevels(size, size);
+
+	// Subresources are ordered face by face, every mip of a face back to back the way MipGenerator lays out a chain
+	std::vector<size_t> mipOffsets(numMips + 1, 0);
+	for (uint32_t mip = 0; mip < numMips; mip++)
+	{
+		const size_t mipSize = std::max(size >> mip, 1u);
+		mipOffsets[mip + 1] = mipOffsets[mip] + mipSize * mipSize * s_NumChannels;
+	}
+	const size_t faceSize = MipGenerator::GetChainSize(size, size);
+	ASSERT(faceSize == mipOffsets[numMips]);
+	// The extra byte is stb_image's slack after the last face, see stbi_set_output_target
+	const BufferPool::Buffer staging = BufferPool::Acquire(faceSize * 6 + 1);
+	ImportProfiler::AddBytesAllocated(staging.GetSize());
+
+	// Box filtering never reaches across a face's edge, unlike the wider filters which would wrap around to its far side
+	MipSettings mipSettings;
+	mipSettings.Filter = MipFilter::Box;
+
+	std::array<bool, 6> decoded = {};
+	ThreadPool::ParallelFor(6, [&](uint32_t i)
+	{
+		uint8_t* face = staging.GetData() + faceSize * i;
+		const size_t topSize = mipOffsets[1];
+
+		int width, height, numChannels;
+		stbi_set_output_target(face, topSize);
+		stbi_uc* pixels = stbi_load_from_memory(files[i].GetData(), static_cast<int>(files[i].GetSize()), &width, &height, &numChannels, s_NumChannels);
+		stbi_set_output_target(nullptr, 0);
+
+		const bool isValid = pixels && width == widths[i] && height == heights[i];
+		if (pixels != face)
+		{
+			// stb_image needed another buffer of the same size along the way and returned that one
+			if (isValid)
+			{
+				memcpy(face, pixels, topSize);
+			}
+			stbi_image_free(pixels);
+		}
+
+		if (isValid)
+		{
+			MipGenerator::GenerateInPlace(face, size, size, mipSettings);
+			decoded[i] = true;
+		}
+	});
+
 	for (int i = 0; i < 6; i++)
 	{
-		std::string filepath = mapDir + s_Faces[i];
-		LOG_DEBUG("Loading {}", filepath);
-		
-		textureData[i] = stbi_load(filepath.c_str(), &width, &height, &numChannels, desiredChannels);
+		if (!decoded[i])
+		{
+			ASSERT(false, "Failed to decode " + mapDir + s_Faces[i]);
+			return;
+		}
 	}
 
 	D3D11_TEXTURE2D_DESC textureDesc = {};
-	textureDesc.Width = width;
-	textureDesc.Height = height;
-	textureDesc.MipLevels = 1;
+	textureDesc.Width = size;
+	textureDesc.Height = size;
+	textureDesc.MipLevels = numMips;
 	textureDesc.ArraySize = 6;
 	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.SampleDesc.Quality = 0;
-	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
 	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 	textureDesc.CPUAccessFlags = 0;
 	textureDesc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE;
 
-	D3D11_SUBRESOURCE_DATA data[6];
-	for (int i = 0; i < 6; i++)
+	std::vector<D3D11_SUBRESOURCE_DATA> data(6 * numMips);
+	for (uint32_t face = 0; face < 6; face++)
 	{
-		data[i].pSysMem = textureData[i];
-		data[i].SysMemPitch = width * desiredChannels;
-		data[i].SysMemSlicePitch = 0;
+		for (uint32_t mip = 0; mip < numMips; mip++)
+		{
+			D3D11_SUBRESOURCE_DATA& subresource = data[D3D11CalcSubresource(mip, face, numMips)];
+			subresource.pSysMem = staging.GetData() + faceSize * face + mipOffsets[mip];
+			subresource.SysMemPitch = std::max(size >> mip, 1u) * s_NumChannels;
+			subresource.SysMemSlicePitch = 0;
+		}
 	}
 
 	ComPtr<ID3D11Texture2D> texture;
-	ASSERT_HR(m_Context.GetDevice().CreateTexture2D(&textureDesc, data, &texture));
+	ASSERT_HR(m_Context.GetDevice().CreateTexture2D(&textureDesc, data.data(), &texture));
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Format = textureDesc.Format;
 	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
-	srvDesc.Texture2D.MostDetailedMip = 0;
-	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.TextureCube.MostDetailedMip = 0;
+	srvDesc.TextureCube.MipLevels = -1; // -1 will use all mip levels
 
 	ASSERT_HR(
 		m_Context.GetDevice().CreateShaderResourceView(texture.Get(), &srvDesc, &m_TextureView)
 	);
 
-	D3D11_SAMPLER_DESC samplerDesc = {};
-	samplerDesc.Filter = FilterToD3D(filter);
-	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-	samplerDesc.MaxAnisotropy = D3D11_REQ_MAXANISOTROPY;
-	samplerDesc.MipLODBias = 0.f;
-	samplerDesc.MinLOD = 0.f;
-	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
-	ASSERT_HR(
-		m_Context.GetDevice().CreateSamplerState(&samplerDesc, &m_SamplerState)
-	);
+	LOG_DEBUG("Loaded cube map {} ({}x{}, {} mips) in {:.2f}ms", mapDir, size, size, numMips, timer.GetElapsedInMilliseconds());
 
+	m_Sampler = Sampler::Resolve(filter);
 }
 
 void DX11TextureCube::Bind() const
 {
-	m_Context.GetDeviceContext().PSSetSamplers(0, 1, m_SamplerState.GetAddressOf());
 	m_Context.GetDeviceContext().PSSetShaderResources(m_Slot, 1, m_TextureView.GetAddressOf());
 }
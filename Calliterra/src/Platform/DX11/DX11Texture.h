@@ -1,9 +1,12 @@
 #pragma once
 #include "Renderer/Texture.h"
 #include "DX11Context.h"
+#include "Asset/TextureCompressor.h"
+#include "Asset/TextureDecoder.h"
+#include <mutex>
 
 
-static D3D11_FILTER FilterToD3D(Texture::Filter filter); 
+static DXGI_FORMAT TextureFormatToDXGI(TextureFormat format);
 
 class DX11Texture : public Texture
 {
@@ -11,24 +14,44 @@ public:
 	DX11Texture(DX11Context& context, const std::string& filepath, uint32_t slot = 0, Filter filter = Filter::Anisotropic);
 	
 	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForTexture(m_Slot); }
 
 	bool HasBlending() override { return m_HasAlpha; }
 
+	bool IsStreamable() const override { return m_MipTail > 0; }
+	uint32_t GetWidth() const override { return m_Width; }
+	uint32_t GetNumMips() const override { return static_cast<uint32_t>(m_Source->Mips.size()); }
+	uint32_t GetResidentMip() const override { return m_ResidentMip; }
+	size_t GetMemorySize(uint32_t firstMip) const override;
+	void StreamMips(uint32_t firstMip) override;
+	bool CommitStreamedMips() override;
+
+private:
+	// Creates an immutable texture holding only the mips from firstMip down
+	void CreateMipResources(uint32_t firstMip, ComPtr<ID3D11Texture2D>& texture, ComPtr<ID3D11ShaderResourceView>& textureView) const;
+
 private:
 	DX11Context& m_DX11Context;
 	uint32_t m_Slot;
 	
 	std::string m_Filepath;
-	int m_Width;
-	int m_Height;
-	int m_NumChannels;
-	const int m_DesiredChannels = 4;
-	unsigned char* m_TextureData;
+	uint32_t m_Width;
+	uint32_t m_Height;
 	bool m_HasAlpha = false;
 
+	// Memory mapped from the TextureCache, streamed mips are created straight from it
+	std::shared_ptr<CookedTexture> m_Source;
+	uint32_t m_MipTail = 0;
+	uint32_t m_ResidentMip = 0;
+
 	ComPtr<ID3D11Texture2D> m_Texture;
 	ComPtr<ID3D11ShaderResourceView> m_TextureView;
-	ComPtr<ID3D11SamplerState> m_SamplerState;
+
+	// Created by StreamMips on a worker thread, waiting for CommitStreamedMips
+	ComPtr<ID3D11Texture2D> m_PendingTexture;
+	ComPtr<ID3D11ShaderResourceView> m_PendingTextureView;
+	uint32_t m_PendingMip = 0;
+	std::mutex m_PendingMutex;
 };
 
 class DX11TextureCube : public Texture
@@ -37,6 +60,7 @@ public:
 	DX11TextureCube(DX11Context& context, const std::string& mapDir, uint32_t slot = 0, Filter filter = Filter::Anisotropic);
 
 	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForTexture(m_Slot); }
 	bool HasBlending() override { return false; }
 
 private:
@@ -49,11 +73,11 @@ private:
 		"RIGHT.png",
 		"LEFT.png"
 	};
+	inline static constexpr int s_NumChannels = 4;
 
 private:
 	DX11Context& m_Context;
 	uint32_t m_Slot;
 
 	ComPtr<ID3D11ShaderResourceView> m_TextureView;
-	ComPtr<ID3D11SamplerState> m_SamplerState;
 };
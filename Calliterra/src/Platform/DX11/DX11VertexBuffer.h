@@ -16,6 +16,9 @@ static DXGI_FORMAT ShaderDataTypeToD3D(ShaderDataType type)
 	case ShaderDataType::Int2:		return DXGI_FORMAT_R32G32_SINT;
 	case ShaderDataType::Int3:		return DXGI_FORMAT_R32G32B32_SINT;
 	case ShaderDataType::Int4:		return DXGI_FORMAT_R32G32B32A32_SINT;
+	case ShaderDataType::Half2:		return DXGI_FORMAT_R16G16_FLOAT;
+	case ShaderDataType::Short2Norm:	return DXGI_FORMAT_R16G16_SNORM;
+	case ShaderDataType::UShort4Norm:	return DXGI_FORMAT_R16G16B16A16_UNORM;
 	}
 
 	ASSERT(false, "ShaderType Conversion not supported yet.");
@@ -27,39 +30,28 @@ class DX11VertexBuffer : public VertexBuffer
 {
 public:
 	DX11VertexBuffer(const DX11Context& context, const std::vector<Type>& vertices)
-		: m_DX11Context(context), m_VertexLists(std::vector<std::vector<Type>>{vertices}), m_BufferCount(1)
+		: m_DX11Context(context), m_BufferCount(1)
 	{
-		InitSingleVertexBuffer();
+		InitSingleVertexBuffer(vertices);
 	}
 
 	DX11VertexBuffer(const DX11Context& context, const std::vector<std::vector<Type>>& listOfVertexArrays)
-		: m_DX11Context(context), m_VertexLists(listOfVertexArrays), m_BufferCount(listOfVertexArrays.size())
+		: m_DX11Context(context), m_BufferCount(static_cast<uint32_t>(listOfVertexArrays.size()))
 	{
-		InitMultiVertexBuffers();
+		InitMultiVertexBuffers(listOfVertexArrays);
 	}
 
 	void DX11VertexBuffer<Type>::Bind() const override
 	{
 		ASSERT(m_HasLayout, "Attempting to bind vertex buffer before a layout has been created.");
 		m_DX11Context.GetDeviceContext().IASetInputLayout(m_D3DBufferLayout.Get());
-
-		std::vector<UINT> strideList;
-		strideList.reserve(m_BufferCount);
-		std::vector<UINT> offsets;
-		for (uint32_t i = 0; i < m_BufferCount; i++)
-		{
-			size_t strd = m_BufferLayoutArray[i].GetStride();
-			strideList.push_back(static_cast<UINT>(m_BufferLayoutArray[i].GetStride()));
-			offsets.push_back(0);
-		}
-
-		m_DX11Context.GetDeviceContext().IASetVertexBuffers(0, static_cast<UINT>(m_BufferCount), m_D3DVertexBufferArray[0].GetAddressOf(), &strideList[0], offsets.data());
-			
+		m_DX11Context.GetDeviceContext().IASetVertexBuffers(0, static_cast<UINT>(m_BufferCount), m_D3DVertexBufferArray[0].GetAddressOf(), m_Strides, m_Offsets);
 	}
 
 	void DX11VertexBuffer<Type>::CreateLayout(const VertexBufferLayout& layout, Shader* shader) override
 	{
 		m_BufferLayoutArray[0] = layout;
+		m_Strides[0] = static_cast<UINT>(layout.GetStride());
 		std::vector<D3D11_INPUT_ELEMENT_DESC> desc;
 		std::vector<BufferElement> layoutElements = layout.GetElements();
 
@@ -101,6 +93,7 @@ public:
 		for (int i = 0; i < layoutList.size(); i++)
 		{
 			m_BufferLayoutArray[i] = layoutList[i];
+			m_Strides[i] = static_cast<UINT>(layoutList[i].GetStride());
 			std::vector<BufferElement> layoutElements = layoutList[i].GetElements();
 
 			for (int j = 0; j < layoutElements.size(); j++)
@@ -134,18 +127,19 @@ public:
 	}
 
 private:
-	void InitSingleVertexBuffer()
+	// The vertices are only needed to fill the buffer, we don't keep a CPU side copy of them
+	void InitSingleVertexBuffer(const std::vector<Type>& vertices)
 	{
 		D3D11_BUFFER_DESC vbDesc = {};
 		vbDesc.Usage = D3D11_USAGE_DEFAULT;
-		vbDesc.ByteWidth = static_cast<UINT>(sizeof(Type) * m_VertexLists[0].size());
+		vbDesc.ByteWidth = static_cast<UINT>(sizeof(Type) * vertices.size());
 		vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 		vbDesc.CPUAccessFlags = 0;
 		vbDesc.MiscFlags = 0;
 		vbDesc.StructureByteStride = 0;
 
 		D3D11_SUBRESOURCE_DATA vertexInitData = {};
-		vertexInitData.pSysMem = m_VertexLists[0].data();
+		vertexInitData.pSysMem = vertices.data();
 
 		ASSERT_HR(
 			m_DX11Context.GetDevice().CreateBuffer(
@@ -156,7 +150,7 @@ private:
 		);
 	}
 
-	void InitMultiVertexBuffers()
+	void InitMultiVertexBuffers(const std::vector<std::vector<Type>>& listOfVertexArrays)
 	{
 		ASSERT(m_BufferCount < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, "Too many buffers are being bound!");
 
@@ -164,14 +158,14 @@ private:
 		{
 			D3D11_BUFFER_DESC vbDesc = {};
 			vbDesc.Usage = D3D11_USAGE_DEFAULT;
-			vbDesc.ByteWidth = static_cast<UINT>(sizeof(Type) * m_VertexLists[i].size());
+			vbDesc.ByteWidth = static_cast<UINT>(sizeof(Type) * listOfVertexArrays[i].size());
 			vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 			vbDesc.CPUAccessFlags = 0;
 			vbDesc.MiscFlags = 0;
 			vbDesc.StructureByteStride = 0;
 
 			D3D11_SUBRESOURCE_DATA vertexInitData = {};
-			vertexInitData.pSysMem = m_VertexLists[i].data(); 
+			vertexInitData.pSysMem = listOfVertexArrays[i].data(); 
 
 			ASSERT_HR(
 				m_DX11Context.GetDevice().CreateBuffer(
@@ -187,12 +181,14 @@ private:
 private:
 	const DX11Context& m_DX11Context;
 
-	const std::vector<std::vector<Type>> m_VertexLists;
 	const uint32_t m_BufferCount;
 
 	ComPtr<ID3D11Buffer> m_D3DVertexBufferArray[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
 	ComPtr<ID3D11InputLayout> m_D3DBufferLayout;
 	VertexBufferLayout m_BufferLayoutArray[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+	// Worked out with the layout, so binding doesn't have to
+	UINT m_Strides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {};
+	UINT m_Offsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {};
 
 	bool m_HasLayout = false;
 
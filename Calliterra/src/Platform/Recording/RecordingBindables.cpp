@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "RecordingBindables.h"
+
+RecordingShader::RecordingShader(RecordingContext& context, const std::string&, ShaderType type)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_Type(type)
+{
+}
+
+void RecordingShader::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindShader, m_Id, static_cast<uint8_t>(m_Type));
+}
+
+RecordingTexture::RecordingTexture(RecordingContext& context, const std::string&, uint32_t slot, Filter filter, TextureType)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_Slot(slot)
+{
+	m_Sampler = Sampler::Resolve(filter);
+}
+
+void RecordingTexture::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindTexture, m_Id, Shader::PIXEL_SHADER, static_cast<uint16_t>(m_Slot));
+}
+
+RecordingSampler::RecordingSampler(RecordingContext& context, Texture::Filter filter, uint32_t slot)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_Filter(filter), m_Slot(slot)
+{
+}
+
+void RecordingSampler::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindSampler, m_Id, Shader::PIXEL_SHADER, static_cast<uint16_t>(m_Slot), static_cast<uint32_t>(m_Filter));
+}
+
+RecordingVertexBuffer::RecordingVertexBuffer(RecordingContext& context, size_t vertexCount)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_VertexCount(vertexCount)
+{
+}
+
+void RecordingVertexBuffer::Bind() const
+{
+	ASSERT(m_HasLayout, "Attempting to bind vertex buffer before a layout has been created.");
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindVertexBuffer, m_Id, 0, 0, static_cast<uint32_t>(m_VertexCount));
+}
+
+RecordingIndexBuffer::RecordingIndexBuffer(RecordingContext& context, const std::vector<uint32_t>& indices)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_Count(static_cast<uint32_t>(indices.size()))
+{
+}
+
+void RecordingIndexBuffer::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindIndexBuffer, m_Id);
+}
+
+RecordingConstantBuffer::RecordingConstantBuffer(RecordingContext& context, Shader::ShaderType shaderType, size_t size, uint32_t slot)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_ShaderType(shaderType), m_Size(size), m_Slot(slot)
+{
+}
+
+void RecordingConstantBuffer::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindConstantBuffer, m_Id, static_cast<uint8_t>(m_ShaderType), static_cast<uint16_t>(m_Slot));
+}
+
+void RecordingConstantBuffer::Update(size_t size)
+{
+	ASSERT(size == m_Size, "Constant buffer updated with a different type than it was created with");
+	m_Context.GetCommandStream().Record(RecordedCommandType::UpdateConstantBuffer, m_Id, static_cast<uint8_t>(m_ShaderType), static_cast<uint16_t>(m_Slot), static_cast<uint32_t>(size));
+}
+
+RecordingBlender::RecordingBlender(RecordingContext& context, bool enableBlending)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_EnableBlending(enableBlending)
+{
+}
+
+void RecordingBlender::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindBlender, m_Id, 0, 0, m_EnableBlending);
+}
+
+RecordingDepthStencilMask::RecordingDepthStencilMask(RecordingContext& context, Mode mode)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_Mode(mode)
+{
+}
+
+void RecordingDepthStencilMask::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindDepthStencilMask, m_Id, 0, 0, static_cast<uint32_t>(m_Mode));
+}
+
+RecordingTopology::RecordingTopology(RecordingContext& context, PrimitiveTopology primitiveTopology)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_PrimitiveTopology(primitiveTopology)
+{
+}
+
+void RecordingTopology::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindTopology, m_Id, 0, 0, static_cast<uint32_t>(m_PrimitiveTopology));
+}
+
+RecordingRasterizer::RecordingRasterizer(RecordingContext& context, FillMode fillMode, CullMode cullMode)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId()), m_FillMode(fillMode), m_CullMode(cullMode)
+{
+}
+
+void RecordingRasterizer::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindRasterizer, m_Id, 0, 0, static_cast<uint32_t>(m_FillMode), static_cast<uint32_t>(m_CullMode));
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "Renderer/Shader.h"
+#include "Renderer/Texture.h"
+#include "Renderer/VertexBuffer.h"
+#include "Renderer/IndexBuffer.h"
+#include "Renderer/ConstantBuffer.h"
+#include "Renderer/Blender.h"
+#include "Renderer/DepthStencilMask.h"
+#include "Renderer/Topology.h"
+#include "Renderer/Rasterizer.h"
+#include "Renderer/Sampler.h"
+#include "RecordingContext.h"
+
+// The recording backend's bindables. None of them own any GPU resources (or read their source files), binding
+// one records the call with the object's id, which is all that's needed to count draws and state changes.
+
+class RecordingShader : public Shader
+{
+public:
+	RecordingShader(RecordingContext& context, const std::string& filepath, ShaderType type);
+	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForShader(m_Type); }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	ShaderType m_Type;
+};
+
+class RecordingTexture : public Texture
+{
+public:
+	RecordingTexture(RecordingContext& context, const std::string& filepath, uint32_t slot, Filter filter, TextureType type);
+	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForTexture(m_Slot); }
+
+	// The texture is never decoded, so there's no alpha channel to blend with
+	bool HasBlending() override { return false; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	uint32_t m_Slot;
+};
+
+class RecordingSampler : public Sampler
+{
+public:
+	RecordingSampler(RecordingContext& context, Texture::Filter filter, uint32_t slot);
+	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForSampler(m_Slot); }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	Texture::Filter m_Filter;
+	uint32_t m_Slot;
+};
+
+class RecordingVertexBuffer : public VertexBuffer
+{
+public:
+	RecordingVertexBuffer(RecordingContext& context, size_t vertexCount);
+	void Bind() const override;
+
+	void CreateLayout(const VertexBufferLayout&, Shader* = nullptr) override { m_HasLayout = true; }
+	void CreateLayoutList(const std::vector<VertexBufferLayout>&, Shader* = nullptr) override { m_HasLayout = true; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	size_t m_VertexCount;
+	bool m_HasLayout = false;
+};
+
+class RecordingIndexBuffer : public IndexBuffer
+{
+public:
+	RecordingIndexBuffer(RecordingContext& context, const std::vector<uint32_t>& indices);
+	void Bind() const override;
+
+	uint32_t GetCount() const override { return m_Count; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	uint32_t m_Count;
+};
+
+// A single class for every shader stage and constants type, Renderer::UpdateConstantBuffer passes the size along
+class RecordingConstantBuffer : public ConstantBuffer
+{
+public:
+	RecordingConstantBuffer(RecordingContext& context, Shader::ShaderType shaderType, size_t size, uint32_t slot);
+	void Bind() const override;
+	uint32_t GetBindSlot() const override { return BindSlot::ForConstantBuffer(m_ShaderType, m_Slot); }
+	void Update(size_t size);
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	Shader::ShaderType m_ShaderType;
+	size_t m_Size;
+	uint32_t m_Slot;
+};
+
+class RecordingBlender : public Blender
+{
+public:
+	RecordingBlender(RecordingContext& context, bool enableBlending);
+	void Bind() const override;
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	bool m_EnableBlending;
+};
+
+class RecordingDepthStencilMask : public DepthStencilMask
+{
+public:
+	RecordingDepthStencilMask(RecordingContext& context, Mode mode);
+	void Bind() const override;
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	Mode m_Mode;
+};
+
+class RecordingTopology : public Topology
+{
+public:
+	RecordingTopology(RecordingContext& context, PrimitiveTopology primitiveTopology);
+	void Bind() const override;
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	PrimitiveTopology m_PrimitiveTopology;
+};
+
+class RecordingRasterizer : public Rasterizer
+{
+public:
+	RecordingRasterizer(RecordingContext& context, FillMode fillMode, CullMode cullMode);
+	void Bind() const override;
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+	FillMode m_FillMode;
+	CullMode m_CullMode;
+};
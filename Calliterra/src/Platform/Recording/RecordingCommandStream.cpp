@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "RecordingCommandStream.h"
+
+void RecordingCommandStream::Record(RecordedCommandType type, uint32_t resource, uint8_t stage, uint16_t slot, uint32_t arg0, uint32_t arg1)
+{
+	m_Commands.push_back({ type, stage, slot, resource, arg0, arg1 });
+	m_Stats.Commands[static_cast<size_t>(type)]++;
+
+	switch (type)
+	{
+	case RecordedCommandType::UpdateConstantBuffer:
+	case RecordedCommandType::ClearRenderTarget:
+	case RecordedCommandType::ClearDepthStencil:
+	case RecordedCommandType::Present:
+		break;
+	case RecordedCommandType::DrawIndexed:
+		m_Stats.IndicesDrawn += arg0;
+		break;
+	default:
+	{
+		// Render targets are bound together with their depth stencil buffer, either changing is a state change
+		const uint32_t key = static_cast<uint32_t>(type) << 24 | static_cast<uint32_t>(stage) << 16 | slot;
+		const uint64_t state = type == RecordedCommandType::BindRenderTarget ? (static_cast<uint64_t>(arg0) << 32 | resource) : resource;
+		const auto [it, inserted] = m_Bound.try_emplace(key, 0);
+		if (!inserted && it->second == state)
+		{
+			m_Stats.RedundantBinds++;
+		}
+		else
+		{
+			it->second = state;
+			m_Stats.StateChanges++;
+		}
+		break;
+	}
+	}
+}
+
+void RecordingCommandStream::Clear()
+{
+	m_Commands.clear();
+	m_Stats = {};
+}
+
+std::string RecordingCommandStream::ToString() const
+{
+	std::string text;
+	for (const RecordedCommand& command : m_Commands)
+	{
+		text += std::format("{} resource={} stage={} slot={} args={},{}\n", GetCommandName(command.Type), command.Resource,
+			command.Stage, command.Slot, command.Arg0, command.Arg1);
+	}
+	return text;
+}
+
+const char* RecordingCommandStream::GetCommandName(RecordedCommandType type)
+{
+	switch (type)
+	{
+	case RecordedCommandType::BindShader:           return "BindShader";
+	case RecordedCommandType::BindVertexBuffer:     return "BindVertexBuffer";
+	case RecordedCommandType::BindIndexBuffer:      return "BindIndexBuffer";
+	case RecordedCommandType::BindTexture:          return "BindTexture";
+	case RecordedCommandType::BindSampler:          return "BindSampler";
+	case RecordedCommandType::BindConstantBuffer:   return "BindConstantBuffer";
+	case RecordedCommandType::UpdateConstantBuffer: return "UpdateConstantBuffer";
+	case RecordedCommandType::BindBlender:          return "BindBlender";
+	case RecordedCommandType::BindDepthStencilMask: return "BindDepthStencilMask";
+	case RecordedCommandType::BindTopology:         return "BindTopology";
+	case RecordedCommandType::BindRasterizer:       return "BindRasterizer";
+	case RecordedCommandType::BindRenderTarget:     return "BindRenderTarget";
+	case RecordedCommandType::ClearRenderTarget:    return "ClearRenderTarget";
+	case RecordedCommandType::ClearDepthStencil:    return "ClearDepthStencil";
+	case RecordedCommandType::DrawIndexed:          return "DrawIndexed";
+	case RecordedCommandType::Present:              return "Present";
+	case RecordedCommandType::NumCommandTypes:      break;
+	}
+
+	return "Unknown";
+}
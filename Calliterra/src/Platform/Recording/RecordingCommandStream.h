@@ -0,0 +1,77 @@
+#pragma once
+
+enum class RecordedCommandType : uint8_t
+{
+	BindShader,
+	BindVertexBuffer,
+	BindIndexBuffer,
+	BindTexture,
+	BindSampler,
+	BindConstantBuffer,
+	UpdateConstantBuffer,
+	BindBlender,
+	BindDepthStencilMask,
+	BindTopology,
+	BindRasterizer,
+	BindRenderTarget,
+	ClearRenderTarget,
+	ClearDepthStencil,
+	DrawIndexed,
+	Present,
+	NumCommandTypes
+};
+
+// A single call into the recording backend. Resource is the id of the object the call was made on, the
+// meaning of the arguments depends on the type:
+//   Bind*                 Arg0 is the state the object describes (topology, fill mode, ...) where there is one
+//   BindRenderTarget      Arg0 is the depth stencil buffer's id, 0 for none
+//   UpdateConstantBuffer  Arg0 is the size of the update in bytes
+//   DrawIndexed           Arg0 is the index count, Arg1 the start index
+struct RecordedCommand
+{
+	RecordedCommandType Type;
+	uint8_t Stage; // Shader::ShaderType for shaders and the resources bound to them
+	uint16_t Slot;
+	uint32_t Resource;
+	uint32_t Arg0;
+	uint32_t Arg1;
+};
+
+struct RecordingStats
+{
+	std::array<uint32_t, static_cast<size_t>(RecordedCommandType::NumCommandTypes)> Commands = {};
+	// Binds that replaced what was bound to the same stage and slot
+	uint32_t StateChanges = 0;
+	// Binds of what was already bound there, a real device would have done nothing
+	uint32_t RedundantBinds = 0;
+	uint64_t IndicesDrawn = 0;
+
+	uint32_t GetCount(RecordedCommandType type) const { return Commands[static_cast<size_t>(type)]; }
+};
+
+// Everything the recording backend was asked to do, in order. Which object is bound to each stage and
+// slot is tracked the same way a device would, so redundant binds can be told apart from state changes.
+class RecordingCommandStream
+{
+public:
+	uint32_t CreateResourceId() { return ++m_LastResourceId; }
+
+	void Record(RecordedCommandType type, uint32_t resource, uint8_t stage = 0, uint16_t slot = 0, uint32_t arg0 = 0, uint32_t arg1 = 0);
+
+	const std::vector<RecordedCommand>& GetCommands() const { return m_Commands; }
+	const RecordingStats& GetStats() const { return m_Stats; }
+
+	// Starts a new recording. What is bound stays bound, like it would on a device.
+	void Clear();
+	// One line per command, for diffing the command streams of two runs
+	std::string ToString() const;
+
+	static const char* GetCommandName(RecordedCommandType type);
+
+private:
+	std::vector<RecordedCommand> m_Commands;
+	RecordingStats m_Stats;
+	// Bound resource by type, stage and slot
+	std::unordered_map<uint32_t, uint64_t> m_Bound;
+	uint32_t m_LastResourceId = 0;
+};
@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "RecordingContext.h"
+#include "RecordingRenderTarget.h"
+
+RecordingContext::RecordingContext(uint32_t width, uint32_t height)
+	: m_Width(width), m_Height(height)
+{
+}
+
+void RecordingContext::Init()
+{
+	m_RenderTarget = std::make_shared<RecordingOutputOnlyRenderTarget>(*this);
+}
+
+void RecordingContext::SwapBuffers()
+{
+	m_CommandStream.Record(RecordedCommandType::Present, 0);
+}
+
+std::shared_ptr<RenderTarget> RecordingContext::GetBackBufferTarget() const
+{
+	return m_RenderTarget;
+}
+
+// The same steps as DX11Context::OnWindowResize, so resizing can be tested headless
+void RecordingContext::OnWindowResize()
+{
+	FreeBuffers();
+	m_RenderTarget = std::make_shared<RecordingOutputOnlyRenderTarget>(*this);
+	InitRenderQueueBuffers();
+}
+
+void RecordingContext::Resize(uint32_t width, uint32_t height)
+{
+	m_Width = width;
+	m_Height = height;
+	OnWindowResize();
+}
+
+void RecordingContext::FreeBuffers()
+{
+	m_RenderTarget.reset();
+	FreeRenderQueueBuffers();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Renderer/GraphicsContext.h"
+#include "RecordingCommandStream.h"
+
+class RecordingOutputOnlyRenderTarget;
+
+// Graphics context of the recording backend. There is no device or window behind it, every bindable
+// created for it just records its calls into the context's command stream. This lets the render queue,
+// passes and drawables run headless, to benchmark the CPU side of a frame or check how many draws and
+// state changes it took.
+class RecordingContext : public GraphicsContext
+{
+public:
+	RecordingContext(uint32_t width, uint32_t height);
+
+	void Init() override;
+	void SwapBuffers() override;
+	void OnWindowResize() override;
+	// There's no window to resize, this stands in for it
+	void Resize(uint32_t width, uint32_t height);
+
+	std::shared_ptr<RenderTarget> GetBackBufferTarget() const override;
+
+	uint32_t GetWidth() const override { return m_Width; }
+	uint32_t GetHeight() const override { return m_Height; }
+
+	void ToggleFullscreen() override {}
+
+	RecordingCommandStream& GetCommandStream() { return m_CommandStream; }
+	const RecordingCommandStream& GetCommandStream() const { return m_CommandStream; }
+
+private:
+	void FreeBuffers() override;
+
+private:
+	uint32_t m_Width;
+	uint32_t m_Height;
+	RecordingCommandStream m_CommandStream;
+
+	std::shared_ptr<RecordingOutputOnlyRenderTarget> m_RenderTarget = nullptr;
+};
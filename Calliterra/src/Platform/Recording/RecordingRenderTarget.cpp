@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "RecordingRenderTarget.h"
+#include "Renderer/Shader.h"
+
+namespace
+{
+	// Like the DX11 backend, binding a render target unbinds whatever texture was in the first pixel shader slot
+	void RecordRenderTargetBind(RecordingCommandStream& stream, uint32_t renderTarget, uint32_t depthStencil)
+	{
+		stream.Record(RecordedCommandType::BindTexture, 0, Shader::PIXEL_SHADER, 0);
+		stream.Record(RecordedCommandType::BindRenderTarget, renderTarget, 0, 0, depthStencil);
+	}
+}
+
+RecordingShaderInputRenderTarget::RecordingShaderInputRenderTarget(RecordingContext& context, uint32_t, uint32_t, uint32_t slot)
+	: ShaderInputRenderTarget(slot), m_Context(context), m_Id(context.GetCommandStream().CreateResourceId())
+{
+}
+
+void RecordingShaderInputRenderTarget::Bind() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindTexture, m_Id, Shader::PIXEL_SHADER, static_cast<uint16_t>(m_Slot));
+}
+
+void RecordingShaderInputRenderTarget::Clear() const
+{
+	Clear({0.f, 0.f, 0.f, 0.f});
+}
+
+void RecordingShaderInputRenderTarget::Clear(DX::XMFLOAT4) const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::ClearRenderTarget, m_Id);
+}
+
+void RecordingShaderInputRenderTarget::BindAsBuffer() const
+{
+	RecordRenderTargetBind(m_Context.GetCommandStream(), m_Id, 0);
+}
+
+void RecordingShaderInputRenderTarget::BindAsBuffer(BufferResource* depthStencil) const
+{
+	ASSERT(dynamic_cast<RecordingDepthStencilBuffer*>(depthStencil) != nullptr);
+	RecordRenderTargetBind(m_Context.GetCommandStream(), m_Id, static_cast<RecordingDepthStencilBuffer*>(depthStencil)->GetId());
+}
+
+
+//=========================================================================================
+
+
+RecordingOutputOnlyRenderTarget::RecordingOutputOnlyRenderTarget(RecordingContext& context)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId())
+{
+}
+
+void RecordingOutputOnlyRenderTarget::Bind() const
+{
+	ASSERT(false, "Cannot bind OutputOnlyRenderTarget as shader input");
+}
+
+void RecordingOutputOnlyRenderTarget::Clear() const
+{
+	Clear({0.f, 0.f, 0.f, 0.f});
+}
+
+void RecordingOutputOnlyRenderTarget::Clear(DX::XMFLOAT4) const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::ClearRenderTarget, m_Id);
+}
+
+void RecordingOutputOnlyRenderTarget::BindAsBuffer() const
+{
+	RecordRenderTargetBind(m_Context.GetCommandStream(), m_Id, 0);
+}
+
+void RecordingOutputOnlyRenderTarget::BindAsBuffer(BufferResource* depthStencil) const
+{
+	ASSERT(dynamic_cast<RecordingDepthStencilBuffer*>(depthStencil) != nullptr);
+	RecordRenderTargetBind(m_Context.GetCommandStream(), m_Id, static_cast<RecordingDepthStencilBuffer*>(depthStencil)->GetId());
+}
+
+
+//=========================================================================================
+
+
+RecordingDepthStencilBuffer::RecordingDepthStencilBuffer(RecordingContext& context, uint32_t, uint32_t, bool)
+	: m_Context(context), m_Id(context.GetCommandStream().CreateResourceId())
+{
+}
+
+void RecordingDepthStencilBuffer::BindAsBuffer() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::BindRenderTarget, 0, 0, 0, m_Id);
+}
+
+void RecordingDepthStencilBuffer::BindAsBuffer(BufferResource* renderTarget) const
+{
+	ASSERT(dynamic_cast<RecordingShaderInputRenderTarget*>(renderTarget) != nullptr);
+	static_cast<RecordingShaderInputRenderTarget*>(renderTarget)->BindAsBuffer(const_cast<RecordingDepthStencilBuffer*>(this));
+}
+
+void RecordingDepthStencilBuffer::Clear() const
+{
+	m_Context.GetCommandStream().Record(RecordedCommandType::ClearDepthStencil, m_Id);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Renderer/RenderTarget.h"
+#include "Renderer/DepthStencilBuffer.h"
+#include "RecordingContext.h"
+
+class RecordingShaderInputRenderTarget : public ShaderInputRenderTarget
+{
+public:
+	RecordingShaderInputRenderTarget(RecordingContext& context, uint32_t width, uint32_t height, uint32_t slot);
+	void Bind() const override; // Binds as a texture to be used in a shader
+	void Clear() const override;
+	void Clear(DX::XMFLOAT4) const override;
+
+	void BindAsBuffer() const override; // Binds as a buffer to render to
+	void BindAsBuffer(BufferResource* depthStencil) const override;
+
+	uint32_t GetId() const { return m_Id; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+};
+
+
+//=========================================================================================
+
+
+class RecordingOutputOnlyRenderTarget : public OutputOnlyRenderTarget
+{
+public:
+	RecordingOutputOnlyRenderTarget(RecordingContext& context);
+	void Bind() const override;
+	void Clear() const override;
+	void Clear(DX::XMFLOAT4) const override;
+
+	void BindAsBuffer() const override;
+	void BindAsBuffer(BufferResource* depthStencil) const override;
+
+	uint32_t GetId() const { return m_Id; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+};
+
+
+//=========================================================================================
+
+
+class RecordingDepthStencilBuffer : public DepthStencilBuffer
+{
+public:
+	RecordingDepthStencilBuffer(RecordingContext& context, uint32_t width, uint32_t height, bool canBindShaderResource);
+	void BindAsBuffer() const override;
+	void BindAsBuffer(BufferResource* renderTarget) const override;
+	void Clear() const override;
+
+	uint32_t GetId() const { return m_Id; }
+
+private:
+	RecordingContext& m_Context;
+	uint32_t m_Id;
+};
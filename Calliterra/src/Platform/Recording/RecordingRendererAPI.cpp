@@ -0,0 +1,14 @@
+#include "pch.h"
+#include "RecordingRendererAPI.h"
+
+void RecordingRendererAPI::Init(std::shared_ptr<GraphicsContext> context)
+{
+	m_Context = std::dynamic_pointer_cast<RecordingContext>(context);
+	ASSERT(m_Context, "The recording RendererAPI needs a RecordingContext");
+	LOG_INFO("Recording Renderer Initialized");
+}
+
+void RecordingRendererAPI::DrawIndexed(uint32_t indexCount, uint32_t startIndex)
+{
+	m_Context->GetCommandStream().Record(RecordedCommandType::DrawIndexed, 0, 0, 0, indexCount, startIndex);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "Renderer/RendererAPI.h"
+#include "RecordingContext.h"
+
+class RecordingRendererAPI : public RendererAPI
+{
+public:
+	void Init(std::shared_ptr<GraphicsContext> context) override;
+	void DrawIndexed(uint32_t indexCount, uint32_t startIndex) override;
+
+private:
+	std::shared_ptr<RecordingContext> m_Context;
+};
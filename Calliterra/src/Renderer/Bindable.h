@@ -3,6 +3,36 @@
 
 class Drawable;
 
+// The pipeline slot a bindable sets, Renderer::Bind skips bindables that are already bound to theirs
+namespace BindSlot
+{
+	inline constexpr uint32_t None = ~0u;
+
+	inline constexpr uint32_t VertexBuffer = 0; // Includes the input layout
+	inline constexpr uint32_t IndexBuffer = 1;
+	inline constexpr uint32_t Blender = 2;
+	inline constexpr uint32_t DepthStencilMask = 3;
+	inline constexpr uint32_t Rasterizer = 4;
+	inline constexpr uint32_t Topology = 5;
+
+	inline constexpr uint32_t NumShaderStages = 7; // Shader::ShaderType
+	inline constexpr uint32_t MaxConstantBuffers = 14;
+	inline constexpr uint32_t MaxTextures = 16;
+	inline constexpr uint32_t MaxSamplers = 16;
+
+	inline constexpr uint32_t FirstShader = 6;
+	inline constexpr uint32_t FirstConstantBuffer = FirstShader + NumShaderStages;
+	inline constexpr uint32_t FirstTexture = FirstConstantBuffer + NumShaderStages * MaxConstantBuffers;
+	inline constexpr uint32_t FirstSampler = FirstTexture + MaxTextures;
+	inline constexpr uint32_t Count = FirstSampler + MaxSamplers;
+
+	constexpr uint32_t ForShader(uint32_t shaderType) { return FirstShader + shaderType; }
+	constexpr uint32_t ForConstantBuffer(uint32_t shaderType, uint32_t slot) { return FirstConstantBuffer + shaderType * MaxConstantBuffers + slot; }
+	// Pixel shader resource and sampler slots
+	constexpr uint32_t ForTexture(uint32_t slot) { return FirstTexture + slot; }
+	constexpr uint32_t ForSampler(uint32_t slot) { return FirstSampler + slot; }
+}
+
 class Bindable
 {
 public:
@@ -10,4 +40,11 @@ public:
 
 	virtual void Bind() const = 0;
 	virtual void InitializeParentReference(const Drawable&) {}
+
+	// Bindables without a slot are always bound
+	virtual uint32_t GetBindSlot() const { return BindSlot::None; }
+	// Binding does more than set the slot (e.g. uploads the drawable's transforms), so it can't be skipped
+	virtual bool HasBindSideEffects() const { return false; }
+	// Bound right after this one whether or not this one was skipped (e.g. a texture's sampler)
+	virtual const Bindable* GetAttachedBindable() const { return nullptr; }
 };
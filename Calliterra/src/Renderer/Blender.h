@@ -31,6 +31,7 @@ public:
 	};
 
 	virtual ~Blender() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::Blender; }
 
 	static const std::string GenerateUID(bool enableBlending, BlendFunc srcBlend, BlendFunc destBlend, BlendOp blendOp);
 	static std::shared_ptr<Blender> Resolve(bool enableBlending, BlendFunc srcBlend, BlendFunc destBlend, BlendOp blendOp);
@@ -7,7 +7,8 @@ enum class ShaderDataType
 	Float, Float2, Float3, Float4,
 	Mat3, Mat4,
 	Int, Int2, Int3, Int4,
-	Bool
+	Bool,
+	Half2, Short2Norm, UShort4Norm
 };
 
 static size_t ShaderDataTypeSize(ShaderDataType type)
@@ -25,6 +26,10 @@ static size_t ShaderDataTypeSize(ShaderDataType type)
 	case ShaderDataType::Int3: return 4 * 3;
 	case ShaderDataType::Int4: return 4 * 4;
 	case ShaderDataType::Bool: return 1;
+	case ShaderDataType::Half2: return 2 * 2;
+	case ShaderDataType::Short2Norm: return 2 * 2;
+	case ShaderDataType::UShort4Norm: return 2 * 4;
+	case ShaderDataType::None: break;
 	}
 
 	ASSERT(false, "Invalid ShaderDataType");
@@ -61,6 +66,10 @@ struct BufferElement
 		case ShaderDataType::Int3:		return 3;
 		case ShaderDataType::Int4:		return 4;
 		case ShaderDataType::Bool:		return 1;
+		case ShaderDataType::Half2:		return 2;
+		case ShaderDataType::Short2Norm:	return 2;
+		case ShaderDataType::UShort4Norm:	return 4;
+		case ShaderDataType::None:		break;
 		}
 
 		ASSERT(false, "Invalid ShaderDataType");
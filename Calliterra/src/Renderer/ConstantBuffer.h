@@ -8,17 +8,15 @@ public:
 	virtual ~ConstantBuffer() = default;
 
 	template <typename...IgnoreParams>
-	static const std::string GenerateUID(const std::string& tag, Shader::ShaderType shaderType, IgnoreParams&&...ignore)
+	static const std::string GenerateUID(const std::string& tag, Shader::ShaderType shaderType, IgnoreParams&&...)
 	{
 		using namespace std::string_literals;
 		return typeid(ConstantBuffer).name() + "#"s + tag + "#"s + std::to_string(shaderType);
 	}
 
+	// Defined at the end of Renderer.h
 	template<typename Type>
-	static std::shared_ptr<ConstantBuffer> Resolve(Shader::ShaderType shaderType, const Type& constants, uint32_t slot = 0, const std::string& tag = typeid(Type).name())
-	{
-		return Renderer::GetResourceLibrary().Resolve<ConstantBuffer>(tag, shaderType, constants, slot);
-	}
+	static std::shared_ptr<ConstantBuffer> Resolve(Shader::ShaderType shaderType, const Type& constants, uint32_t slot = 0, const std::string& tag = typeid(Type).name());
 
 };
 
@@ -39,6 +37,9 @@ public:
 	virtual Transforms GetTransforms() const;
 	void Bind() const override;
 
+	uint32_t GetBindSlot() const override { return BindSlot::ForConstantBuffer(Shader::VERTEX_SHADER, 0); }
+	bool HasBindSideEffects() const override { return true; }
+
 protected:
 	inline static std::shared_ptr<ConstantBuffer> s_ConstantBuffer = nullptr;
 	const Drawable* m_Parent = nullptr;
@@ -52,6 +53,9 @@ public:
 	virtual DX::XMMATRIX GetTransform() const;
 	void Bind() const override;
 
+	uint32_t GetBindSlot() const override { return BindSlot::ForConstantBuffer(Shader::VERTEX_SHADER, 0); }
+	bool HasBindSideEffects() const override { return true; }
+
 protected:
 	inline static std::shared_ptr<ConstantBuffer> s_ConstantBuffer = nullptr;
 	const Drawable* m_Parent = nullptr;
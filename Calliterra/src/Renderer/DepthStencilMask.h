@@ -15,6 +15,7 @@ public:
 	};
 
 	virtual ~DepthStencilMask() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::DepthStencilMask; }
 
 	static const std::string GenerateUID(Mode mode);
 	static std::shared_ptr<DepthStencilMask> Resolve(Mode mode);
@@ -6,7 +6,13 @@ class Drawable
 {
 public:
 	Drawable() = default;
-	virtual ~Drawable() = default;
+	virtual ~Drawable()
+	{
+		if (IsRetained() && Renderer::HasRenderQueue())
+		{
+			Release();
+		}
+	}
 
 	Drawable(const DX::XMMATRIX& transform, DX::XMFLOAT3 color)
 		: m_Transform(transform), m_Color(color)
@@ -23,12 +29,53 @@ public:
 
 	void AddTechnique(Technique technique)
 	{
+		ASSERT(!IsRetained(), "The steps of a retained drawable can't be changed");
 		technique.InitializeParentReferences(*this);
 		m_Techniques.push_back(std::move(technique));
 	}
 
+	// The steps of all techniques stay in the render queue until Release instead of being submitted every
+	// frame, SubmitTechniques does nothing in the meantime. Only for drawables whose steps are always drawn
+	// in full whatever the view, e.g. not meshes (LODs, culling) or blended steps (drawn back to front).
+	void Retain()
+	{
+		ASSERT(!IsRetained(), "Drawable is already retained");
+		for (const auto& technique : m_Techniques)
+		{
+			technique.Retain(m_RetainedSteps);
+		}
+		m_Retained = true;
+	}
+
+	void Release()
+	{
+		ASSERT(IsRetained(), "Drawable isn't retained");
+		for (const auto& handle : m_RetainedSteps)
+		{
+			Renderer::GetRenderQueue().ReleaseRetained(handle);
+		}
+		m_RetainedSteps.clear();
+		m_Retained = false;
+	}
+
+	// Has to be called after a material of one of the steps changed, transform changes don't need it
+	void MarkRetainedDirty()
+	{
+		for (const auto& handle : m_RetainedSteps)
+		{
+			Renderer::GetRenderQueue().UpdateRetained(handle);
+		}
+	}
+
+	bool IsRetained() const { return m_Retained; }
+
 	void SubmitTechniques() const
 	{
+		if (m_Retained)
+		{
+			return;
+		}
+
 		for (const auto& technique : m_Techniques)
 		{
 			technique.Submit();
@@ -40,6 +87,7 @@ public:
 	const DX::XMMATRIX& GetProjectionTransform() const { return m_ProjectionMatrix; }
 
 	std::vector<Technique>& GetTechniques() { return m_Techniques; }
+	const std::vector<Technique>& GetTechniques() const { return m_Techniques; }
 
 protected:
 	struct FaceColorsBuffer
@@ -56,14 +104,14 @@ protected:
 	inline static constexpr FaceColorsBuffer s_ColorsBuffer =
 	{
 		{
-			{ 1.f, 1.f, 1.f },
-			{ 1.f, 0.f, 0.f },
-			{ 0.f, 1.f, 0.f },
-			{ 1.f, 1.f, 0.f },
-			{ 0.f, 0.f, 1.f },
-			{ 1.f, 0.f, 1.f },
-			{ 0.f, 1.f, 1.f },
-			{ 0.f, 0.f, 0.f }
+			{ 1.f, 1.f, 1.f, 0.f },
+			{ 1.f, 0.f, 0.f, 0.f },
+			{ 0.f, 1.f, 0.f, 0.f },
+			{ 1.f, 1.f, 0.f, 0.f },
+			{ 0.f, 0.f, 1.f, 0.f },
+			{ 1.f, 0.f, 1.f, 0.f },
+			{ 0.f, 1.f, 1.f, 0.f },
+			{ 0.f, 0.f, 0.f, 0.f }
 		}
 	};
 
@@ -75,4 +123,6 @@ protected:
 	std::shared_ptr<TransformConstantBuffer> m_TransformConstantBuffer;
 private:
 	std::vector<Technique> m_Techniques;
+	std::vector<RetainedStepHandle> m_RetainedSteps;
+	bool m_Retained = false;
 };
@@ -2,18 +2,29 @@
 #include "GraphicsContext.h"
 
 #include "Renderer/Renderer.h"
-#include "Platform/DX11/DX11Context.h"
+#include "Platform/Recording/RecordingContext.h"
+#ifdef _WIN32
+	#include "Platform/DX11/DX11Context.h"
+#endif
 #include "Renderer/RenderQueue/RenderQueue.h"
 
-std::shared_ptr<GraphicsContext> GraphicsContext::Create(void* window, WindowProps& windowProps)
+std::shared_ptr<GraphicsContext> GraphicsContext::Create([[maybe_unused]] void* window, [[maybe_unused]] WindowProps& windowProps)
 {
 	switch (Renderer::GetAPI())
 	{
 	case RendererAPI::API::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::API::DX11:
 		return std::make_shared<DX11Context>(static_cast<HWND*>(window), windowProps);
+#else
+	case RendererAPI::API::DX11:
+		break;
+#endif
+	case RendererAPI::API::Recording:
+		ASSERT(false, "The Recording API doesn't use a window, create its context with CreateHeadless");
+		return nullptr;
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -21,6 +32,14 @@ std::shared_ptr<GraphicsContext> GraphicsContext::Create(void* window, WindowPro
 
 }
 
+std::shared_ptr<GraphicsContext> GraphicsContext::CreateHeadless(uint32_t width, uint32_t height)
+{
+	ASSERT(Renderer::GetAPI() == RendererAPI::API::Recording, "Only the Recording API can run without a window");
+	std::shared_ptr<GraphicsContext> context = std::make_shared<RecordingContext>(width, height);
+	context->Init();
+	return context;
+}
+
 void GraphicsContext::FreeRenderQueueBuffers()
 {
 	m_RenderQueue->FreeBuffers();
@@ -24,6 +24,8 @@ public:
 	virtual void ToggleFullscreen() = 0;
 
 	static std::shared_ptr<GraphicsContext> Create(void* window, WindowProps& windowProps);
+	// A context without a window for the Recording API, for benchmarks and tests
+	static std::shared_ptr<GraphicsContext> CreateHeadless(uint32_t width, uint32_t height);
 
 protected:
 	void FreeRenderQueueBuffers();
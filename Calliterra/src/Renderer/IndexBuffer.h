@@ -5,9 +5,10 @@ class IndexBuffer : public Bindable
 {
 public:
 	virtual ~IndexBuffer() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::IndexBuffer; }
 
 	template <typename...IgnoreParams>
-	static const std::string GenerateUID(const std::string& tag, IgnoreParams&&...ignore)
+	static const std::string GenerateUID(const std::string& tag, IgnoreParams&&...)
 	{
 		using namespace std::string_literals;
 		return typeid(IndexBuffer).name() + "#"s + tag;
@@ -18,6 +18,7 @@ class Rasterizer : public Bindable
 {
 public:
 	virtual ~Rasterizer() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::Rasterizer; }
 
 	static const std::string GenerateUID(FillMode fillMode, CullMode cullMode);
 	static std::shared_ptr<Rasterizer> Resolve(FillMode fillMode, CullMode cullMode);
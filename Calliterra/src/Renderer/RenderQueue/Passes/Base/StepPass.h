@@ -1,31 +1,191 @@
 #pragma once
 #include "RenderPass.h"
 #include "Renderer/RenderQueue/Step.h"
+#include "Renderer/RenderQueue/SortKey.h"
 
+// Steps are executed in the order of their sort keys (see SortKey), steps with the same key in the order
+// they were accepted. When consecutive steps share a material only the first of them binds it.
+//
+// Steps are either submitted every frame (Accept) or retained (Retain), which keeps them in the pass until
+// they're released. The retained steps are kept sorted, only the ones that were added, updated or released
+// since the last Execute are sorted and merged back in, so a frame where nothing changed costs nothing but
+// the draws.
 class StepPass : public RenderPass
 {
 public:
 	StepPass() = default;
 
-	virtual void Accept(const Step& step)
+	// drawRanges has to stay valid until Reset, the RenderQueue keeps them in its frame arena
+	virtual void Accept(const Step& step, std::span<const DrawRange> drawRanges = {}, float viewDepth = 0.f)
 	{
-		m_Steps.push_back(step);
+		m_SortEntries.push_back({ step.GetSortKey(viewDepth), static_cast<uint32_t>(m_Commands.size()) });
+		m_Commands.push_back({ &step, drawRanges });
 	}
 
+	// Retained steps are drawn in full and sorted without a view depth, the returned index stays valid
+	// until the step is released. That leaves them unsorted by depth, so they have to be opaque.
+	uint32_t Retain(const Step& step)
+	{
+		ASSERT(!step.HasBlending(), "Blended steps have to be submitted every frame to be drawn back to front");
+
+		uint32_t index = static_cast<uint32_t>(m_Retained.size());
+		if (!m_FreeRetained.empty())
+		{
+			index = m_FreeRetained.back();
+			m_FreeRetained.pop_back();
+			m_Retained[index] = {};
+		}
+		else
+		{
+			m_Retained.emplace_back();
+		}
+
+		m_Retained[index].RetainedStep = &step;
+		MarkDirty(index);
+		return index;
+	}
+
+	// The step's sort key is worked out again, e.g. after its material changed
+	void UpdateRetained(uint32_t index)
+	{
+		ASSERT(index < m_Retained.size() && m_Retained[index].RetainedStep, "Invalid retained step");
+		MarkDirty(index);
+	}
+
+	void ReleaseRetained(uint32_t index)
+	{
+		ASSERT(index < m_Retained.size() && m_Retained[index].RetainedStep, "Invalid retained step");
+		m_Retained[index].RetainedStep = nullptr;
+		MarkDirty(index);
+	}
+
+	size_t GetNumRetained() const { return m_RetainedOrder.size(); }
+
 	void Execute() const override
 	{
-		for (auto& step : m_Steps)
+		SortKey::RadixSort(m_SortEntries, m_SortScratch);
+		if (!m_DirtyRetained.empty())
 		{
-			step.Execute();
+			MergeRetained();
+		}
+
+		// Both lists are sorted, so they're drawn by merging them. Material 0 has no bindables, so it never
+		// needs binding.
+		uint32_t boundMaterial = 0;
+		size_t submitted = 0;
+		size_t retained = 0;
+		while (submitted < m_SortEntries.size() || retained < m_RetainedOrder.size())
+		{
+			const bool takeRetained = retained < m_RetainedOrder.size() &&
+				(submitted == m_SortEntries.size() || m_RetainedOrder[retained].Key <= m_SortEntries[submitted].Key);
+
+			const Step* step = nullptr;
+			std::span<const DrawRange> drawRanges;
+			if (takeRetained)
+			{
+				step = m_Retained[m_RetainedOrder[retained++].Index].RetainedStep;
+			}
+			else
+			{
+				const StepCommand& command = m_Commands[m_SortEntries[submitted++].Index];
+				step = command.SubmittedStep;
+				drawRanges = command.DrawRanges;
+			}
+
+			step->Execute(drawRanges, step->GetMaterialId() != boundMaterial);
+			boundMaterial = step->GetMaterialId();
 		}
 	}
 
+	// Clearing keeps the capacity, so a frame only allocates when it submits more than any frame before it.
+	// Retained steps stay.
 	void Reset() override
 	{
-		m_Steps.clear();
+		m_Commands.clear();
+		m_SortEntries.clear();
 	}
 
 private:
-	std::vector<Step> m_Steps;
-};
+	void MarkDirty(uint32_t index)
+	{
+		if (!m_Retained[index].Dirty)
+		{
+			m_Retained[index].Dirty = true;
+			m_DirtyRetained.push_back(index);
+		}
+	}
+
+	// Drops the dirty steps from the sorted order and merges the ones that are still retained back in with
+	// their new keys. Released indices can only be reused after this, until then the order still has them.
+	void MergeRetained() const
+	{
+		m_RetainedChanges.clear();
+		for (const uint32_t index : m_DirtyRetained)
+		{
+			RetainedEntry& entry = m_Retained[index];
+			if (entry.RetainedStep)
+			{
+				entry.Key = entry.RetainedStep->GetSortKey(0.f);
+				m_RetainedChanges.push_back({ entry.Key, index });
+			}
+		}
+		SortKey::RadixSort(m_RetainedChanges, m_SortScratch);
+
+		m_RetainedScratch.clear();
+		size_t change = 0;
+		for (const auto& entry : m_RetainedOrder)
+		{
+			if (m_Retained[entry.Index].Dirty)
+			{
+				continue;
+			}
+			while (change < m_RetainedChanges.size() && m_RetainedChanges[change].Key < entry.Key)
+			{
+				m_RetainedScratch.push_back(m_RetainedChanges[change++]);
+			}
+			m_RetainedScratch.push_back(entry);
+		}
+		m_RetainedScratch.insert(m_RetainedScratch.end(), m_RetainedChanges.begin() + change, m_RetainedChanges.end());
+		m_RetainedOrder.swap(m_RetainedScratch);
+
+		for (const uint32_t index : m_DirtyRetained)
+		{
+			m_Retained[index].Dirty = false;
+			if (!m_Retained[index].RetainedStep)
+			{
+				m_FreeRetained.push_back(index);
+			}
+		}
+		m_DirtyRetained.clear();
+	}
+
+private:
+	// What's submitted each frame, the step itself belongs to its technique
+	struct StepCommand
+	{
+		const Step* SubmittedStep;
+		std::span<const DrawRange> DrawRanges;
+	};
 
+	struct RetainedEntry
+	{
+		const Step* RetainedStep = nullptr; // nullptr once released
+		uint64_t Key = 0;
+		bool Dirty = false;
+	};
+
+private:
+	std::vector<StepCommand> m_Commands;
+	// Sorted in Execute, which is const for every other pass
+	mutable std::vector<SortKey::Entry> m_SortEntries;
+	mutable std::vector<SortKey::Entry> m_SortScratch;
+
+	// Indexed by the index Retain returned
+	mutable std::vector<RetainedEntry> m_Retained;
+	mutable std::vector<uint32_t> m_FreeRetained;
+	// Retained steps that were added, updated or released since the last Execute
+	mutable std::vector<uint32_t> m_DirtyRetained;
+	mutable std::vector<SortKey::Entry> m_RetainedOrder;
+	mutable std::vector<SortKey::Entry> m_RetainedChanges;
+	mutable std::vector<SortKey::Entry> m_RetainedScratch;
+};
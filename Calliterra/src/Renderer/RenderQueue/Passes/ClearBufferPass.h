@@ -5,16 +5,19 @@
 class ClearBufferPass : public RenderPass
 {
 public:
-	ClearBufferPass(std::shared_ptr<BufferResource> buffer)
-		: m_Buffer(buffer)
-	{
-	}
+	ClearBufferPass() = default;
 
 	void Execute() const override
 	{
 		m_Buffer->Clear();
 	}
 
+	// The buffer is recreated when the window is resized, see RenderQueue::InitPasses
+	void SetBuffer(std::shared_ptr<BufferResource> buffer)
+	{
+		m_Buffer = std::move(buffer);
+	}
+
 private:
 	std::shared_ptr<BufferResource> m_Buffer;
 };
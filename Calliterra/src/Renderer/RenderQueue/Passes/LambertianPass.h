@@ -4,25 +4,50 @@
 class LambertianPass : public StepPass
 {
 public:
-	LambertianPass(std::shared_ptr<RenderTarget> renderTarget, std::shared_ptr<DepthStencilBuffer> depthStencil, FillMode fillMode, CullMode cullMode)
-		: m_RenderTarget(renderTarget), m_DepthStencilBuffer(depthStencil), m_FillMode(fillMode), m_CullMode(cullMode)
+	LambertianPass(FillMode fillMode, CullMode cullMode)
+		: m_FillMode(fillMode), m_CullMode(cullMode),
+		  m_DepthStencilMask(DepthStencilMask::Resolve(DepthStencilMask::Mode::Off)),
+		  m_Topology(Topology::Resolve(PrimitiveTopology::Triangles)),
+		  m_Rasterizer(Rasterizer::Resolve(fillMode, cullMode))
 	{
 	}
 
 	void Execute() const override
 	{
 		m_RenderTarget->BindAsBuffer(m_DepthStencilBuffer.get());
-		DepthStencilMask::Resolve(DepthStencilMask::Mode::Off)->Bind();
-		Topology::Resolve(PrimitiveTopology::Triangles)->Bind();
-		Rasterizer::Resolve(m_FillMode, m_CullMode)->Bind();
+		m_DepthStencilMask->Bind();
+		m_Topology->Bind();
+		m_Rasterizer->Bind();
 		StepPass::Execute();
 	}
 
-	void SetFillMode(FillMode fillMode) { m_FillMode = fillMode; }
-	void SetCullMode(CullMode cullMode) { m_CullMode = cullMode; }
+	// The targets are recreated when the window is resized, see RenderQueue::InitPasses
+	void SetTargets(std::shared_ptr<RenderTarget> renderTarget, std::shared_ptr<DepthStencilBuffer> depthStencil)
+	{
+		m_RenderTarget = std::move(renderTarget);
+		m_DepthStencilBuffer = std::move(depthStencil);
+	}
+
+	void SetFillMode(FillMode fillMode)
+	{
+		m_FillMode = fillMode;
+		m_Rasterizer = Rasterizer::Resolve(m_FillMode, m_CullMode);
+	}
+
+	void SetCullMode(CullMode cullMode)
+	{
+		m_CullMode = cullMode;
+		m_Rasterizer = Rasterizer::Resolve(m_FillMode, m_CullMode);
+	}
+
 private:
 	std::shared_ptr<RenderTarget> m_RenderTarget;
 	std::shared_ptr<DepthStencilBuffer> m_DepthStencilBuffer;
 	FillMode m_FillMode;
 	CullMode m_CullMode;
+
+	// Resolved up front, resolving builds the UID strings
+	std::shared_ptr<DepthStencilMask> m_DepthStencilMask;
+	std::shared_ptr<Topology> m_Topology;
+	std::shared_ptr<Rasterizer> m_Rasterizer;
 };
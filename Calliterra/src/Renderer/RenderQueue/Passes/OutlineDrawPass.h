@@ -4,12 +4,20 @@
 class OutlineDrawPass : public StepPass
 {
 public:
-	OutlineDrawPass() = default;
+	OutlineDrawPass()
+		: m_DepthStencilMask(DepthStencilMask::Resolve(DepthStencilMask::Mode::Mask)),
+		  m_Rasterizer(Rasterizer::Resolve(FillMode::Solid, CullMode::Back))
+	{
+	}
 
 	void Execute() const override
 	{
-		DepthStencilMask::Resolve(DepthStencilMask::Mode::Mask)->Bind();
-		Rasterizer::Resolve(FillMode::Solid, CullMode::Back)->Bind();
+		m_DepthStencilMask->Bind();
+		m_Rasterizer->Bind();
 		StepPass::Execute();
 	}
+
+private:
+	std::shared_ptr<DepthStencilMask> m_DepthStencilMask;
+	std::shared_ptr<Rasterizer> m_Rasterizer;
 };
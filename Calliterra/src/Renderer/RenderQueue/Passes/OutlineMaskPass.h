@@ -4,13 +4,21 @@
 class OutlineMaskPass : public StepPass
 {
 public:
-	OutlineMaskPass() = default;
+	OutlineMaskPass()
+		: m_DepthStencilMask(DepthStencilMask::Resolve(DepthStencilMask::Mode::Write)),
+		  m_PixelShader(Shader::Resolve("", Shader::PIXEL_SHADER))
+	{
+	}
 
 	void Execute() const override
 	{
-		DepthStencilMask::Resolve(DepthStencilMask::Mode::Write)->Bind();
-		Shader::Resolve("", Shader::PIXEL_SHADER)->Bind();
+		m_DepthStencilMask->Bind();
+		m_PixelShader->Bind();
 		
 		StepPass::Execute();
 	}
+
+private:
+	std::shared_ptr<DepthStencilMask> m_DepthStencilMask;
+	std::shared_ptr<Shader> m_PixelShader;
 };
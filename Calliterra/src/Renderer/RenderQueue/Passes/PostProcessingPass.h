@@ -4,8 +4,10 @@
 class PostProcessingPass : public FullScreenPass
 {
 public:
-	PostProcessingPass(const GraphicsContext& context, std::shared_ptr<RenderTarget> backBuffer, std::shared_ptr<RenderTarget> renderTarget)
-		: m_Context(context), m_BackBuffer(backBuffer), m_RenderTarget(renderTarget)
+	PostProcessingPass(const GraphicsContext& context)
+		: m_Context(context),
+		  m_PixelShader(Shader::Resolve("assets/shaders/DefaultFullScreenPS.hlsl", Shader::PIXEL_SHADER)),
+		  m_Rasterizer(Rasterizer::Resolve(FillMode::Solid, CullMode::Back))
 	{
 		
 	}
@@ -14,13 +16,22 @@ public:
 	{
 		m_BackBuffer->BindAsBuffer();
 		m_RenderTarget->Bind();
-		Shader::Resolve("assets/shaders/DefaultFullScreenPS.hlsl", Shader::PIXEL_SHADER)->Bind();
-		Rasterizer::Resolve(FillMode::Solid, CullMode::Back)->Bind();
+		m_PixelShader->Bind();
+		m_Rasterizer->Bind();
 		FullScreenPass::Execute();
 	}
 
+	// The targets are recreated when the window is resized, see RenderQueue::InitPasses
+	void SetTargets(std::shared_ptr<RenderTarget> backBuffer, std::shared_ptr<RenderTarget> renderTarget)
+	{
+		m_BackBuffer = std::move(backBuffer);
+		m_RenderTarget = std::move(renderTarget);
+	}
+
 private:
 	const GraphicsContext& m_Context;
 	std::shared_ptr<RenderTarget> m_BackBuffer;
 	std::shared_ptr<RenderTarget> m_RenderTarget;
+	std::shared_ptr<Shader> m_PixelShader;
+	std::shared_ptr<Rasterizer> m_Rasterizer;
 };
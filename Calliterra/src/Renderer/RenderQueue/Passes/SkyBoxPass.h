@@ -5,11 +5,17 @@
 class SkyBoxPass : public StepPass
 {
 public:
-	SkyBoxPass() = default;
+	SkyBoxPass()
+		: m_DepthStencilMask(DepthStencilMask::Resolve(DepthStencilMask::Mode::DepthFirst))
+	{
+	}
 
 	void Execute() const override
 	{
-		DepthStencilMask::Resolve(DepthStencilMask::Mode::DepthFirst)->Bind();
+		m_DepthStencilMask->Bind();
 		StepPass::Execute();
 	}
+
+private:
+	std::shared_ptr<DepthStencilMask> m_DepthStencilMask;
 };
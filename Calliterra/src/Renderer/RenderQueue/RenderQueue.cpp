@@ -14,6 +14,13 @@
 RenderQueue::RenderQueue(GraphicsContext& context)
 	: m_Context(context), m_BackBuffer(context.GetBackBufferTarget())
 {
+	m_Passes[(int)PassName::ClearRenderTarget] = std::make_unique<ClearBufferPass>();
+	m_Passes[(int)PassName::ClearDepthStencilBuffer] = std::make_unique<ClearBufferPass>();
+	m_Passes[(int)PassName::Lambertian] = std::make_unique<LambertianPass>(m_FillMode, m_CullMode);
+	m_Passes[(int)PassName::SkyBox] = std::make_unique<SkyBoxPass>();
+	m_Passes[(int)PassName::OutlineMask] = std::make_unique<OutlineMaskPass>();
+	m_Passes[(int)PassName::OutlineDraw] = std::make_unique<OutlineDrawPass>();
+	m_Passes[(int)PassName::PostProcessing] = std::make_unique<PostProcessingPass>(m_Context);
 	InitPasses();
 
 	std::vector<SettingsType> settings = { SettingsType::IsWireFrame, SettingsType::CullMode };
@@ -21,8 +28,10 @@ RenderQueue::RenderQueue(GraphicsContext& context)
 
 }
 
-void RenderQueue::Accept(const Step& step, PassName targetPass)
+void RenderQueue::Accept(const Step& step, PassName targetPass, std::span<const DrawRange> drawRanges, float viewDepth)
 {
+	const std::span<const DrawRange> frameDrawRanges = m_FrameArena.Copy(drawRanges);
+
 	// Only passes that inherit from StepPass should be allowed to accept a step
 	switch (targetPass)
 	{
@@ -30,28 +39,28 @@ void RenderQueue::Accept(const Step& step, PassName targetPass)
 	{
 		auto p = dynamic_cast<LambertianPass*>(m_Passes[(int)targetPass].get());
 		ASSERT(p, "Cannot add Steps to this pass type");
-		p->Accept(step);
+		p->Accept(step, frameDrawRanges, viewDepth);
 		break;
 	}
 	case PassName::SkyBox:
 	{
 		auto p = dynamic_cast<SkyBoxPass*>(m_Passes[(int)targetPass].get());
 		ASSERT(p, "Cannot add Steps to this pass type");
-		p->Accept(step);
+		p->Accept(step, frameDrawRanges, viewDepth);
 		break;
 	}
 	case PassName::OutlineMask:
 	{
 		auto p = dynamic_cast<OutlineMaskPass*>(m_Passes[(int)targetPass].get());
 		ASSERT(p, "Cannot add Steps to this pass type");
-		p->Accept(step);
+		p->Accept(step, frameDrawRanges, viewDepth);
 		break;
 	}
 	case PassName::OutlineDraw:
 	{
 		auto p = dynamic_cast<OutlineDrawPass*>(m_Passes[(int)targetPass].get());
 		ASSERT(p, "Cannot add Steps to this pass type");
-		p->Accept(step);
+		p->Accept(step, frameDrawRanges, viewDepth);
 		break;
 	}
 	default:
@@ -60,10 +69,42 @@ void RenderQueue::Accept(const Step& step, PassName targetPass)
 
 }
 
+RetainedStepHandle RenderQueue::Retain(const Step& step, PassName targetPass)
+{
+	// Their order depends on the view, see SortKey
+	ASSERT(!step.HasBlending(), "Blended steps have to be submitted every frame to be drawn back to front");
+	return { targetPass, GetStepPass(targetPass).Retain(step) };
+}
+
+void RenderQueue::UpdateRetained(const RetainedStepHandle& handle)
+{
+	GetStepPass(handle.Pass).UpdateRetained(handle.Index);
+}
+
+void RenderQueue::ReleaseRetained(const RetainedStepHandle& handle)
+{
+	GetStepPass(handle.Pass).ReleaseRetained(handle.Index);
+}
+
+size_t RenderQueue::GetNumRetained() const
+{
+	size_t numRetained = 0;
+	for (const auto& pass : m_Passes)
+	{
+		if (const auto* stepPass = dynamic_cast<const StepPass*>(pass.get()))
+		{
+			numRetained += stepPass->GetNumRetained();
+		}
+	}
+	return numRetained;
+}
+
 void RenderQueue::Execute()
 {
 	for (const auto& pass : m_Passes)
 	{
+		// Passes bind their targets and states directly
+		Renderer::InvalidateBindState();
 		pass->Execute();
 	}
 }
@@ -74,6 +115,7 @@ void RenderQueue::Reset()
 	{
 		pass->Reset();
 	}
+	m_FrameArena.Reset();
 }
 
 void RenderQueue::OnSettingsUpdate(SettingsType type)
@@ -108,7 +150,10 @@ void RenderQueue::OnSettingsUpdate(SettingsType type)
 			break;
 		}
 		dynamic_cast<LambertianPass*>(m_Passes[(int)PassName::Lambertian].get())->SetCullMode(m_CullMode);
+		break;
 	}
+	default:
+		break;
 	}
 
 }
@@ -121,22 +166,37 @@ void RenderQueue::InitPasses()
 	}
 	m_RenderTarget = Renderer::CreateRenderTarget();
 	m_MasterDepthStencilBuffer = Renderer::CreateDepthStencilBuffer(0, 0, false);
+	SetPassTargets();
+}
 
-	m_Passes[(int)PassName::ClearRenderTarget] = std::make_unique<ClearBufferPass>(m_RenderTarget);
-	m_Passes[(int)PassName::ClearDepthStencilBuffer] = std::make_unique<ClearBufferPass>(m_MasterDepthStencilBuffer);
-	m_Passes[(int)PassName::Lambertian] = std::make_unique<LambertianPass>(m_RenderTarget, m_MasterDepthStencilBuffer, m_FillMode, m_CullMode);
-	m_Passes[(int)PassName::SkyBox] = std::make_unique<SkyBoxPass>();
-	m_Passes[(int)PassName::OutlineMask] = std::make_unique<OutlineMaskPass>();
-	m_Passes[(int)PassName::OutlineDraw] = std::make_unique<OutlineDrawPass>();
-	m_Passes[(int)PassName::PostProcessing] = std::make_unique<PostProcessingPass>(m_Context, m_BackBuffer, m_RenderTarget);
+void RenderQueue::SetPassTargets()
+{
+	GetPass<ClearBufferPass>(PassName::ClearRenderTarget).SetBuffer(m_RenderTarget);
+	GetPass<ClearBufferPass>(PassName::ClearDepthStencilBuffer).SetBuffer(m_MasterDepthStencilBuffer);
+	GetPass<LambertianPass>(PassName::Lambertian).SetTargets(m_RenderTarget, m_MasterDepthStencilBuffer);
+	GetPass<PostProcessingPass>(PassName::PostProcessing).SetTargets(m_BackBuffer, m_RenderTarget);
 }
 
+template<typename Type>
+Type& RenderQueue::GetPass(PassName pass) const
+{
+	ASSERT(pass > PassName::None && pass < PassName::NumPasses, "Invalid pass");
+	auto p = dynamic_cast<Type*>(m_Passes[(int)pass].get());
+	ASSERT(p, "Pass has a different type");
+	return *p;
+}
+
+StepPass& RenderQueue::GetStepPass(PassName pass) const
+{
+	return GetPass<StepPass>(pass);
+}
+
+// Every reference to the back buffer has to be gone before the swap chain can be resized
 void RenderQueue::FreeBuffers()
 {
 	m_BackBuffer.reset();
-	for (auto& pass : m_Passes)
-	{
-		pass.reset();
-	}
+	m_RenderTarget.reset();
+	m_MasterDepthStencilBuffer.reset();
+	SetPassTargets();
 }
 
@@ -4,6 +4,9 @@
 #include "Renderer/DepthStencilBuffer.h"
 #include "Core/GlobalSettings.h"
 #include "Renderer/Rasterizer.h"
+#include "Core/FrameArena.h"
+
+class StepPass;
 
 class RenderQueue : public SettingsSubscriber
 {
@@ -11,20 +14,35 @@ class RenderQueue : public SettingsSubscriber
 public:
 	RenderQueue(GraphicsContext&);
 
-	void Accept(const Step& step, PassName targetPass);
+	// The step is referenced and the draw ranges are copied, see Step::Submit
+	void Accept(const Step& step, PassName targetPass, std::span<const DrawRange> drawRanges = {}, float viewDepth = 0.f);
+	// Retained steps stay in their pass across Reset and are drawn every frame until they're released. The
+	// step is referenced, so it can't be destroyed or moved before that. UpdateRetained has to be called
+	// when something the step is sorted by changes (its material), transforms are read when it's drawn.
+	RetainedStepHandle Retain(const Step& step, PassName targetPass);
+	void UpdateRetained(const RetainedStepHandle& handle);
+	void ReleaseRetained(const RetainedStepHandle& handle);
+	size_t GetNumRetained() const;
 	void Execute();
 	void Reset();
 
 	void OnSettingsUpdate(SettingsType type);
 private:
+	// Only the targets are recreated on a resize, the passes stay and so do the steps retained in them
 	void InitPasses();
 	void FreeBuffers();
+	void SetPassTargets();
+	template<typename Type>
+	Type& GetPass(PassName pass) const;
+	StepPass& GetStepPass(PassName pass) const;
 private:
 	std::array<std::unique_ptr<RenderPass>, (int)PassName::NumPasses> m_Passes;
 	GraphicsContext& m_Context;
 	std::shared_ptr<RenderTarget> m_BackBuffer;
 	std::shared_ptr<DepthStencilBuffer> m_MasterDepthStencilBuffer;
 	std::shared_ptr<RenderTarget> m_RenderTarget;
+	// Holds the draw ranges of the steps until Reset
+	FrameArena m_FrameArena;
 
 	FillMode m_FillMode = FillMode::Solid;
 	CullMode m_CullMode = CullMode::Back;
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <bit>
+
+enum class PassName;
+
+// Orders the steps of a pass. From the most significant bit:
+//   opaque:      pass (4) | 0 | shader (12) | material (20) | depth (24)     | unused (3)
+//   transparent: pass (4) | 1 | ~depth (24) | shader (12)   | material (20)  | unused (3)
+// Opaque steps are grouped by state first and drawn front to back within a group, transparent ones are
+// drawn after them back to front, which is all that blending needs to be correct.
+class SortKey
+{
+public:
+	struct Entry
+	{
+		uint64_t Key;
+		uint32_t Index; // Into the pass' steps
+	};
+
+public:
+	static uint64_t Make(PassName pass, bool blending, uint32_t shaderId, uint32_t materialId, float viewDepth)
+	{
+		const uint64_t passBits = static_cast<uint64_t>(static_cast<int>(pass) & 0xF) << 60;
+		const uint64_t shader = shaderId & 0xFFF;
+		const uint64_t material = materialId & 0xFFFFF;
+		const uint64_t depth = QuantizeDepth(viewDepth);
+
+		if (!blending)
+		{
+			return passBits | (shader << 47) | (material << 27) | (depth << 3);
+		}
+		return passBits | (1ull << 59) | ((~depth & 0xFFFFFF) << 35) | (shader << 23) | (material << 3);
+	}
+
+	// The bits of a non negative float sort the same way as its value, the top 24 of them keep the
+	// exponent and 16 bits of mantissa, so the precision follows the depth without knowing the far plane
+	static uint32_t QuantizeDepth(float viewDepth)
+	{
+		const float depth = viewDepth > 0.f ? viewDepth : 0.f;
+		return std::bit_cast<uint32_t>(depth) >> 7;
+	}
+
+	// Stable LSD radix sort on the keys, a byte at a time. Bytes that are the same for every key (the pass,
+	// and usually the top of the shader bits) are skipped. scratch is only kept so it doesn't have to be
+	// reallocated every frame.
+	static void RadixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch)
+	{
+		if (entries.size() < 2)
+		{
+			return;
+		}
+
+		scratch.resize(entries.size());
+		for (uint32_t shift = 0; shift < 64; shift += 8)
+		{
+			std::array<size_t, 256> offsets = {};
+			for (const auto& entry : entries)
+			{
+				offsets[(entry.Key >> shift) & 0xFF]++;
+			}
+			if (offsets[(entries[0].Key >> shift) & 0xFF] == entries.size())
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (auto& count : offsets)
+			{
+				const size_t bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for (const auto& entry : entries)
+			{
+				scratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+			}
+			entries.swap(scratch);
+		}
+	}
+};
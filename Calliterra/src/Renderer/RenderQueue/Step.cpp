@@ -3,6 +3,7 @@
 #include "Renderer/Renderer.h"
 #include "Renderer/Drawable.h"
 #include "Renderer/RenderQueue/Passes/Base/RenderPass.h"
+#include "SortKey.h"
 
 Step::Step(PassName targetPass)
 	: m_TargetPass(targetPass)
@@ -11,6 +12,7 @@ Step::Step(PassName targetPass)
 
 void Step::AddBindable(std::shared_ptr<Bindable> bindable)
 {
+	AddSortState(*bindable);
 	m_Bindables.push_back(bindable);
 }
 
@@ -22,26 +24,84 @@ void Step::AddBindable(std::shared_ptr<IndexBuffer> bindable)
 
 void Step::AddBindables(const std::vector<std::shared_ptr<Bindable>>& bindables)
 {
-	for (const auto bindable : bindables)
+	for (const auto& bindable : bindables)
 	{
+		AddSortState(*bindable);
 		m_Bindables.push_back(bindable);
 	}
 }
 
+void Step::SetSharedBindables(std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> bindables)
+{
+	for (const auto& bindable : *bindables)
+	{
+		AddSortState(*bindable);
+	}
+	m_SharedBindables = std::move(bindables);
+}
+
+void Step::SetMaterial(uint32_t materialId, std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> bindables, bool blending)
+{
+	m_MaterialId = materialId;
+	m_MaterialBindables = std::move(bindables);
+	m_Blending = blending;
+}
+
 void Step::SetIndexCount(uint32_t indexCount)
 {
 	m_IndexCount = indexCount;
 }
 
-void Step::Submit() const
+void Step::Submit(float viewDepth) const
 {
-	Renderer::GetRenderQueue().Accept(*this, m_TargetPass);
+	Renderer::GetRenderQueue().Accept(*this, m_TargetPass, {}, viewDepth);
 }
 
-void Step::Execute() const
+void Step::Submit(const std::vector<DrawRange>& drawRanges, float viewDepth) const
 {
+	Renderer::GetRenderQueue().Accept(*this, m_TargetPass, drawRanges, viewDepth);
+}
+
+RetainedStepHandle Step::Retain() const
+{
+	return Renderer::GetRenderQueue().Retain(*this, m_TargetPass);
+}
+
+uint64_t Step::GetSortKey(float viewDepth) const
+{
+	return SortKey::Make(m_TargetPass, m_Blending, m_ShaderId, m_MaterialId, viewDepth);
+}
+
+void Step::Execute(std::span<const DrawRange> drawRanges, bool bindMaterial) const
+{
+	if (m_SharedBindables)
+	{
+		Renderer::Bind(*m_SharedBindables, m_IndexCount);
+	}
+	if (m_MaterialBindables && bindMaterial)
+	{
+		Renderer::Bind(*m_MaterialBindables, m_IndexCount);
+	}
 	Renderer::Bind(m_Bindables, m_IndexCount);
-	Renderer::Draw();
+	if (drawRanges.empty())
+	{
+		Renderer::Draw();
+		return;
+	}
+
+	for (const auto& range : drawRanges)
+	{
+		Renderer::Draw(range.IndexCount, range.StartIndex);
+	}
+}
+
+// Ids only have to tell the shaders of a pass apart, so wrapping around only costs some grouping
+void Step::AddSortState(const Bindable& bindable)
+{
+	if (const auto* shader = dynamic_cast<const Shader*>(&bindable))
+	{
+		m_ShaderId = ((m_ShaderId << 6) | (shader->GetSortId() & 0x3F)) & 0xFFF;
+	}
 }
 
 void Step::InitializeParentReferences(const Drawable& parent)
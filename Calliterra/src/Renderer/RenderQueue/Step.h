@@ -1,10 +1,25 @@
 #pragma once
+#include <span>
 #include "Renderer/Bindable.h"
 #include "Renderer/IndexBuffer.h"
 
 class Drawable;
 enum class PassName;
 
+// Part of a Step's index buffer to draw
+struct DrawRange
+{
+	uint32_t StartIndex;
+	uint32_t IndexCount;
+};
+
+// Identifies a retained step within its pass, see RenderQueue::Retain
+struct RetainedStepHandle
+{
+	PassName Pass;
+	uint32_t Index;
+};
+
 class Step
 {
 public:
@@ -13,14 +28,44 @@ public:
 	void AddBindable(std::shared_ptr<Bindable> bindable);
 	void AddBindable(std::shared_ptr<IndexBuffer> bindable);
 	void AddBindables(const std::vector<std::shared_ptr<Bindable>>& bindables);
+	// Bindables that are shared with other steps (e.g. every instance of a ModelPrototype), they are bound
+	// before the step's own bindables. The index count has to be set separately.
+	void SetSharedBindables(std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> bindables);
+	// Bindables of the material the step is drawn with, bound after the shared bindables. When steps with the
+	// same materialId are drawn back to back only the first of them binds the material (see StepPass), so the
+	// rest of a step's bindables must not overwrite anything its material binds. Blended steps are sorted
+	// back to front after the opaque ones.
+	void SetMaterial(uint32_t materialId, std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> bindables, bool blending = false);
+	uint32_t GetMaterialId() const { return m_MaterialId; }
+	bool HasBlending() const { return m_Blending; }
 	void SetIndexCount(uint32_t indexCount);
-	void Submit() const ;
-	void Execute() const;
+	// viewDepth is the distance along the camera's view direction, used to order the steps within the pass.
+	// The queue only keeps a pointer to the step, it can't be changed or destroyed until the queue is reset.
+	void Submit(float viewDepth = 0.f) const;
+	// Only draws the given ranges of the index buffer instead of all of it, the queue keeps a copy of them
+	void Submit(const std::vector<DrawRange>& drawRanges, float viewDepth = 0.f) const;
+	// Keeps the step in its pass until the handle is released, instead of submitting it every frame
+	RetainedStepHandle Retain() const;
+	// See SortKey for the layout
+	uint64_t GetSortKey(float viewDepth) const;
+	// Draws all of the index buffer when drawRanges is empty. bindMaterial can only be false when the
+	// previously executed step had the same material.
+	void Execute(std::span<const DrawRange> drawRanges = {}, bool bindMaterial = true) const;
 	void InitializeParentReferences(const Drawable& parent);
 
+private:
+	void AddSortState(const Bindable& bindable);
+
 private:
 	PassName m_TargetPass;
 	std::vector<std::shared_ptr<Bindable>> m_Bindables;
+	std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> m_SharedBindables;
+	// 0 is no material
+	uint32_t m_MaterialId = 0;
+	bool m_Blending = false;
+	// Sort ids of the step's shaders, 6 bits each in the order they're added
+	uint32_t m_ShaderId = 0;
+	std::shared_ptr<const std::vector<std::shared_ptr<Bindable>>> m_MaterialBindables;
 	uint32_t m_IndexCount = 0;
 };
 
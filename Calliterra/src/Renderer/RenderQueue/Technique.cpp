@@ -7,11 +7,27 @@ void Technique::AddStep(Step step)
 	m_Steps.push_back(std::move(step));
 }
 
-void Technique::Submit() const
+void Technique::Submit(float viewDepth) const
 {
 	for (const auto& step : m_Steps)
 	{
-		step.Submit();
+		step.Submit(viewDepth);
+	}
+}
+
+void Technique::Submit(const std::vector<DrawRange>& drawRanges, float viewDepth) const
+{
+	for (const auto& step : m_Steps)
+	{
+		step.Submit(drawRanges, viewDepth);
+	}
+}
+
+void Technique::Retain(std::vector<RetainedStepHandle>& handles) const
+{
+	for (const auto& step : m_Steps)
+	{
+		handles.push_back(step.Retain());
 	}
 }
 
@@ -2,6 +2,8 @@
 
 class Step;
 class Drawable;
+struct DrawRange;
+struct RetainedStepHandle;
 
 class Technique
 {
@@ -9,7 +11,10 @@ public:
 	Technique() = default;
 
 	void AddStep(Step step);
-	void Submit() const;
+	void Submit(float viewDepth = 0.f) const;
+	void Submit(const std::vector<DrawRange>& drawRanges, float viewDepth = 0.f) const;
+	// Adds a handle for each of the steps
+	void Retain(std::vector<RetainedStepHandle>& handles) const;
 	void InitializeParentReferences(const Drawable& parent);
 
 private:
@@ -21,6 +21,7 @@ public:
 	{
 	}
 
+	uint32_t GetBindSlot() const override { return BindSlot::ForTexture(m_Slot); }
 
 protected:
 	uint32_t m_Slot;
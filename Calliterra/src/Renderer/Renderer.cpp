@@ -1,20 +1,26 @@
 #include "pch.h"
 #include "Renderer.h"
-#include "Platform/DX11/DX11VertexBuffer.h"
-#include "Platform/DX11/DX11IndexBuffer.h"
-#include "Platform/DX11/DX11Shader.h"
-#include "Platform/DX11/DX11Texture.h"
-#include "Platform/DX11/DX11Blender.h"
-#include "Platform/DX11/DX11DepthStencilMask.h"
-#include "Platform/DX11/DX11RenderTarget.h"
-#include "Platform/DX11/DX11DepthStencilBuffer.h"
-#include "Platform/DX11/DX11Topology.h"
-#include "Platform/DX11/DX11Rasterizer.h"
+#include "Platform/Recording/RecordingBindables.h"
+#include "Platform/Recording/RecordingRenderTarget.h"
+#ifdef _WIN32
+	#include "Platform/DX11/DX11VertexBuffer.h"
+	#include "Platform/DX11/DX11IndexBuffer.h"
+	#include "Platform/DX11/DX11Shader.h"
+	#include "Platform/DX11/DX11Texture.h"
+	#include "Platform/DX11/DX11Sampler.h"
+	#include "Platform/DX11/DX11Blender.h"
+	#include "Platform/DX11/DX11DepthStencilMask.h"
+	#include "Platform/DX11/DX11RenderTarget.h"
+	#include "Platform/DX11/DX11DepthStencilBuffer.h"
+	#include "Platform/DX11/DX11Topology.h"
+	#include "Platform/DX11/DX11Rasterizer.h"
+#endif
 
 void Renderer::Init(std::shared_ptr<GraphicsContext> graphicsContext)
 {
 	s_GraphicsContext = graphicsContext;
 
+	s_RendererAPI = RendererAPI::Create();
 	s_RendererAPI->Init(s_GraphicsContext);
 	s_RenderQueue = std::make_unique<RenderQueue>(*s_GraphicsContext);
 	s_GraphicsContext->LinkRenderQueueReference(s_RenderQueue.get());
@@ -23,6 +29,7 @@ void Renderer::Init(std::shared_ptr<GraphicsContext> graphicsContext)
 void Renderer::Shutdown()
 {
 	s_RenderQueue.reset();
+	s_RendererAPI.reset();
 }
 
 // TODO: Remove this
@@ -36,38 +43,38 @@ void Renderer::Bind(const std::vector<std::shared_ptr<Shader>>& shaderList,
 {
 	for (auto& shader : shaderList)
 	{
-		shader->Bind();
+		BindIfChanged(*shader);
 	}
 
 	if (vertexBuffer != nullptr)
 	{
-		vertexBuffer->Bind();
+		BindIfChanged(*vertexBuffer);
 	}
 
 	if (indexBuffer != nullptr)
 	{
-		indexBuffer->Bind();
+		BindIfChanged(*indexBuffer);
 		s_IndexCount = indexBuffer->GetCount();
 	}
 
 	for (auto& texture : textureList)
 	{
-		texture->Bind();
+		BindIfChanged(*texture);
 	}
 
 	for (auto& buffer : constantBufferList)
 	{
-		buffer->Bind();
+		BindIfChanged(*buffer);
 	}
 
 	if (blender != nullptr)
 	{
-		blender->Bind();
+		BindIfChanged(*blender);
 	}
 
 	if (depthStencil != nullptr)
 	{
-		depthStencil->Bind();
+		BindIfChanged(*depthStencil);
 	}
 }
 
@@ -76,13 +83,50 @@ void Renderer::Bind(const std::vector<std::shared_ptr<Bindable>>& bindables, uin
 	s_IndexCount = indexCount;
 	for (const auto& bind : bindables)
 	{
-		bind->Bind();
+		BindIfChanged(*bind);
+	}
+}
+
+void Renderer::InvalidateBindState()
+{
+	s_BoundState.fill(nullptr);
+}
+
+void Renderer::BindIfChanged(const Bindable& bindable)
+{
+	const uint32_t slot = bindable.GetBindSlot();
+	ASSERT(slot == BindSlot::None || slot < BindSlot::Count, "Bind slot out of range");
+	if (slot == BindSlot::None)
+	{
+		bindable.Bind();
+		s_BindStats.Issued++;
+	}
+	else if (s_BoundState[slot] == &bindable && !bindable.HasBindSideEffects())
+	{
+		s_BindStats.Skipped++;
+	}
+	else
+	{
+		bindable.Bind();
+		s_BindStats.Issued++;
+		// What a bindable with side effects leaves bound isn't necessarily itself
+		s_BoundState[slot] = bindable.HasBindSideEffects() ? nullptr : &bindable;
+	}
+
+	if (const Bindable* attached = bindable.GetAttachedBindable())
+	{
+		BindIfChanged(*attached);
 	}
 }
 
 void Renderer::Draw()
 {
-	s_RendererAPI->DrawIndexed(s_IndexCount);
+	s_RendererAPI->DrawIndexed(s_IndexCount, 0);
+}
+
+void Renderer::Draw(uint32_t indexCount, uint32_t startIndex)
+{
+	s_RendererAPI->DrawIndexed(indexCount, startIndex);
 }
 
 std::shared_ptr<IndexBuffer> Renderer::CreateIndexBuffer(const std::vector<uint32_t>& indices)
@@ -92,8 +136,15 @@ std::shared_ptr<IndexBuffer> Renderer::CreateIndexBuffer(const std::vector<uint3
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11IndexBuffer>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), indices);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingIndexBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), indices);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -109,8 +160,15 @@ std::shared_ptr<Shader> Renderer::CreateShader(const std::string& filepath, Shad
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11Shader>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), filepath, type);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingShader>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), filepath, type);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -125,6 +183,7 @@ std::shared_ptr<Texture> Renderer::CreateTexture(const std::string& filepath, ui
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		if (type == Texture::TextureType::Texture2D)
 		{
@@ -134,21 +193,56 @@ std::shared_ptr<Texture> Renderer::CreateTexture(const std::string& filepath, ui
 		{
 			return std::make_shared<DX11TextureCube>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), filepath, slot, filter);
 		}
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingTexture>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), filepath, slot, filter, type);
+	}
+
+	LOG_ERROR("Unknown RendererAPI");
+	return nullptr;
+}
+
+std::shared_ptr<Sampler> Renderer::CreateSampler(Texture::Filter filter, uint32_t slot)
+{
+	switch(GetAPI())
+	{
+	case RendererAPI::None: 
+		ASSERT(false, "RendererAPI is set to None!");
+		return nullptr;
+#ifdef _WIN32
+	case RendererAPI::DX11:
+		return std::make_shared<DX11Sampler>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), filter, slot);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingSampler>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), filter, slot);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
 	return nullptr;
 }
 
-std::shared_ptr<Blender> Renderer::CreateBlendState(bool enableBlending, Blender::BlendFunc srcBlend, Blender::BlendFunc destBlend, Blender::BlendOp blendOp)
+std::shared_ptr<Blender> Renderer::CreateBlendState(bool enableBlending, [[maybe_unused]] Blender::BlendFunc srcBlend, [[maybe_unused]] Blender::BlendFunc destBlend, [[maybe_unused]] Blender::BlendOp blendOp)
 {
 	switch(GetAPI())
 	{
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11Blender>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), enableBlending, srcBlend, destBlend, blendOp);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingBlender>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), enableBlending);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -162,8 +256,15 @@ std::shared_ptr<DepthStencilMask> Renderer::CreateDepthStencilMask(DepthStencilM
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11DepthStencilMask>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), mode);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingDepthStencilMask>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), mode);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -177,8 +278,15 @@ std::shared_ptr<Topology> Renderer::CreateTopology(PrimitiveTopology primitiveTo
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11Topology>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), primitiveTopology);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingTopology>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), primitiveTopology);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -192,8 +300,15 @@ std::shared_ptr<Rasterizer> Renderer::CreateRasterizer(FillMode fillMode, CullMo
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11Rasterizer>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), fillMode, cullMode);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingRasterizer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), fillMode, cullMode);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -216,8 +331,15 @@ std::shared_ptr<ShaderInputRenderTarget> Renderer::CreateRenderTarget(uint32_t w
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_unique<DX11ShaderInputRenderTarget>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), width, height, slot);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingShaderInputRenderTarget>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), width, height, slot);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -240,8 +362,15 @@ std::shared_ptr<DepthStencilBuffer> Renderer::CreateDepthStencilBuffer(uint32_t
 	case RendererAPI::None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case RendererAPI::DX11:
 		return std::make_shared<DX11DepthStencilBuffer>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), width, height, canBindShaderInput);
+#else
+	case RendererAPI::DX11:
+		break;
+#endif
+	case RendererAPI::Recording:
+		return std::make_shared<RecordingDepthStencilBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), width, height, canBindShaderInput);
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
@@ -257,3 +386,8 @@ RenderQueue& Renderer::GetRenderQueue()
 {
 	return *s_RenderQueue;
 }
+
+uint32_t Renderer::GetViewportHeight()
+{
+	return s_GraphicsContext->GetHeight();
+}
@@ -9,15 +9,26 @@
 #include "Shader.h"
 #include "ConstantBuffer.h"
 #include "Texture.h"
+#include "Sampler.h"
 #include "Blender.h"
 #include "DepthStencilMask.h"
 #include "Topology.h"
 #include "Rasterizer.h"
-#include "Platform/DX11/DX11ConstantBuffer.h"
-#include "Platform/DX11/DX11VertexBuffer.h"
+#include "Platform/Recording/RecordingBindables.h"
+#ifdef _WIN32
+	#include "Platform/DX11/DX11ConstantBuffer.h"
+	#include "Platform/DX11/DX11VertexBuffer.h"
+#endif
 
 class RenderGraph;
 
+// Bindables passed to Renderer::Bind since the last ResetBindStats, and how many of them were already bound
+struct BindStats
+{
+	uint32_t Issued = 0;
+	uint32_t Skipped = 0;
+};
+
 class Renderer
 {
 public:
@@ -31,8 +42,15 @@ public:
 					 const std::shared_ptr<Blender>& blender = nullptr,
 					 const std::shared_ptr<DepthStencilMask>& depthStencil = nullptr
 	);
+	// Skips the bindables that are already bound to their slot, see BindSlot
 	static void Bind(const std::vector<std::shared_ptr<Bindable>>& bindables, uint32_t indexCount);
+	// Forgets what's bound, which has to happen whenever something is bound without going through
+	// Renderer::Bind. The render queue does it before every pass.
+	static void InvalidateBindState();
+	static const BindStats& GetBindStats() { return s_BindStats; }
+	static void ResetBindStats() { s_BindStats = {}; }
 	static void Draw();
+	static void Draw(uint32_t indexCount, uint32_t startIndex);
 
 	template<typename Type>
 	static std::shared_ptr<VertexBuffer> CreateVertexBuffer(const std::vector<Type>& vertices)
@@ -42,8 +60,15 @@ public:
 		case RendererAPI::None: 
 			ASSERT(false, "RendererAPI is set to None!");
 			return nullptr;
+#ifdef _WIN32
 		case RendererAPI::DX11:
 			return std::make_shared<DX11VertexBuffer<Type>>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), vertices);
+#else
+		case RendererAPI::DX11:
+			break;
+#endif
+		case RendererAPI::Recording:
+			return std::make_shared<RecordingVertexBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), vertices.size());
 		}
 
 		LOG_ERROR("Unknown RendererAPI");
@@ -58,8 +83,15 @@ public:
 		case RendererAPI::None: 
 			ASSERT(false, "RendererAPI is set to None!");
 			return nullptr;
+#ifdef _WIN32
 		case RendererAPI::DX11:
 			return std::make_shared<DX11VertexBuffer<Type>>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), listOfVertexArrays);
+#else
+		case RendererAPI::DX11:
+			break;
+#endif
+		case RendererAPI::Recording:
+			return std::make_shared<RecordingVertexBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), listOfVertexArrays.empty() ? 0 : listOfVertexArrays[0].size());
 		}
 
 		LOG_ERROR("Unknown RendererAPI");
@@ -70,13 +102,14 @@ public:
 	static std::shared_ptr<Shader> CreateShader(const std::string& filepath, Shader::ShaderType type);
 
 	template<typename Type>
-	static std::shared_ptr<ConstantBuffer> CreateConstantBuffer(Shader::ShaderType shaderType, const Type& constants, uint32_t slot = 0)
+	static std::shared_ptr<ConstantBuffer> CreateConstantBuffer(Shader::ShaderType shaderType, [[maybe_unused]] const Type& constants, uint32_t slot = 0)
 	{
 		switch (GetAPI())
 		{
 		case RendererAPI::None:
 			ASSERT(false, "RendererAPI is set to None!");
 			return nullptr;
+#ifdef _WIN32
 		case RendererAPI::DX11:
 		{
 			switch (shaderType)
@@ -97,9 +130,14 @@ public:
 			case Shader::DOMAIN_SHADER:
 				return std::make_shared<DX11DomainConstantBuffer<Type>>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), shaderType, constants, slot);
 			}
-
+			break;
 		}
-			
+#else
+		case RendererAPI::DX11:
+			break;
+#endif
+		case RendererAPI::Recording:
+			return std::make_shared<RecordingConstantBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), shaderType, sizeof(Type), slot);
 		}
 
 		ASSERT(false, "ConstantBuffer creation is not supported for this API");
@@ -114,6 +152,7 @@ public:
 		case RendererAPI::None:
 			ASSERT(false, "RendererAPI is set to None!");
 			return nullptr;
+#ifdef _WIN32
 		case RendererAPI::DX11:
 		{
 			switch (shaderType)
@@ -134,8 +173,14 @@ public:
 			case Shader::DOMAIN_SHADER:
 				return std::make_shared<DX11DomainConstantBuffer<Type>>(*dynamic_cast<DX11Context*>(s_GraphicsContext.get()), shaderType, slot);
 			}
+			break;
 		}
-
+#else
+		case RendererAPI::DX11:
+			break;
+#endif
+		case RendererAPI::Recording:
+			return std::make_shared<RecordingConstantBuffer>(*dynamic_cast<RecordingContext*>(s_GraphicsContext.get()), shaderType, sizeof(Type), slot);
 		}
 		ASSERT(false, "ConstantBuffer creation is not supported for this API");
 		return nullptr;
@@ -144,16 +189,21 @@ public:
 	// Due to limitations of not being able to have virtual template functions we have the renderer manually
 	// type cast and call the appropriate update function for a constant buffer
 	template<typename Type>
-	static void UpdateConstantBuffer(std::shared_ptr<ConstantBuffer> constantBuffer, Type constants)
+	static void UpdateConstantBuffer(std::shared_ptr<ConstantBuffer> constantBuffer, [[maybe_unused]] Type constants)
 	{
 		switch (GetAPI())
 		{
 		case RendererAPI::None:
 			ASSERT(false, "RendererAPI is set to None!");
 			break;
+#ifdef _WIN32
 		case RendererAPI::DX11:
 			std::dynamic_pointer_cast<DX11ConstantBuffer<Type>>(constantBuffer)->Update(constants);
 			break;
+#endif
+		case RendererAPI::Recording:
+			std::static_pointer_cast<RecordingConstantBuffer>(constantBuffer)->Update(sizeof(Type));
+			break;
 		default:
 			ASSERT(false, "ConstantBuffer is not supported for this API");
 			break;
@@ -162,6 +212,7 @@ public:
 	}
 
 	static std::shared_ptr<Texture> CreateTexture(const std::string& filepath, uint32_t slot = 0, Texture::Filter filter = Texture::Filter::Anisotropic, Texture::TextureType type = Texture::TextureType::Texture2D);
+	static std::shared_ptr<Sampler> CreateSampler(Texture::Filter filter, uint32_t slot = 0);
 	static std::shared_ptr<Blender> CreateBlendState(bool enableBlending, Blender::BlendFunc srcBlend, Blender::BlendFunc destBlend, Blender::BlendOp blendOp);
 	static std::shared_ptr<DepthStencilMask> CreateDepthStencilMask(DepthStencilMask::Mode mode);
 	static std::shared_ptr<Topology> CreateTopology(PrimitiveTopology primitiveTopology);
@@ -172,14 +223,120 @@ public:
 
 	static RendererResourceLibrary& GetResourceLibrary();
 	static RenderQueue& GetRenderQueue();
+	// False after Shutdown, which can come before everything that retained steps has been destroyed
+	static bool HasRenderQueue() { return s_RenderQueue != nullptr; }
 
 	static RendererAPI::API GetAPI() { return RendererAPI::GetAPI(); }
+	static uint32_t GetViewportHeight();
+
+private:
+	static void BindIfChanged(const Bindable& bindable);
 
 private:
-	inline static std::shared_ptr<RendererAPI> s_RendererAPI = RendererAPI::Create();
+	// Created by Init, so the API can still be changed with RendererAPI::SetAPI before that
+	inline static std::shared_ptr<RendererAPI> s_RendererAPI = nullptr;
 	inline static std::shared_ptr<GraphicsContext> s_GraphicsContext = nullptr;
 	inline static RendererResourceLibrary s_ResourceLibrary;
 	inline static std::unique_ptr<RenderQueue> s_RenderQueue = nullptr;
 	inline static uint32_t s_IndexCount = 0;
+
+	// Bindables are only compared by address, none of them are destroyed while a pass executes
+	inline static std::array<const Bindable*, BindSlot::Count> s_BoundState = {};
+	inline static BindStats s_BindStats;
 };
 
+// The bindables' Resolve templates create them through the Renderer, which is only complete from here on
+
+template<typename Type, typename...Params>
+std::shared_ptr<Type> RendererResourceLibrary::Resolve(Params&...p)
+{
+	const auto key = Type::GenerateUID(p...);
+	const auto i = m_Bindables.find(key);
+
+	// The bindable is not inside our map, so we need to create it and store it
+	if (i == m_Bindables.end())
+	{
+		std::shared_ptr<Type> bind;
+
+		// We perform a compile-time check of the type of bindable we are trying
+		// to create and call the appropriate creation function.
+		if constexpr (std::is_same<Type, Shader>::value)
+		{
+			bind = Renderer::CreateShader(p...);
+		}
+		else if constexpr(std::is_same<Type, Texture>::value)
+		{
+			bind = Renderer::CreateTexture(p...);
+		}
+		else if constexpr(std::is_same<Type, VertexBuffer>::value)
+		{
+			// VertexBuffer uses a user provided tag for hashing, which occupies the first parameter.
+			// Since CreateVertexBuffer() doesn't need this tag we'll use this std::tie trick to
+			// get the other parameters we need.
+			const auto& vertices = std::get<1>(std::tie(p...));
+			bind = Renderer::CreateVertexBuffer(vertices);
+		}
+		else if constexpr(std::is_same<Type, IndexBuffer>::value)
+		{
+			const auto& indices = std::get<1>(std::tie(p...));
+			bind = Renderer::CreateIndexBuffer(indices);
+		}
+		else if constexpr(std::is_same<Type, ConstantBuffer>::value)
+		{
+			// ConstantBuffer uses a user provided tag for hashing, which occupies the first parameter.
+			// Since CreateConstantBuffer() doesn't need this tag we'll use this std::tie trick to
+			// get the other parameters we need.
+			const auto& shaderType = std::get<1>(std::tie(p...));
+			const auto& constants = std::get<2>(std::tie(p...));
+			const auto& slot = std::get<3>(std::tie(p...));
+			bind = Renderer::CreateConstantBuffer(shaderType, constants, slot);
+		}
+		else if constexpr (std::is_same<Type, Sampler>::value)
+		{
+			bind = Renderer::CreateSampler(p...);
+		}
+		else if constexpr (std::is_same<Type, Blender>::value)
+		{
+			bind = Renderer::CreateBlendState(p...);
+		}
+		else if constexpr (std::is_same<Type, DepthStencilMask>::value)
+		{
+			bind = Renderer::CreateDepthStencilMask(p...);
+		}
+		else if constexpr (std::is_same<Type, Topology>::value)
+		{
+			bind = Renderer::CreateTopology(p...);
+		}
+		else if constexpr (std::is_same<Type, Rasterizer>::value)
+		{
+			bind = Renderer::CreateRasterizer(p...);
+		}
+
+		m_Bindables[key] = bind;
+		return bind;
+	}
+	// The bindable is in our map, so we can return it
+	else 
+	{
+		// Since we are storing map values as Bindables we need to use this cast to return them as the intended type
+		return std::static_pointer_cast<Type>(i->second);
+	}
+}
+
+template <typename Type>
+std::shared_ptr<VertexBuffer> VertexBuffer::Resolve(const std::string& tag, const std::vector<Type>& vertices)
+{
+	return Renderer::GetResourceLibrary().Resolve<VertexBuffer>(tag, vertices);
+}
+
+template <typename Type>
+std::shared_ptr<VertexBuffer> VertexBuffer::Resolve(const std::string& tag, const std::vector<std::vector<Type>>& listOfVertexArrays, uint32_t bufferCount)
+{
+	return Renderer::GetResourceLibrary().Resolve<VertexBuffer>(tag, listOfVertexArrays);
+}
+
+template<typename Type>
+std::shared_ptr<ConstantBuffer> ConstantBuffer::Resolve(Shader::ShaderType shaderType, const Type& constants, uint32_t slot, const std::string& tag)
+{
+	return Renderer::GetResourceLibrary().Resolve<ConstantBuffer>(tag, shaderType, constants, slot);
+}
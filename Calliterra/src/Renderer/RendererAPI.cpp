@@ -1,7 +1,10 @@
 #include "pch.h"
 #include "RendererAPI.h"
 
-#include "Platform/DX11/DX11RendererAPI.h"
+#include "Platform/Recording/RecordingRendererAPI.h"
+#ifdef _WIN32
+	#include "Platform/DX11/DX11RendererAPI.h"
+#endif
 
 std::unique_ptr<RendererAPI>RendererAPI::Create()
 {
@@ -10,8 +13,15 @@ std::unique_ptr<RendererAPI>RendererAPI::Create()
 	case None: 
 		ASSERT(false, "RendererAPI is set to None!");
 		return nullptr;
+#ifdef _WIN32
 	case DX11:
 		return std::make_unique<DX11RendererAPI>();
+#else
+	case DX11:
+		break;
+#endif
+	case Recording:
+		return std::make_unique<RecordingRendererAPI>();
 	}
 
 	LOG_ERROR("Unknown RendererAPI");
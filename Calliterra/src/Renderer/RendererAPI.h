@@ -1,22 +1,30 @@
 #pragma once
-#include "Renderer\GraphicsContext.h"
+#include "Renderer/GraphicsContext.h"
 
 class RendererAPI
 {
 public:
 	enum API
 	{
-		None = 0, DX11 = 1
+		None = 0, DX11 = 1,
+		// No device, everything is recorded into a command stream instead (see RecordingContext)
+		Recording = 2
 	};
 
 	virtual ~RendererAPI() = default;
 	virtual void Init(std::shared_ptr<GraphicsContext> context) = 0;
 
-	virtual void DrawIndexed(uint32_t indexCount) = 0;
+	virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex) = 0;
 
 	static API GetAPI() { return s_API; }
+	// Has to be called before the GraphicsContext is created and the Renderer is initialized
+	static void SetAPI(API api) { s_API = api; }
 	static std::unique_ptr<RendererAPI> Create();
 private:
+#ifdef _WIN32
 	inline static API s_API = DX11;
+#else
+	inline static API s_API = Recording;
+#endif
 };
 
@@ -0,0 +1,14 @@
+#include "pch.h"
+#include "Sampler.h"
+#include "Renderer.h"
+
+const std::string Sampler::GenerateUID(Texture::Filter filter, uint32_t slot)
+{
+	using namespace std::string_literals;
+	return typeid(Sampler).name() + "#"s + std::to_string(static_cast<int>(filter)) + "#"s + std::to_string(slot);
+}
+
+std::shared_ptr<Sampler> Sampler::Resolve(Texture::Filter filter, uint32_t slot)
+{
+	return Renderer::GetResourceLibrary().Resolve<Sampler>(filter, slot);
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "Texture.h"
+
+// Pixel shader sampler state, shared by every texture that samples with the same filter. Textures bind theirs
+// right after themselves (see Bindable::GetAttachedBindable), so with the shaders only declaring s0 the
+// sampler of the last texture bound is the one that's used.
+class Sampler : public Bindable
+{
+public:
+	virtual ~Sampler() = default;
+
+	static const std::string GenerateUID(Texture::Filter filter, uint32_t slot = 0);
+	static std::shared_ptr<Sampler> Resolve(Texture::Filter filter, uint32_t slot = 0);
+};
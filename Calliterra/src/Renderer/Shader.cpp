@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Shader.h"
 #include "Renderer.h"
+#include "Core/ImportProfiler.h"
 
 const std::string Shader::GenerateUID(const std::string& filepath, Shader::ShaderType type)
 {
@@ -10,5 +11,6 @@ const std::string Shader::GenerateUID(const std::string& filepath, Shader::Shade
 
 std::shared_ptr<Shader> Shader::Resolve(const std::string& filepath, Shader::ShaderType type)
 {
+	PROFILE_IMPORT("Shader::Resolve", filepath);
 	return Renderer::GetResourceLibrary().Resolve<Shader>(filepath, type);
 }
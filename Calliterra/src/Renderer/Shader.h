@@ -23,4 +23,11 @@ public:
 	static const std::string GenerateUID(const std::string& filepath, Shader::ShaderType type);
 
 	static std::shared_ptr<Shader> Resolve(const std::string& filepath, Shader::ShaderType type);
+
+	// Small id used by the render queue's sort keys, shaders are resolved so every distinct one gets its own
+	uint32_t GetSortId() const { return m_SortId; }
+
+private:
+	inline static uint32_t s_NextSortId = 1;
+	uint32_t m_SortId = s_NextSortId++;
 };
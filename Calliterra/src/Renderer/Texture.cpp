@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "Texture.h"
+#include "Sampler.h"
 #include "Renderer.h"
+#include "TextureStreamer.h"
+#include "Core/ImportProfiler.h"
 
 const std::string Texture::GenerateUID(const std::string& filepath, uint32_t slot, Filter filter, TextureType type)
 {
@@ -10,5 +13,17 @@ const std::string Texture::GenerateUID(const std::string& filepath, uint32_t slo
 
 std::shared_ptr<Texture> Texture::Resolve(const std::string& filepath, uint32_t slot, Filter filter, TextureType type)
 {
-	return Renderer::GetResourceLibrary().Resolve<Texture>(filepath, slot, filter, type);
+	PROFILE_IMPORT("Texture::Resolve", filepath);
+	std::shared_ptr<Texture> texture = Renderer::GetResourceLibrary().Resolve<Texture>(filepath, slot, filter, type);
+	if (texture->IsStreamable())
+	{
+		TextureStreamer::Register(texture);
+	}
+
+	return texture;
+}
+
+const Bindable* Texture::GetAttachedBindable() const
+{
+	return m_Sampler.get();
 }
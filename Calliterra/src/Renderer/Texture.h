@@ -2,6 +2,7 @@
 #include "Bindable.h"
 
 class Renderer;
+class Sampler;
 
 class Texture : public Bindable
 {
@@ -23,9 +24,27 @@ public:
 	virtual ~Texture() = default;
 
 	virtual bool HasBlending() = 0;
+	const Bindable* GetAttachedBindable() const override;
+
+	// Mip streaming, see TextureStreamer. Textures that don't stream keep all of their mips resident.
+	virtual bool IsStreamable() const { return false; }
+	virtual uint32_t GetWidth() const { return 0; }
+	virtual uint32_t GetNumMips() const { return 1; }
+	// The most detailed mip that is currently resident
+	virtual uint32_t GetResidentMip() const { return 0; }
+	// Memory used by the mips from firstMip down to 1x1
+	virtual size_t GetMemorySize([[maybe_unused]] uint32_t firstMip) const { return 0; }
+	// Creates the resources for the mips from firstMip down, safe to call from a worker thread. They only
+	// replace the current ones once CommitStreamedMips is called on the main thread.
+	virtual void StreamMips([[maybe_unused]] uint32_t firstMip) {}
+	virtual bool CommitStreamedMips() { return false; }
 
 	static const std::string GenerateUID(const std::string& filepath, uint32_t slot = 0, Filter filter = Filter::Anisotropic, TextureType type = TextureType::Texture2D);
+	// Streamable textures start out with only their mip tail resident and are registered with the TextureStreamer
 	static std::shared_ptr<Texture> Resolve(const std::string& filepath, uint32_t slot = 0, Filter filter = Filter::Anisotropic, TextureType type = TextureType::Texture2D);
 
-	
+protected:
+	// The shaders only declare s0, so every texture binds its filter's sampler there after itself and the
+	// last texture bound decides how they're all sampled
+	std::shared_ptr<Sampler> m_Sampler;
 };
@@ -0,0 +1,247 @@
+#include "pch.h"
+#include "TextureStreamer.h"
+#include "Core/ThreadPool.h"
+
+void TextureStreamer::Register(const std::shared_ptr<Texture>& texture)
+{
+	// A texture that died can leave its entry behind until the next Update, and a new texture can be
+	// allocated at the same address before that. Its entry is started over, any load it had has finished
+	// since the load holds on to the texture.
+	const auto it = s_Textures.find(texture.get());
+	if (it != s_Textures.end() && !it->second.Resource.expired())
+	{
+		return;
+	}
+
+	StreamedTexture& streamed = s_Textures[texture.get()];
+	streamed = {};
+	streamed.Resource = texture;
+	streamed.MipTail = texture->GetResidentMip();
+	streamed.RequestedMip = streamed.MipTail;
+	streamed.TargetMip = streamed.MipTail;
+}
+
+void TextureStreamer::Request(const Texture* texture, float pixelsPerUv)
+{
+	const auto it = s_Textures.find(texture);
+	if (it == s_Textures.end())
+	{
+		return;
+	}
+
+	StreamedTexture& streamed = it->second;
+
+	// One mip down halves the texels per UV, so the mip that maps closest to one texel per pixel is log2 of the ratio.
+	// Anything we can't measure (behind the camera, infinitely large on screen) just asks for everything.
+	uint32_t mip = 0;
+	if (pixelsPerUv > 0.f && std::isfinite(pixelsPerUv))
+	{
+		const float level = std::floor(std::log2(static_cast<float>(texture->GetWidth()) / pixelsPerUv));
+		mip = static_cast<uint32_t>(std::clamp(level, 0.f, static_cast<float>(streamed.MipTail)));
+	}
+
+	// Several meshes can share a texture, the closest one decides
+	if (streamed.LastRequested != s_Frame)
+	{
+		streamed.LastRequested = s_Frame;
+		streamed.RequestedMip = mip;
+	}
+	else
+	{
+		streamed.RequestedMip = std::min(streamed.RequestedMip, mip);
+	}
+}
+
+void TextureStreamer::Update()
+{
+	CommitLoads();
+
+	// The scratch vectors keep their capacity from frame to frame, so once the set of textures has settled
+	// none of this allocates
+	std::vector<StreamedTexture*>& textures = s_ScratchTextures;
+	textures.clear();
+	for (auto it = s_Textures.begin(); it != s_Textures.end();)
+	{
+		StreamedTexture& streamed = it->second;
+		if (streamed.Resource.expired() && !streamed.Load.valid())
+		{
+			it = s_Textures.erase(it);
+			continue;
+		}
+
+		const bool isUsed = streamed.LastRequested + s_UnusedFrames >= s_Frame;
+		streamed.TargetMip = isUsed ? streamed.RequestedMip : streamed.MipTail;
+		textures.push_back(&streamed);
+		++it;
+	}
+
+	ApplyBudget(textures);
+
+	// Dropping mips is cheap and frees memory so it's always done right away, loading them is limited to a
+	// few textures at a time with the ones that are missing the most detail going first.
+	uint32_t loading = 0;
+	std::vector<std::pair<StreamedTexture*, std::shared_ptr<Texture>>>& upgrades = s_ScratchUpgrades;
+	upgrades.clear();
+	for (StreamedTexture* streamed : textures)
+	{
+		if (streamed->Load.valid())
+		{
+			loading++;
+			continue;
+		}
+
+		std::shared_ptr<Texture> texture = streamed->Resource.lock();
+		if (!texture)
+		{
+			continue;
+		}
+
+		const uint32_t residentMip = texture->GetResidentMip();
+		if (streamed->TargetMip > residentMip)
+		{
+			const uint32_t targetMip = streamed->TargetMip;
+			streamed->Load = ThreadPool::Submit([texture, targetMip]() { texture->StreamMips(targetMip); });
+			loading++;
+		}
+		else if (streamed->TargetMip < residentMip)
+		{
+			upgrades.emplace_back(streamed, std::move(texture));
+		}
+	}
+
+	std::sort(upgrades.begin(), upgrades.end(), [](const auto& a, const auto& b)
+		{
+			return a.second->GetResidentMip() - a.first->TargetMip > b.second->GetResidentMip() - b.first->TargetMip;
+		});
+
+	for (auto& [streamed, texture] : upgrades)
+	{
+		if (loading >= s_MaxLoadsInFlight)
+		{
+			break;
+		}
+
+		const uint32_t targetMip = streamed->TargetMip;
+		streamed->Load = ThreadPool::Submit([texture, targetMip]() { texture->StreamMips(targetMip); });
+		loading++;
+	}
+
+	s_Stats.Textures = static_cast<uint32_t>(textures.size());
+	s_Stats.Loading = loading;
+	s_Stats.ResidentMemory = 0;
+	s_Stats.Budget = s_Budget;
+	for (StreamedTexture* streamed : textures)
+	{
+		if (std::shared_ptr<Texture> texture = streamed->Resource.lock())
+		{
+			s_Stats.ResidentMemory += texture->GetMemorySize(texture->GetResidentMip());
+		}
+	}
+
+	upgrades.clear();
+
+	s_Frame++;
+}
+
+void TextureStreamer::Shutdown()
+{
+	for (auto& [texture, streamed] : s_Textures)
+	{
+		if (streamed.Load.valid())
+		{
+			streamed.Load.wait();
+		}
+	}
+	s_Textures.clear();
+	s_ScratchTextures.clear();
+	s_ScratchUpgrades.clear();
+	s_ScratchCandidates.clear();
+	s_Stats = {};
+}
+
+uint32_t TextureStreamer::GetMipTail(uint32_t width, uint32_t height, uint32_t numMips, TextureFormat format)
+{
+	// Halving keeps a side a multiple of 4 only until it runs out of factors of 2, so the mips a block
+	// compressed texture can start at are all the ones down to some level. Every mip the streamer targets
+	// lies between mip 0 and the tail, which makes all of them valid as well.
+	const auto isWholeBlocks = [width, height](uint32_t mip)
+		{
+			return std::max(width >> mip, 1u) % 4 == 0 && std::max(height >> mip, 1u) % 4 == 0;
+		};
+	const bool isBlockCompressed = TextureCompressor::IsBlockCompressed(format);
+
+	uint32_t mip = 0;
+	while (mip + 1 < numMips && std::max(width >> mip, height >> mip) > s_MipTailSize && (!isBlockCompressed || isWholeBlocks(mip + 1)))
+	{
+		mip++;
+	}
+
+	return mip;
+}
+
+// Swaps in the mips that finished loading. Only the main thread touches the device context, so this
+// is the only place the texture's resources actually change.
+void TextureStreamer::CommitLoads()
+{
+	for (auto& [key, streamed] : s_Textures)
+	{
+		if (!streamed.Load.valid() || streamed.Load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			continue;
+		}
+
+		streamed.Load.get();
+		if (std::shared_ptr<Texture> texture = streamed.Resource.lock())
+		{
+			texture->CommitStreamedMips();
+		}
+	}
+}
+
+// Least recently drawn textures give up their most detailed mips first, one mip at a time, until the targets fit
+void TextureStreamer::ApplyBudget(std::vector<StreamedTexture*>& textures)
+{
+	std::vector<std::pair<StreamedTexture*, std::shared_ptr<Texture>>>& candidates = s_ScratchCandidates;
+	candidates.clear();
+	size_t memory = 0;
+	for (StreamedTexture* streamed : textures)
+	{
+		if (std::shared_ptr<Texture> texture = streamed->Resource.lock())
+		{
+			memory += texture->GetMemorySize(streamed->TargetMip);
+			candidates.emplace_back(streamed, std::move(texture));
+		}
+	}
+
+	if (memory <= s_Budget)
+	{
+		// Don't keep the textures alive until the next frame
+		candidates.clear();
+		return;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+		{
+			return a.first->LastRequested < b.first->LastRequested;
+		});
+
+	bool droppedAny = true;
+	while (memory > s_Budget && droppedAny)
+	{
+		droppedAny = false;
+		for (auto& [streamed, texture] : candidates)
+		{
+			if (streamed->TargetMip >= streamed->MipTail)
+			{
+				continue;
+			}
+
+			memory -= texture->GetMemorySize(streamed->TargetMip) - texture->GetMemorySize(streamed->TargetMip + 1);
+			streamed->TargetMip++;
+			droppedAny = true;
+			break;
+		}
+	}
+
+	candidates.clear();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <future>
+#include "Texture.h"
+#include "Asset/TextureCompressor.h"
+
+struct TextureStreamingStats
+{
+	uint32_t Textures = 0;
+	uint32_t Loading = 0;
+	size_t ResidentMemory = 0;
+	size_t Budget = 0;
+};
+
+// Streams texture mips in and out by how much detail is actually visible. Textures start out with only
+// their mip tail resident, every frame the meshes that get drawn Request() the resolution they need for
+// each of their textures and Update() then loads the missing mips on the ThreadPool.
+//
+// The resident mips of all streamed textures are kept within a memory budget, when going over it the
+// textures that were drawn least recently lose their most detailed mips first.
+class TextureStreamer
+{
+public:
+	static void Register(const std::shared_ptr<Texture>& texture);
+
+	// pixelsPerUv is how many pixels a single repeat of the texture (one unit of UV) covers on screen
+	static void Request(const Texture* texture, float pixelsPerUv);
+
+	// Called once a frame after everything has been submitted
+	static void Update();
+	static void Shutdown();
+
+	// The first mip that is small enough to be part of the always resident tail. A block compressed texture
+	// can only be created starting at a mip whose sides are both multiples of 4, so its tail stops at the
+	// last of those if it's bigger than that.
+	static uint32_t GetMipTail(uint32_t width, uint32_t height, uint32_t numMips, TextureFormat format);
+
+	static void SetBudget(size_t bytes) { s_Budget = bytes; }
+	static const TextureStreamingStats& GetStats() { return s_Stats; }
+
+private:
+	struct StreamedTexture
+	{
+		std::weak_ptr<Texture> Resource;
+		uint32_t MipTail = 0;
+		// The most detailed mip asked for during LastRequested's frame
+		uint32_t RequestedMip = 0;
+		uint64_t LastRequested = 0;
+		uint32_t TargetMip = 0;
+		std::future<void> Load;
+	};
+
+	static void CommitLoads();
+	static void ApplyBudget(std::vector<StreamedTexture*>& textures);
+
+private:
+	inline static std::unordered_map<const Texture*, StreamedTexture> s_Textures;
+	inline static uint64_t s_Frame = 1;
+	inline static size_t s_Budget = 256ull * 1024 * 1024;
+	inline static TextureStreamingStats s_Stats;
+
+	// Only used during Update, they're members so their memory is reused every frame
+	inline static std::vector<StreamedTexture*> s_ScratchTextures;
+	inline static std::vector<std::pair<StreamedTexture*, std::shared_ptr<Texture>>> s_ScratchUpgrades;
+	inline static std::vector<std::pair<StreamedTexture*, std::shared_ptr<Texture>>> s_ScratchCandidates;
+
+	// Mips at or below this size are always resident
+	inline static constexpr uint32_t s_MipTailSize = 64;
+	// Textures that haven't been drawn for this many frames fall back to their mip tail
+	inline static constexpr uint64_t s_UnusedFrames = 120;
+	inline static constexpr uint32_t s_MaxLoadsInFlight = 4;
+};
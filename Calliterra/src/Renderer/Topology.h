@@ -15,6 +15,7 @@ class Topology : public Bindable
 {
 public:
 	virtual ~Topology() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::Topology; }
 
 	static const std::string GenerateUID(PrimitiveTopology primtiveTopology);
 	static std::shared_ptr<Topology> Resolve(PrimitiveTopology primtiveTopology);
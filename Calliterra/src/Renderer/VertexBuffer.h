@@ -8,28 +8,24 @@ class VertexBuffer : public Bindable
 {
 public:
 	virtual ~VertexBuffer() = default;
+	uint32_t GetBindSlot() const override { return BindSlot::VertexBuffer; }
 
 	virtual void CreateLayout(const VertexBufferLayout& layout, Shader* shader = nullptr) = 0;
 	virtual void CreateLayoutList(const std::vector<VertexBufferLayout>& layoutList, Shader* shader = nullptr) = 0;
 
 	template <typename...IgnoreParams>
-	static const std::string GenerateUID(const std::string& tag, IgnoreParams&&...ignore)
+	static const std::string GenerateUID(const std::string& tag, IgnoreParams&&...)
 	{
 		using namespace std::string_literals;
 		return typeid(VertexBuffer).name() + "#"s + tag;
 	}
 
+	// Defined at the end of Renderer.h
 	template <typename Type>
-	static std::shared_ptr<VertexBuffer> Resolve(const std::string& tag, const std::vector<Type>& vertices)
-	{
-		return Renderer::GetResourceLibrary().Resolve<VertexBuffer>(tag, vertices);
-	}
+	static std::shared_ptr<VertexBuffer> Resolve(const std::string& tag, const std::vector<Type>& vertices);
 
 	template <typename Type>
-	static std::shared_ptr<VertexBuffer> Resolve(const std::string& tag, const std::vector<std::vector<Type>>& listOfVertexArrays, uint32_t bufferCount)
-	{
-		return Renderer::GetResourceLibrary().Resolve<VertexBuffer>(tag, listOfVertexArrays);
-	}
+	static std::shared_ptr<VertexBuffer> Resolve(const std::string& tag, const std::vector<std::vector<Type>>& listOfVertexArrays, uint32_t bufferCount);
 
 };
 
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Cube.h"
 #include "Renderer/RenderQueue/Passes/Base/RenderPass.h"
+#include "Renderer/TextureStreamer.h"
 
 Cube::Cube(DX::XMMATRIX transform, DX::XMFLOAT3 color)
 	: Drawable(transform, color)
@@ -62,13 +63,15 @@ void Cube::MakeIndependent()
 				}, vShader.get());
 
 			onlyStep.AddBindable(vBuff);
-			onlyStep.AddBindable(Texture::Resolve("assets/textures/brickwall.jpg"));
+			m_Texture = Texture::Resolve("assets/textures/brickwall.jpg");
+			onlyStep.AddBindable(m_Texture);
 
 			m_TransformConstantBuffer = std::make_shared<TransformConstantBuffer>();
 
 			CubePixelConstantBuffer pcb = {
 				0.6f,
-				128.f
+				128.f,
+				{}
 			};
 
 			onlyStep.AddBindable(ConstantBuffer::Resolve<CubePixelConstantBuffer>(Shader::PIXEL_SHADER, pcb, 1));
@@ -143,14 +146,25 @@ void Cube::MakeIndependent()
 	}
 }
 
-void Cube::Update(float dt)
+// The cube is only ever a handful of units across, not worth working out how much of its texture is visible
+void Cube::Submit() const
+{
+	if (m_Texture)
+	{
+		TextureStreamer::Request(m_Texture.get(), std::numeric_limits<float>::infinity());
+	}
+
+	SubmitTechniques();
+}
+
+void Cube::Update(float)
 {
 }
 
 void Cube::CalculateNormals()
 {
 	using namespace DirectX; // For some reason we need to include this line in order to use the XMMath overloaded operators...
-	for (int i = 0; i < m_IndependentCubeIndices.size(); i += 3)
+	for (size_t i = 0; i < m_IndependentCubeIndices.size(); i += 3)
 	{
 		CubeVertex& v0 = m_IndependentCubeVertices[m_IndependentCubeIndices[i]];
 		CubeVertex& v1 = m_IndependentCubeVertices[m_IndependentCubeIndices[i+1]];
@@ -9,11 +9,15 @@ public:
 	void MakeSkyBox();
 	void MakeIndependent();
 
+	void Submit() const override;
 	void Update(float dt) override;
 
 private:
 	static void CalculateNormals();
 
+private:
+	std::shared_ptr<Texture> m_Texture;
+
 private:
 	inline static constexpr uint32_t m_VERTEXCOUNT= 8 * 3 * 3;
 	inline static constexpr uint32_t m_INDEXCOUNT = 36;
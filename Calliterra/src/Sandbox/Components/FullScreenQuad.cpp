@@ -24,18 +24,16 @@ FullScreenQuad::FullScreenQuad()
 		std::vector<uint32_t> iBuff = { 0, 1, 2, 1, 3, 2 };
 		m_IndexBuffer = IndexBuffer::Resolve(tag, iBuff);
 
+		m_Bindables = {
+			m_VertexBuffer,
+			m_IndexBuffer,
+			m_VertexShader,
+		};
 	}
 
 void FullScreenQuad::Bind() const
 {
-
-	std::vector<std::shared_ptr<Bindable>> bindables = {
-		m_VertexBuffer,
-		m_IndexBuffer,
-		m_VertexShader,
-	};
-
-	Renderer::Bind(bindables, m_IndexBuffer->GetCount());
+	Renderer::Bind(m_Bindables, m_IndexBuffer->GetCount());
 }
 
 void FullScreenQuad::Draw() const
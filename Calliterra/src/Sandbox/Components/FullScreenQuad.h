@@ -18,5 +18,6 @@ private:
 	std::shared_ptr<IndexBuffer> m_IndexBuffer;
 	std::shared_ptr<Shader> m_VertexShader;
 	std::shared_ptr<Shader> m_PixelShader;
+	std::vector<std::shared_ptr<Bindable>> m_Bindables;
 };
 
@@ -8,6 +8,10 @@
 #include "Sandbox/Components/Sun.h"
 #include "Asset/Model.h"
 #include "Asset/ModelLoader.h"
+#include "Asset/ModelImporter.h"
+#include "Asset/VertexKernels.h"
+#include "Renderer/TextureStreamer.h"
+#include "Core/AllocationCounter.h"
 
 Sandbox::Sandbox(float aspectRatio)
 	: m_Camera(aspectRatio, 90.f)
@@ -18,7 +22,14 @@ Sandbox::Sandbox(float aspectRatio)
 void Sandbox::OnUpdate(float dt)
 {
 	m_Camera.OnUpdate(dt);
-	
+
+	const uint64_t allocations = AllocationCounter::GetCount();
+
+	// Finish off any models that are streaming in, within this frame's upload budget
+	ModelLoader::ProcessPendingLoads();
+
+	Mesh::ResetCullingStats();
+	Renderer::ResetBindStats();
 	for (auto& drawable : m_Drawables)
 	{
 		drawable->SetViewMatrix(m_Camera.GetViewMatrix());
@@ -29,6 +40,10 @@ void Sandbox::OnUpdate(float dt)
 
 	Renderer::GetRenderQueue().Execute();
 	Renderer::GetRenderQueue().Reset();
+
+	// Everything has asked for its textures by now
+	TextureStreamer::Update();
+	s_FrameAllocations = AllocationCounter::GetCount() - allocations;
 }
 
 void Sandbox::OnEvent(Event& e)
@@ -44,16 +59,19 @@ void Sandbox::LoadSandboxPreset()
 	CreateSun();
 	CreateSkyBox();
 
-	//std::shared_ptr<rapidobj::Result> dragonModel = ModelLoader::LoadModelObj("assets/models/dragon.obj");
-	//std::shared_ptr<fastgltf::Asset> vaseClayModel = ModelLoader::LoadModelGltf("assets/models/Vase_Clay.gltf");
-	//std::shared_ptr<UfbxScene> heartModel = ModelLoader::LoadModelFbx("assets/models/HumanHeart_FBX.fbx");
+	//std::shared_ptr<rapidobj::Result> dragonModel = ModelImporter::LoadModelObj("assets/models/dragon.obj");
+	//std::shared_ptr<fastgltf::Asset> vaseClayModel = ModelImporter::LoadModelGltf("assets/models/Vase_Clay.gltf");
+	//std::shared_ptr<UfbxScene> heartModel = ModelImporter::LoadModelFbx("assets/models/HumanHeart_FBX.fbx");
+
+	// The import and vertex kernel benchmarks are run through the Importer, see its usage
+	//ModelLoader::BenchmarkInstancing("assets/models/nano_textured/nanosuit.obj");
 
 	//DX::XMMATRIX transform = DX::XMMatrixRotationX(DX::XMConvertToRadians(90)) * DX::XMMatrixTranslation(10.f, 10.f, -10.f);
 	DX::XMMATRIX transform2 = DX::XMMatrixIdentity();
 	DX::XMMATRIX transform3 = DX::XMMatrixScaling(0.05f, 0.05f, 0.05f);
 
 	//m_Drawables.emplace_back(std::make_unique<Model>(ModelLoader::GetModel("assets/models/nano_textured/nanosuit.obj", transform2, DX::XMFLOAT3(0.2f, 0.4f, 0.9f))));
-	m_Drawables.emplace_back(std::make_unique<Model>(ModelLoader::GetModel("assets/models/Sponza/sponza.obj", transform3, DX::XMFLOAT3(0.2f, 0.4f, 0.9f))));
+	m_Drawables.emplace_back(ModelLoader::LoadModelAsync("assets/models/Sponza/sponza.obj", transform3, DX::XMFLOAT3(0.2f, 0.4f, 0.9f)));
 	CreateCube(DX::XMMatrixScaling(5.f, 5.f, 5.f) * DX::XMMatrixTranslation(6.f, 0.f, 0.f));
 	CreateCube(DX::XMMatrixScaling(5.f, 5.f, 5.f));
 
@@ -69,6 +87,7 @@ void Sandbox::CreateCube(const DX::XMMATRIX& transform)
 {
 	m_Drawables.emplace_back(std::make_unique<Cube>(transform));
 	dynamic_cast<Cube*>(m_Drawables.back().get())->MakeIndependent();
+	m_Drawables.back()->Retain();
 }
 
 void Sandbox::CreateRadialSphere()
@@ -109,6 +128,7 @@ void Sandbox::CreateSkyBox()
 {
 	m_Drawables.emplace_back(std::make_unique<Cube>());
 	dynamic_cast<Cube*>(m_Drawables.back().get())->MakeSkyBox();
+	m_Drawables.back()->Retain();
 }
 
 const Camera& Sandbox::GetCamera() const
@@ -24,7 +24,13 @@ public:
 
 	const Camera& GetCamera() const;
 
+	// Heap allocations made during the last frame, from finishing loads through streaming textures, see
+	// AllocationCounter. Once the scene has been drawn a few times (and nothing is loading) this should stay at 0.
+	static uint64_t GetFrameAllocations() { return s_FrameAllocations; }
+
 private:
 	std::vector<std::unique_ptr<Drawable>> m_Drawables;
 	Camera m_Camera;
+
+	inline static uint64_t s_FrameAllocations = 0;
 };
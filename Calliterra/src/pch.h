@@ -6,11 +6,17 @@
 	#define _CRT_DECLARE_NONSTDC_NAMES 0
 #endif
 
-#include <Windows.h>
+// Only the asset pipeline is built for other platforms (see the Importer project), everything
+// that needs Windows.h or COM is part of the renderer
+#ifdef _WIN32
+	#include <Windows.h>
+	#include <wrl.h>
+	using Microsoft::WRL::ComPtr;
+#endif
+
 #include <DirectXMath.h>
-#include <wrl.h>
+#include <DirectXCollision.h>
 namespace DX = DirectX;
-using Microsoft::WRL::ComPtr;
 
 #include <iostream>
 #include <memory>
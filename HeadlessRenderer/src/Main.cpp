@@ -0,0 +1,257 @@
+#include "pch.h"
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include "Renderer/Renderer.h"
+#include "Renderer/TextureStreamer.h"
+#include "Platform/Recording/RecordingContext.h"
+#include "Sandbox/BasicShapes/Cube.h"
+#include "Core/ThreadPool.h"
+#include "Core/AllocationCounter.h"
+
+// Renders the Sandbox's cubes and skybox through the Recording API, which needs neither a window nor a graphics
+// device, checks the commands the frames recorded and then times the CPU side of a frame. Like the Importer this
+// builds on Linux, so the render queue, passes and bindables can be tested and benchmarked from scripts and CI.
+// Exits with 1 if any of the checks failed.
+//
+// Usage:
+//   HeadlessRenderer [--frames <count>] [--cubes <count>] [--dump <file>]
+
+namespace
+{
+	bool s_Failed = false;
+
+	void Check(bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			std::cerr << "Check failed: " << message << "\n";
+			s_Failed = true;
+		}
+	}
+
+	// D3D only creates a block compressed texture from a top level that's a whole number of blocks, so that has
+	// to hold for the mip tail and every mip the streamer can load down to from there, non power of two sizes included
+	void CheckMipTails()
+	{
+		for (uint32_t height = 4; height <= 1024; height += 4)
+		{
+			for (uint32_t width = 4; width <= 1024; width += 4)
+			{
+				const uint32_t numMips = std::bit_width(std::max(width, height));
+				const uint32_t mipTail = TextureStreamer::GetMipTail(width, height, numMips, TextureFormat::BC7);
+				for (uint32_t mip = 0; mip <= mipTail; mip++)
+				{
+					const uint32_t mipWidth = std::max(width >> mip, 1u);
+					const uint32_t mipHeight = std::max(height >> mip, 1u);
+					Check(mipWidth % 4 == 0 && mipHeight % 4 == 0,
+						std::format("A {}x{} BC7 texture can stream down to mip {} which is {}x{}", width, height, mip, mipWidth, mipHeight));
+				}
+			}
+		}
+
+		struct MipTailCase
+		{
+			uint32_t Width;
+			uint32_t Height;
+			TextureFormat Format;
+			uint32_t MipTail;
+		};
+
+		const MipTailCase cases[] = {
+			{ 1000, 1000, TextureFormat::BC7, 1 },   // 250x250 isn't whole blocks, so it stops at 500x500
+			{ 1000, 1000, TextureFormat::RGBA8, 4 }, // 62x62
+			{ 256, 4, TextureFormat::BC1, 0 },
+			{ 256, 4, TextureFormat::RGBA8, 2 },     // 64x1
+			{ 768, 512, TextureFormat::BC3, 4 },     // 48x32
+			{ 2048, 2048, TextureFormat::BC5, 5 },   // 64x64
+		};
+
+		for (const MipTailCase& test : cases)
+		{
+			const uint32_t numMips = std::bit_width(std::max(test.Width, test.Height));
+			const uint32_t mipTail = TextureStreamer::GetMipTail(test.Width, test.Height, numMips, test.Format);
+			Check(mipTail == test.MipTail, std::format("The mip tail of a {}x{} texture is mip {} instead of {}", test.Width, test.Height, mipTail, test.MipTail));
+		}
+	}
+
+	// Half of the cubes are retained like the Sandbox's, the other half are submitted every frame
+	std::vector<std::unique_ptr<Drawable>> CreateScene(uint32_t numCubes)
+	{
+		std::vector<std::unique_ptr<Drawable>> drawables;
+		for (uint32_t i = 0; i < numCubes; i++)
+		{
+			auto cube = std::make_unique<Cube>(DX::XMMatrixTranslation(2.f * i, 0.f, 0.f));
+			cube->MakeIndependent();
+			if (i % 2 == 0)
+			{
+				cube->Retain();
+			}
+			drawables.push_back(std::move(cube));
+		}
+
+		auto skyBox = std::make_unique<Cube>();
+		skyBox->MakeSkyBox();
+		skyBox->Retain();
+		drawables.push_back(std::move(skyBox));
+
+		return drawables;
+	}
+
+	// The same as Sandbox::OnUpdate, only the commands of this frame are left in the stream afterwards
+	void RenderFrame(RecordingContext& context, const std::vector<std::unique_ptr<Drawable>>& drawables)
+	{
+		context.GetCommandStream().Clear();
+		Renderer::ResetBindStats();
+		for (const auto& drawable : drawables)
+		{
+			drawable->Submit();
+		}
+
+		Renderer::GetRenderQueue().Execute();
+		Renderer::GetRenderQueue().Reset();
+		context.SwapBuffers();
+
+		TextureStreamer::Update();
+	}
+
+	void CheckFrame(const RecordingCommandStream& stream, uint32_t numCubes, const std::string& frame)
+	{
+		const RecordingStats& stats = stream.GetStats();
+
+		// Every cube is drawn by the Lambertian and both outline passes, then there's the skybox and the full screen quad
+		const uint32_t expectedDraws = numCubes * 3 + 2;
+		Check(stats.GetCount(RecordedCommandType::DrawIndexed) == expectedDraws,
+			std::format("{} recorded {} draws instead of {}", frame, stats.GetCount(RecordedCommandType::DrawIndexed), expectedDraws));
+		Check(stats.GetCount(RecordedCommandType::Present) == 1, frame + " wasn't presented once");
+
+		// The shaders only declare s0, whatever samples a texture needs a sampler to have been bound there first
+		bool hasTexture = false;
+		bool hasSampler = false;
+		uint32_t draw = 0;
+		for (const RecordedCommand& command : stream.GetCommands())
+		{
+			switch (command.Type)
+			{
+			case RecordedCommandType::BindTexture:
+				hasTexture = true;
+				break;
+			case RecordedCommandType::BindSampler:
+				hasSampler |= command.Slot == 0;
+				break;
+			case RecordedCommandType::DrawIndexed:
+				Check(!hasTexture || hasSampler, std::format("{} draw {} samples a texture without a sampler bound", frame, draw));
+				draw++;
+				break;
+			default:
+				break;
+			}
+		}
+
+		// The cubes share their shaders and buffers, so with more than one Renderer::Bind has something to skip
+		if (numCubes > 1)
+		{
+			Check(Renderer::GetBindStats().Skipped > 0, frame + " didn't skip any binds");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	STRIP_DEBUG(Log::Init());
+
+	uint32_t numFrames = 1000;
+	uint32_t numCubes = 16;
+	std::filesystem::path dumpPath;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--frames" && i + 1 < argc)
+		{
+			numFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--cubes" && i + 1 < argc)
+		{
+			numCubes = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--dump" && i + 1 < argc)
+		{
+			dumpPath = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: HeadlessRenderer [--frames <count>] [--cubes <count>] [--dump <file>]\n";
+			return 1;
+		}
+	}
+
+	CheckMipTails();
+
+	ThreadPool::Init();
+	RendererAPI::SetAPI(RendererAPI::Recording);
+	const std::shared_ptr<GraphicsContext> graphicsContext = GraphicsContext::CreateHeadless(1280, 720);
+	RecordingContext& context = static_cast<RecordingContext&>(*graphicsContext);
+	Renderer::Init(graphicsContext);
+
+	{
+		const std::vector<std::unique_ptr<Drawable>> drawables = CreateScene(numCubes);
+
+		RenderFrame(context, drawables);
+		CheckFrame(context.GetCommandStream(), numCubes, "The first frame");
+		const std::string firstFrame = context.GetCommandStream().ToString();
+		if (!dumpPath.empty())
+		{
+			std::ofstream(dumpPath) << firstFrame;
+		}
+
+		// Nothing changed, so neither should what gets recorded
+		RenderFrame(context, drawables);
+		CheckFrame(context.GetCommandStream(), numCubes, "The second frame");
+		Check(context.GetCommandStream().ToString() == firstFrame, "The second frame recorded different commands than the first");
+
+		// Resizing recreates the render queue's targets, what's retained has to be drawn the same afterwards and
+		// released from the same passes when the drawables are destroyed
+		const size_t numRetained = Renderer::GetRenderQueue().GetNumRetained();
+		context.Resize(1920, 1080);
+		RenderFrame(context, drawables);
+		CheckFrame(context.GetCommandStream(), numCubes, "The frame after a resize");
+		Check(Renderer::GetRenderQueue().GetNumRetained() == numRetained,
+			std::format("{} steps were retained after a resize instead of {}", Renderer::GetRenderQueue().GetNumRetained(), numRetained));
+
+		// Like the Sandbox's, a frame that has been drawn before (texture streaming included) shouldn't allocate
+		if (AllocationCounter::IsEnabled())
+		{
+			RenderFrame(context, drawables);
+			const uint64_t allocations = AllocationCounter::GetCount();
+			RenderFrame(context, drawables);
+			const uint64_t frameAllocations = AllocationCounter::GetCount() - allocations;
+			Check(frameAllocations == 0, std::format("A frame that was drawn before made {} heap allocations", frameAllocations));
+		}
+
+		Timer timer;
+		for (uint32_t i = 0; i < numFrames; i++)
+		{
+			RenderFrame(context, drawables);
+		}
+		const double ms = timer.GetElapsedInMilliseconds();
+
+		const RecordingStats& stats = context.GetCommandStream().GetStats();
+		std::cout << std::format("{} frames of {} cubes in {:.2f}ms, {:.4f}ms per frame\n", numFrames, numCubes, ms, numFrames > 0 ? ms / numFrames : 0.);
+		std::cout << std::format("Per frame: {} commands, {} draws, {} state changes, {} redundant binds, {} binds skipped by the renderer\n",
+			context.GetCommandStream().GetCommands().size(), stats.GetCount(RecordedCommandType::DrawIndexed), stats.StateChanges,
+			stats.RedundantBinds, Renderer::GetBindStats().Skipped);
+	}
+
+	// The drawables are gone by now, so their retained steps have been released
+	TextureStreamer::Shutdown();
+	Renderer::Shutdown();
+	ThreadPool::Shutdown();
+
+	if (s_Failed)
+	{
+		std::cerr << "Some checks failed\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,308 @@
+#include "pch.h"
+#include "Asset/ModelImporter.h"
+#include "Asset/TextureDecoder.h"
+#include "Asset/VertexKernels.h"
+#include "Core/ImportProfiler.h"
+#include "Core/ThreadPool.h"
+#include "Core/VirtualFileSystem.h"
+
+// Imports models and cooks the textures their materials use the same way the engine does, but without a window
+// or a graphics device, then writes out where the time went (see ImportProfiler). Meant for tracking import
+// times from scripts and CI, which is why this is the one project that also builds on Linux.
+//
+// Models and textures are read from and written to the caches as usual, delete the cache directory first to
+// time full imports. Paths are relative to the working directory, like they are for the engine.
+//
+// --benchmark times our own importer against Assimp for a model (see ModelImporter::BenchmarkImport), it can be
+// given more than once. --benchmark-loading imports all the models it's given one after the other and then all at
+// once on the ThreadPool (see ModelImporter::BenchmarkLoading). --kernels checks that the importers' SIMD vertex kernels give the same results as plain
+// scalar loops and then times them against each other. Both run before anything else so the profile isn't
+// affected by them.
+//
+// --lods, --lod-reduction and --lod-error set how the LOD chains are built (see LodOptions), models
+// cached with different options are imported again.
+//
+// --check-textures compares the top level of every cooked texture against its source image and round trips the
+// source through the other block compressed formats its usage allows, failing if any of them is below the
+// minimum PSNR for its format.
+//
+// Usage:
+//   Importer [--archive <archive>] [--profile <json>] [--trace <json>] [--benchmark <model>]... [--benchmark-loading <model>]... [--kernels] [--lods <count>] [--lod-reduction <share>] [--lod-error <error>] [--check-textures] <model>...
+
+namespace
+{
+	constexpr const char* s_FormatNames[] = { "RGBA8", "BC1", "BC3", "BC5", "BC7" };
+
+	// Over the channels a format keeps. The worst of the bundled textures are a few dB above these (BC1 30.6dB, BC3
+	// 31.9dB, BC5 36.1dB and BC7 32.9dB, all of them Sponza's), a broken encoder ends up far below them.
+	double GetMinimumPsnr(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::RGBA8:
+			return std::numeric_limits<double>::infinity();
+		case TextureFormat::BC1:
+			return 28.0;
+		case TextureFormat::BC3:
+			return 28.0;
+		case TextureFormat::BC5:
+			return 32.0;
+		case TextureFormat::BC7:
+			return 30.0;
+		}
+
+		return 0.0;
+	}
+
+	bool CheckTexture(const std::string& filepath, TextureUsage usage)
+	{
+		const std::shared_ptr<DecodedImage> image = TextureDecoder::Decode(filepath);
+		const std::shared_ptr<CookedTexture> cooked = TextureDecoder::Acquire(filepath, usage);
+		const uint32_t width = static_cast<uint32_t>(image->Width);
+		const uint32_t height = static_cast<uint32_t>(image->Height);
+
+		bool passed = true;
+		std::string results = filepath + ":";
+		const auto measure = [&](const std::string& name, TextureFormat format, const uint8_t* data)
+		{
+			const std::vector<uint8_t> pixels = TextureCompressor::Decompress(format, data, width, height);
+			const double error = TextureCompressor::MeanSquaredError(image->Pixels, pixels.data(), width, height, TextureCompressor::GetNumChannels(format));
+			const double psnr = TextureCompressor::GetPsnr(error);
+			results += std::format(" {} {:.2f}dB", name, psnr);
+			if (psnr < GetMinimumPsnr(format))
+			{
+				results += std::format(" (MSE {:.2f}, below {:.0f}dB)", error, GetMinimumPsnr(format));
+				passed = false;
+			}
+		};
+
+		measure(std::format("cooked {}", s_FormatNames[static_cast<uint32_t>(cooked->Format)]), cooked->Format, cooked->GetMipData(0));
+
+		std::vector<TextureFormat> formats;
+		if (usage == TextureUsage::NormalMap)
+		{
+			formats = { TextureFormat::BC5 };
+		}
+		else
+		{
+			if (!cooked->HasAlpha)
+			{
+				formats.push_back(TextureFormat::BC1);
+			}
+			formats.push_back(TextureFormat::BC3);
+			formats.push_back(TextureFormat::BC7);
+		}
+
+		for (TextureFormat format : formats)
+		{
+			const std::vector<uint8_t> data = TextureCompressor::Compress(format, image->Pixels, width, height);
+			measure(s_FormatNames[static_cast<uint32_t>(format)], format, data.data());
+		}
+
+		(passed ? std::cout : std::cerr) << results << "\n";
+		return passed;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	STRIP_DEBUG(Log::Init());
+
+	std::filesystem::path profilePath = "import_profile.json";
+	std::filesystem::path tracePath = "import_trace.json";
+	std::vector<std::filesystem::path> models;
+	std::vector<std::filesystem::path> benchmarks;
+	std::vector<std::filesystem::path> loadingBenchmarks;
+	LodOptions lodOptions;
+	bool runKernels = false;
+	bool checkTextures = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--archive" && i + 1 < argc)
+		{
+			const std::filesystem::path archivePath = argv[++i];
+			if (!VirtualFileSystem::Mount(archivePath))
+			{
+				std::cerr << "Failed to mount " << archivePath.string() << "\n";
+				return 1;
+			}
+		}
+		else if (arg == "--profile" && i + 1 < argc)
+		{
+			profilePath = argv[++i];
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+		}
+		else if (arg == "--benchmark" && i + 1 < argc)
+		{
+			benchmarks.emplace_back(argv[++i]);
+		}
+		else if (arg == "--benchmark-loading" && i + 1 < argc)
+		{
+			loadingBenchmarks.emplace_back(argv[++i]);
+		}
+		else if (arg == "--lods" && i + 1 < argc)
+		{
+			lodOptions.MaxLods = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (arg == "--lod-reduction" && i + 1 < argc)
+		{
+			lodOptions.Reduction = std::stof(argv[++i]);
+		}
+		else if (arg == "--lod-error" && i + 1 < argc)
+		{
+			lodOptions.TargetError = std::stof(argv[++i]);
+		}
+		else if (arg == "--kernels")
+		{
+			runKernels = true;
+		}
+		else if (arg == "--check-textures")
+		{
+			checkTextures = true;
+		}
+		else
+		{
+			models.emplace_back(arg);
+		}
+	}
+
+	if (models.empty() && benchmarks.empty() && loadingBenchmarks.empty() && !runKernels)
+	{
+		std::cerr << "Usage: Importer [--archive <archive>] [--profile <json>] [--trace <json>] [--benchmark <model>]... [--benchmark-loading <model>]... [--kernels] [--lods <count>] [--lod-reduction <share>] [--lod-error <error>] [--check-textures] <model>...\n";
+		return 1;
+	}
+
+	if (lodOptions.MaxLods == 0 || lodOptions.MaxLods > MeshSimplifier::s_MaxLods ||
+		!(lodOptions.Reduction > 0.f && lodOptions.Reduction < 1.f) || !(lodOptions.TargetError >= 0.f))
+	{
+		std::cerr << std::format("--lods has to be between 1 and {}, --lod-reduction between 0 and 1 (exclusive) and --lod-error can't be negative\n", MeshSimplifier::s_MaxLods);
+		return 1;
+	}
+	ModelImporter::SetLodOptions(lodOptions);
+
+	ThreadPool::Init();
+
+	if (runKernels)
+	{
+		if (!VertexKernels::MatchesScalar())
+		{
+			std::cerr << "The vertex kernels don't match their scalar loops\n";
+			ThreadPool::Shutdown();
+			return 1;
+		}
+
+		VertexKernels::RunBenchmarks();
+	}
+
+	for (const auto& filepath : benchmarks)
+	{
+		if (!VirtualFileSystem::Exists(filepath))
+		{
+			std::cerr << "Failed to find " << filepath.string() << "\n";
+			ThreadPool::Shutdown();
+			return 1;
+		}
+
+		ModelImporter::BenchmarkImport(filepath);
+	}
+
+	if (!loadingBenchmarks.empty())
+	{
+		for (const auto& filepath : loadingBenchmarks)
+		{
+			if (!VirtualFileSystem::Exists(filepath))
+			{
+				std::cerr << "Failed to find " << filepath.string() << "\n";
+				ThreadPool::Shutdown();
+				return 1;
+			}
+		}
+
+		ModelImporter::BenchmarkLoading(loadingBenchmarks);
+	}
+
+	if (models.empty())
+	{
+		ThreadPool::Shutdown();
+		return 0;
+	}
+
+	ImportProfiler::SetEnabled(true);
+
+	// Like the ModelLoader, a model's textures start cooking on the ThreadPool as soon as the model is
+	// imported, so they overlap with importing the next model
+	Timer timer;
+	std::vector<std::pair<std::string, TextureUsage>> textures;
+	size_t numModels = 0;
+	size_t numMeshes = 0;
+	for (const auto& filepath : models)
+	{
+		if (!VirtualFileSystem::Exists(filepath))
+		{
+			std::cerr << "Failed to find " << filepath.string() << "\n";
+			continue;
+		}
+
+		const std::shared_ptr<ModelData> model = ModelImporter::LoadModelCooked(filepath);
+		numModels++;
+		numMeshes += model->Meshes.size();
+
+		std::vector<std::pair<std::string, TextureUsage>> modelTextures;
+		for (const auto& mesh : model->Meshes)
+		{
+			const auto& filepaths = mesh.MeshMaterial->GetMaterialMaps();
+			for (uint32_t i = 0; i < filepaths.size(); i++)
+			{
+				std::pair<std::string, TextureUsage> texture = { filepaths[i], TextureDecoder::GetUsage(i) };
+				if (std::find(textures.begin(), textures.end(), texture) == textures.end())
+				{
+					modelTextures.push_back(texture);
+					textures.push_back(std::move(texture));
+				}
+			}
+		}
+		TextureDecoder::Prefetch(modelTextures);
+	}
+
+	for (const auto& [filepath, usage] : textures)
+	{
+		TextureDecoder::Acquire(filepath, usage);
+	}
+	const double ms = timer.GetElapsedInMilliseconds();
+
+	// Decoding the sources again would show up in the profile
+	size_t numFailedTextures = 0;
+	if (checkTextures)
+	{
+		ImportProfiler::SetEnabled(false);
+		for (const auto& [filepath, usage] : textures)
+		{
+			numFailedTextures += CheckTexture(filepath, usage) ? 0 : 1;
+		}
+	}
+
+	TextureDecoder::Shutdown();
+	ThreadPool::Shutdown();
+
+	STRIP_DEBUG(ImportProfiler::LogSummary());
+	if (!ImportProfiler::WriteJson(profilePath) || !ImportProfiler::WriteChromeTrace(tracePath))
+	{
+		std::cerr << "Failed to write the import profile\n";
+		return 1;
+	}
+
+	std::cout << std::format("Imported {} models ({} meshes, {} textures) in {:.2f}ms, profile written to {} and {}\n",
+		numModels, numMeshes, textures.size(), ms, profilePath.string(), tracePath.string());
+
+	if (numFailedTextures > 0)
+	{
+		std::cerr << std::format("{} of {} textures are below the minimum PSNR\n", numFailedTextures, textures.size());
+		return 1;
+	}
+
+	return 0;
+}
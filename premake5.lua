@@ -104,4 +104,217 @@ project (PROJECT_NAME)
         optimize "Full"
         links { "assimp-vc143-mt"}
         postbuildcommands { "{COPYDIR} %[%{wks.location}Calliterra/vendor/assimp/bin/%{cfg.buildcfg}/assimp-vc143-mt.dll] %[bin/%{outputdir}/%{PROJECT_NAME}]"}
-        postbuildcommands { "{COPYDIR} %[%{prj.location}/assets] %[bin/%{outputdir}/%{PROJECT_NAME}/assets]" }
\ No newline at end of file
+        dependson { "AssetPacker" }
+        postbuildcommands { "%[%{wks.location}bin/%{outputdir}/AssetPacker/AssetPacker.exe] %[%{prj.location}/assets] %[bin/%{outputdir}/%{PROJECT_NAME}/assets.cpak]" }
+
+-- Packs the assets directory into the archive the Distribution build reads from, see AssetArchive
+project "AssetPacker"
+    location "AssetPacker"
+    kind "ConsoleApp"
+    language "C++"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("obj/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "%{prj.name}/src/**.cpp",
+        "%{prj.name}/src/**.h",
+        PROJECT_NAME .. "/src/Core/AssetArchive.cpp",
+        PROJECT_NAME .. "/src/Core/Compression.cpp",
+        PROJECT_NAME .. "/src/Core/MappedFile.cpp",
+        PROJECT_NAME .. "/src/Core/VirtualFileSystem.cpp",
+        PROJECT_NAME .. "/src/Core/ImportProfiler.cpp",
+        PROJECT_NAME .. "/src/Core/Log.cpp"
+    }
+
+    includedirs
+    {
+        PROJECT_NAME .. "/src",
+        PROJECT_NAME .. "/vendor/spdlog/include"
+    }
+
+    filter "system:windows"
+		cppdialect "C++20"
+		staticruntime "On"
+		systemversion "latest"
+
+    filter "configurations:Debug"
+        defines { "_DEBUG", "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Debug"
+        symbols "On"
+        optimize "On"
+
+    filter "configurations:Distribution"
+        defines { "NDEBUG", "DISTRIBUTION" }
+        runtime "Release"
+        optimize "Full"
+
+-- Imports models and cooks their textures without a graphics device, writing out an ImportProfiler profile.
+-- Only the asset pipeline is compiled in, so unlike the engine this also builds on Linux (premake5 gmake2).
+project "Importer"
+    location "Importer"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("obj/" .. outputdir .. "/%{prj.name}")
+
+    defines
+    {
+        "UFBX_REAL_IS_FLOAT"
+    }
+
+    files
+    {
+        "%{prj.name}/src/**.cpp",
+        "%{prj.name}/src/**.h",
+        PROJECT_NAME .. "/src/Asset/ModelImporter.cpp",
+        PROJECT_NAME .. "/src/Asset/ModelAPI.cpp",
+        PROJECT_NAME .. "/src/Asset/ModelCache.cpp",
+        PROJECT_NAME .. "/src/Asset/MeshProcessing.cpp",
+        PROJECT_NAME .. "/src/Asset/MeshOptimizer.cpp",
+        PROJECT_NAME .. "/src/Asset/MeshSimplifier.cpp",
+        PROJECT_NAME .. "/src/Asset/MeshletBuilder.cpp",
+        PROJECT_NAME .. "/src/Asset/VertexKernels.cpp",
+        PROJECT_NAME .. "/src/Asset/TextureDecoder.cpp",
+        PROJECT_NAME .. "/src/Asset/TextureCache.cpp",
+        PROJECT_NAME .. "/src/Asset/TextureCompressor.cpp",
+        PROJECT_NAME .. "/src/Asset/MipGenerator.cpp",
+        PROJECT_NAME .. "/src/Core/AssetArchive.cpp",
+        PROJECT_NAME .. "/src/Core/BufferPool.cpp",
+        PROJECT_NAME .. "/src/Core/Compression.cpp",
+        PROJECT_NAME .. "/src/Core/ImportProfiler.cpp",
+        PROJECT_NAME .. "/src/Core/Log.cpp",
+        PROJECT_NAME .. "/src/Core/MappedFile.cpp",
+        PROJECT_NAME .. "/src/Core/ThreadPool.cpp",
+        PROJECT_NAME .. "/src/Core/VirtualFileSystem.cpp",
+        PROJECT_NAME .. "/vendor/ufbx/ufbx.c",
+        PROJECT_NAME .. "/vendor/stb/stb_image.c"
+    }
+
+    includedirs
+    {
+        PROJECT_NAME .. "/src",
+        PROJECT_NAME .. "/vendor/spdlog/include",
+        PROJECT_NAME .. "/vendor/rapidobj/include",
+        PROJECT_NAME .. "/vendor/ufbx/",
+        PROJECT_NAME .. "/vendor/stb/",
+        "%{IncludeDir.fastgltf}",
+        "%{IncludeDir.assimp}"
+    }
+
+    links
+    {
+        "fastgltf"
+    }
+
+    filter "system:windows"
+		staticruntime "On"
+		systemversion "latest"
+        flags { "MultiProcessorCompile" }
+        libdirs { "%{wks.location}/Calliterra/vendor/assimp/bin/%{cfg.buildcfg}/" }
+
+    -- DirectXMath (header only) and assimp come from the system, see the README
+    filter "system:linux"
+        links { "assimp", "pthread" }
+
+    filter "configurations:Debug"
+        defines { "_DEBUG", "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Debug"
+        symbols "On"
+        optimize "On"
+
+    filter "configurations:Distribution"
+        defines { "NDEBUG", "DISTRIBUTION" }
+        runtime "Release"
+        optimize "Full"
+
+    filter { "system:windows", "configurations:Debug" }
+        links { "assimp-vc143-mtd" }
+        postbuildcommands { "{COPYDIR} %[%{wks.location}Calliterra/vendor/assimp/bin/%{cfg.buildcfg}/assimp-vc143-mtd.dll] %[bin/%{outputdir}/%{prj.name}]" }
+
+    filter { "system:windows", "configurations:Release or Distribution" }
+        links { "assimp-vc143-mt" }
+        postbuildcommands { "{COPYDIR} %[%{wks.location}Calliterra/vendor/assimp/bin/%{cfg.buildcfg}/assimp-vc143-mt.dll] %[bin/%{outputdir}/%{prj.name}]" }
+
+-- Renders a test scene through the Recording RendererAPI, checks the recorded commands and times the CPU side of a
+-- frame. Only generated for Linux (premake5 gmake2), on Windows the renderer pulls in the DX11 backend along with
+-- everything it depends on, which is what the engine project is for.
+if os.istarget("linux") then
+project "HeadlessRenderer"
+    location "HeadlessRenderer"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("obj/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "%{prj.name}/src/**.cpp",
+        "%{prj.name}/src/**.h",
+        PROJECT_NAME .. "/src/Renderer/Blender.cpp",
+        PROJECT_NAME .. "/src/Renderer/ConstantBuffer.cpp",
+        PROJECT_NAME .. "/src/Renderer/DepthStencilMask.cpp",
+        PROJECT_NAME .. "/src/Renderer/GraphicsContext.cpp",
+        PROJECT_NAME .. "/src/Renderer/IndexBuffer.cpp",
+        PROJECT_NAME .. "/src/Renderer/Rasterizer.cpp",
+        PROJECT_NAME .. "/src/Renderer/Renderer.cpp",
+        PROJECT_NAME .. "/src/Renderer/RendererAPI.cpp",
+        PROJECT_NAME .. "/src/Renderer/Sampler.cpp",
+        PROJECT_NAME .. "/src/Renderer/Shader.cpp",
+        PROJECT_NAME .. "/src/Renderer/Texture.cpp",
+        PROJECT_NAME .. "/src/Renderer/TextureStreamer.cpp",
+        PROJECT_NAME .. "/src/Renderer/Topology.cpp",
+        PROJECT_NAME .. "/src/Renderer/RenderQueue/**.cpp",
+        PROJECT_NAME .. "/src/Platform/Recording/**.cpp",
+        PROJECT_NAME .. "/src/Sandbox/BasicShapes/Cube.cpp",
+        PROJECT_NAME .. "/src/Sandbox/Components/FullScreenQuad.cpp",
+        PROJECT_NAME .. "/src/Core/AllocationCounter.cpp",
+        PROJECT_NAME .. "/src/Core/FrameArena.cpp",
+        PROJECT_NAME .. "/src/Core/ImportProfiler.cpp",
+        PROJECT_NAME .. "/src/Core/Log.cpp",
+        PROJECT_NAME .. "/src/Core/ThreadPool.cpp"
+    }
+
+    includedirs
+    {
+        PROJECT_NAME .. "/src",
+        PROJECT_NAME .. "/vendor/spdlog/include"
+    }
+
+    -- -Wall -Wextra on GCC and Clang, the renderer code it builds compiles without warnings
+    warnings "Extra"
+
+    -- DirectXMath (header only) comes from the system, see the README
+    links { "pthread" }
+
+    filter "configurations:Debug"
+        defines { "_DEBUG", "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Debug"
+        symbols "On"
+        optimize "On"
+
+    filter "configurations:Distribution"
+        defines { "NDEBUG", "DISTRIBUTION" }
+        runtime "Release"
+        optimize "Full"
+end